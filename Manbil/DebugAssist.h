@@ -87,6 +87,7 @@ public:
 
             case PS_8U_GREYSCALE: return "R_8U";
             case PS_16U_GREYSCALE: return "R_16U";
+            case PS_16F_GREYSCALE: return "R_16F";
             case PS_32F_GREYSCALE: return "R_32F";
 
             case PS_16U_DEPTH: return "Depth_16U";
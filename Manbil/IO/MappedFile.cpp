@@ -0,0 +1,185 @@
+#include "MappedFile.h"
+
+#ifdef _WIN32
+    #define WIN32_LEAN_AND_MEAN
+    #define NOMINMAX
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <unistd.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <string.h>
+    #include <errno.h>
+#endif
+
+
+MappedFile::MappedFile(const std::string& filePath, size_t nBytes, std::string& outErrorMsg)
+    : path(filePath), size(nBytes), data(0), fileHandle(0), mappingHandle(0)
+{
+    Open(true, outErrorMsg);
+}
+MappedFile::MappedFile(const std::string& filePath, std::string& outErrorMsg)
+    : path(filePath), size(0), data(0), fileHandle(0), mappingHandle(0)
+{
+    Open(false, outErrorMsg);
+}
+MappedFile::~MappedFile(void)
+{
+    Close();
+}
+
+
+#ifdef _WIN32
+
+void MappedFile::Open(bool createNew, std::string& outErrorMsg)
+{
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, 0,
+                              (createNew ? CREATE_ALWAYS : OPEN_EXISTING), FILE_ATTRIBUTE_NORMAL, 0);
+    if (file == INVALID_HANDLE_VALUE)
+    {
+        outErrorMsg = "Couldn't open file '" + path + "': error code " + std::to_string(GetLastError());
+        return;
+    }
+    fileHandle = file;
+
+    if (!createNew)
+    {
+        LARGE_INTEGER fileSize;
+        if (!GetFileSizeEx(file, &fileSize))
+        {
+            outErrorMsg = "Couldn't get the size of file '" + path + "': error code " + std::to_string(GetLastError());
+            Close();
+            return;
+        }
+        size = (size_t)fileSize.QuadPart;
+    }
+    if (size == 0)
+    {
+        outErrorMsg = "File '" + path + "' is empty";
+        Close();
+        return;
+    }
+
+    //Creating the mapping also extends a new file to the right size.
+    unsigned long long size64 = (unsigned long long)size;
+    HANDLE mapping = CreateFileMappingA(file, 0, PAGE_READWRITE,
+                                        (DWORD)(size64 >> 32), (DWORD)(size64 & 0xffffffff), 0);
+    if (mapping == 0)
+    {
+        outErrorMsg = "Couldn't create a mapping for file '" + path + "': error code " + std::to_string(GetLastError());
+        Close();
+        return;
+    }
+    mappingHandle = mapping;
+
+    data = (unsigned char*)MapViewOfFile(mapping, FILE_MAP_ALL_ACCESS, 0, 0, size);
+    if (data == 0)
+    {
+        outErrorMsg = "Couldn't map file '" + path + "': error code " + std::to_string(GetLastError());
+        Close();
+        return;
+    }
+}
+void MappedFile::Close(void)
+{
+    if (data != 0)
+    {
+        UnmapViewOfFile(data);
+        data = 0;
+    }
+    if (mappingHandle != 0)
+    {
+        CloseHandle((HANDLE)mappingHandle);
+        mappingHandle = 0;
+    }
+    if (fileHandle != 0)
+    {
+        CloseHandle((HANDLE)fileHandle);
+        fileHandle = 0;
+    }
+}
+std::string MappedFile::Flush(void)
+{
+    if (data == 0)
+        return "File isn't mapped";
+
+    if (!FlushViewOfFile(data, 0) || !FlushFileBuffers((HANDLE)fileHandle))
+        return "Couldn't flush file '" + path + "': error code " + std::to_string(GetLastError());
+    return "";
+}
+
+#else
+
+//There's no separate mapping handle on POSIX systems, so "fileHandle" just stores the file descriptor plus 1.
+
+void MappedFile::Open(bool createNew, std::string& outErrorMsg)
+{
+    int file = open(path.c_str(), (createNew ? (O_RDWR | O_CREAT | O_TRUNC) : O_RDWR), 0644);
+    if (file < 0)
+    {
+        outErrorMsg = "Couldn't open file '" + path + "': " + strerror(errno);
+        return;
+    }
+    fileHandle = (void*)(size_t)(file + 1);
+
+    if (createNew)
+    {
+        if (ftruncate(file, (off_t)size) != 0)
+        {
+            outErrorMsg = "Couldn't resize file '" + path + "': " + strerror(errno);
+            Close();
+            return;
+        }
+    }
+    else
+    {
+        struct stat fileInfo;
+        if (fstat(file, &fileInfo) != 0)
+        {
+            outErrorMsg = "Couldn't get the size of file '" + path + "': " + strerror(errno);
+            Close();
+            return;
+        }
+        size = (size_t)fileInfo.st_size;
+    }
+    if (size == 0)
+    {
+        outErrorMsg = "File '" + path + "' is empty";
+        Close();
+        return;
+    }
+
+    void* mapped = mmap(0, size, PROT_READ | PROT_WRITE, MAP_SHARED, file, 0);
+    if (mapped == MAP_FAILED)
+    {
+        outErrorMsg = "Couldn't map file '" + path + "': " + strerror(errno);
+        Close();
+        return;
+    }
+    data = (unsigned char*)mapped;
+}
+void MappedFile::Close(void)
+{
+    if (data != 0)
+    {
+        munmap(data, size);
+        data = 0;
+    }
+    if (fileHandle != 0)
+    {
+        close((int)((size_t)fileHandle - 1));
+        fileHandle = 0;
+    }
+}
+std::string MappedFile::Flush(void)
+{
+    if (data == 0)
+        return "File isn't mapped";
+
+    if (msync(data, size, MS_SYNC) != 0)
+        return "Couldn't flush file '" + path + "': " + strerror(errno);
+    return "";
+}
+
+#endif
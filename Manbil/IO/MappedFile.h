@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+
+
+//A file whose contents are mapped directly into memory.
+//The operating system pages the file's data in and out as it's used,
+//    so the file can be much bigger than the available RAM.
+//Anything written into the mapped memory is eventually written back into the file.
+class MappedFile
+{
+public:
+
+    //Creates a new file of the given size at the given path (overwriting any existing file) and maps it.
+    //If something goes wrong, an error message is written to "outErrorMsg" and this instance is left invalid.
+    MappedFile(const std::string& filePath, size_t nBytes, std::string& outErrorMsg);
+    //Opens and maps the existing file at the given path.
+    //If something goes wrong, an error message is written to "outErrorMsg" and this instance is left invalid.
+    MappedFile(const std::string& filePath, std::string& outErrorMsg);
+
+    ~MappedFile(void);
+
+    MappedFile(const MappedFile& cpy) = delete;
+    MappedFile& operator=(const MappedFile& cpy) = delete;
+
+
+    //Gets whether the file was successfully opened and mapped.
+    bool IsValid(void) const { return data != 0; }
+
+    const std::string& GetPath(void) const { return path; }
+    //Gets the size of the file, in bytes.
+    size_t GetSize(void) const { return size; }
+
+    //Gets the start of the file's mapped memory.
+    unsigned char* GetData(void) { return data; }
+    //Gets the start of the file's mapped memory.
+    const unsigned char* GetData(void) const { return data; }
+
+    //Forces any changes in the mapped memory to be written to the file now.
+    //Returns an error message, or the empty string if everything was written successfully.
+    std::string Flush(void);
+
+
+private:
+
+    std::string path;
+    size_t size;
+    unsigned char* data;
+
+    //The operating system's handles for the file and its mapping.
+    void* fileHandle;
+    void* mappingHandle;
+
+
+    void Open(bool createNew, std::string& outErrorMsg);
+    void Close(void);
+};
@@ -653,6 +653,7 @@ IMPL_WRITE(MTexture2D)
         GET_AND_WRITE_TEX2(Vector4f, Color, PS_32F, "RGBA Float 32");
         GET_AND_WRITE_TEX2(unsigned char, Greyscale, PS_8U_GREYSCALE, "Greyscale UInt 8");
         GET_AND_WRITE_TEX2(float, Greyscale, PS_16U_GREYSCALE, "Greyscale UInt 16");
+        GET_AND_WRITE_TEX2(float, Greyscale, PS_16F_GREYSCALE, "Greyscale Float 16");
         GET_AND_WRITE_TEX2(float, Greyscale, PS_32F_GREYSCALE, "Greyscale Float 32");
         GET_AND_WRITE_TEX2(float, Depth, PS_16U_DEPTH, "Depth UInt 16");
         GET_AND_WRITE_TEX2(float, Depth, PS_24U_DEPTH, "Depth UInt 24");
@@ -683,6 +684,7 @@ IMPL_READ(MTexture2D)
     READ_TEX2("RGBA Float 32", Vector4f, Color, PS_32F)
     READ_TEX2("Greyscale UInt 8", unsigned char, Greyscale, PS_8U_GREYSCALE)
     READ_TEX2("Greyscale UInt 16", float, Greyscale, PS_16U_GREYSCALE)
+    READ_TEX2("Greyscale Float 16", float, Greyscale, PS_16F_GREYSCALE)
     READ_TEX2("Greyscale Float 32", float, Greyscale, PS_32F_GREYSCALE)
     READ_TEX2("Depth UInt 16", float, Depth, PS_16U_DEPTH)
     READ_TEX2("Depth UInt 24", float, Depth, PS_24U_DEPTH)
@@ -730,6 +732,7 @@ IMPL_WRITE(MTexture3D)
         GET_AND_WRITE_TEX3(Vector4f, Color, PS_32F, "RGBA Float 32");
         GET_AND_WRITE_TEX3(unsigned char, Greyscale, PS_8U_GREYSCALE, "Greyscale UInt 8");
         GET_AND_WRITE_TEX3(float, Greyscale, PS_16U_GREYSCALE, "Greyscale UInt 16");
+        GET_AND_WRITE_TEX3(float, Greyscale, PS_16F_GREYSCALE, "Greyscale Float 16");
         GET_AND_WRITE_TEX3(float, Greyscale, PS_32F_GREYSCALE, "Greyscale Float 32");
         GET_AND_WRITE_TEX3(float, Depth, PS_16U_DEPTH, "Depth UInt 16");
         GET_AND_WRITE_TEX3(float, Depth, PS_24U_DEPTH, "Depth UInt 24");
@@ -761,6 +764,7 @@ IMPL_READ(MTexture3D)
     READ_TEX3("RGBA Float 32", Vector4f, Color, PS_32F)
     READ_TEX3("Greyscale UInt 8", unsigned char, Greyscale, PS_8U_GREYSCALE)
     READ_TEX3("Greyscale UInt 16", float, Greyscale, PS_16U_GREYSCALE)
+    READ_TEX3("Greyscale Float 16", float, Greyscale, PS_16F_GREYSCALE)
     READ_TEX3("Greyscale Float 32", float, Greyscale, PS_32F_GREYSCALE)
     READ_TEX3("Depth UInt 16", float, Depth, PS_16U_DEPTH)
     READ_TEX3("Depth UInt 24", float, Depth, PS_24U_DEPTH)
@@ -822,6 +826,7 @@ IMPL_WRITE(MTextureCubemap)
         GET_AND_WRITE_TEXCUBE(Vector4f, Color, PS_32F, "RGBA Float 32");
         GET_AND_WRITE_TEXCUBE(unsigned char, Greyscale, PS_8U_GREYSCALE, "Greyscale UInt 8");
         GET_AND_WRITE_TEXCUBE(float, Greyscale, PS_16U_GREYSCALE, "Greyscale UInt 16");
+        GET_AND_WRITE_TEXCUBE(float, Greyscale, PS_16F_GREYSCALE, "Greyscale Float 16");
         GET_AND_WRITE_TEXCUBE(float, Greyscale, PS_32F_GREYSCALE, "Greyscale Float 32");
         GET_AND_WRITE_TEXCUBE(float, Depth, PS_16U_DEPTH, "Depth UInt 16");
         GET_AND_WRITE_TEXCUBE(float, Depth, PS_24U_DEPTH, "Depth UInt 24");
@@ -853,6 +858,7 @@ IMPL_READ(MTextureCubemap)
     READ_TEXCUBE("RGBA Float 32", Vector4f, Color, PS_32F)
     READ_TEXCUBE("Greyscale UInt 8", unsigned char, Greyscale, PS_8U_GREYSCALE)
     READ_TEXCUBE("Greyscale UInt 16", float, Greyscale, PS_16U_GREYSCALE)
+    READ_TEXCUBE("Greyscale Float 16", float, Greyscale, PS_16F_GREYSCALE)
     READ_TEXCUBE("Greyscale Float 32", float, Greyscale, PS_32F_GREYSCALE)
     READ_TEXCUBE("Depth UInt 16", float, Depth, PS_16U_DEPTH)
     READ_TEXCUBE("Depth UInt 24", float, Depth, PS_24U_DEPTH)
@@ -0,0 +1,448 @@
+#pragma once
+
+#include <string.h>
+#include "MappedFile.h"
+#include "../Math/Lower Math/Array2D.h"
+#include "../Math/Lower Math/Array3D.h"
+
+
+//The header at the start of every "TiledArray2D" or "TiledArray3D" file.
+//Padded to 64 bytes so that the tiles after it are nicely aligned.
+struct TiledArrayHeader
+{
+public:
+
+    //Identifies the file as a tiled array: "TAR2" for 2D arrays and "TAR3" for 3D arrays.
+    char MagicID[4];
+    unsigned int Version;
+    //The size of each element, in bytes.
+    unsigned int ElementSize;
+    //The size of each tile along every axis.
+    unsigned int TileSize;
+    //The size of the array along each axis. "Depth" is always 1 for 2D arrays.
+    unsigned int Width, Height, Depth;
+
+    unsigned char Padding[36];
+
+
+    static const unsigned int CurrentVersion = 1;
+
+    //Checks whether this header describes a valid array of the given element size and number of dimensions.
+    //Returns an error message, or the empty string if the header is valid.
+    std::string Validate(const char* expectedMagicID, unsigned int expectedElementSize) const
+    {
+        if (memcmp(MagicID, expectedMagicID, 4) != 0)
+            return "Not a tiled array file with the right number of dimensions";
+        if (Version != CurrentVersion)
+            return "Unsupported tiled array version " + std::to_string(Version);
+        if (ElementSize != expectedElementSize)
+            return "Expected elements of size " + std::to_string(expectedElementSize) +
+                       " but the file has elements of size " + std::to_string(ElementSize);
+        if (TileSize == 0 || Width == 0 || Height == 0 || Depth == 0)
+            return "The file's array has a size of 0";
+        return "";
+    }
+};
+static_assert(sizeof(TiledArrayHeader) == 64, "TiledArrayHeader should be 64 bytes");
+
+
+
+//The type of item this array contains. Must be trivially-copiable, because it's stored directly in a file.
+template<typename ArrayType>
+//A two-dimensional array stored in a memory-mapped file, so it can be much bigger than the available RAM
+//    (e.x. a 16k x 16k heightmap).
+//The array is split into square tiles, and each tile is stored contiguously in the file.
+//This means that working on the array one tile at a time only touches a small part of the file at once,
+//    unlike a normal row-by-row layout where even a small square region is spread across the whole file.
+//Tiles on the edge of the array are padded out to the full tile size.
+class TiledArray2D
+{
+public:
+
+    //Creates a new file at the given path (overwriting any existing file) to hold an array of the given size.
+    //The elements are left uninitialized (which in practice means zeroed out).
+    //If something goes wrong, an error message is written to "outErrorMsg" and this instance is left invalid.
+    TiledArray2D(const std::string& filePath, Vector2u _size, unsigned int _tileSize, std::string& outErrorMsg)
+        : size(_size), tileSize(_tileSize), values(0)
+    {
+        assert(size.x > 0 && size.y > 0 && tileSize > 0);
+        nTiles = Vector2u((size.x + tileSize - 1) / tileSize, (size.y + tileSize - 1) / tileSize);
+
+        size_t nBytes = sizeof(TiledArrayHeader) +
+                        ((size_t)nTiles.x * nTiles.y * tileSize * tileSize * sizeof(ArrayType));
+        file = std::make_shared<MappedFile>(filePath, nBytes, outErrorMsg);
+        if (!file->IsValid())
+            return;
+
+        TiledArrayHeader& header = *(TiledArrayHeader*)file->GetData();
+        memset(&header, 0, sizeof(TiledArrayHeader));
+        memcpy(header.MagicID, "TAR2", 4);
+        header.Version = TiledArrayHeader::CurrentVersion;
+        header.ElementSize = sizeof(ArrayType);
+        header.TileSize = tileSize;
+        header.Width = size.x;
+        header.Height = size.y;
+        header.Depth = 1;
+
+        values = (ArrayType*)(file->GetData() + sizeof(TiledArrayHeader));
+    }
+    //Opens an existing tiled array file.
+    //If something goes wrong, an error message is written to "outErrorMsg" and this instance is left invalid.
+    TiledArray2D(const std::string& filePath, std::string& outErrorMsg)
+        : tileSize(0), values(0)
+    {
+        file = std::make_shared<MappedFile>(filePath, outErrorMsg);
+        if (!file->IsValid())
+            return;
+
+        if (file->GetSize() < sizeof(TiledArrayHeader))
+        {
+            outErrorMsg = "File is too small to be a tiled array";
+            return;
+        }
+        const TiledArrayHeader& header = *(const TiledArrayHeader*)file->GetData();
+        outErrorMsg = header.Validate("TAR2", sizeof(ArrayType));
+        if (!outErrorMsg.empty())
+            return;
+
+        size = Vector2u(header.Width, header.Height);
+        tileSize = header.TileSize;
+        nTiles = Vector2u((size.x + tileSize - 1) / tileSize, (size.y + tileSize - 1) / tileSize);
+
+        size_t nBytes = sizeof(TiledArrayHeader) +
+                        ((size_t)nTiles.x * nTiles.y * tileSize * tileSize * sizeof(ArrayType));
+        if (file->GetSize() < nBytes)
+        {
+            outErrorMsg = "File is too small to hold the array it describes";
+            return;
+        }
+
+        values = (ArrayType*)(file->GetData() + sizeof(TiledArrayHeader));
+    }
+
+
+    //Gets whether the file was successfully opened.
+    bool IsValid(void) const { return values != 0; }
+
+
+    ArrayType& operator[](Vector2u l) { return values[GetIndex(l.x, l.y)]; }
+    const ArrayType& operator[](Vector2u l) const { return values[GetIndex(l.x, l.y)]; }
+
+
+    //Gets the X size of this array.
+    unsigned int GetWidth(void) const { return size.x; }
+    //Gets the Y size of this array.
+    unsigned int GetHeight(void) const { return size.y; }
+    //Gets the size of this array along each axis.
+    Vector2u GetDimensions(void) const { return size; }
+
+    //Gets the size of each tile along each axis.
+    unsigned int GetTileSize(void) const { return tileSize; }
+    //Gets the number of tiles along each axis.
+    Vector2u GetNumbTiles(void) const { return nTiles; }
+
+
+    //Gets the index in the file's element data for the given position.
+    size_t GetIndex(unsigned int x, unsigned int y) const
+    {
+        size_t tileIndex = (x / tileSize) + ((size_t)(y / tileSize) * nTiles.x);
+        return (tileIndex * tileSize * tileSize) + (x % tileSize) + ((y % tileSize) * tileSize);
+    }
+
+
+    //Gets an array that directly uses the memory of the given tile.
+    //The array is always "GetTileSize()" elements wide and tall; for tiles on the edge of this array,
+    //    the elements outside this array are just padding.
+    //The array keeps the file open for as long as it exists.
+    Array2D<ArrayType> GetTile(Vector2u tile)
+    {
+        assert(tile.x < nTiles.x && tile.y < nTiles.y);
+        size_t tileIndex = tile.x + ((size_t)tile.y * nTiles.x);
+        return Array2D<ArrayType>(tileSize, tileSize, &values[tileIndex * tileSize * tileSize], file);
+    }
+    //Gets the range of positions in this array covered by the given tile, not including any padding.
+    void GetTileBounds(Vector2u tile, Vector2u& outMin, Vector2u& outMaxExclusive) const
+    {
+        outMin = tile * tileSize;
+        outMaxExclusive = Vector2u(Mathf::Min(outMin.x + tileSize, size.x),
+                                   Mathf::Min(outMin.y + tileSize, size.y));
+    }
+
+
+    //Fills every element with the given value.
+    void Fill(const ArrayType& value)
+    {
+        size_t nElements = (size_t)nTiles.x * nTiles.y * tileSize * tileSize;
+        for (size_t i = 0; i < nElements; ++i)
+            values[i] = value;
+    }
+
+    //A function with signature "void GetValue(Vector2u index, ArrayType* outNewValue)".
+    template<typename Func>
+    //Fills every element using the given function.
+    //Goes through the array one tile at a time, to only touch one part of the file at once.
+    void FillFunc(Func getValue)
+    {
+        Vector2u tile, minPos, maxPos, loc;
+        for (tile.y = 0; tile.y < nTiles.y; ++tile.y)
+            for (tile.x = 0; tile.x < nTiles.x; ++tile.x)
+            {
+                GetTileBounds(tile, minPos, maxPos);
+                for (loc.y = minPos.y; loc.y < maxPos.y; ++loc.y)
+                    for (loc.x = minPos.x; loc.x < maxPos.x; ++loc.x)
+                        getValue(loc, &values[GetIndex(loc.x, loc.y)]);
+            }
+    }
+
+
+    //Copies the part of this array starting at the given position into the given array.
+    //The start position may be negative, and the region may go past the edge of this array;
+    //    positions outside this array are clamped to the nearest edge.
+    //This makes it easy to read a tile along with a border of its neighbors' values.
+    void ReadRegion(Vector2i start, Array2D<ArrayType>& outRegion) const
+    {
+        Vector2i maxPos = ToV2i(size) - Vector2i(1, 1);
+        Vector2u loc;
+        for (loc.y = 0; loc.y < outRegion.GetHeight(); ++loc.y)
+        {
+            unsigned int y = (unsigned int)Mathf::Clamp(start.y + (int)loc.y, 0, maxPos.y);
+            for (loc.x = 0; loc.x < outRegion.GetWidth(); ++loc.x)
+            {
+                unsigned int x = (unsigned int)Mathf::Clamp(start.x + (int)loc.x, 0, maxPos.x);
+                outRegion[loc] = values[GetIndex(x, y)];
+            }
+        }
+    }
+    //Copies the given array into this one, starting at the given position.
+    //Any values of the given array that don't correspond to a value in this array are ignored.
+    void WriteRegion(Vector2u start, const Array2D<ArrayType>& region)
+    {
+        Vector2u maxPos(Mathf::Min(start.x + region.GetWidth(), size.x),
+                        Mathf::Min(start.y + region.GetHeight(), size.y));
+        for (Vector2u loc(0, start.y); loc.y < maxPos.y; ++loc.y)
+            for (loc.x = start.x; loc.x < maxPos.x; ++loc.x)
+                values[GetIndex(loc.x, loc.y)] = region[loc - start];
+    }
+
+
+    //Forces any changes to be written to the file now.
+    //Returns an error message, or the empty string if everything was written successfully.
+    std::string Flush(void) { return file->Flush(); }
+
+
+private:
+
+    std::shared_ptr<MappedFile> file;
+    Vector2u size, nTiles;
+    unsigned int tileSize;
+    ArrayType* values;
+};
+
+
+
+//The type of item this array contains. Must be trivially-copiable, because it's stored directly in a file.
+template<typename ArrayType>
+//A three-dimensional array stored in a memory-mapped file, so it can be much bigger than the available RAM
+//    (e.x. a 512^3 volume).
+//The array is split into cube-shaped tiles, and each tile is stored contiguously in the file.
+//Tiles on the edge of the array are padded out to the full tile size.
+class TiledArray3D
+{
+public:
+
+    //Creates a new file at the given path (overwriting any existing file) to hold an array of the given size.
+    //The elements are left uninitialized (which in practice means zeroed out).
+    //If something goes wrong, an error message is written to "outErrorMsg" and this instance is left invalid.
+    TiledArray3D(const std::string& filePath, Vector3u _size, unsigned int _tileSize, std::string& outErrorMsg)
+        : size(_size), tileSize(_tileSize), values(0)
+    {
+        assert(size.x > 0 && size.y > 0 && size.z > 0 && tileSize > 0);
+        nTiles = Vector3u((size.x + tileSize - 1) / tileSize,
+                          (size.y + tileSize - 1) / tileSize,
+                          (size.z + tileSize - 1) / tileSize);
+
+        size_t nBytes = sizeof(TiledArrayHeader) +
+                        ((size_t)nTiles.x * nTiles.y * nTiles.z * tileSize * tileSize * tileSize * sizeof(ArrayType));
+        file = std::make_shared<MappedFile>(filePath, nBytes, outErrorMsg);
+        if (!file->IsValid())
+            return;
+
+        TiledArrayHeader& header = *(TiledArrayHeader*)file->GetData();
+        memset(&header, 0, sizeof(TiledArrayHeader));
+        memcpy(header.MagicID, "TAR3", 4);
+        header.Version = TiledArrayHeader::CurrentVersion;
+        header.ElementSize = sizeof(ArrayType);
+        header.TileSize = tileSize;
+        header.Width = size.x;
+        header.Height = size.y;
+        header.Depth = size.z;
+
+        values = (ArrayType*)(file->GetData() + sizeof(TiledArrayHeader));
+    }
+    //Opens an existing tiled array file.
+    //If something goes wrong, an error message is written to "outErrorMsg" and this instance is left invalid.
+    TiledArray3D(const std::string& filePath, std::string& outErrorMsg)
+        : tileSize(0), values(0)
+    {
+        file = std::make_shared<MappedFile>(filePath, outErrorMsg);
+        if (!file->IsValid())
+            return;
+
+        if (file->GetSize() < sizeof(TiledArrayHeader))
+        {
+            outErrorMsg = "File is too small to be a tiled array";
+            return;
+        }
+        const TiledArrayHeader& header = *(const TiledArrayHeader*)file->GetData();
+        outErrorMsg = header.Validate("TAR3", sizeof(ArrayType));
+        if (!outErrorMsg.empty())
+            return;
+
+        size = Vector3u(header.Width, header.Height, header.Depth);
+        tileSize = header.TileSize;
+        nTiles = Vector3u((size.x + tileSize - 1) / tileSize,
+                          (size.y + tileSize - 1) / tileSize,
+                          (size.z + tileSize - 1) / tileSize);
+
+        size_t nBytes = sizeof(TiledArrayHeader) +
+                        ((size_t)nTiles.x * nTiles.y * nTiles.z * tileSize * tileSize * tileSize * sizeof(ArrayType));
+        if (file->GetSize() < nBytes)
+        {
+            outErrorMsg = "File is too small to hold the array it describes";
+            return;
+        }
+
+        values = (ArrayType*)(file->GetData() + sizeof(TiledArrayHeader));
+    }
+
+
+    //Gets whether the file was successfully opened.
+    bool IsValid(void) const { return values != 0; }
+
+
+    ArrayType& operator[](Vector3u l) { return values[GetIndex(l.x, l.y, l.z)]; }
+    const ArrayType& operator[](Vector3u l) const { return values[GetIndex(l.x, l.y, l.z)]; }
+
+
+    //Gets the X size of this array.
+    unsigned int GetWidth(void) const { return size.x; }
+    //Gets the Y size of this array.
+    unsigned int GetHeight(void) const { return size.y; }
+    //Gets the Z size of this array.
+    unsigned int GetDepth(void) const { return size.z; }
+    //Gets the size of this array along each axis.
+    Vector3u GetDimensions(void) const { return size; }
+
+    //Gets the size of each tile along each axis.
+    unsigned int GetTileSize(void) const { return tileSize; }
+    //Gets the number of tiles along each axis.
+    Vector3u GetNumbTiles(void) const { return nTiles; }
+
+
+    //Gets the index in the file's element data for the given position.
+    size_t GetIndex(unsigned int x, unsigned int y, unsigned int z) const
+    {
+        size_t tileIndex = (x / tileSize) + ((size_t)(y / tileSize) * nTiles.x) +
+                           ((size_t)(z / tileSize) * nTiles.x * nTiles.y);
+        return (tileIndex * tileSize * tileSize * tileSize) +
+               (x % tileSize) + ((y % tileSize) * tileSize) + ((size_t)(z % tileSize) * tileSize * tileSize);
+    }
+
+
+    //Gets an array that directly uses the memory of the given tile.
+    //The array is always "GetTileSize()" elements along each axis; for tiles on the edge of this array,
+    //    the elements outside this array are just padding.
+    //The array keeps the file open for as long as it exists.
+    Array3D<ArrayType> GetTile(Vector3u tile)
+    {
+        assert(tile.x < nTiles.x && tile.y < nTiles.y && tile.z < nTiles.z);
+        size_t tileIndex = tile.x + ((size_t)tile.y * nTiles.x) + ((size_t)tile.z * nTiles.x * nTiles.y);
+        return Array3D<ArrayType>(tileSize, tileSize, tileSize,
+                                  &values[tileIndex * tileSize * tileSize * tileSize], file);
+    }
+    //Gets the range of positions in this array covered by the given tile, not including any padding.
+    void GetTileBounds(Vector3u tile, Vector3u& outMin, Vector3u& outMaxExclusive) const
+    {
+        outMin = Vector3u(tile.x * tileSize, tile.y * tileSize, tile.z * tileSize);
+        outMaxExclusive = Vector3u(Mathf::Min(outMin.x + tileSize, size.x),
+                                   Mathf::Min(outMin.y + tileSize, size.y),
+                                   Mathf::Min(outMin.z + tileSize, size.z));
+    }
+
+
+    //Fills every element with the given value.
+    void Fill(const ArrayType& value)
+    {
+        size_t nElements = (size_t)nTiles.x * nTiles.y * nTiles.z * tileSize * tileSize * tileSize;
+        for (size_t i = 0; i < nElements; ++i)
+            values[i] = value;
+    }
+
+    //A function with signature "void GetValue(Vector3u index, ArrayType* outNewValue)".
+    template<typename Func>
+    //Fills every element using the given function.
+    //Goes through the array one tile at a time, to only touch one part of the file at once.
+    void FillFunc(Func getValue)
+    {
+        Vector3u tile, minPos, maxPos, loc;
+        for (tile.z = 0; tile.z < nTiles.z; ++tile.z)
+            for (tile.y = 0; tile.y < nTiles.y; ++tile.y)
+                for (tile.x = 0; tile.x < nTiles.x; ++tile.x)
+                {
+                    GetTileBounds(tile, minPos, maxPos);
+                    for (loc.z = minPos.z; loc.z < maxPos.z; ++loc.z)
+                        for (loc.y = minPos.y; loc.y < maxPos.y; ++loc.y)
+                            for (loc.x = minPos.x; loc.x < maxPos.x; ++loc.x)
+                                getValue(loc, &values[GetIndex(loc.x, loc.y, loc.z)]);
+                }
+    }
+
+
+    //Copies the part of this array starting at the given position into the given array.
+    //The start position may be negative, and the region may go past the edge of this array;
+    //    positions outside this array are clamped to the nearest edge.
+    //This makes it easy to read a tile along with a border of its neighbors' values.
+    void ReadRegion(Vector3i start, Array3D<ArrayType>& outRegion) const
+    {
+        Vector3i maxPos = ToV3i(size) - Vector3i(1, 1, 1);
+        Vector3u loc;
+        for (loc.z = 0; loc.z < outRegion.GetDepth(); ++loc.z)
+        {
+            unsigned int z = (unsigned int)Mathf::Clamp(start.z + (int)loc.z, 0, maxPos.z);
+            for (loc.y = 0; loc.y < outRegion.GetHeight(); ++loc.y)
+            {
+                unsigned int y = (unsigned int)Mathf::Clamp(start.y + (int)loc.y, 0, maxPos.y);
+                for (loc.x = 0; loc.x < outRegion.GetWidth(); ++loc.x)
+                {
+                    unsigned int x = (unsigned int)Mathf::Clamp(start.x + (int)loc.x, 0, maxPos.x);
+                    outRegion[loc] = values[GetIndex(x, y, z)];
+                }
+            }
+        }
+    }
+    //Copies the given array into this one, starting at the given position.
+    //Any values of the given array that don't correspond to a value in this array are ignored.
+    void WriteRegion(Vector3u start, const Array3D<ArrayType>& region)
+    {
+        Vector3u maxPos(Mathf::Min(start.x + region.GetWidth(), size.x),
+                        Mathf::Min(start.y + region.GetHeight(), size.y),
+                        Mathf::Min(start.z + region.GetDepth(), size.z));
+        for (Vector3u loc(0, 0, start.z); loc.z < maxPos.z; ++loc.z)
+            for (loc.y = start.y; loc.y < maxPos.y; ++loc.y)
+                for (loc.x = start.x; loc.x < maxPos.x; ++loc.x)
+                    values[GetIndex(loc.x, loc.y, loc.z)] = region[loc - start];
+    }
+
+
+    //Forces any changes to be written to the file now.
+    //Returns an error message, or the empty string if everything was written successfully.
+    std::string Flush(void) { return file->Flush(); }
+
+
+private:
+
+    std::shared_ptr<MappedFile> file;
+    Vector3u size, nTiles;
+    unsigned int tileSize;
+    ArrayType* values;
+};
@@ -62,4 +62,33 @@ void BumpmapToNormalmap::Convert(const Array2D<float>& heightmap, float heightSc
             normals[loc] = sum;
         }
     }
+}
+
+void BumpmapToNormalmap::ConvertGradients(const Array2D<Vector2f>& gradients, float heightScale,
+                                          bool normalizeRange, Array2D<Vector3f>& normals)
+{
+    if (normals.GetWidth() != gradients.GetWidth() ||
+        normals.GetHeight() != gradients.GetHeight())
+    {
+        normals.Resize(gradients.GetWidth(), gradients.GetHeight(), Vector3f());
+    }
+
+    //The surface "z = heightScale * height(x, y)" has the normal
+    //    "{-heightScale * dHeight/dX, -heightScale * dHeight/dY, 1}".
+    for (Vector2u loc(0, 0); loc.y < gradients.GetHeight(); ++loc.y)
+    {
+        for (loc.x = 0; loc.x < gradients.GetWidth(); ++loc.x)
+        {
+            Vector2f gradient = gradients[loc];
+            Vector3f normal = Vector3f(-heightScale * gradient.x, -heightScale * gradient.y, 1.0f).Normalized();
+
+            //Pack the normal into the range [0, 1] if necessary.
+            if (normalizeRange)
+            {
+                normal = (normal * 0.5f) + Vector3f(0.5f, 0.5f, 0.5f);
+            }
+
+            normals[loc] = normal;
+        }
+    }
 }
\ No newline at end of file
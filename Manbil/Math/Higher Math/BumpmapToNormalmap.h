@@ -12,4 +12,13 @@ public:
     //Resizes "outNormals" if they aren't the same size as "heightmap" already.
     static void Convert(const Array2D<float>& heightmap, float heightScale,
                         bool normalizeRange, Array2D<Vector3f>& outNormals);
+
+    //Calculates a normal map from the gradient of a heightmap
+    //    (e.x. from "Generator2D::GenerateWithGradients").
+    //Each normal only depends on its own gradient, so no neighboring heights are needed.
+    //If "normalizeRange" is true, each normal's X, Y, and Z values will be remapped
+    //    from [-1, 1] to [0, 1] for packing into a texture.
+    //Resizes "outNormals" if they aren't the same size as "gradients" already.
+    static void ConvertGradients(const Array2D<Vector2f>& gradients, float heightScale,
+                                 bool normalizeRange, Array2D<Vector3f>& outNormals);
 };
\ No newline at end of file
@@ -0,0 +1,417 @@
+#include "Erosion.h"
+
+#include <cstring>
+
+#include "../Lower Math/HashRand.h"
+#include "../Lower Math/SIMD.h"
+#include "../../ThreadPool.h"
+
+
+namespace
+{
+    //Gets the bilinearly-interpolated height and slope at the given position.
+    //The position must be at least one cell away from the right/bottom edges.
+    float GetHeightAndGradient(const Array2D<float>& heights, Vector2f pos, Vector2f& outGradient)
+    {
+        Vector2u cell((unsigned int)pos.x, (unsigned int)pos.y);
+        Vector2f t(pos.x - (float)cell.x, pos.y - (float)cell.y);
+
+        float hNW = heights[cell],
+              hNE = heights[Vector2u(cell.x + 1, cell.y)],
+              hSW = heights[Vector2u(cell.x, cell.y + 1)],
+              hSE = heights[Vector2u(cell.x + 1, cell.y + 1)];
+
+        outGradient = Vector2f(((hNE - hNW) * (1.0f - t.y)) + ((hSE - hSW) * t.y),
+                               ((hSW - hNW) * (1.0f - t.x)) + ((hSE - hNE) * t.x));
+        return (hNW * (1.0f - t.x) * (1.0f - t.y)) + (hNE * t.x * (1.0f - t.y)) +
+               (hSW * (1.0f - t.x) * t.y) + (hSE * t.x * t.y);
+    }
+
+
+    //In all of these helpers, "pitch" is the number of values from the start of one row of the heightmap
+    //    to the start of the next, which is more than "width" if the rows are padded.
+
+    //The eight neighbors of a cell, and one over the distance to each one.
+    const int neighborXs[8] = { -1, 0, 1, -1, 1, -1, 0, 1 },
+              neighborYs[8] = { -1, -1, -1, 0, 0, 1, 1, 1 };
+    const float diagonal = 0.70710678f;
+    const float neighborInvDistances[8] = { diagonal, 1.0f, diagonal, 1.0f, 1.0f, diagonal, 1.0f, diagonal };
+
+    template<bool CheckEdges>
+    //Gets how much material the given cell sends to each lower neighbor per unit of slope to it.
+    //If "CheckEdges" is false, the cell must not be on the edge of the heightmap.
+    float GetMoveScale(const float* heights, int x, int y, int width, int height, int pitch,
+                       float talusSlope, float rate)
+    {
+        float cellHeight = heights[x + (y * pitch)],
+              maxSlope = 0.0f,
+              totalSlope = 0.0f;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            int nX = x + neighborXs[i],
+                nY = y + neighborYs[i];
+            if (CheckEdges && (nX < 0 || nY < 0 || nX >= width || nY >= height))
+                continue;
+
+            float slope = (cellHeight - heights[nX + (nY * pitch)]) * neighborInvDistances[i];
+            maxSlope = (slope > talusSlope && slope > maxSlope) ? slope : maxSlope;
+            totalSlope += (slope > talusSlope) ? slope : 0.0f;
+        }
+        return (totalSlope > 0.0f) ? (rate * (maxSlope - talusSlope) / totalSlope) : 0.0f;
+    }
+    template<bool CheckEdges>
+    //Gets the given cell's height after it sends material to its lower neighbors
+    //    and gets material from its higher ones.
+    //If "CheckEdges" is false, the cell must not be on the edge of the heightmap.
+    float GetMovedHeight(const float* heights, const float* moveScales,
+                         int x, int y, int width, int height, int pitch, float talusSlope)
+    {
+        int index = x + (y * pitch);
+        float cellHeight = heights[index],
+              scale = moveScales[index],
+              change = 0.0f;
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            int nX = x + neighborXs[i],
+                nY = y + neighborYs[i];
+            if (CheckEdges && (nX < 0 || nY < 0 || nX >= width || nY >= height))
+                continue;
+            int nIndex = nX + (nY * pitch);
+
+            //These are computed exactly like the slopes in "GetMoveScale" for each cell.
+            float slopeOut = (cellHeight - heights[nIndex]) * neighborInvDistances[i],
+                  slopeIn = (heights[nIndex] - cellHeight) * neighborInvDistances[i];
+            change -= (slopeOut > talusSlope) ? (scale * slopeOut) : 0.0f;
+            change += (slopeIn > talusSlope) ? (moveScales[nIndex] * slopeIn) : 0.0f;
+        }
+        return cellHeight + change;
+    }
+
+    //Does "GetMoveScale<false>" for a pack of cells in a row, starting at the given one.
+    //Gives exactly the same values, since it does the same operations in the same order.
+    SIMDFloats GetMoveScales(const float* heights, int x, int y, int pitch, float talusSlope, float rate)
+    {
+        const float* cells = heights + x + (y * pitch);
+        SIMDFloats cellHeights = SIMDFloats::Load(cells),
+                   talus(talusSlope),
+                   maxSlope(0.0f),
+                   totalSlope(0.0f);
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            SIMDFloats slope = (cellHeights - SIMDFloats::Load(cells + neighborXs[i] + (neighborYs[i] * pitch))) *
+                               SIMDFloats(neighborInvDistances[i]);
+            SIMDInts isSteep = slope.GreaterThan(talus);
+            maxSlope = SIMDFloats::Select(isSteep & slope.GreaterThan(maxSlope), slope, maxSlope);
+            totalSlope = totalSlope + SIMDFloats::Select(isSteep, slope, SIMDFloats(0.0f));
+        }
+        return SIMDFloats::Select(totalSlope.GreaterThan(SIMDFloats(0.0f)),
+                                  SIMDFloats(rate) * (maxSlope - talus) / totalSlope,
+                                  SIMDFloats(0.0f));
+    }
+    //Does "GetMovedHeight<false>" for a pack of cells in a row, starting at the given one.
+    //Gives exactly the same values, since it does the same operations in the same order.
+    SIMDFloats GetMovedHeights(const float* heights, const float* moveScales,
+                               int x, int y, int pitch, float talusSlope)
+    {
+        int index = x + (y * pitch);
+        SIMDFloats cellHeights = SIMDFloats::Load(heights + index),
+                   scales = SIMDFloats::Load(moveScales + index),
+                   talus(talusSlope),
+                   change(0.0f);
+        for (unsigned int i = 0; i < 8; ++i)
+        {
+            int nIndex = index + neighborXs[i] + (neighborYs[i] * pitch);
+            SIMDFloats nHeights = SIMDFloats::Load(heights + nIndex),
+                       invDistance(neighborInvDistances[i]),
+                       slopeOut = (cellHeights - nHeights) * invDistance,
+                       slopeIn = (nHeights - cellHeights) * invDistance;
+            change = change - SIMDFloats::Select(slopeOut.GreaterThan(talus), scales * slopeOut, SIMDFloats(0.0f));
+            change = change + SIMDFloats::Select(slopeIn.GreaterThan(talus),
+                                                 SIMDFloats::Load(moveScales + nIndex) * slopeIn,
+                                                 SIMDFloats(0.0f));
+        }
+        return cellHeights + change;
+    }
+}
+
+
+HydraulicErosion::Brush HydraulicErosion::MakeBrush(void) const
+{
+    Brush brush;
+    float weightSum = 0.0f,
+          radius = (float)ErosionRadius;
+    int iRadius = (int)ErosionRadius;
+    for (int y = -iRadius; y <= iRadius; ++y)
+    {
+        for (int x = -iRadius; x <= iRadius; ++x)
+        {
+            float weight = radius - sqrtf((float)((x * x) + (y * y)));
+            if (weight > 0.0f)
+            {
+                brush.Offsets.push_back(Vector2i(x, y));
+                brush.Weights.push_back(weight);
+                weightSum += weight;
+            }
+        }
+    }
+
+    //A radius of 0 just erodes the droplet's own cell.
+    if (brush.Offsets.empty())
+    {
+        brush.Offsets.push_back(Vector2i());
+        brush.Weights.push_back(1.0f);
+        weightSum = 1.0f;
+    }
+
+    for (unsigned int i = 0; i < brush.Weights.size(); ++i)
+        brush.Weights[i] /= weightSum;
+    return brush;
+}
+
+void HydraulicErosion::RunDroplets(Array2D<float>& region, const Brush& brush, Vector2u startMin, Vector2u startMax,
+                                   unsigned int firstDroplet, unsigned int nDroplets) const
+{
+    Vector2f startRange = ToV2f(startMax - startMin),
+             maxPos((float)(region.GetWidth() - 1), (float)(region.GetHeight() - 1));
+    Vector2i regionSize((int)region.GetWidth(), (int)region.GetHeight());
+
+    for (unsigned int i = 0; i < nDroplets; ++i)
+    {
+        int droplet = (int)(firstDroplet + i);
+        Vector2f pos = ToV2f(startMin) + Vector2f(startRange.x * HashRand::GetZeroToOne(Seed, droplet, 0),
+                                                  startRange.y * HashRand::GetZeroToOne(Seed, droplet, 1));
+        //Tiles that are only one cell wide along the right/bottom edges have nowhere to start droplets.
+        if (pos.x >= maxPos.x || pos.y >= maxPos.y)
+            continue;
+
+        Vector2f dir;
+        float speed = StartSpeed,
+              water = StartWater,
+              sediment = 0.0f;
+
+        for (unsigned int step = 0; step < MaxLifetime; ++step)
+        {
+            Vector2u cell((unsigned int)pos.x, (unsigned int)pos.y);
+            Vector2f cellT(pos.x - (float)cell.x, pos.y - (float)cell.y);
+
+            //Turn towards the downhill direction and move one cell.
+            Vector2f gradient;
+            float height = GetHeightAndGradient(region, pos, gradient);
+            dir = (dir * Inertia) - (gradient * (1.0f - Inertia));
+            float dirLength = dir.Length();
+            if (dirLength == 0.0f)
+                break;
+            dir /= dirLength;
+            pos += dir;
+            if (pos.x < 0.0f || pos.y < 0.0f || pos.x >= maxPos.x || pos.y >= maxPos.y)
+                break;
+
+            float newHeight = GetHeightAndGradient(region, pos, gradient),
+                  deltaHeight = newHeight - height,
+                  capacity = Mathf::Max(-deltaHeight * speed * water * SedimentCapacityFactor,
+                                        MinSedimentCapacity);
+
+            if (sediment > capacity || deltaHeight > 0.0f)
+            {
+                //Drop sediment onto the four corners of the old cell.
+                //If the droplet went uphill, try to fill in the pit it left.
+                float deposit = (deltaHeight > 0.0f) ?
+                                    Mathf::Min(deltaHeight, sediment) :
+                                    ((sediment - capacity) * DepositSpeed);
+                sediment -= deposit;
+
+                region[cell] += deposit * (1.0f - cellT.x) * (1.0f - cellT.y);
+                region[Vector2u(cell.x + 1, cell.y)] += deposit * cellT.x * (1.0f - cellT.y);
+                region[Vector2u(cell.x, cell.y + 1)] += deposit * (1.0f - cellT.x) * cellT.y;
+                region[Vector2u(cell.x + 1, cell.y + 1)] += deposit * cellT.x * cellT.y;
+            }
+            else
+            {
+                //Pick up sediment from the area around the old cell,
+                //    but never more than the height it dropped, and never from below its new height
+                //    (otherwise droplets keep digging the same pits deeper and deeper).
+                float erode = Mathf::Min((capacity - sediment) * ErodeSpeed, -deltaHeight);
+                Vector2i iCell((int)cell.x, (int)cell.y);
+                for (unsigned int j = 0; j < brush.Offsets.size(); ++j)
+                {
+                    Vector2i brushPos = iCell + brush.Offsets[j];
+                    if (brushPos.x >= 0 && brushPos.y >= 0 && brushPos.x < regionSize.x && brushPos.y < regionSize.y)
+                    {
+                        float& brushHeight = region[Vector2u((unsigned int)brushPos.x, (unsigned int)brushPos.y)];
+                        float amount = Mathf::Min(erode * brush.Weights[j],
+                                                  Mathf::Max(0.0f, brushHeight - newHeight));
+                        brushHeight -= amount;
+                        sediment += amount;
+                    }
+                }
+            }
+
+            speed = sqrtf(Mathf::Max(0.0f, (speed * speed) - (deltaHeight * Gravity)));
+            water *= (1.0f - EvaporateSpeed);
+        }
+    }
+}
+
+void HydraulicErosion::Erode(Array2D<float>& heightmap) const
+{
+    Vector2u size = heightmap.GetDimensions();
+    if (size.x < 2 || size.y < 2 || NumbDroplets == 0)
+        return;
+
+    //Every droplet stays within "MaxLifetime" cells of its start,
+    //    and it touches cells up to "ErosionRadius + 1" cells away from where it is.
+    unsigned int halo = MaxLifetime + ErosionRadius + 2,
+                 tileSize = Mathf::Max(TileSize, 2 * halo);
+    Vector2u nTiles((size.x + tileSize - 1) / tileSize,
+                    (size.y + tileSize - 1) / tileSize);
+
+    //Each tile gets a share of the droplets based on its area.
+    //Droplet indices are handed out to the tiles in order, so every droplet has the same index
+    //    (and therefore the same start position) no matter how the tiles are scheduled.
+    std::vector<unsigned int> firstDroplets(nTiles.x * nTiles.y + 1);
+    unsigned long long totalArea = (unsigned long long)size.x * (unsigned long long)size.y,
+                       areaSoFar = 0;
+    for (unsigned int i = 0; i < nTiles.x * nTiles.y; ++i)
+    {
+        Vector2u tile(i % nTiles.x, i / nTiles.x),
+                 tileMin = tile * tileSize,
+                 tileMax = Vector2u(Mathf::Min(tileMin.x + tileSize, size.x),
+                                    Mathf::Min(tileMin.y + tileSize, size.y));
+
+        firstDroplets[i] = (unsigned int)((unsigned long long)NumbDroplets * areaSoFar / totalArea);
+        areaSoFar += (unsigned long long)(tileMax.x - tileMin.x) * (unsigned long long)(tileMax.y - tileMin.y);
+    }
+    firstDroplets.back() = NumbDroplets;
+
+    Brush brush = MakeBrush();
+
+    //Do the four checkerboard passes of tiles.
+    for (unsigned int pass = 0; pass < 4; ++pass)
+    {
+        std::vector<unsigned int> passTiles;
+        for (unsigned int i = 0; i < nTiles.x * nTiles.y; ++i)
+            if ((i % nTiles.x) % 2 == pass % 2 && (i / nTiles.x) % 2 == pass / 2)
+                passTiles.push_back(i);
+
+        ThreadPool::GetGlobalPool().RunChunks(passTiles.size(), Mathf::Max(NumbThreads, (unsigned int)1),
+                                              [&](unsigned int /*chunk*/, unsigned int start, unsigned int end)
+        {
+            Array2D<float> region(1, 1);
+            for (unsigned int i = start; i < end; ++i)
+            {
+                unsigned int tileI = passTiles[i];
+                Vector2u tile(tileI % nTiles.x, tileI / nTiles.x),
+                         tileMin = tile * tileSize,
+                         tileMax = Vector2u(Mathf::Min(tileMin.x + tileSize, size.x),
+                                            Mathf::Min(tileMin.y + tileSize, size.y)),
+                         regionMin(tileMin.x - Mathf::Min(tileMin.x, halo),
+                                   tileMin.y - Mathf::Min(tileMin.y, halo)),
+                         regionMax(Mathf::Min(tileMax.x + halo, size.x),
+                                   Mathf::Min(tileMax.y + halo, size.y)),
+                         regionSize = regionMax - regionMin;
+
+                //Copy the tile and its halo out of the heightmap.
+                region.Reset(regionSize.x, regionSize.y);
+                for (unsigned int y = 0; y < regionSize.y; ++y)
+                    memcpy(&region[Vector2u(0, y)], &heightmap[Vector2u(regionMin.x, regionMin.y + y)],
+                           sizeof(float) * regionSize.x);
+
+                //Droplets need a full cell to the right/bottom of them for interpolation.
+                Vector2u startMin = tileMin - regionMin,
+                         startMax = Vector2u(Mathf::Min(tileMax.x, size.x - 1),
+                                             Mathf::Min(tileMax.y, size.y - 1)) - regionMin;
+                RunDroplets(region, brush, startMin, startMax,
+                            firstDroplets[tileI], firstDroplets[tileI + 1] - firstDroplets[tileI]);
+
+                //Copy the results back. No other tile in this pass touches this region.
+                for (unsigned int y = 0; y < regionSize.y; ++y)
+                    memcpy(&heightmap[Vector2u(regionMin.x, regionMin.y + y)], &region[Vector2u(0, y)],
+                           sizeof(float) * regionSize.x);
+            }
+        });
+    }
+}
+
+
+void ThermalErosion::Erode(Array2D<float>& heightmap) const
+{
+    int width = (int)heightmap.GetWidth(),
+        height = (int)heightmap.GetHeight(),
+        pitch = (int)heightmap.GetRowPitch();
+    unsigned int nBands = Mathf::Max(NumbThreads, (unsigned int)1);
+
+    //The heights ping-pong between the heightmap and a second array each iteration.
+    //"moveScales" is how much material each cell sends to each neighbor per unit of slope to it.
+    //Both are laid out just like the heightmap (including any row padding).
+    Array2D<float> otherHeights(heightmap.GetWidth(), heightmap.GetHeight()),
+                   moveScales(heightmap.GetWidth(), heightmap.GetHeight());
+    otherHeights.SetRowPadding(heightmap.HasRowPadding());
+    moveScales.SetRowPadding(heightmap.HasRowPadding());
+    const float* oldHeights = heightmap.GetArray();
+    float* newHeights = otherHeights.GetArray();
+
+    for (unsigned int iteration = 0; iteration < Iterations; ++iteration)
+    {
+        //First, find how much material each cell loses,
+        //    split across its neighbors in proportion to how steep the slope is to each one.
+        //Next, move the material. Each cell gathers what its higher neighbors send it,
+        //    using exactly the same slope calculation, so no material is lost or created.
+        //Cells along the edges of the heightmap have to check which neighbors exist;
+        //    the rest are done a whole SIMD pack at a time.
+        ThreadPool::GetGlobalPool().RunChunks((unsigned int)height, nBands,
+                                              [&](unsigned int /*band*/, unsigned int startY, unsigned int endY)
+        {
+            for (int y = (int)startY; y < (int)endY; ++y)
+            {
+                float* scaleRow = moveScales.GetRow((unsigned int)y);
+                if (y == 0 || y == height - 1 || width < 3)
+                {
+                    for (int x = 0; x < width; ++x)
+                        scaleRow[x] = GetMoveScale<true>(oldHeights, x, y, width, height, pitch, TalusSlope, Rate);
+                    continue;
+                }
+
+                scaleRow[0] = GetMoveScale<true>(oldHeights, 0, y, width, height, pitch, TalusSlope, Rate);
+                int x = 1;
+                for (; x + (int)SIMDFloats::Width < width; x += SIMDFloats::Width)
+                    GetMoveScales(oldHeights, x, y, pitch, TalusSlope, Rate).Store(scaleRow + x);
+                for (; x < width - 1; ++x)
+                    scaleRow[x] = GetMoveScale<false>(oldHeights, x, y, width, height, pitch, TalusSlope, Rate);
+                scaleRow[width - 1] = GetMoveScale<true>(oldHeights, width - 1, y, width, height, pitch, TalusSlope, Rate);
+            }
+        });
+        ThreadPool::GetGlobalPool().RunChunks((unsigned int)height, nBands,
+                                              [&](unsigned int /*band*/, unsigned int startY, unsigned int endY)
+        {
+            const float* scales = moveScales.GetArray();
+            for (int y = (int)startY; y < (int)endY; ++y)
+            {
+                float* outRow = newHeights + (y * pitch);
+                if (y == 0 || y == height - 1 || width < 3)
+                {
+                    for (int x = 0; x < width; ++x)
+                        outRow[x] = GetMovedHeight<true>(oldHeights, scales, x, y, width, height, pitch, TalusSlope);
+                    continue;
+                }
+
+                outRow[0] = GetMovedHeight<true>(oldHeights, scales, 0, y, width, height, pitch, TalusSlope);
+                int x = 1;
+                for (; x + (int)SIMDFloats::Width < width; x += SIMDFloats::Width)
+                    GetMovedHeights(oldHeights, scales, x, y, pitch, TalusSlope).Store(outRow + x);
+                for (; x < width - 1; ++x)
+                    outRow[x] = GetMovedHeight<false>(oldHeights, scales, x, y, width, height, pitch, TalusSlope);
+                outRow[width - 1] = GetMovedHeight<true>(oldHeights, scales, width - 1, y, width, height, pitch, TalusSlope);
+            }
+        });
+
+        float* swapTemp = newHeights;
+        newHeights = (float*)oldHeights;
+        oldHeights = swapTemp;
+    }
+
+    if (oldHeights != heightmap.GetArray())
+    {
+        for (int y = 0; y < height; ++y)
+            memcpy(heightmap.GetRow((unsigned int)y), oldHeights + (y * pitch), sizeof(float) * width);
+    }
+}
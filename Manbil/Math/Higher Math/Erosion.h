@@ -0,0 +1,105 @@
+#pragma once
+
+#include "Terrain.h"
+
+
+//Simulates rain carving a heightmap: thousands of water droplets run downhill,
+//    picking up sediment where they speed up and dropping it where they slow down.
+//Based on Hans Theobald Beyer's "Implementation of a method for hydraulic erosion".
+//The heightmap is split into square tiles. Each droplet starts in one tile and can't travel more than
+//    "MaxLifetime" cells, so each tile is simulated on its own copy of the heights around it
+//    (a "halo" wide enough to hold everything its droplets can touch) and then copied back.
+//The tiles are done in four passes, like the four colors of a 2x2 checkerboard,
+//    so the tiles in each pass are far enough apart that their halos never overlap.
+//Each droplet's start position comes from hashing "Seed" and the droplet's index,
+//    so the result is exactly the same no matter how many threads are used.
+struct HydraulicErosion
+{
+public:
+
+    //The number of droplets to simulate across the whole heightmap.
+    unsigned int NumbDroplets;
+    int Seed;
+
+    //The max number of steps (each one cell long) that a droplet travels before it's removed.
+    unsigned int MaxLifetime;
+    //The radius (in cells) of the area each droplet erodes from.
+    unsigned int ErosionRadius;
+
+    //How much a droplet keeps its old direction instead of following the slope, from 0 to 1.
+    float Inertia;
+    //Scales how much sediment a droplet can carry.
+    float SedimentCapacityFactor;
+    //Keeps droplets on flat ground from having no sediment capacity at all.
+    float MinSedimentCapacity;
+    //How quickly a droplet picks up and drops sediment, from 0 to 1.
+    float ErodeSpeed, DepositSpeed;
+    //How quickly a droplet's water evaporates each step, from 0 to 1.
+    float EvaporateSpeed;
+    float Gravity;
+    float StartSpeed, StartWater;
+
+    //The width/height of each tile, in cells.
+    //If this is smaller than twice the halo ("MaxLifetime + ErosionRadius + 2"), twice the halo is used instead.
+    unsigned int TileSize;
+    //The number of threads each pass of tiles is split across.
+    unsigned int NumbThreads;
+
+
+    HydraulicErosion(unsigned int nDroplets, int seed = 12345)
+        : NumbDroplets(nDroplets), Seed(seed), MaxLifetime(30), ErosionRadius(3),
+          Inertia(0.05f), SedimentCapacityFactor(4.0f), MinSedimentCapacity(0.01f),
+          ErodeSpeed(0.3f), DepositSpeed(0.3f), EvaporateSpeed(0.01f), Gravity(4.0f),
+          StartSpeed(1.0f), StartWater(1.0f), TileSize(128), NumbThreads(1) { }
+
+
+    void Erode(Array2D<float>& heightmap) const;
+    void Erode(Terrain& terrain) const { Erode(terrain.GetHeightmap()); }
+
+
+private:
+
+    //The cells a droplet erodes from, relative to its cell, and their weights (which add up to 1).
+    struct Brush
+    {
+        std::vector<Vector2i> Offsets;
+        std::vector<float> Weights;
+    };
+
+    Brush MakeBrush(void) const;
+    //Runs the given number of droplets, starting at the given global droplet index,
+    //    over the given region of heights. The droplets start inside the given area of the region.
+    void RunDroplets(Array2D<float>& region, const Brush& brush, Vector2u startMin, Vector2u startMax,
+                     unsigned int firstDroplet, unsigned int nDroplets) const;
+};
+
+
+//Simulates material sliding down slopes that are too steep, like loose rock crumbling off a cliff.
+//Each iteration moves material from every cell to its lower neighbors (in all 8 directions)
+//    if the slope to them is steeper than "TalusSlope".
+//Every cell's new height is computed only from the previous iteration's heights,
+//    so the rows are split into bands that run in parallel,
+//    with each band reading a one-row halo from the bands next to it.
+//The result is exactly the same no matter how many threads are used.
+struct ThermalErosion
+{
+public:
+
+    unsigned int Iterations;
+    //The steepest slope (height difference per cell) that material can rest on.
+    float TalusSlope;
+    //How much of the excess material moves each iteration, from 0 to 1.
+    //Values above 0.5 can make material slide back and forth.
+    float Rate;
+
+    //The number of bands the rows are split into.
+    unsigned int NumbThreads;
+
+
+    ThermalErosion(unsigned int iterations, float talusSlope)
+        : Iterations(iterations), TalusSlope(talusSlope), Rate(0.5f), NumbThreads(1) { }
+
+
+    void Erode(Array2D<float>& heightmap) const;
+    void Erode(Terrain& terrain) const { Erode(terrain.GetHeightmap()); }
+};
@@ -37,7 +37,31 @@ unsigned int Terrain::GetNIndices(Vector2u regionSize, unsigned int zoomOut)
 void Terrain::SetHeightmap(const Array2D<float> & copy)
 {
     heightmap.Reset(copy.GetWidth(), copy.GetHeight());
-    heightmap.Fill(copy.GetArray(), true);
+
+    //The given heightmap's rows may be padded, so copy one row at a time.
+    for (unsigned int y = 0; y < copy.GetHeight(); ++y)
+        memcpy(heightmap.GetRow(y), copy.GetRow(y), sizeof(float) * copy.GetWidth());
+}
+
+float Terrain::GetHeightAt(Vector2f pos) const
+{
+    pos = pos.Clamp(Vector2f(0.0f, 0.0f),
+                    Vector2f((float)(GetWidth() - 1), (float)(GetHeight() - 1)));
+
+    //Use the cell whose min corner is at or before the position,
+    //    except on the far edges, where the position is at the max corner of the last cell.
+    unsigned int x0 = Mathf::Min((unsigned int)pos.x, Mathf::Max(GetWidth(), (unsigned int)2) - 2),
+                 y0 = Mathf::Min((unsigned int)pos.y, Mathf::Max(GetHeight(), (unsigned int)2) - 2),
+                 x1 = Mathf::Min(x0 + 1, GetWidth() - 1),
+                 y1 = Mathf::Min(y0 + 1, GetHeight() - 1);
+    float tX = pos.x - (float)x0,
+          tY = pos.y - (float)y0;
+
+    const float *row0 = heightmap.GetRow(y0),
+                *row1 = heightmap.GetRow(y1);
+    float top = row0[x0] + (tX * (row0[x1] - row0[x0])),
+          bottom = row1[x0] + (tX * (row1[x1] - row1[x0]));
+    return top + (tY * (bottom - top));
 }
 
 float Terrain::Interp(Vector2f p) const
@@ -2,6 +2,7 @@
 
 #include <vector>
 #include "../LowerMath.hpp"
+#include "../../ThreadPool.h"
 
 
 //Represents a rectangular terrain with a heightmap of floats.
@@ -30,12 +31,17 @@ public:
 
 	float operator[](Vector2f p) const { return Interp(p); }
 
+    //Gets the bilinearly-interpolated height at the given heightmap position.
+    //Positions outside the heightmap are clamped to its edges.
+    float GetHeightAt(Vector2f pos) const;
+
 
     unsigned int GetWidth(void) const { return heightmap.GetWidth(); }
     unsigned int GetHeight(void) const { return heightmap.GetHeight(); }
 
 
     const Array2D<float>& GetHeightmap(void) const { return heightmap; }
+    Array2D<float>& GetHeightmap(void) { return heightmap; }
 	void SetHeightmap(const Array2D<float>& copy);
 
 
@@ -252,6 +258,95 @@ public:
                           Vector2u(), Vector2u(GetWidth() - 1, GetHeight() - 1), heightScale, zoomOut);
     }
 
+    //A function with signature "void WriteVertex(VertexType& outVert, Vector3f pos, Vector2f uv, Vector3f normal)".
+    template<typename VertexType, typename Func>
+    //Generates vertices and indices for some rectangular subset of this terrain
+    //    straight into the given arrays, without allocating anything.
+    //The vertex array must have room for "GetNVertices(regionSize, zoomOut)" (x times y) vertices,
+    //    and the index array must have room for "GetNIndices(regionSize, zoomOut)" indices,
+    //    where "regionSize" is "bottomRight - topLeft + {1, 1}".
+    //Pass 0 for the index array to only output vertices
+    //    (e.x. when using shared indices from a "TerrainIndexCache").
+    //The rows of vertices are split across the given number of threads.
+    //Unlike the other version, every LOD level puts its vertices at the terrain positions they came from,
+    //    UVs always go from 0 to 1 across the whole terrain, and each normal comes from the slope
+    //    between the vertex's neighbors at that LOD level (which can be outside the region),
+    //    so neighboring regions line up exactly.
+    void GenerateTriangles(VertexType* outVerts, unsigned int* outIndices, Func writeVertex,
+                           Vector2u topLeft, Vector2u bottomRight,
+                           float heightScale = 1.0f, unsigned int zoomOut = 0, unsigned int nThreads = 1) const
+    {
+        assert(topLeft.x <= bottomRight.x && topLeft.y <= bottomRight.y);
+        assert(bottomRight.x < GetWidth() && bottomRight.y < GetHeight());
+
+        Vector2u nVerts = GetNVertices(bottomRight - topLeft + Vector2u(1, 1), zoomOut);
+        assert(nVerts.x > 1 && nVerts.y > 1);
+
+        unsigned int step = 1 << zoomOut;
+
+        ThreadPool::GetGlobalPool().RunChunks(nVerts.y, Mathf::Max(nThreads, (unsigned int)1),
+                                              [&](unsigned int chunk, unsigned int startRow, unsigned int endRow)
+        {
+            for (unsigned int row = startRow; row < endRow; ++row)
+            {
+                WriteVertexRow(outVerts + (row * nVerts.x), writeVertex,
+                               topLeft.y + (row * step), topLeft.x, nVerts.x, step, heightScale);
+
+                //Output the two triangles for each cell between this row and the previous one.
+                if (row == 0 || outIndices == 0)
+                    continue;
+                unsigned int* indices = outIndices + (6 * (nVerts.x - 1) * (row - 1));
+                for (unsigned int col = 1; col < nVerts.x; ++col)
+                {
+                    unsigned int vertIndex = col + (row * nVerts.x);
+
+                    indices[0] = vertIndex;
+                    indices[1] = vertIndex - 1 - nVerts.x;
+                    indices[2] = vertIndex - 1;
+
+                    indices[3] = vertIndex;
+                    indices[4] = vertIndex - nVerts.x;
+                    indices[5] = vertIndex - 1 - nVerts.x;
+
+                    indices += 6;
+                }
+            }
+        });
+    }
+    //A function with signature "void WriteVertex(VertexType& outVert, Vector3f pos, Vector2f uv, Vector3f normal)".
+    template<typename VertexType, typename Func>
+    //Generates vertices and indices for this whole terrain straight into the given arrays.
+    //See the other version of "GenerateTriangles" that takes arrays for more info.
+    void GenerateTrianglesFull(VertexType* outVerts, unsigned int* outIndices, Func writeVertex,
+                               float heightScale = 1.0f, unsigned int zoomOut = 0, unsigned int nThreads = 1) const
+    {
+        GenerateTriangles(outVerts, outIndices, writeVertex,
+                          Vector2u(), Vector2u(GetWidth() - 1, GetHeight() - 1), heightScale, zoomOut, nThreads);
+    }
+
+    //A function with signature "void WriteVertex(VertexType& outVert, Vector3f pos, Vector2f uv, Vector3f normal)".
+    template<typename VertexType, typename Func>
+    //Re-generates the vertices in the given region (inclusive) of an array holding every vertex
+    //    of this terrain at full detail, as output by the array version of "GenerateTrianglesFull".
+    //Used to update a mesh after some heights changed. Each normal depends on the heights
+    //    next to it, so the region should reach one vertex past the changed heights.
+    void GenerateVertices(VertexType* terrainVerts, Func writeVertex, Vector2u topLeft, Vector2u bottomRight,
+                          float heightScale = 1.0f, unsigned int nThreads = 1) const
+    {
+        assert(topLeft.x <= bottomRight.x && topLeft.y <= bottomRight.y);
+        assert(bottomRight.x < GetWidth() && bottomRight.y < GetHeight());
+
+        ThreadPool::GetGlobalPool().RunChunks(bottomRight.y - topLeft.y + 1, Mathf::Max(nThreads, (unsigned int)1),
+                                              [&](unsigned int chunk, unsigned int startRow, unsigned int endRow)
+        {
+            for (unsigned int y = topLeft.y + startRow; y < topLeft.y + endRow; ++y)
+            {
+                WriteVertexRow(terrainVerts + (y * GetWidth()) + topLeft.x, writeVertex,
+                               y, topLeft.x, bottomRight.x - topLeft.x + 1, 1, heightScale);
+            }
+        });
+    }
+
 
 private:
 
@@ -259,4 +354,38 @@ private:
 
 	//Gets the height at the given fractional position using interpolation.
 	float Interp(Vector2f pos) const;
+
+    //A function with signature "void WriteVertex(VertexType& outVert, Vector3f pos, Vector2f uv, Vector3f normal)".
+    template<typename VertexType, typename Func>
+    //Writes the given number of vertices along the given row of heights,
+    //    starting at "firstX" and moving "step" heights between each one.
+    //Each normal comes from the slope between the vertex's neighbors "step" heights away.
+    void WriteVertexRow(VertexType* outVerts, Func& writeVertex, unsigned int y, unsigned int firstX,
+                        unsigned int nVerts, unsigned int step, float heightScale) const
+    {
+        Vector2f texCoordIncrement(1.0f / (float)GetWidth(),
+                                   1.0f / (float)GetHeight());
+
+        unsigned int lessY = (y < step ? 0 : y - step),
+                     moreY = Mathf::Min(y + step, GetHeight() - 1);
+        const float *heights = heightmap.GetRow(y),
+                    *lessYHeights = heightmap.GetRow(lessY),
+                    *moreYHeights = heightmap.GetRow(moreY);
+        float slopeScaleY = heightScale / (float)(moreY - lessY);
+
+        for (unsigned int col = 0; col < nVerts; ++col)
+        {
+            unsigned int x = firstX + (col * step),
+                         lessX = (x < step ? 0 : x - step),
+                         moreX = Mathf::Min(x + step, GetWidth() - 1);
+
+            Vector3f normal((heights[lessX] - heights[moreX]) * heightScale / (float)(moreX - lessX),
+                            (lessYHeights[x] - moreYHeights[x]) * slopeScaleY,
+                            1.0f);
+            writeVertex(outVerts[col],
+                        Vector3f((float)x, (float)y, heightScale * heights[x]),
+                        Vector2f(texCoordIncrement.x * (float)x, texCoordIncrement.y * (float)y),
+                        normal.Normalized());
+        }
+    }
 };
\ No newline at end of file
@@ -0,0 +1,309 @@
+#include "TerrainEditor.h"
+
+
+float TerrainEditor::Brush::GetWeight(Vector2f pos) const
+{
+    float dist = pos.Distance(Center),
+          innerRadius = Hardness * Radius;
+    if (dist >= Radius)
+        return 0.0f;
+    if (dist <= innerRadius)
+        return Strength;
+
+    float t = (dist - innerRadius) / (Radius - innerRadius);
+    return Strength * (1.0f - Mathf::Smooth(t));
+}
+
+
+TerrainEditor::TerrainEditor(Terrain& _terrain)
+    : MaxUndoSteps(64), terrain(&_terrain), inStroke(false), isAutoStroke(false), currentStrokeID(0),
+      tileStrokeIDs((_terrain.GetWidth() + TileSize - 1) / TileSize,
+                    (_terrain.GetHeight() + TileSize - 1) / TileSize,
+                    0)
+{
+
+}
+
+
+void TerrainEditor::BeginStroke(void)
+{
+    assert(!inStroke);
+
+    inStroke = true;
+    currentStrokeID += 1;
+    undoStrokes.push_back(Stroke());
+}
+void TerrainEditor::EndStroke(void)
+{
+    assert(inStroke);
+    inStroke = false;
+
+    //Throw out strokes that didn't change anything, and forget the oldest strokes.
+    if (undoStrokes.back().size() == 0)
+        undoStrokes.pop_back();
+    while (undoStrokes.size() > MaxUndoSteps)
+        undoStrokes.pop_front();
+}
+
+
+void TerrainEditor::Raise(const Brush& brush, float amount)
+{
+    Region area;
+    if (!StartEdit(brush, area))
+        return;
+
+    Array2D<float>& heightmap = terrain->GetHeightmap();
+    for (unsigned int y = area.Min.y; y <= area.Max.y; ++y)
+    {
+        float* row = heightmap.GetRow(y);
+        for (unsigned int x = area.Min.x; x <= area.Max.x; ++x)
+            row[x] += amount * brush.GetWeight(Vector2f((float)x, (float)y));
+    }
+
+    EndEdit(area);
+}
+void TerrainEditor::Flatten(const Brush& brush, float height)
+{
+    Region area;
+    if (!StartEdit(brush, area))
+        return;
+
+    Array2D<float>& heightmap = terrain->GetHeightmap();
+    for (unsigned int y = area.Min.y; y <= area.Max.y; ++y)
+    {
+        float* row = heightmap.GetRow(y);
+        for (unsigned int x = area.Min.x; x <= area.Max.x; ++x)
+        {
+            float weight = Mathf::Clamp(brush.GetWeight(Vector2f((float)x, (float)y)), 0.0f, 1.0f);
+            row[x] += (height - row[x]) * weight;
+        }
+    }
+
+    EndEdit(area);
+}
+void TerrainEditor::Smooth(const Brush& brush)
+{
+    Region area;
+    if (!StartEdit(brush, area))
+        return;
+
+    //Copy the original heights (plus a border for their neighbors) so that edited heights
+    //    don't affect the ones after them.
+    Array2D<float>& heightmap = terrain->GetHeightmap();
+    Vector2u copyMin((area.Min.x == 0) ? 0 : (area.Min.x - 1),
+                     (area.Min.y == 0) ? 0 : (area.Min.y - 1)),
+             copyMax(Mathf::Min(area.Max.x + 1, heightmap.GetWidth() - 1),
+                     Mathf::Min(area.Max.y + 1, heightmap.GetHeight() - 1));
+    unsigned int copyWidth = copyMax.x - copyMin.x + 1;
+    tempHeights.resize(copyWidth * (copyMax.y - copyMin.y + 1));
+    for (unsigned int y = copyMin.y; y <= copyMax.y; ++y)
+    {
+        memcpy(&tempHeights[(y - copyMin.y) * copyWidth], heightmap.GetRow(y) + copyMin.x,
+               sizeof(float) * copyWidth);
+    }
+
+    for (unsigned int y = area.Min.y; y <= area.Max.y; ++y)
+    {
+        float* row = heightmap.GetRow(y);
+        unsigned int minY = Mathf::Max(y, (unsigned int)1) - 1,
+                     maxY = Mathf::Min(y + 1, copyMax.y);
+        for (unsigned int x = area.Min.x; x <= area.Max.x; ++x)
+        {
+            float weight = Mathf::Clamp(brush.GetWeight(Vector2f((float)x, (float)y)), 0.0f, 1.0f);
+            if (weight == 0.0f)
+                continue;
+
+            //Average the neighboring heights.
+            unsigned int minX = Mathf::Max(x, (unsigned int)1) - 1,
+                         maxX = Mathf::Min(x + 1, copyMax.x);
+            float sum = 0.0f;
+            for (unsigned int y2 = minY; y2 <= maxY; ++y2)
+            {
+                const float* copyRow = &tempHeights[(y2 - copyMin.y) * copyWidth] - copyMin.x;
+                for (unsigned int x2 = minX; x2 <= maxX; ++x2)
+                    sum += copyRow[x2];
+            }
+            float average = sum / (float)((maxX - minX + 1) * (maxY - minY + 1));
+
+            row[x] += (average - row[x]) * weight;
+        }
+    }
+
+    EndEdit(area);
+}
+void TerrainEditor::Noise(const Brush& brush, const Generator2D& noise, float amplitude)
+{
+    assert(noise.CanSample());
+
+    Region area;
+    if (!StartEdit(brush, area))
+        return;
+
+    Array2D<float>& heightmap = terrain->GetHeightmap();
+    unsigned int width = area.Max.x - area.Min.x + 1;
+    tempPositions.resize(width);
+    tempHeights.resize(width);
+    for (unsigned int y = area.Min.y; y <= area.Max.y; ++y)
+    {
+        for (unsigned int i = 0; i < width; ++i)
+            tempPositions[i] = Vector2f((float)(area.Min.x + i), (float)y);
+        noise.SampleMany(tempPositions.data(), tempHeights.data(), width);
+
+        float* row = heightmap.GetRow(y) + area.Min.x;
+        for (unsigned int i = 0; i < width; ++i)
+            row[i] += amplitude * (tempHeights[i] - 0.5f) * brush.GetWeight(tempPositions[i]);
+    }
+
+    EndEdit(area);
+}
+
+
+bool TerrainEditor::Undo(void)
+{
+    if (inStroke)
+        EndStroke();
+    if (undoStrokes.size() == 0)
+        return false;
+
+    SwapTiles(undoStrokes.back());
+    redoStrokes.push_back(std::move(undoStrokes.back()));
+    undoStrokes.pop_back();
+    return true;
+}
+bool TerrainEditor::Redo(void)
+{
+    if (inStroke)
+        EndStroke();
+    if (redoStrokes.size() == 0)
+        return false;
+
+    SwapTiles(redoStrokes.back());
+    undoStrokes.push_back(std::move(redoStrokes.back()));
+    redoStrokes.pop_back();
+    return true;
+}
+void TerrainEditor::ClearHistory(void)
+{
+    undoStrokes.clear();
+    redoStrokes.clear();
+
+    //Make sure the current stroke (if any) still saves the tiles it changes from now on.
+    if (inStroke)
+    {
+        currentStrokeID += 1;
+        undoStrokes.push_back(Stroke());
+    }
+}
+
+
+bool TerrainEditor::StartEdit(const Brush& brush, Region& outArea)
+{
+    float maxX = (float)(terrain->GetWidth() - 1),
+          maxY = (float)(terrain->GetHeight() - 1);
+    Vector2f minPos = brush.Center - Vector2f(brush.Radius, brush.Radius),
+             maxPos = brush.Center + Vector2f(brush.Radius, brush.Radius);
+    if (maxPos.x < 0.0f || maxPos.y < 0.0f || minPos.x > maxX || minPos.y > maxY)
+        return false;
+
+    outArea.Min = Vector2u((unsigned int)ceilf(Mathf::Max(minPos.x, 0.0f)),
+                           (unsigned int)ceilf(Mathf::Max(minPos.y, 0.0f)));
+    outArea.Max = Vector2u((unsigned int)floorf(Mathf::Min(maxPos.x, maxX)),
+                           (unsigned int)floorf(Mathf::Min(maxPos.y, maxY)));
+    if (outArea.Min.x > outArea.Max.x || outArea.Min.y > outArea.Max.y)
+        return false;
+
+    isAutoStroke = !inStroke;
+    if (isAutoStroke)
+        BeginStroke();
+    redoStrokes.clear();
+
+    //Save any tiles this stroke hasn't touched yet.
+    const Array2D<float>& heightmap = terrain->GetHeightmap();
+    Stroke& stroke = undoStrokes.back();
+    for (Vector2u tile(0, outArea.Min.y / TileSize); tile.y <= outArea.Max.y / TileSize; ++tile.y)
+    {
+        for (tile.x = outArea.Min.x / TileSize; tile.x <= outArea.Max.x / TileSize; ++tile.x)
+        {
+            if (tileStrokeIDs[tile] == currentStrokeID)
+                continue;
+            tileStrokeIDs[tile] = currentStrokeID;
+
+            Vector2u tileMin = tile * TileSize,
+                     tileMax(Mathf::Min(tileMin.x + TileSize, heightmap.GetWidth()),
+                             Mathf::Min(tileMin.y + TileSize, heightmap.GetHeight()));
+            unsigned int tileWidth = tileMax.x - tileMin.x;
+
+            stroke.push_back(SavedTile());
+            SavedTile& saved = stroke.back();
+            saved.Tile = tile;
+            saved.Heights.resize(tileWidth * (tileMax.y - tileMin.y));
+            for (unsigned int y = tileMin.y; y < tileMax.y; ++y)
+            {
+                memcpy(&saved.Heights[(y - tileMin.y) * tileWidth], heightmap.GetRow(y) + tileMin.x,
+                       sizeof(float) * tileWidth);
+            }
+        }
+    }
+
+    return true;
+}
+void TerrainEditor::EndEdit(Region area)
+{
+    AddDirtyRegion(area);
+    if (isAutoStroke)
+    {
+        EndStroke();
+        isAutoStroke = false;
+    }
+}
+
+void TerrainEditor::AddDirtyRegion(Region heightsArea)
+{
+    //The normals of the vertices next to the changed heights change too.
+    Region region(Vector2u((heightsArea.Min.x == 0) ? 0 : (heightsArea.Min.x - 1),
+                           (heightsArea.Min.y == 0) ? 0 : (heightsArea.Min.y - 1)),
+                  Vector2u(Mathf::Min(heightsArea.Max.x + 1, terrain->GetWidth() - 1),
+                           Mathf::Min(heightsArea.Max.y + 1, terrain->GetHeight() - 1)));
+
+    //If combining this region with an existing one doesn't cover much more area than the two of them,
+    //    combine them.
+    for (unsigned int i = 0; i < dirtyRegions.size(); ++i)
+    {
+        Region& other = dirtyRegions[i];
+        Region combined(Vector2u(Mathf::Min(region.Min.x, other.Min.x), Mathf::Min(region.Min.y, other.Min.y)),
+                        Vector2u(Mathf::Max(region.Max.x, other.Max.x), Mathf::Max(region.Max.y, other.Max.y)));
+        if (combined.GetArea() <= region.GetArea() + other.GetArea())
+        {
+            other = combined;
+            return;
+        }
+    }
+
+    dirtyRegions.push_back(region);
+}
+void TerrainEditor::SwapTiles(Stroke& tiles)
+{
+    Array2D<float>& heightmap = terrain->GetHeightmap();
+    for (unsigned int i = 0; i < tiles.size(); ++i)
+    {
+        SavedTile& saved = tiles[i];
+        Vector2u tileMin = saved.Tile * TileSize,
+                 tileMax(Mathf::Min(tileMin.x + TileSize, heightmap.GetWidth()),
+                         Mathf::Min(tileMin.y + TileSize, heightmap.GetHeight()));
+        unsigned int tileWidth = tileMax.x - tileMin.x;
+
+        for (unsigned int y = tileMin.y; y < tileMax.y; ++y)
+        {
+            float* row = heightmap.GetRow(y) + tileMin.x;
+            float* savedRow = &saved.Heights[(y - tileMin.y) * tileWidth];
+            for (unsigned int x = 0; x < tileWidth; ++x)
+            {
+                float temp = row[x];
+                row[x] = savedRow[x];
+                savedRow[x] = temp;
+            }
+        }
+
+        AddDirtyRegion(Region(tileMin, tileMax - Vector2u(1, 1)));
+    }
+}
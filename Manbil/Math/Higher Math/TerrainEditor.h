@@ -0,0 +1,141 @@
+#pragma once
+
+#include <deque>
+#include "Terrain.h"
+#include "../Noise Generation/BasicGenerators.h"
+
+
+//Brush-style editing of a Terrain's heights, with undo/redo and tracking of which areas changed.
+//Every edit records the rectangle of vertices it affected (the changed heights plus a one-vertex border,
+//    since the normals next to a changed height change too), so that only those vertices
+//    have to be re-generated ("Terrain::GenerateVertices") and re-uploaded ("Mesh::SetVertexSubData", one row at a time).
+//Any "TerrainHeightPyramid" for the terrain can be updated with its partial "Rebuild" on the same rectangles.
+//Edits are grouped into strokes. The first time a stroke touches a tile of the heightmap,
+//    the tile's original heights are saved, so undoing a stroke only has to swap those tiles back in.
+class TerrainEditor
+{
+public:
+
+    //The area an edit affects.
+    struct Brush
+    {
+        //The center of the brush, in heightmap coordinates.
+        Vector2f Center;
+        //The radius of the brush, in heightmap cells.
+        float Radius;
+        //The fraction of the radius in which the brush has its full effect.
+        //Outside of it, the effect smoothly falls off to nothing at the edge of the brush.
+        float Hardness;
+        //The effect of the brush at its full strength. Usually between 0 and 1.
+        float Strength;
+
+        Brush(Vector2f center, float radius, float hardness = 0.5f, float strength = 1.0f)
+            : Center(center), Radius(radius), Hardness(hardness), Strength(strength) { }
+
+        //Gets how much effect this brush has on the height at the given position.
+        float GetWeight(Vector2f pos) const;
+    };
+
+    //A rectangle of vertices in the heightmap (inclusive).
+    struct Region
+    {
+        Vector2u Min, Max;
+
+        Region(void) { }
+        Region(Vector2u min, Vector2u max) : Min(min), Max(max) { }
+
+        unsigned int GetArea(void) const { return (Max.x - Min.x + 1) * (Max.y - Min.y + 1); }
+    };
+
+
+    //The size of each tile of heights saved for undoing a stroke.
+    static const unsigned int TileSize = 32;
+
+
+    //The maximum number of strokes that can be undone. Older strokes are forgotten.
+    unsigned int MaxUndoSteps;
+
+
+    //The terrain must stay alive for as long as this editor uses it.
+    TerrainEditor(Terrain& terrain);
+
+
+    const Terrain& GetTerrain(void) const { return *terrain; }
+
+
+    //Starts a new stroke. Every edit until "EndStroke" is called is undone/redone together.
+    //Edits made outside of a stroke are each their own stroke.
+    void BeginStroke(void);
+    //Ends the current stroke.
+    void EndStroke(void);
+    bool IsInStroke(void) const { return inStroke; }
+
+
+    //Adds the given amount to the heights under the brush. Negative amounts lower the terrain.
+    void Raise(const Brush& brush, float amount);
+    //Moves the heights under the brush towards the given height.
+    void Flatten(const Brush& brush, float height);
+    //Moves the heights under the brush towards the average of their neighbors.
+    void Smooth(const Brush& brush);
+    //Adds the given noise to the heights under the brush. The noise is sampled at each height's position,
+    //    so the noise generator must be able to "Sample".
+    //Noise values are in the range [0, 1], so 0.5 is subtracted from them first
+    //    so that the stamp raises and lowers the terrain by about the same amount.
+    void Noise(const Brush& brush, const Generator2D& noise, float amplitude);
+
+
+    unsigned int GetNUndoSteps(void) const { return (unsigned int)undoStrokes.size(); }
+    unsigned int GetNRedoSteps(void) const { return (unsigned int)redoStrokes.size(); }
+
+    //Undoes the most recent stroke. Returns whether there was anything to undo.
+    bool Undo(void);
+    //Redoes the most recently-undone stroke. Returns whether there was anything to redo.
+    //Any new stroke clears the strokes that can be redone.
+    bool Redo(void);
+    //Forgets every stroke that could be undone or redone.
+    void ClearHistory(void);
+
+
+    //Gets the rectangles of vertices that were affected by edits since the last call to "ClearDirtyRegions".
+    //Rectangles that mostly overlap are merged together.
+    const std::vector<Region>& GetDirtyRegions(void) const { return dirtyRegions; }
+    void ClearDirtyRegions(void) { dirtyRegions.clear(); }
+
+
+private:
+
+    //The original heights of one tile touched by a stroke.
+    struct SavedTile
+    {
+        Vector2u Tile;
+        std::vector<float> Heights;
+    };
+    typedef std::vector<SavedTile> Stroke;
+
+
+    Terrain* terrain;
+
+    bool inStroke, isAutoStroke;
+    unsigned int currentStrokeID;
+    //The ID of the last stroke that saved each tile.
+    Array2D<unsigned int> tileStrokeIDs;
+
+    std::deque<Stroke> undoStrokes, redoStrokes;
+    std::vector<Region> dirtyRegions;
+
+    //Scratch space for edits, kept around to avoid allocating every time.
+    std::vector<float> tempHeights;
+    std::vector<Vector2f> tempPositions;
+
+
+    //Gets the rectangle of heights under the given brush, and saves them for undoing.
+    //Returns false if the brush doesn't touch the terrain.
+    bool StartEdit(const Brush& brush, Region& outArea);
+    //Finishes an edit of the given area.
+    void EndEdit(Region area);
+
+    //Records that the given rectangle of heights changed.
+    void AddDirtyRegion(Region heightsArea);
+    //Swaps the heights in the given tiles with the terrain's heights.
+    void SwapTiles(Stroke& tiles);
+};
@@ -0,0 +1,329 @@
+#include "TerrainHeightPyramid.h"
+
+#include "../../ThreadPool.h"
+#include <limits>
+
+
+namespace
+{
+    //Gets the cell along one axis that contains the given coordinate.
+    //If the coordinate is right on the border between two cells, picks the one the ray is moving into.
+    int GetCellCoord(float pos, float dir)
+    {
+        return (dir < 0.0f) ? ((int)ceilf(pos) - 1) : (int)floorf(pos);
+    }
+}
+
+
+TerrainHeightPyramid::TerrainHeightPyramid(const Terrain& _terrain, unsigned int nThreads)
+    : terrain(&_terrain)
+{
+    assert(terrain->GetWidth() > 1 && terrain->GetHeight() > 1);
+
+    //Keep adding levels until one node covers every cell.
+    Vector2u nCells(terrain->GetWidth() - 1, terrain->GetHeight() - 1);
+    unsigned int nodeSize = 2;
+    do
+    {
+        levels.push_back(Array2D<MinMax>((nCells.x + nodeSize - 1) / nodeSize,
+                                         (nCells.y + nodeSize - 1) / nodeSize));
+        nodeSize *= 2;
+    } while (levels.back().GetWidth() > 1 || levels.back().GetHeight() > 1);
+
+    Rebuild(nThreads);
+}
+
+void TerrainHeightPyramid::ComputeNode(unsigned int level, Vector2u node)
+{
+    MinMax bounds;
+    bounds.Min = std::numeric_limits<float>::max();
+    bounds.Max = -std::numeric_limits<float>::max();
+
+    if (level == 0)
+    {
+        //Look at the heights around the node's 2x2 cells.
+        const Array2D<float>& heightmap = terrain->GetHeightmap();
+        unsigned int maxX = Mathf::Min((node.x * 2) + 2, heightmap.GetWidth() - 1),
+                     maxY = Mathf::Min((node.y * 2) + 2, heightmap.GetHeight() - 1);
+        for (unsigned int y = node.y * 2; y <= maxY; ++y)
+        {
+            const float* row = heightmap.GetRow(y);
+            for (unsigned int x = node.x * 2; x <= maxX; ++x)
+            {
+                bounds.Min = Mathf::Min(bounds.Min, row[x]);
+                bounds.Max = Mathf::Max(bounds.Max, row[x]);
+            }
+        }
+    }
+    else
+    {
+        //Combine the children.
+        const Array2D<MinMax>& children = levels[level - 1];
+        for (unsigned int i = 0; i < 4; ++i)
+        {
+            Vector2u child((node.x * 2) + (i % 2), (node.y * 2) + (i / 2));
+            if (child.x < children.GetWidth() && child.y < children.GetHeight())
+            {
+                const MinMax& childBounds = children[child];
+                bounds.Min = Mathf::Min(bounds.Min, childBounds.Min);
+                bounds.Max = Mathf::Max(bounds.Max, childBounds.Max);
+            }
+        }
+    }
+
+    levels[level][node] = bounds;
+}
+
+void TerrainHeightPyramid::Rebuild(unsigned int nThreads)
+{
+    for (unsigned int level = 0; level < levels.size(); ++level)
+    {
+        Array2D<MinMax>& nodes = levels[level];
+        ThreadPool::GetGlobalPool().RunChunks(nodes.GetHeight(), Mathf::Max(nThreads, (unsigned int)1),
+                                              [&](unsigned int chunk, unsigned int startY, unsigned int endY)
+        {
+            for (Vector2u node(0, startY); node.y < endY; ++node.y)
+                for (node.x = 0; node.x < nodes.GetWidth(); ++node.x)
+                    ComputeNode(level, node);
+        });
+    }
+}
+void TerrainHeightPyramid::Rebuild(Vector2u minPos, Vector2u maxPos)
+{
+    //Each height touches the cells on either side of it.
+    Vector2u minCell((minPos.x == 0) ? 0 : (minPos.x - 1),
+                     (minPos.y == 0) ? 0 : (minPos.y - 1)),
+             maxCell(Mathf::Min(maxPos.x, terrain->GetWidth() - 2),
+                     Mathf::Min(maxPos.y, terrain->GetHeight() - 2));
+
+    for (unsigned int level = 0; level < levels.size(); ++level)
+    {
+        unsigned int shift = level + 1;
+        for (Vector2u node(0, minCell.y >> shift); node.y <= (maxCell.y >> shift); ++node.y)
+            for (node.x = (minCell.x >> shift); node.x <= (maxCell.x >> shift); ++node.x)
+                ComputeNode(level, node);
+    }
+}
+
+
+bool TerrainHeightPyramid::CastRay(Vector3f start, Vector3f dir, float maxDist, float& outDist) const
+{
+    float lastX = (float)(terrain->GetWidth() - 1),
+          lastY = (float)(terrain->GetHeight() - 1);
+
+    //Rays that go straight up or down only touch one spot.
+    float lengthXY = sqrtf((dir.x * dir.x) + (dir.y * dir.y));
+    if (lengthXY <= 0.000001f * dir.Length() || lengthXY == 0.0f)
+    {
+        if (start.x < 0.0f || start.y < 0.0f || start.x > lastX || start.y > lastY)
+            return false;
+
+        float height = GetHeightAt(Vector2f(start.x, start.y));
+        if (start.z <= height)
+        {
+            outDist = 0.0f;
+            return true;
+        }
+        if (dir.z < 0.0f && (height - start.z) / dir.z <= maxDist)
+        {
+            outDist = (height - start.z) / dir.z;
+            return true;
+        }
+        return false;
+    }
+
+    //March along the ray using distances in the XY plane, which makes it easy to find node borders.
+    Vector3f d = dir / lengthXY;
+    float invDX = (d.x == 0.0f) ? 0.0f : (1.0f / d.x),
+          invDY = (d.y == 0.0f) ? 0.0f : (1.0f / d.y);
+
+    //Clip the ray to the terrain's area.
+    float s = 0.0f,
+          sEnd = maxDist * lengthXY;
+    if (d.x == 0.0f)
+    {
+        if (start.x < 0.0f || start.x > lastX)
+            return false;
+    }
+    else
+    {
+        float s1 = -start.x * invDX,
+              s2 = (lastX - start.x) * invDX;
+        s = Mathf::Max(s, Mathf::Min(s1, s2));
+        sEnd = Mathf::Min(sEnd, Mathf::Max(s1, s2));
+    }
+    if (d.y == 0.0f)
+    {
+        if (start.y < 0.0f || start.y > lastY)
+            return false;
+    }
+    else
+    {
+        float s1 = -start.y * invDY,
+              s2 = (lastY - start.y) * invDY;
+        s = Mathf::Max(s, Mathf::Min(s1, s2));
+        sEnd = Mathf::Min(sEnd, Mathf::Max(s1, s2));
+    }
+    if (s > sEnd)
+        return false;
+
+
+    int maxCellX = (int)terrain->GetWidth() - 2,
+        maxCellY = (int)terrain->GetHeight() - 2;
+
+    //The cell the ray is currently in.
+    //It's only computed from the ray's position along the axes the ray didn't just cross a border on,
+    //    so that rounding error can't put it back in the cell it just left.
+    Vector3f pos = start + (d * s);
+    Vector2i cell(Mathf::Clamp(GetCellCoord(pos.x, d.x), 0, maxCellX),
+                  Mathf::Clamp(GetCellCoord(pos.y, d.y), 0, maxCellY));
+
+    //Level "n" uses the nodes in "levels[n - 1]"; level 0 is the individual cells.
+    //Start with nodes about as big as the ray is long, since anything bigger can't skip any more of it.
+    unsigned int maxLevel = 0;
+    while (maxLevel < GetNLevels() && (float)(1 << maxLevel) < (sEnd - s))
+        maxLevel += 1;
+    unsigned int level = maxLevel;
+    while (true)
+    {
+        //Find the node's area and where the ray leaves it.
+        Vector2i node(cell.x >> level, cell.y >> level);
+        int minX = node.x << level,
+            minY = node.y << level,
+            maxX = Mathf::Min(minX + (1 << level), maxCellX + 1),
+            maxY = Mathf::Min(minY + (1 << level), maxCellY + 1);
+
+        float sX = (d.x > 0.0f) ? (((float)maxX - start.x) * invDX) :
+                       ((d.x < 0.0f) ? (((float)minX - start.x) * invDX) : std::numeric_limits<float>::max()),
+              sY = (d.y > 0.0f) ? (((float)maxY - start.y) * invDY) :
+                       ((d.y < 0.0f) ? (((float)minY - start.y) * invDY) : std::numeric_limits<float>::max());
+        float sExit = Mathf::Max(s, Mathf::Min(sEnd, Mathf::Min(sX, sY)));
+
+        if (level > 0)
+        {
+            //If the ray is entirely above the node's heights, skip the node.
+            //If it enters the node below all of them, it's already inside the terrain.
+            //Otherwise, look at the smaller nodes inside it.
+            const MinMax& bounds = levels[level - 1][Vector2u((unsigned int)node.x, (unsigned int)node.y)];
+            float zEnter = start.z + (d.z * s),
+                  zExit = start.z + (d.z * sExit);
+            if (zEnter < bounds.Min)
+            {
+                outDist = s / lengthXY;
+                return true;
+            }
+            if (Mathf::Min(zEnter, zExit) <= bounds.Max)
+            {
+                level -= 1;
+                continue;
+            }
+        }
+        else
+        {
+            float hitS;
+            if (CastRayInCell(start, d, Vector2u((unsigned int)cell.x, (unsigned int)cell.y), s, sExit, hitS))
+            {
+                outDist = hitS / lengthXY;
+                return true;
+            }
+        }
+
+        //Move on to the next node.
+        if (sExit >= sEnd)
+            return false;
+
+        pos = start + (d * sExit);
+        Vector2i lastCell = cell;
+        cell.x = (sX <= sExit) ?
+                     ((d.x > 0.0f) ? maxX : (minX - 1)) :
+                     Mathf::Clamp(GetCellCoord(pos.x, d.x), minX, maxX - 1);
+        cell.y = (sY <= sExit) ?
+                     ((d.y > 0.0f) ? maxY : (minY - 1)) :
+                     Mathf::Clamp(GetCellCoord(pos.y, d.y), minY, maxY - 1);
+        if (cell.x < 0 || cell.y < 0 || cell.x > maxCellX || cell.y > maxCellY)
+            return false;
+
+        s = sExit;
+
+        //Move up to the biggest node the ray just entered.
+        //The nodes it's still inside were already found to overlap it, so there's no point testing them again.
+        while (level < maxLevel &&
+               ((cell.x >> (level + 1)) != (lastCell.x >> (level + 1)) ||
+                (cell.y >> (level + 1)) != (lastCell.y >> (level + 1))))
+        {
+            level += 1;
+        }
+    }
+}
+bool TerrainHeightPyramid::CastRayInCell(Vector3f start, Vector3f dir, Vector2u cell, float minDist, float maxDist,
+                                         float& outDist) const
+{
+    const Array2D<float>& heightmap = terrain->GetHeightmap();
+    const float *row0 = heightmap.GetRow(cell.y),
+                *row1 = heightmap.GetRow(cell.y + 1);
+    float h00 = row0[cell.x], h10 = row0[cell.x + 1],
+          h01 = row1[cell.x], h11 = row1[cell.x + 1];
+
+    //The bilinear surface is "h00 + (hX * u) + (hY * v) + (hXY * u * v)",
+    //    where {u, v} is the position relative to the cell's min corner.
+    float hX = h10 - h00,
+          hY = h01 - h00,
+          hXY = h00 - h10 - h01 + h11;
+
+    //The height of the ray above the surface, starting from "minDist", is "a*t^2 + b*t + c".
+    Vector3f pos = start + (dir * minDist);
+    float u = pos.x - (float)cell.x,
+          v = pos.y - (float)cell.y;
+    float c = pos.z - (h00 + (hX * u) + (hY * v) + (hXY * u * v)),
+          b = dir.z - ((hX * dir.x) + (hY * dir.y) + (hXY * ((u * dir.y) + (v * dir.x)))),
+          a = -hXY * dir.x * dir.y;
+    float length = maxDist - minDist;
+
+    if (c <= 0.0f)
+    {
+        outDist = minDist;
+        return true;
+    }
+
+    //Find the first time the ray's height above the surface reaches 0.
+    float t = -1.0f;
+    if (Mathf::Abs(a) < 0.0000001f)
+    {
+        if (b < 0.0f)
+            t = -c / b;
+    }
+    else
+    {
+        float discriminant = (b * b) - (4.0f * a * c);
+        if (discriminant >= 0.0f)
+        {
+            //Use the numerically-stable form of the quadratic formula.
+            float sqrtD = sqrtf(discriminant),
+                  q = -0.5f * (b + ((b < 0.0f) ? -sqrtD : sqrtD));
+            float t1 = q / a,
+                  t2 = (q == 0.0f) ? t1 : (c / q);
+            if (t1 > t2)
+            {
+                float temp = t1;
+                t1 = t2;
+                t2 = temp;
+            }
+            t = (t1 >= 0.0f) ? t1 : t2;
+        }
+    }
+
+    if (t >= 0.0f && t <= length)
+    {
+        outDist = minDist + t;
+        return true;
+    }
+
+    //Catch any roots lost to rounding error.
+    if ((a * length * length) + (b * length) + c <= 0.0f)
+    {
+        outDist = maxDist;
+        return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "Terrain.h"
+
+
+//A mip pyramid of the min and max heights over a Terrain, for fast raycasts and line-of-sight checks.
+//Each level halves the resolution of the one before it, so each node covers a square of 2^n grid cells
+//    (where a cell is the square between four neighboring heights), until one node covers the whole terrain.
+//A ray is marched from node to node, starting with the biggest ones; nodes whose heights the ray passes
+//    completely above or below are skipped entirely, and only the cells it might touch are tested exactly.
+//The terrain surface is treated as bilinear inside each cell, matching "Terrain::GetHeightAt".
+//Rays and heights are in heightmap units: X and Y are grid coordinates, and Z is the unscaled height.
+class TerrainHeightPyramid
+{
+public:
+
+    //Builds the pyramid for the given terrain, splitting the work across the given number of threads.
+    //The terrain must stay alive for as long as this pyramid uses it.
+    TerrainHeightPyramid(const Terrain& terrain, unsigned int nThreads = 1);
+
+
+    const Terrain& GetTerrain(void) const { return *terrain; }
+
+    //Gets the number of levels above the individual cells.
+    unsigned int GetNLevels(void) const { return (unsigned int)levels.size(); }
+
+    //Updates the min/max heights after the terrain's heights were changed.
+    void Rebuild(unsigned int nThreads = 1);
+    //Updates the min/max heights after the terrain's heights were changed inside the given area (inclusive).
+    void Rebuild(Vector2u minPos, Vector2u maxPos);
+
+
+    //Gets the bilinearly-interpolated height at the given position, clamped to the terrain's edges.
+    float GetHeightAt(Vector2f pos) const { return terrain->GetHeightAt(pos); }
+
+    //Finds the first place the given ray hits the terrain, within the given distance along the ray
+    //    (measured in multiples of "dir", which doesn't have to be normalized).
+    //If the ray starts below the terrain, it hits immediately.
+    //Returns whether it hit anything, and if so, outputs the distance along the ray to the hit.
+    //The terrain only exists inside its heightmap; a ray passing outside of it won't hit anything there.
+    bool CastRay(Vector3f start, Vector3f dir, float maxDist, float& outDist) const;
+    //Finds whether the straight line between the two given points is free of terrain.
+    bool HasLineOfSight(Vector3f from, Vector3f to) const
+    {
+        float dist;
+        return !CastRay(from, to - from, 1.0f, dist);
+    }
+
+
+private:
+
+    struct MinMax
+    {
+        float Min, Max;
+    };
+
+
+    const Terrain* terrain;
+    //The min/max heights for nodes at each level. The nodes in "levels[i]" cover 2^(i + 1) cells on each side.
+    std::vector<Array2D<MinMax>> levels;
+
+    //Computes the given node's min/max heights from the level below it (or the heightmap).
+    void ComputeNode(unsigned int level, Vector2u node);
+    //Tests the given ray, which is normalized in the XY plane, against the given cell
+    //    between the given distances.
+    bool CastRayInCell(Vector3f start, Vector3f dir, Vector2u cell, float minDist, float maxDist,
+                       float& outDist) const;
+};
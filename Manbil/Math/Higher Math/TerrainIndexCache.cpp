@@ -0,0 +1,59 @@
+#include "TerrainIndexCache.h"
+
+
+const TerrainIndexCache::Indices& TerrainIndexCache::Get(unsigned int patchSize, unsigned int lod,
+                                                         unsigned int seamMask)
+{
+    unsigned int nCells = patchSize >> lod;
+    assert(nCells >= 2 && nCells % 2 == 0 && (nCells << lod) == patchSize);
+    assert(seamMask < 16);
+
+    unsigned long long key = ((unsigned long long)patchSize << 16) |
+                             ((unsigned long long)lod << 4) |
+                             (unsigned long long)seamMask;
+
+    std::unique_lock<std::mutex> lck(lock);
+
+    auto found = entries.find(key);
+    if (found != entries.end())
+        return *found->second;
+
+    std::unique_ptr<Indices> indices(new Indices());
+    indices->NVerticesPerSide = nCells + 1;
+    indices->Uses16Bit = (TerrainQuadtree::GetNChunkVertices(nCells) <= 65536);
+
+    unsigned int nIndices = TerrainQuadtree::GetNChunkIndices(nCells, seamMask);
+    if (indices->Uses16Bit)
+    {
+        indices->Indices16.resize(nIndices);
+        TerrainQuadtree::GetChunkIndices(nCells, seamMask, indices->Indices16.data());
+    }
+    else
+    {
+        indices->Indices32.resize(nIndices);
+        TerrainQuadtree::GetChunkIndices(nCells, seamMask, indices->Indices32.data());
+    }
+
+    usedBytes += indices->GetNBytes();
+    const Indices& result = *indices;
+    entries[key] = std::move(indices);
+    return result;
+}
+
+unsigned int TerrainIndexCache::GetNEntries(void) const
+{
+    std::unique_lock<std::mutex> lck(lock);
+    return (unsigned int)entries.size();
+}
+size_t TerrainIndexCache::GetUsedBytes(void) const
+{
+    std::unique_lock<std::mutex> lck(lock);
+    return usedBytes;
+}
+
+void TerrainIndexCache::Clear(void)
+{
+    std::unique_lock<std::mutex> lck(lock);
+    entries.clear();
+    usedBytes = 0;
+}
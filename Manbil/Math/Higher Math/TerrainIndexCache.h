@@ -0,0 +1,84 @@
+#pragma once
+
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include "TerrainQuadtree.h"
+
+
+//Keeps one copy of the triangle indices for each kind of terrain patch,
+//    so every patch with the same size, LOD level, and seams shares one index list
+//    instead of generating its own.
+//A patch is a square grid of vertices in row order, like a "TerrainQuadtree" chunk
+//    or a square region output by the array version of "Terrain::GenerateTriangles".
+//A patch covering "patchSize" cells at full detail has "(patchSize >> lod) + 1" vertices along each side.
+//It's triangulated like a "TerrainQuadtree" chunk, so patches at neighboring LOD levels
+//    line up without cracks when the finer one skips the odd vertices on that edge.
+//Patches with no more than 65536 vertices get 16-bit indices, which halves their memory and bandwidth.
+//All functions are thread-safe, and the returned index lists stay valid until "Clear" is called.
+class TerrainIndexCache
+{
+public:
+
+    //The triangle indices for one kind of patch.
+    struct Indices
+    {
+        //The number of vertices along each side of the patch.
+        unsigned int NVerticesPerSide;
+        //If true, the indices are in "Indices16". Otherwise, they're in "Indices32".
+        bool Uses16Bit;
+
+        std::vector<unsigned short> Indices16;
+        std::vector<unsigned int> Indices32;
+
+
+        unsigned int GetNIndices(void) const
+        {
+            return (unsigned int)(Uses16Bit ? Indices16.size() : Indices32.size());
+        }
+        //Gets the number of bytes the indices take up.
+        size_t GetNBytes(void) const
+        {
+            return GetNIndices() * (Uses16Bit ? sizeof(unsigned short) : sizeof(unsigned int));
+        }
+        //Gets a pointer to the first index, e.x. for uploading to the GPU.
+        const void* GetData(void) const
+        {
+            return (Uses16Bit ? (const void*)Indices16.data() : (const void*)Indices32.data());
+        }
+    };
+
+
+    TerrainIndexCache(void) : usedBytes(0) { }
+
+    TerrainIndexCache(const TerrainIndexCache& cpy) = delete;
+    TerrainIndexCache& operator=(const TerrainIndexCache& cpy) = delete;
+
+
+    //Gets the indices for a patch covering the given number of cells at full detail,
+    //    at the given LOD level (0 = full detail, 1 = 1/4 detail, 2 = 1/8 detail, etc.),
+    //    with the odd vertices skipped along the given edges ("TerrainQuadtree::Edges" flags).
+    //The number of cells along each side at that LOD level must be even.
+    //The indices are generated the first time they're asked for.
+    const Indices& Get(unsigned int patchSize, unsigned int lod = 0, unsigned int seamMask = 0);
+    //Gets the indices for the given "TerrainQuadtree" chunk.
+    const Indices& Get(const TerrainQuadtree& quadtree, const TerrainQuadtree::Chunk& chunk)
+    {
+        return Get(quadtree.PatchSize, 0, chunk.SeamMask);
+    }
+
+    //Gets the number of different index lists in the cache.
+    unsigned int GetNEntries(void) const;
+    //Gets the number of bytes all the cached index lists take up.
+    size_t GetUsedBytes(void) const;
+
+    //Throws out every cached index list.
+    void Clear(void);
+
+
+private:
+
+    mutable std::mutex lock;
+    std::unordered_map<unsigned long long, std::unique_ptr<Indices>> entries;
+    size_t usedBytes;
+};
@@ -0,0 +1,415 @@
+#include "TerrainQuadtree.h"
+
+#include "../../ThreadPool.h"
+#include <limits>
+
+
+namespace
+{
+    //Gets the smallest and biggest levels in the level map just outside the given edge of a chunk.
+    //The chunk's position and size are in leaf cells (full-detail chunks).
+    //Returns false if the edge is on the border of the terrain.
+    bool GetNeighborLevels(const Array2D<unsigned char>& levelMap, Vector2u cellMin, unsigned int cellSize,
+                           TerrainQuadtree::Edges edge, unsigned char& outMin, unsigned char& outMax)
+    {
+        Vector2u start, dir;
+        switch (edge)
+        {
+            case TerrainQuadtree::EDGE_LEFT:
+                if (cellMin.x == 0)
+                    return false;
+                start = Vector2u(cellMin.x - 1, cellMin.y);
+                dir = Vector2u(0, 1);
+                break;
+            case TerrainQuadtree::EDGE_RIGHT:
+                if (cellMin.x + cellSize >= levelMap.GetWidth())
+                    return false;
+                start = Vector2u(cellMin.x + cellSize, cellMin.y);
+                dir = Vector2u(0, 1);
+                break;
+            case TerrainQuadtree::EDGE_TOP:
+                if (cellMin.y == 0)
+                    return false;
+                start = Vector2u(cellMin.x, cellMin.y - 1);
+                dir = Vector2u(1, 0);
+                break;
+            case TerrainQuadtree::EDGE_BOTTOM:
+                if (cellMin.y + cellSize >= levelMap.GetHeight())
+                    return false;
+                start = Vector2u(cellMin.x, cellMin.y + cellSize);
+                dir = Vector2u(1, 0);
+                break;
+
+            default:
+                assert(false);
+                return false;
+        }
+
+        outMin = 255;
+        outMax = 0;
+        for (unsigned int i = 0; i < cellSize; ++i)
+        {
+            unsigned char level = levelMap[Vector2u(start.x + (dir.x * i), start.y + (dir.y * i))];
+            outMin = Mathf::Min(outMin, level);
+            outMax = Mathf::Max(outMax, level);
+        }
+        return true;
+    }
+
+    const TerrainQuadtree::Edges allEdges[4] = { TerrainQuadtree::EDGE_LEFT, TerrainQuadtree::EDGE_RIGHT,
+                                                 TerrainQuadtree::EDGE_TOP, TerrainQuadtree::EDGE_BOTTOM };
+
+
+    template<typename IndexType>
+    //Outputs the indices for "TerrainQuadtree::GetChunkIndices".
+    void WriteChunkIndices(unsigned int patchSize, unsigned int seamMask, IndexType* outIndices)
+    {
+        assert(patchSize >= 2 && patchSize % 2 == 0);
+
+        unsigned int rowSize = patchSize + 1,
+                     nBlocks = patchSize / 2;
+        for (unsigned int blockY = 0; blockY < nBlocks; ++blockY)
+        {
+            for (unsigned int blockX = 0; blockX < nBlocks; ++blockX)
+            {
+                unsigned int x = blockX * 2,
+                             y = blockY * 2;
+                unsigned int center = (x + 1) + ((y + 1) * rowSize);
+
+                //The vertices around the block's center, going around the block starting at its min corner.
+                //The odd ones are the middle of each edge, and are skipped if that edge is on a seam.
+                unsigned int ring[8] = { x + (y * rowSize), (x + 1) + (y * rowSize), (x + 2) + (y * rowSize),
+                                         (x + 2) + ((y + 1) * rowSize), (x + 2) + ((y + 2) * rowSize),
+                                         (x + 1) + ((y + 2) * rowSize), x + ((y + 2) * rowSize),
+                                         x + ((y + 1) * rowSize) };
+                bool skip[8] = { false, (blockY == 0 && (seamMask & TerrainQuadtree::EDGE_TOP) != 0),
+                                 false, (blockX == nBlocks - 1 && (seamMask & TerrainQuadtree::EDGE_RIGHT) != 0),
+                                 false, (blockY == nBlocks - 1 && (seamMask & TerrainQuadtree::EDGE_BOTTOM) != 0),
+                                 false, (blockX == 0 && (seamMask & TerrainQuadtree::EDGE_LEFT) != 0) };
+
+                for (unsigned int i = 0; i < 8; ++i)
+                {
+                    if (skip[i])
+                        continue;
+
+                    unsigned int next = (i + 1) % 8;
+                    if (skip[next])
+                        next = (next + 1) % 8;
+
+                    //Use the same winding order as "Terrain::GenerateTriangles".
+                    outIndices[0] = (IndexType)center;
+                    outIndices[1] = (IndexType)ring[next];
+                    outIndices[2] = (IndexType)ring[i];
+                    outIndices += 3;
+                }
+            }
+        }
+    }
+}
+
+
+unsigned int TerrainQuadtree::GetNChunkIndices(unsigned int patchSize, unsigned int seamMask)
+{
+    unsigned int nSeams = 0;
+    for (unsigned int i = 0; i < 4; ++i)
+        if ((seamMask & allEdges[i]) != 0)
+            nSeams += 1;
+
+    //Each 2x2 block of cells is a fan of 8 triangles around its center,
+    //    minus one triangle for each seam it touches.
+    return 3 * ((2 * patchSize * patchSize) - (nSeams * (patchSize / 2)));
+}
+void TerrainQuadtree::GetChunkIndices(unsigned int patchSize, unsigned int seamMask, unsigned int* outIndices)
+{
+    WriteChunkIndices(patchSize, seamMask, outIndices);
+}
+void TerrainQuadtree::GetChunkIndices(unsigned int patchSize, unsigned int seamMask, unsigned short* outIndices)
+{
+    assert(GetNChunkVertices(patchSize) <= 65536);
+    WriteChunkIndices(patchSize, seamMask, outIndices);
+}
+
+float TerrainQuadtree::GetMorphHeight(const Array2D<float>& heightmap, Vector2u gridPos, unsigned int level)
+{
+    unsigned int step = 1 << level;
+    bool oddX = ((gridPos.x >> level) % 2) == 1,
+         oddY = ((gridPos.y >> level) % 2) == 1;
+
+    //Even vertices are also on the next level.
+    if (!oddX && !oddY)
+        return heightmap[gridPos];
+
+    //Vertices in the middle of an edge of the next level are halfway between its two ends.
+    if (oddX && !oddY)
+        return 0.5f * (heightmap[Vector2u(gridPos.x - step, gridPos.y)] +
+                       heightmap[Vector2u(gridPos.x + step, gridPos.y)]);
+    if (!oddX && oddY)
+        return 0.5f * (heightmap[Vector2u(gridPos.x, gridPos.y - step)] +
+                       heightmap[Vector2u(gridPos.x, gridPos.y + step)]);
+
+    //Vertices in the middle of a cell of the next level are halfway along its diagonal,
+    //    which goes between the cell's even and odd corners (at that level).
+    unsigned int nextX = (gridPos.x >> level) / 2,
+                 nextY = (gridPos.y >> level) / 2;
+    if ((nextX % 2) == (nextY % 2))
+        return 0.5f * (heightmap[Vector2u(gridPos.x - step, gridPos.y - step)] +
+                       heightmap[Vector2u(gridPos.x + step, gridPos.y + step)]);
+    else
+        return 0.5f * (heightmap[Vector2u(gridPos.x + step, gridPos.y - step)] +
+                       heightmap[Vector2u(gridPos.x - step, gridPos.y + step)]);
+}
+
+
+TerrainQuadtree::TerrainQuadtree(const Terrain& _terrain, unsigned int patchSize, unsigned int nThreads)
+    : PatchSize(patchSize), HeightScale(1.0f), Metric(LM_DISTANCE), LODDistance(64.0f),
+      MaxScreenError(2.0f), ScreenErrorScale(600.0f), MorphFraction(0.3f), terrain(&_terrain)
+{
+    assert(PatchSize >= 2 && PatchSize % 2 == 0);
+    assert(terrain->GetWidth() > 1 && (terrain->GetWidth() - 1) % PatchSize == 0);
+    assert(terrain->GetHeight() > 1 && (terrain->GetHeight() - 1) % PatchSize == 0);
+
+    //Keep adding levels as long as the chunks can be merged in groups of four.
+    Vector2u nChunks((terrain->GetWidth() - 1) / PatchSize, (terrain->GetHeight() - 1) / PatchSize);
+    levels.push_back(Array2D<ChunkBounds>(nChunks.x, nChunks.y));
+    while (nChunks.x % 2 == 0 && nChunks.y % 2 == 0)
+    {
+        nChunks = Vector2u(nChunks.x / 2, nChunks.y / 2);
+        levels.push_back(Array2D<ChunkBounds>(nChunks.x, nChunks.y));
+    }
+    levelErrors.resize(levels.size());
+
+    Rebuild(nThreads);
+}
+
+void TerrainQuadtree::SetProjection(const ProjectionInfo& projection)
+{
+    ScreenErrorScale = projection.Height / (2.0f * tanf(projection.FOV * 0.5f));
+}
+
+void TerrainQuadtree::Rebuild(unsigned int nThreads)
+{
+    const Array2D<float>& heightmap = terrain->GetHeightmap();
+    nThreads = Mathf::Max(nThreads, (unsigned int)1);
+
+    //Full-detail chunks just need the bounds of their heights.
+    Array2D<ChunkBounds>& leaves = levels[0];
+    ThreadPool::GetGlobalPool().RunChunks(leaves.GetHeight(), nThreads,
+                                          [&](unsigned int chunk, unsigned int startY, unsigned int endY)
+    {
+        for (unsigned int chunkY = startY; chunkY < endY; ++chunkY)
+        {
+            for (unsigned int chunkX = 0; chunkX < leaves.GetWidth(); ++chunkX)
+            {
+                ChunkBounds bounds;
+                bounds.MinZ = std::numeric_limits<float>::max();
+                bounds.MaxZ = -std::numeric_limits<float>::max();
+                bounds.Error = 0.0f;
+
+                for (unsigned int y = chunkY * PatchSize; y <= (chunkY + 1) * PatchSize; ++y)
+                {
+                    const float* row = heightmap.GetRow(y);
+                    for (unsigned int x = chunkX * PatchSize; x <= (chunkX + 1) * PatchSize; ++x)
+                    {
+                        bounds.MinZ = Mathf::Min(bounds.MinZ, row[x]);
+                        bounds.MaxZ = Mathf::Max(bounds.MaxZ, row[x]);
+                    }
+                }
+
+                leaves[Vector2u(chunkX, chunkY)] = bounds;
+            }
+        }
+    });
+    levelErrors[0] = 0.0f;
+
+    //Each bigger chunk combines its children's bounds, and its error is its children's error
+    //    plus how far their vertices are from its own surface.
+    for (unsigned int level = 1; level < levels.size(); ++level)
+    {
+        const Array2D<ChunkBounds>& children = levels[level - 1];
+        Array2D<ChunkBounds>& parents = levels[level];
+        unsigned int childStep = 1 << (level - 1),
+                     size = PatchSize << level;
+
+        ThreadPool::GetGlobalPool().RunChunks(parents.GetHeight(), nThreads,
+                                              [&](unsigned int chunk, unsigned int startY, unsigned int endY)
+        {
+            for (unsigned int chunkY = startY; chunkY < endY; ++chunkY)
+            {
+                for (unsigned int chunkX = 0; chunkX < parents.GetWidth(); ++chunkX)
+                {
+                    ChunkBounds bounds;
+                    bounds.MinZ = std::numeric_limits<float>::max();
+                    bounds.MaxZ = -std::numeric_limits<float>::max();
+                    bounds.Error = 0.0f;
+                    for (unsigned int i = 0; i < 4; ++i)
+                    {
+                        const ChunkBounds& child = children[Vector2u((chunkX * 2) + (i % 2),
+                                                                     (chunkY * 2) + (i / 2))];
+                        bounds.MinZ = Mathf::Min(bounds.MinZ, child.MinZ);
+                        bounds.MaxZ = Mathf::Max(bounds.MaxZ, child.MaxZ);
+                        bounds.Error = Mathf::Max(bounds.Error, child.Error);
+                    }
+
+                    float maxDiff = 0.0f;
+                    Vector2u gridPos;
+                    for (gridPos.y = chunkY * size; gridPos.y <= (chunkY + 1) * size; gridPos.y += childStep)
+                        for (gridPos.x = chunkX * size; gridPos.x <= (chunkX + 1) * size; gridPos.x += childStep)
+                            maxDiff = Mathf::Max(maxDiff, Mathf::Abs(heightmap[gridPos] -
+                                                                     GetMorphHeight(heightmap, gridPos, level - 1)));
+                    bounds.Error += maxDiff;
+
+                    parents[Vector2u(chunkX, chunkY)] = bounds;
+                }
+            }
+        });
+
+        levelErrors[level] = levelErrors[level - 1];
+        for (unsigned int i = 0; i < parents.GetNumbElements(); ++i)
+            levelErrors[level] = Mathf::Max(levelErrors[level], parents.GetArray()[i].Error);
+    }
+}
+
+
+float TerrainQuadtree::GetLODRange(unsigned int level) const
+{
+    if (level + 1 >= GetNLevels())
+        return std::numeric_limits<float>::max();
+
+    switch (Metric)
+    {
+        case LM_DISTANCE:
+            return LODDistance * (float)(1 << level);
+
+        case LM_SCREEN_ERROR:
+            //The next level's error, seen from this distance, covers exactly "MaxScreenError" pixels.
+            //The errors never get smaller with each level, so neither do the ranges.
+            return levelErrors[level + 1] * Mathf::Abs(HeightScale) * ScreenErrorScale / MaxScreenError;
+
+        default:
+            assert(false);
+            return 0.0f;
+    }
+}
+float TerrainQuadtree::GetMorph(unsigned int level, float distance) const
+{
+    if (level + 1 >= GetNLevels())
+        return 0.0f;
+
+    float end = GetLODRange(level),
+          start = end - (MorphFraction * (end - ((level == 0) ? 0.0f : GetLODRange(level - 1))));
+    if (distance >= end)
+        return 1.0f;
+    if (distance <= start)
+        return 0.0f;
+    return (distance - start) / (end - start);
+}
+
+
+void TerrainQuadtree::Select(Vector3f camPos, std::vector<Chunk>& outChunks) const
+{
+    outChunks.clear();
+
+    //Keep track of the level covering each full-detail chunk, to find each chunk's neighbors.
+    Array2D<unsigned char> levelMap(levels[0].GetWidth(), levels[0].GetHeight());
+
+    unsigned int topLevel = GetNLevels() - 1;
+    const Array2D<ChunkBounds>& roots = levels[topLevel];
+    for (Vector2u root; root.y < roots.GetHeight(); ++root.y)
+        for (root.x = 0; root.x < roots.GetWidth(); ++root.x)
+            SelectChunk(camPos, root, topLevel, outChunks, levelMap);
+
+
+    //Split chunks until none of them is next to a chunk more than one level finer.
+    bool changed = true;
+    while (changed)
+    {
+        changed = false;
+
+        unsigned int i = 0;
+        while (i < outChunks.size())
+        {
+            Chunk chunk = outChunks[i];
+            Vector2u cellMin(chunk.Min.x / PatchSize, chunk.Min.y / PatchSize);
+            unsigned int cellSize = 1 << chunk.Level;
+
+            bool shouldSplit = false;
+            unsigned char minLevel, maxLevel;
+            for (unsigned int edge = 0; edge < 4 && !shouldSplit; ++edge)
+                if (GetNeighborLevels(levelMap, cellMin, cellSize, allEdges[edge], minLevel, maxLevel))
+                    shouldSplit = ((unsigned int)minLevel + 1 < chunk.Level);
+
+            if (!shouldSplit)
+            {
+                i += 1;
+                continue;
+            }
+
+            //Replace the chunk with its four children, then check the first child again.
+            changed = true;
+            unsigned int childLevel = chunk.Level - 1,
+                         childSize = PatchSize << childLevel;
+            outChunks[i] = Chunk(chunk.Min, childLevel);
+            outChunks.push_back(Chunk(Vector2u(chunk.Min.x + childSize, chunk.Min.y), childLevel));
+            outChunks.push_back(Chunk(Vector2u(chunk.Min.x, chunk.Min.y + childSize), childLevel));
+            outChunks.push_back(Chunk(Vector2u(chunk.Min.x + childSize, chunk.Min.y + childSize), childLevel));
+            for (unsigned int y = 0; y < cellSize; ++y)
+                for (unsigned int x = 0; x < cellSize; ++x)
+                    levelMap[Vector2u(cellMin.x + x, cellMin.y + y)] = (unsigned char)childLevel;
+        }
+    }
+
+
+    //Find which edges border coarser or finer chunks.
+    for (unsigned int i = 0; i < outChunks.size(); ++i)
+    {
+        Chunk& chunk = outChunks[i];
+        Vector2u cellMin(chunk.Min.x / PatchSize, chunk.Min.y / PatchSize);
+        unsigned int cellSize = 1 << chunk.Level;
+
+        unsigned char minLevel, maxLevel;
+        for (unsigned int edge = 0; edge < 4; ++edge)
+        {
+            if (GetNeighborLevels(levelMap, cellMin, cellSize, allEdges[edge], minLevel, maxLevel))
+            {
+                if (maxLevel > chunk.Level)
+                    chunk.SeamMask |= allEdges[edge];
+                if (minLevel < chunk.Level)
+                    chunk.FinerMask |= allEdges[edge];
+            }
+        }
+    }
+}
+void TerrainQuadtree::SelectChunk(Vector3f camPos, Vector2u chunkCoords, unsigned int level,
+                                  std::vector<Chunk>& outChunks, Array2D<unsigned char>& levelMap) const
+{
+    unsigned int size = PatchSize << level;
+    Vector2u min(chunkCoords.x * size, chunkCoords.y * size);
+
+    //Split the chunk if any part of it is close enough to the camera to need the next level.
+    if (level > 0)
+    {
+        const ChunkBounds& bounds = levels[level][chunkCoords];
+        float minZ = Mathf::Min(bounds.MinZ * HeightScale, bounds.MaxZ * HeightScale),
+              maxZ = Mathf::Max(bounds.MinZ * HeightScale, bounds.MaxZ * HeightScale);
+
+        Vector3f toBox(Mathf::Max(0.0f, Mathf::Max((float)min.x - camPos.x, camPos.x - (float)(min.x + size))),
+                       Mathf::Max(0.0f, Mathf::Max((float)min.y - camPos.y, camPos.y - (float)(min.y + size))),
+                       Mathf::Max(0.0f, Mathf::Max(minZ - camPos.z, camPos.z - maxZ)));
+
+        if (toBox.Length() < GetLODRange(level - 1))
+        {
+            for (unsigned int i = 0; i < 4; ++i)
+                SelectChunk(camPos, Vector2u((chunkCoords.x * 2) + (i % 2), (chunkCoords.y * 2) + (i / 2)),
+                            level - 1, outChunks, levelMap);
+            return;
+        }
+    }
+
+    outChunks.push_back(Chunk(min, level));
+
+    Vector2u cellMin(min.x / PatchSize, min.y / PatchSize);
+    unsigned int cellSize = 1 << level;
+    for (unsigned int y = 0; y < cellSize; ++y)
+        for (unsigned int x = 0; x < cellSize; ++x)
+            levelMap[Vector2u(cellMin.x + x, cellMin.y + y)] = (unsigned char)level;
+}
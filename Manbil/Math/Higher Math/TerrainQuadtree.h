@@ -0,0 +1,189 @@
+#pragma once
+
+#include "Terrain.h"
+#include "ProjectionInfo.h"
+
+
+//Splits a Terrain into a quadtree of square chunks for level-of-detail rendering.
+//Every chunk has the same grid of "PatchSize + 1" vertices on each side, but a chunk at level "n"
+//    is 2^n times as big as a full-detail chunk and only uses every 2^n-th height.
+//Each frame, "Select" picks the chunks to draw based on their distance to the camera
+//    and then splits chunks until no chunk is more than one level away from its neighbors.
+//Chunks are triangulated so that each grid cell's diagonal connects its even and odd corners,
+//    which puts every vertex exactly on the surface of the next-coarser level.
+//That makes geomorphing easy: each vertex has a "morph height" (its height at the next level),
+//    and it slides towards that height as it nears the distance where the chunk would be merged into its parent.
+//The odd vertices on an edge next to a coarser chunk are skipped by the indices ("GetChunkIndices"),
+//    and the vertices on an edge next to a finer chunk aren't morphed, so there are never any cracks.
+//The terrain's width and height minus one must be multiples of "PatchSize".
+class TerrainQuadtree
+{
+public:
+
+    //The edges of a chunk, used as bit flags.
+    enum Edges
+    {
+        //The edge along the smallest X.
+        EDGE_LEFT = 1,
+        //The edge along the biggest X.
+        EDGE_RIGHT = 2,
+        //The edge along the smallest Y.
+        EDGE_TOP = 4,
+        //The edge along the biggest Y.
+        EDGE_BOTTOM = 8,
+    };
+
+    //Different ways of deciding how far away each level of detail is used.
+    enum LODMetrics
+    {
+        //Level 0 is used out to "LODDistance" from the camera, and each level after that is used twice as far out.
+        LM_DISTANCE,
+        //Each level is used once the worst error between it and the full-detail heightmap
+        //    (across the whole terrain) would be smaller than "MaxScreenError" pixels.
+        LM_SCREEN_ERROR,
+    };
+
+    //A chunk picked to be drawn.
+    struct Chunk
+    {
+        //The heightmap coordinates of the chunk's min corner.
+        Vector2u Min;
+        //0 is full detail. Each level after that doubles the size of the chunk and the distance between its vertices.
+        unsigned int Level;
+        //The edges that border a coarser chunk ("Edges" flags).
+        unsigned int SeamMask;
+        //The edges that border a finer chunk ("Edges" flags).
+        unsigned int FinerMask;
+
+        Chunk(Vector2u min = Vector2u(), unsigned int level = 0)
+            : Min(min), Level(level), SeamMask(0), FinerMask(0) { }
+    };
+
+
+    //Gets the number of vertices in each chunk with the given patch size.
+    static unsigned int GetNChunkVertices(unsigned int patchSize) { return (patchSize + 1) * (patchSize + 1); }
+    //Gets the number of indices in each chunk with the given patch size and "Edges" flags for its seams.
+    static unsigned int GetNChunkIndices(unsigned int patchSize, unsigned int seamMask);
+    //Outputs the triangle indices for a chunk with the given patch size and "Edges" flags for its seams.
+    //The output array must have room for "GetNChunkIndices" elements.
+    //The indices refer to the chunk's vertices in row order, as output by "GetChunkVertices".
+    static void GetChunkIndices(unsigned int patchSize, unsigned int seamMask, unsigned int* outIndices);
+    //Outputs 16-bit triangle indices for a chunk with the given patch size and "Edges" flags for its seams.
+    //The patch size must be small enough that there are no more than 65536 vertices.
+    static void GetChunkIndices(unsigned int patchSize, unsigned int seamMask, unsigned short* outIndices);
+
+
+    //The number of grid cells along each side of a chunk. Must be even.
+    unsigned int PatchSize;
+    //The scale for the terrain's height.
+    float HeightScale;
+
+    LODMetrics Metric;
+    //If using "LM_DISTANCE", the distance from the camera that full-detail chunks are used out to.
+    float LODDistance;
+    //If using "LM_SCREEN_ERROR", the biggest height error allowed for any chunk, in pixels.
+    float MaxScreenError;
+    //If using "LM_SCREEN_ERROR", the number of pixels covered by one unit of height one unit away from the camera.
+    //Can be set from a projection with "SetProjection".
+    float ScreenErrorScale;
+
+    //The fraction of each level's range (at the far end) where its vertices morph towards the next level.
+    float MorphFraction;
+
+
+    //Builds the quadtree for the given terrain, splitting the work across the given number of threads.
+    //The terrain must stay alive for as long as this quadtree uses it.
+    TerrainQuadtree(const Terrain& terrain, unsigned int patchSize = 32, unsigned int nThreads = 1);
+
+
+    const Terrain& GetTerrain(void) const { return *terrain; }
+
+    //Gets the number of levels of detail. The biggest level's chunks are the roots of the quadtree.
+    unsigned int GetNLevels(void) const { return (unsigned int)levels.size(); }
+    //Gets the worst height error (before "HeightScale") between the given level and the full-detail heightmap.
+    float GetLevelError(unsigned int level) const { return levelErrors[level]; }
+
+    //Sets "ScreenErrorScale" to match the given projection.
+    void SetProjection(const ProjectionInfo& projection);
+
+    //Updates the heights' bounds and errors after the terrain's heights were changed.
+    void Rebuild(unsigned int nThreads = 1);
+
+
+    //Picks the chunks to draw for a camera at the given position.
+    //The output collection is cleared first.
+    void Select(Vector3f camPos, std::vector<Chunk>& outChunks) const;
+
+    //Gets the distance from the camera beyond which the given level is merged into the next one.
+    //Returns the largest float for the biggest level.
+    float GetLODRange(unsigned int level) const;
+    //Gets how far a vertex in a chunk of the given level should move towards its morph height,
+    //    given its distance to the camera. Goes from 0 (not at all) to 1 (all the way).
+    float GetMorph(unsigned int level, float distance) const;
+
+
+    //A function with signature "void WriteVertex(unsigned int index, Vector3f pos, float morphHeight)".
+    template<typename Func>
+    //Outputs each of the given chunk's vertices ("GetNChunkVertices" of them) in row order.
+    //"morphHeight" is the vertex's height at the next-coarser level. The vertex's height should be
+    //    interpolated towards it by "GetMorph" (usually in a vertex shader).
+    //The vertices on edges next to finer chunks have a morph height equal to their height,
+    //    so the output depends on the chunk's "FinerMask".
+    void GetChunkVertices(const Chunk& chunk, Func writeVertex) const
+    {
+        const Array2D<float>& heightmap = terrain->GetHeightmap();
+        unsigned int step = 1 << chunk.Level;
+        bool canMorph = (chunk.Level + 1 < GetNLevels());
+
+        unsigned int index = 0;
+        Vector2u gridPos;
+        for (unsigned int y = 0; y <= PatchSize; ++y)
+        {
+            gridPos.y = chunk.Min.y + (y * step);
+            bool finerY = (y == 0 && (chunk.FinerMask & EDGE_TOP) != 0) ||
+                          (y == PatchSize && (chunk.FinerMask & EDGE_BOTTOM) != 0);
+
+            for (unsigned int x = 0; x <= PatchSize; ++x)
+            {
+                gridPos.x = chunk.Min.x + (x * step);
+                bool finer = finerY ||
+                             (x == 0 && (chunk.FinerMask & EDGE_LEFT) != 0) ||
+                             (x == PatchSize && (chunk.FinerMask & EDGE_RIGHT) != 0);
+
+                float z = HeightScale * heightmap[gridPos];
+                float morphZ = ((canMorph && !finer) ?
+                                    (HeightScale * GetMorphHeight(heightmap, gridPos, chunk.Level)) :
+                                    z);
+                writeVertex(index, Vector3f((float)gridPos.x, (float)gridPos.y, z), morphZ);
+                index += 1;
+            }
+        }
+    }
+
+
+private:
+
+    //The bounds and error of a chunk's heights, before "HeightScale".
+    struct ChunkBounds
+    {
+        float MinZ, MaxZ;
+        //The biggest difference between this chunk's surface and the full-detail heightmap.
+        float Error;
+    };
+
+
+    //Gets the height of the grid point at the given position
+    //    on the surface of the level after the given one.
+    static float GetMorphHeight(const Array2D<float>& heightmap, Vector2u gridPos, unsigned int level);
+
+
+    const Terrain* terrain;
+    //The bounds of every possible chunk at each level.
+    std::vector<Array2D<ChunkBounds>> levels;
+    //The biggest "ChunkBounds::Error" at each level.
+    std::vector<float> levelErrors;
+
+    //Adds the given chunk to the selection, or its children if it needs more detail.
+    void SelectChunk(Vector3f camPos, Vector2u chunkCoords, unsigned int level,
+                     std::vector<Chunk>& outChunks, Array2D<unsigned char>& levelMap) const;
+};
@@ -3,7 +3,12 @@
 #include "LowerMath.hpp"
 
 #include "Higher Math/Camera.h"
+#include "Higher Math/Erosion.h"
 #include "Higher Math/Geometryf.h"
 #include "Higher Math/ProjectionInfo.h"
 #include "Higher Math/Terrain.h"
+#include "Higher Math/TerrainEditor.h"
+#include "Higher Math/TerrainHeightPyramid.h"
+#include "Higher Math/TerrainIndexCache.h"
+#include "Higher Math/TerrainQuadtree.h"
 #include "Higher Math/Transform.h"
\ No newline at end of file
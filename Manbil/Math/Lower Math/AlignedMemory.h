@@ -0,0 +1,78 @@
+#pragma once
+
+#include <assert.h>
+#include <stdlib.h>
+#include <new>
+#include <type_traits>
+
+#if defined(_MSC_VER)
+    #include <malloc.h>
+#endif
+
+
+//Allocates memory aligned to a bigger boundary than "new" guarantees,
+//    so that SIMD code can use aligned loads and no element straddles two cache lines needlessly.
+namespace AlignedMemory
+{
+    //The alignment (in bytes) used for arrays by default: one cache line,
+    //    which is also enough for aligned AVX loads.
+    const size_t DefaultAlignment = 64;
+
+
+    //Allocates the given number of bytes, aligned to the given power of two.
+    //Throws "std::bad_alloc" if the memory couldn't be allocated, just like "new".
+    inline void* Allocate(size_t nBytes, size_t alignment = DefaultAlignment)
+    {
+        assert(alignment >= sizeof(void*) && (alignment & (alignment - 1)) == 0);
+
+        //Some platforms give back null for empty allocations, so always allocate something.
+        if (nBytes == 0)
+            nBytes = alignment;
+
+    #if defined(_MSC_VER)
+        void* ptr = _aligned_malloc(nBytes, alignment);
+    #else
+        void* ptr = 0;
+        if (posix_memalign(&ptr, alignment, nBytes) != 0)
+            ptr = 0;
+    #endif
+
+        if (ptr == 0)
+            throw std::bad_alloc();
+        return ptr;
+    }
+    //Frees memory from "Allocate". Does nothing if given null.
+    inline void Free(void* ptr)
+    {
+    #if defined(_MSC_VER)
+        _aligned_free(ptr);
+    #else
+        free(ptr);
+    #endif
+    }
+
+
+    //Allocates an aligned array of the given number of elements and default-initializes them,
+    //    exactly like "new T[count]" does (so plain types like floats are left uninitialized).
+    template<typename T>
+    T* New(size_t count, size_t alignment = DefaultAlignment)
+    {
+        T* values = (T*)Allocate(count * sizeof(T), alignment);
+        if (!std::is_trivially_default_constructible<T>::value)
+            for (size_t i = 0; i < count; ++i)
+                new (values + i) T;
+        return values;
+    }
+    //Destroys and frees an array from "New". Does nothing if given null.
+    template<typename T>
+    void Delete(T* values, size_t count)
+    {
+        if (values == 0)
+            return;
+
+        if (!std::is_trivially_destructible<T>::value)
+            for (size_t i = 0; i < count; ++i)
+                values[i].~T();
+        Free(values);
+    }
+}
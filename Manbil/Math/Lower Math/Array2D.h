@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Vectors.h"
+#include "AlignedMemory.h"
+#include "../../ThreadPool.h"
+#include <memory>
+#include <cstring>
 
 #pragma warning(disable: 4018)
 
@@ -11,47 +15,73 @@ template<class ArrayType>
 //    so it can be treated like a two-dimensional array.
 //The most cache-efficient way to loop through this array is through
 //    the Y in the outer loop and then the X in the inner loop.
+//The memory is aligned to "AlignedMemory::DefaultAlignment" bytes.
+//Rows can optionally be padded (see "SetRowPadding") so that every row starts on a "RowAlignment"-byte boundary.
 class Array2D
 {
 public:
 
+    //The alignment (in bytes) of the start of each row when rows are padded.
+    static const unsigned int RowAlignment = 32;
+
+
 	//Creates a new Array2D without initializing any of the values.
 	Array2D(unsigned int aWidth, unsigned int aHeight)
 	{
 		width = aWidth;
 		height = aHeight;
+        padRows = false;
+        pitch = width;
 
-		arrayVals = new ArrayType[width * height];
+        capacity = width * height;
+		arrayVals = AlignedMemory::New<ArrayType>(capacity);
+        ownsValues = true;
 	}
     Array2D(unsigned int aWidth, unsigned int aHeight, const ArrayType & defaultValue)
+        : Array2D(aWidth, aHeight)
 	{
-		width = aWidth;
-		height = aHeight;
-
-		arrayVals = new ArrayType[width * height];
-
-        for (unsigned int i = 0; i < width * height; ++i)
-		{
-			arrayVals[i] = defaultValue;
-		}
+        Fill(defaultValue);
 	}
 
+    //Creates a new Array2D that uses the given memory (e.x. a memory-mapped file)
+    //    instead of allocating its own. The memory must hold at least "aWidth * aHeight" elements.
+    //The array never deletes the memory; instead, it holds onto "storageOwner"
+    //    (which may be null) for as long as it uses the memory.
+    //The array can't be reset to a different number of elements.
+    Array2D(unsigned int aWidth, unsigned int aHeight, ArrayType* externalValues, std::shared_ptr<void> storageOwner)
+        : arrayVals(externalValues), ownsValues(false), externalOwner(storageOwner)
+    {
+        width = aWidth;
+        height = aHeight;
+        padRows = false;
+        pitch = width;
+        capacity = width * height;
+    }
+
     //Move semantics.
-    Array2D(Array2D&& toMove) : arrayVals(0) { *this = std::move(toMove); }
+    Array2D(Array2D&& toMove) : arrayVals(0), capacity(0), ownsValues(false) { *this = std::move(toMove); }
     Array2D& operator=(Array2D&& toMove)
     {
-        if (arrayVals != 0)
+        if (ownsValues)
         {
-            delete[] arrayVals;
+            AlignedMemory::Delete(arrayVals, capacity);
         }
 
         width = toMove.width;
         height = toMove.height;
+        pitch = toMove.pitch;
+        padRows = toMove.padRows;
+        capacity = toMove.capacity;
         arrayVals = toMove.arrayVals;
+        externalOwner = std::move(toMove.externalOwner);
+        ownsValues = toMove.ownsValues;
 
         toMove.width = 0;
         toMove.height = 0;
+        toMove.pitch = 0;
+        toMove.capacity = 0;
         toMove.arrayVals = 0;
+        toMove.ownsValues = false;
 
         return *this;
     }
@@ -62,9 +92,9 @@ public:
 
 	~Array2D(void)
 	{
-        if (arrayVals != 0)
+        if (ownsValues)
         {
-		    delete[] arrayVals;
+		    AlignedMemory::Delete(arrayVals, capacity);
         }
 	}
 
@@ -82,20 +112,33 @@ public:
 
 
     //Resets this array to the given size and leaves its elements uninitialized.
-    //If the total number of elements doesn't change, then nothing is allocated or un-allocated
-    //    and the elements keep their values.
+    //If the size of each row and the total number of elements don't change,
+    //    the elements keep their values.
+    //Memory is only re-allocated if the array needs more room than it has,
+    //    or if it would be wasting more than half of its memory.
     void Reset(unsigned int _width, unsigned int _height)
 	{
-        //Only resize if the current array does not have the same number of elements.
-        if ((width * height) != (_width * _height))
+        unsigned int newPitch = GetRowPitch(_width, padRows),
+                     needed = newPitch * _height;
+
+        if (!ownsValues)
         {
-            assert(arrayVals != 0);
-            delete[] arrayVals;
-            arrayVals = new ArrayType[_width * _height];
+            //External memory can't be resized.
+            assert(newPitch * _height == pitch * height);
+        }
+        else if (needed > capacity || (needed * 2) < capacity)
+        {
+            AlignedMemory::Delete(arrayVals, capacity);
+            arrayVals = 0;
+            capacity = 0;
+
+            arrayVals = AlignedMemory::New<ArrayType>(needed);
+            capacity = needed;
         }
 
         width = _width;
         height = _height;
+        pitch = newPitch;
 	}
     //Resets this array to the given size and initializes all elements to the given value.
     void Reset(unsigned int _width, unsigned int _height, const ArrayType& newValues)
@@ -108,12 +151,53 @@ public:
     //Gets the array index for the given position.
     unsigned int GetIndex(unsigned int x, unsigned int y) const
     {
-        return x + (y * width);
+        return x + (y * pitch);
     }
     //Gets the location in this array that corresponds to the given array index.
     Vector2u GetLocation(unsigned int index) const
     {
-        return Vector2u(index % width, index / width);
+        return Vector2u(index % pitch, index / pitch);
+    }
+
+
+    //Gets the number of elements from the start of one row to the start of the next.
+    //This is the width unless the rows are padded.
+    unsigned int GetRowPitch(void) const { return pitch; }
+
+    //Gets a pointer to the first element of the given row.
+    //The rest of the row's elements come right after it.
+    ArrayType* GetRow(unsigned int y) { return arrayVals + (y * pitch); }
+    //Gets a pointer to the first element of the given row.
+    //The rest of the row's elements come right after it.
+    const ArrayType* GetRow(unsigned int y) const { return arrayVals + (y * pitch); }
+
+
+    //Gets whether the rows are padded so that each one starts on a "RowAlignment"-byte boundary.
+    bool HasRowPadding(void) const { return padRows; }
+    //Sets whether to pad the end of each row so that every row starts on a "RowAlignment"-byte boundary.
+    //SIMD code can then use aligned loads/stores at the start of each row,
+    //    and it can run whole packs past the end of a row into the padding ("GetRowPitch() - GetWidth()" elements).
+    //Padded arrays aren't contiguous, so they should be indexed with "GetIndex" or "GetRow"
+    //    instead of assuming "x + (y * width)".
+    //Changing this re-allocates the array, keeping the values of its elements.
+    void SetRowPadding(bool shouldPad)
+    {
+        if (shouldPad == padRows)
+            return;
+        assert(ownsValues); //External memory can't be rearranged.
+
+        unsigned int newPitch = GetRowPitch(width, shouldPad),
+                     newCapacity = newPitch * height;
+        ArrayType* newVals = AlignedMemory::New<ArrayType>(newCapacity);
+        for (unsigned int y = 0; y < height; ++y)
+            for (unsigned int x = 0; x < width; ++x)
+                newVals[x + (y * newPitch)] = arrayVals[GetIndex(x, y)];
+
+        AlignedMemory::Delete(arrayVals, capacity);
+        arrayVals = newVals;
+        capacity = newCapacity;
+        pitch = newPitch;
+        padRows = shouldPad;
     }
 
 
@@ -185,9 +269,19 @@ public:
 	//Fills every element with the given value.
 	void Fill(const ArrayType& value)
 	{
-        for (unsigned int i = 0; i < width * height; ++i)
+        for (unsigned int i = 0; i < pitch * height; ++i)
 			arrayVals[i] = value;
 	}
+    //Fills every element with the given value, splitting the rows across the given number of threads.
+    void Fill(const ArrayType& value, unsigned int nThreads)
+    {
+        ThreadPool::GetGlobalPool().RunChunks(height, Mathf::Max(nThreads, (unsigned int)1),
+                                              [this, &value](unsigned int chunk, unsigned int startY, unsigned int endY)
+        {
+            for (unsigned int i = startY * pitch; i < endY * pitch; ++i)
+                arrayVals[i] = value;
+        });
+    }
     //Copies the given array into this one. The given array may be offset a certain amount.
     //Any values of the given array that don't correspond to a value in this array are ignored.
 	void Fill(const Array2D<ArrayType>& toCopy, Vector2i copyOffset = Vector2i(0, 0))
@@ -216,16 +310,12 @@ public:
         }
 	}
     //Copies the given elements to this array.
-    //Assumes that the size of this array matches with the given one.
+    //Assumes that the given elements are a contiguous (unpadded) array with the same size as this one.
     //If "useMemcpy" is true, this array will have its exact binary data copied quickly using memcpy.
     //Otherwise, each element will be set using its assignment operator.
     void Fill(const ArrayType* values, bool useMemcpy)
     {
-        if (useMemcpy)
-            memcpy(arrayVals, values, width * height * sizeof(ArrayType));
-
-        else for (unsigned int i = 0; i < (width * height); ++i)
-            arrayVals[i] = values[i];
+        CopyRows(values, width, arrayVals, pitch, useMemcpy);
     }
 
     //A function with signature "void GetValue(Vector2u index, ArrayType* outNewValue)".
@@ -235,8 +325,29 @@ public:
     {
         Vector2u loc;
         for (loc.y = 0; loc.y < height; ++loc.y)
+        {
+            ArrayType* row = GetRow(loc.y);
             for (loc.x = 0; loc.x < width; ++loc.x)
-                getValue(loc, &arrayVals[GetIndex(loc.x, loc.y)]);
+                getValue(loc, &row[loc.x]);
+        }
+    }
+    //A function with signature "void GetValue(Vector2u index, ArrayType* outNewValue)".
+    //It must be safe to call from several threads at once.
+    template<typename Func>
+    //Fills every element using the given function, splitting the rows across the given number of threads.
+    void FillFunc(Func getValue, unsigned int nThreads)
+    {
+        ThreadPool::GetGlobalPool().RunChunks(height, Mathf::Max(nThreads, (unsigned int)1),
+                                              [this, &getValue](unsigned int chunk, unsigned int startY, unsigned int endY)
+        {
+            Vector2u loc;
+            for (loc.y = startY; loc.y < endY; ++loc.y)
+            {
+                ArrayType* row = GetRow(loc.y);
+                for (loc.x = 0; loc.x < width; ++loc.x)
+                    getValue(loc, &row[loc.x]);
+            }
+        });
     }
 
     //Sets the given array to be a rotated version of this array.
@@ -257,7 +368,7 @@ public:
         {
             case 0:
                 outArray.Reset(width, height);
-                outArray.Fill(arrayVals, useFastCopy);
+                CopyRows(arrayVals, pitch, outArray.arrayVals, outArray.pitch, useFastCopy);
                 break;
 
             case 1:
@@ -271,7 +382,7 @@ public:
                 break;
 
             case 2:
-                outArray.Reset(height, width);
+                outArray.Reset(width, height);
                 outArray.FillFunc([thisA](Vector2u loc, ArrayType * outValue)
                 {
                     *outValue = thisA->operator[](Vector2u(thisA->GetWidth() - 1 - loc.x,
@@ -298,42 +409,110 @@ public:
     {
         if (width != newWidth || height != newHeight)
         {
-            //Create a copy of this array.
-            Array2D<ArrayType> cpy(width, height);
-            cpy.Fill(arrayVals, true);
+            assert(ownsValues); //External memory can't be resized.
 
-            //Resize this array and fill it with the old values.
-            Reset(newWidth, newHeight, defaultVal);
-            Fill(cpy);
+            //Create the resized array, fill it with the old values, and then replace this array with it.
+            Array2D<ArrayType> resized(1, 1);
+            resized.SetRowPadding(padRows);
+            resized.Reset(newWidth, newHeight, defaultVal);
+            resized.Fill(*this);
+
+            *this = std::move(resized);
         }
     }
 
 
     //Gets a pointer to the first element in this array.
+    //If the rows are padded, use "GetRowPitch" to find the start of each row.
     const ArrayType* GetArray(void) const { return arrayVals; }
     //Gets a pointer to the first element in this array.
+    //If the rows are padded, use "GetRowPitch" to find the start of each row.
     ArrayType* GetArray(void) { return arrayVals; }
+
+    //Gets whether this array allocated its own memory,
+    //    as opposed to using external memory (e.x. a memory-mapped file).
+    bool OwnsValues(void) const { return ownsValues; }
     
     //Copies this array into the given one using "memcpy", which is as fast as possible.
-    //Assumes the given array is the same size as this one.
+    //Assumes the given array is a contiguous (unpadded) array with the same size as this one.
     void MemCopyInto(ArrayType* outValues) const
     {
-        memcpy(outValues, arrayVals, width * height * sizeof(ArrayType));
+        CopyRows(arrayVals, pitch, outValues, width, true);
     }
     //Copies this array into the given one using the assignment operator for each value.
-    //Assumes it is the same size as this array.
+    //Assumes the given array is a contiguous (unpadded) array with the same size as this one.
     //Use this instead of "MemCopyInto" if the items are too complex to just copy their byte-data over.
 	void CopyInto(ArrayType* outValues) const
 	{
-        for (unsigned int i = 0; i < width * height; ++i)
-			outValues[i] = arrayVals[i];
+        CopyRows(arrayVals, pitch, outValues, width, false);
 	}
 
 
 private:
 
+    //Gets the number of elements from the start of one row to the start of the next
+    //    for an array of the given width.
+    static unsigned int GetRowPitch(unsigned int width, bool padRows)
+    {
+        if (!padRows)
+            return width;
+
+        //Find the smallest number of elements that takes up a multiple of "RowAlignment" bytes.
+        unsigned int a = RowAlignment,
+                     b = sizeof(ArrayType);
+        while (b != 0)
+        {
+            unsigned int temp = a % b;
+            a = b;
+            b = temp;
+        }
+        unsigned int step = RowAlignment / a;
+
+        return ((width + step - 1) / step) * step;
+    }
+
+    //Copies the rows of this array's size from one buffer to another.
+    //Each buffer has the given number of elements from the start of one row to the start of the next.
+    void CopyRows(const ArrayType* src, unsigned int srcPitch, ArrayType* dest, unsigned int destPitch,
+                  bool useMemcpy) const
+    {
+        //If neither buffer is padded, copy everything at once.
+        if (srcPitch == width && destPitch == width)
+        {
+            if (useMemcpy)
+                memcpy(dest, src, width * height * sizeof(ArrayType));
+            else for (unsigned int i = 0; i < width * height; ++i)
+                dest[i] = src[i];
+            return;
+        }
+
+        for (unsigned int y = 0; y < height; ++y)
+        {
+            const ArrayType* srcRow = src + (y * srcPitch);
+            ArrayType* destRow = dest + (y * destPitch);
+
+            if (useMemcpy)
+                memcpy(destRow, srcRow, width * sizeof(ArrayType));
+            else for (unsigned int x = 0; x < width; ++x)
+                destRow[x] = srcRow[x];
+        }
+    }
+
+
     unsigned int width, height;
+    //The number of elements from the start of one row to the start of the next.
+    unsigned int pitch;
+    //Whether rows are padded out to "RowAlignment" bytes.
+    bool padRows;
+
 	ArrayType* arrayVals;
+    //The number of elements "arrayVals" has room for.
+    unsigned int capacity;
+
+    //Whether "arrayVals" was allocated by this array and should be deleted by it.
+    bool ownsValues;
+    //Keeps external memory alive while this array uses it.
+    std::shared_ptr<void> externalOwner;
 };
 
 #pragma warning(default: 4018)
\ No newline at end of file
@@ -1,6 +1,10 @@
 #pragma once
 
 #include "Vectors.h"
+#include "AlignedMemory.h"
+#include "../../ThreadPool.h"
+#include <memory>
+#include <cstring>
 
 #pragma warning(disable: 4018)
 
@@ -11,51 +15,77 @@ template<class ArrayType>
 //    a three-dimensional array.
 //The most cache-efficient way to loop through this array is through
 //    the Z in the outer loop, then the Y in the middle loop, and then the X in the inner loop.
+//The memory is aligned to "AlignedMemory::DefaultAlignment" bytes.
+//Rows can optionally be padded (see "SetRowPadding") so that every row starts on a "RowAlignment"-byte boundary.
 class Array3D
 {
 public:
 
+    //The alignment (in bytes) of the start of each row when rows are padded.
+    static const unsigned int RowAlignment = 32;
+
+
 	//Creates a new Array3D without initializing any of the values.
 	Array3D(unsigned int aWidth, unsigned int aHeight, unsigned int aDepth)
 	{
 		width = aWidth;
 		height = aHeight;
         depth = aDepth;
+        padRows = false;
+        pitch = width;
 
-		arrayVals = new ArrayType[width * height * depth];
+        capacity = width * height * depth;
+		arrayVals = AlignedMemory::New<ArrayType>(capacity);
+        ownsValues = true;
 	}
     Array3D(unsigned int aWidth, unsigned int aHeight, unsigned int aDepth, const ArrayType& defaultValue)
+        : Array3D(aWidth, aHeight, aDepth)
 	{
-		width = aWidth;
+        Fill(defaultValue);
+	}
+
+    //Creates a new Array3D that uses the given memory (e.x. a memory-mapped file)
+    //    instead of allocating its own. The memory must hold at least "aWidth * aHeight * aDepth" elements.
+    //The array never deletes the memory; instead, it holds onto "storageOwner"
+    //    (which may be null) for as long as it uses the memory.
+    //The array can't be reset to a different number of elements.
+    Array3D(unsigned int aWidth, unsigned int aHeight, unsigned int aDepth, ArrayType* externalValues, std::shared_ptr<void> storageOwner)
+        : arrayVals(externalValues), ownsValues(false), externalOwner(storageOwner)
+    {
+        width = aWidth;
         height = aHeight;
         depth = aDepth;
-
-		arrayVals = new ArrayType[width * height * depth];
-
-        for (unsigned int i = 0; i < width * height * depth; ++i)
-		{
-			arrayVals[i] = defaultValue;
-		}
-	}
+        padRows = false;
+        pitch = width;
+        capacity = width * height * depth;
+    }
 
     //Move semantics
-    Array3D(Array3D&& toMove) : arrayVals(0) { *this = std::move(toMove); }
+    Array3D(Array3D&& toMove) : arrayVals(0), capacity(0), ownsValues(false) { *this = std::move(toMove); }
     Array3D& operator=(Array3D&& toMove)
     {
-        if (arrayVals != 0)
+        if (ownsValues)
         {
-            delete[] arrayVals;
+            AlignedMemory::Delete(arrayVals, capacity);
         }
 
         width = toMove.width;
         height = toMove.height;
         depth = toMove.depth;
+        pitch = toMove.pitch;
+        padRows = toMove.padRows;
+        capacity = toMove.capacity;
         arrayVals = toMove.arrayVals;
+        externalOwner = std::move(toMove.externalOwner);
+        ownsValues = toMove.ownsValues;
 
         toMove.width = 0;
         toMove.height = 0;
         toMove.depth = 0;
+        toMove.pitch = 0;
+        toMove.capacity = 0;
         toMove.arrayVals = 0;
+        toMove.ownsValues = false;
 
         return *this;
     }
@@ -66,7 +96,10 @@ public:
 
     ~Array3D(void)
 	{
-		delete[] arrayVals;
+        if (ownsValues)
+        {
+		    AlignedMemory::Delete(arrayVals, capacity);
+        }
 	}
 
 
@@ -85,39 +118,98 @@ public:
 
 
     //Resets this array to the given size and leaves its elements uninitialized.
-    //If the total number of elements doesn't change, then nothing is allocated or un-allocated
-    //    and the elements keep their values.
+    //If the size of each row and the total number of elements don't change,
+    //    the elements keep their values.
+    //Memory is only re-allocated if the array needs more room than it has,
+    //    or if it would be wasting more than half of its memory.
     void Reset(unsigned int _width, unsigned int _height, unsigned int _depth)
 	{
-        if ((width * height * depth) != (_width * _height * _depth))
+        unsigned int newPitch = GetRowPitch(_width, padRows),
+                     needed = newPitch * _height * _depth;
+
+        if (!ownsValues)
+        {
+            //External memory can't be resized.
+            assert(needed == pitch * height * depth);
+        }
+        else if (needed > capacity || (needed * 2) < capacity)
         {
-            assert(arrayVals != 0);
-            delete[] arrayVals;
-            arrayVals = new ArrayType[_width * _height * _depth];
+            AlignedMemory::Delete(arrayVals, capacity);
+            arrayVals = 0;
+            capacity = 0;
+
+            arrayVals = AlignedMemory::New<ArrayType>(needed);
+            capacity = needed;
         }
 
         width = _width;
         height = _height;
         depth = _depth;
+        pitch = newPitch;
 	}
     //Resets this array to the given size, and initializes all elements to the given value.
     void Reset(unsigned int _width, unsigned int _height, unsigned int _depth,
                const ArrayType& newValues)
 	{
 		Reset(_width, _height, _depth);
-        Fill(newValues)
+        Fill(newValues);
 	}
     
 
     //Gets the array index for the given position.
     unsigned int GetIndex(unsigned int x, unsigned int y, unsigned int z) const
     {
-        return x + (y * width) + (z * width * height);
+        return x + (pitch * (y + (z * height)));
     }
     //Gets the location in this array that corresponds to the given index.
     Vector3u GetLocation(unsigned int index) const
     {
-        return Vector3u(index % width, index / width, index / (width * height));
+        unsigned int row = index / pitch;
+        return Vector3u(index % pitch, row % height, row / height);
+    }
+
+
+    //Gets the number of elements from the start of one row to the start of the next.
+    //This is the width unless the rows are padded.
+    unsigned int GetRowPitch(void) const { return pitch; }
+    //Gets the number of elements from the start of one Z slice to the start of the next.
+    unsigned int GetSlicePitch(void) const { return pitch * height; }
+
+    //Gets a pointer to the first element of the given row.
+    //The rest of the row's elements come right after it.
+    ArrayType* GetRow(unsigned int y, unsigned int z) { return arrayVals + GetIndex(0, y, z); }
+    //Gets a pointer to the first element of the given row.
+    //The rest of the row's elements come right after it.
+    const ArrayType* GetRow(unsigned int y, unsigned int z) const { return arrayVals + GetIndex(0, y, z); }
+
+
+    //Gets whether the rows are padded so that each one starts on a "RowAlignment"-byte boundary.
+    bool HasRowPadding(void) const { return padRows; }
+    //Sets whether to pad the end of each row so that every row starts on a "RowAlignment"-byte boundary.
+    //SIMD code can then use aligned loads/stores at the start of each row,
+    //    and it can run whole packs past the end of a row into the padding ("GetRowPitch() - GetWidth()" elements).
+    //Padded arrays aren't contiguous, so they should be indexed with "GetIndex" or "GetRow"
+    //    instead of assuming "x + (width * (y + (z * height)))".
+    //Changing this re-allocates the array, keeping the values of its elements.
+    void SetRowPadding(bool shouldPad)
+    {
+        if (shouldPad == padRows)
+            return;
+        assert(ownsValues); //External memory can't be rearranged.
+
+        unsigned int newPitch = GetRowPitch(width, shouldPad),
+                     newCapacity = newPitch * height * depth;
+        ArrayType* newVals = AlignedMemory::New<ArrayType>(newCapacity);
+        for (unsigned int z = 0; z < depth; ++z)
+            for (unsigned int y = 0; y < height; ++y)
+                for (unsigned int x = 0; x < width; ++x)
+                    newVals[x + (newPitch * (y + (z * height)))] = arrayVals[GetIndex(x, y, z)];
+
+        AlignedMemory::Delete(arrayVals, capacity);
+        arrayVals = newVals;
+        capacity = newCapacity;
+        pitch = newPitch;
+        padRows = shouldPad;
     }
 
 
@@ -138,7 +230,7 @@ public:
     //Clamps the given index to be inside the range of allowable indices for this array.
     Vector3f Clamp(Vector3f in) const
     {
-        return Vector3f(Mathf::Clamp<float>(in.x, 0.0f, GetWidth - 1),
+        return Vector3f(Mathf::Clamp<float>(in.x, 0.0f, GetWidth() - 1),
                         Mathf::Clamp<float>(in.y, 0.0f, GetHeight() - 1),
                         Mathf::Clamp<float>(in.z, 0.0f, GetDepth() - 1));
     }
@@ -159,7 +251,7 @@ public:
     //Wraps the given index around the range of allowable indices for this array.
     Vector3u Wrap(Vector3u in) const
     {
-        return Vector3u(in.x % GetWidth(), in.y % GetHeight(), inZ % GetDepth());
+        return Vector3u(in.x % GetWidth(), in.y % GetHeight(), in.z % GetDepth());
     }
     //Wraps the given index around the range of allowable indices for this array.
     Vector3f Wrap(Vector3f in) const
@@ -171,9 +263,9 @@ public:
         while (in.y < 0.0f) in.y += fDims.y;
         while (in.z < 0.0f) in.z += fDims.z;
 
-        in.x %= GetWidth();
-        in.y %= GetHeight();
-        in.z %= GetDepth();
+        in.x = fmodf(in.x, fDims.x);
+        in.y = fmodf(in.y, fDims.y);
+        in.z = fmodf(in.z, fDims.z);
 
         return in;
     }
@@ -196,10 +288,18 @@ public:
 	//Fills every element with the given value.
 	void Fill(const ArrayType& value)
 	{
-        for (int i = (width * height * depth) - 1; i >= 0; --i)
-		{
+        for (unsigned int i = 0; i < pitch * height * depth; ++i)
 			arrayVals[i] = value;
-		}
+    }
+    //Fills every element with the given value, splitting the rows across the given number of threads.
+    void Fill(const ArrayType& value, unsigned int nThreads)
+    {
+        ThreadPool::GetGlobalPool().RunChunks(height * depth, Mathf::Max(nThreads, (unsigned int)1),
+                                              [this, &value](unsigned int chunk, unsigned int startRow, unsigned int endRow)
+        {
+            for (unsigned int i = startRow * pitch; i < endRow * pitch; ++i)
+                arrayVals[i] = value;
+        });
     }
     //Copies the given array into this one. The given array may be offset a certain amount.
     //Any values of the given array that don't correspond to a value in this array are ignored.
@@ -207,29 +307,29 @@ public:
     {
         Vector3i offsetLoc;
 
-        for (Vector3u loc; loc.z < depth; ++loc.z)
+        for (Vector3u loc; loc.z < toCopy.depth; ++loc.z)
         {
             offsetLoc.z = (int)loc.z + copyOffset.z;
 
             if (offsetLoc.z < 0)
                 continue;
-            if (offsetLoc.z >= depth)
+            if (offsetLoc.z >= (int)depth)
                 break;
 
-            for (loc.y = 0; loc.y < height; ++loc.y)
+            for (loc.y = 0; loc.y < toCopy.height; ++loc.y)
             {
                 offsetLoc.y = (int)loc.y + copyOffset.y;
 
                 if (offsetLoc.y < 0)
                     continue;
-                if (offsetLoc.y >= height)
+                if (offsetLoc.y >= (int)height)
                     break;
 
-                for (loc.x = 0; loc.x < width; ++loc.x)
+                for (loc.x = 0; loc.x < toCopy.width; ++loc.x)
                 {
                     offsetLoc.x = (int)loc.x + copyOffset.x;
 
-                    if (offsetLoc.x >= width)
+                    if (offsetLoc.x >= (int)width)
                         break;
 
                     if (offsetLoc.x >= 0)
@@ -239,16 +339,12 @@ public:
         }
     }
     //Copies the given elements to this array.
-    //Assumes that the size of this array matches with the given one.
+    //Assumes that the given elements are a contiguous (unpadded) array with the same size as this one.
     //If "useMemcpy" is true, this array will have its exact binary data quickly copied using memcpy().
     //Otherwise, each element will be individually set using the assignment operator.
     void Fill(const ArrayType* values, bool useMemcpy)
     {
-        if (useMemcpy)
-            memcpy(arrayVals, values, width * height * sizeof(ArrayType));
-
-        else for (unsigned int i = 0; i < (width * height); ++i)
-            arrayVals[i] = values[i];
+        CopyRows(values, width, arrayVals, pitch, useMemcpy);
     }
 
     //A function with signature "void GetValue(Vector3u index, ArrayType* outNewValue)".
@@ -258,9 +354,36 @@ public:
     {
         Vector3u loc;
         for (loc.z = 0; loc.z < depth; ++loc.z)
+        {
             for (loc.y = 0; loc.y < height; ++loc.y)
+            {
+                ArrayType* row = GetRow(loc.y, loc.z);
                 for (loc.x = 0; loc.x < width; ++loc.x)
-                    getValue(loc, &arrayVals[GetIndex(loc.x, loc.y, loc.z)]);
+                    getValue(loc, &row[loc.x]);
+            }
+        }
+    }
+    //A function with signature "void GetValue(Vector3u index, ArrayType* outNewValue)".
+    //It must be safe to call from several threads at once.
+    template<typename Func>
+    //Sets every element using the given function, splitting the rows (across every Z slice)
+    //    between the given number of threads.
+    void FillFunc(Func getValue, unsigned int nThreads)
+    {
+        ThreadPool::GetGlobalPool().RunChunks(height * depth, Mathf::Max(nThreads, (unsigned int)1),
+                                              [this, &getValue](unsigned int chunk, unsigned int startRow, unsigned int endRow)
+        {
+            Vector3u loc;
+            for (unsigned int row = startRow; row < endRow; ++row)
+            {
+                loc.y = row % height;
+                loc.z = row / height;
+
+                ArrayType* rowVals = GetRow(loc.y, loc.z);
+                for (loc.x = 0; loc.x < width; ++loc.x)
+                    getValue(loc, &rowVals[loc.x]);
+            }
+        });
     }
 
     //Resizes this array to the given size, preserving all data
@@ -269,43 +392,114 @@ public:
     void Resize(unsigned int newWidth, unsigned int newHeight, unsigned int newDepth,
                 const ArrayType& defaultVal)
     {
-        if (width != newWi || height != newHeight || depth != newDepth)
+        if (width != newWidth || height != newHeight || depth != newDepth)
         {
-            //Create a new version of this array with the new values.
-            Array3D<ArrayType> newArr(newWidth, newHeight, newDepth);
-            newArr.Fill(*this, defaultVal);
+            assert(ownsValues); //External memory can't be resized.
 
-            //Fill this array with those values.
-            Reset(newWidth, newHeight, newDepth);
-            Fill(newArr, defaultValue);
+            //Create the resized array, fill it with the old values, and then replace this array with it.
+            Array3D<ArrayType> resized(1, 1, 1);
+            resized.SetRowPadding(padRows);
+            resized.Reset(newWidth, newHeight, newDepth, defaultVal);
+            resized.Fill(*this);
+
+            *this = std::move(resized);
         }
     }
 
 
     //Gets a pointer to the first element in this array.
+    //If the rows are padded, use "GetRowPitch" to find the start of each row.
     const ArrayType* GetArray(void) const { return arrayVals; }
     //Gets a pointer to the first element in this array.
+    //If the rows are padded, use "GetRowPitch" to find the start of each row.
     ArrayType* GetArray(void) { return arrayVals; }
 
+    //Gets whether this array allocated its own memory,
+    //    as opposed to using external memory (e.x. a memory-mapped file).
+    bool OwnsValues(void) const { return ownsValues; }
+
     //Copies this array into the given one using "memcpy", which is as fast as possible.
-    //Assumes the given array is the same size as this one.
+    //Assumes the given array is a contiguous (unpadded) array with the same size as this one.
     void MemCopyInto(ArrayType* outValues) const
     {
-        memcpy(outValues, arrayVals, width * height * depth * sizeof(ArrayType));
+        CopyRows(arrayVals, pitch, outValues, width, true);
     }
-    //Copies this array into the given one. Assumes it is the same size as this array.
+    //Copies this array into the given one.
+    //Assumes the given array is a contiguous (unpadded) array with the same size as this one.
     //Use this instead of "MemCopyInto" if the items are too complex to just copy their byte-data over.
 	void CopyInto(ArrayType* outValues) const
 	{
-        for (unsigned int i = 0; i < width * height * depth; ++i)
-			outValues[i] = arrayVals[i];
+        CopyRows(arrayVals, pitch, outValues, width, false);
 	}
 
 
 private:
 
+    //Gets the number of elements from the start of one row to the start of the next
+    //    for an array of the given width.
+    static unsigned int GetRowPitch(unsigned int width, bool padRows)
+    {
+        if (!padRows)
+            return width;
+
+        //Find the smallest number of elements that takes up a multiple of "RowAlignment" bytes.
+        unsigned int a = RowAlignment,
+                     b = sizeof(ArrayType);
+        while (b != 0)
+        {
+            unsigned int temp = a % b;
+            a = b;
+            b = temp;
+        }
+        unsigned int step = RowAlignment / a;
+
+        return ((width + step - 1) / step) * step;
+    }
+
+    //Copies the rows of this array's size from one buffer to another.
+    //Each buffer has the given number of elements from the start of one row to the start of the next,
+    //    and its Z slices are packed right after each other.
+    void CopyRows(const ArrayType* src, unsigned int srcPitch, ArrayType* dest, unsigned int destPitch,
+                  bool useMemcpy) const
+    {
+        //If neither buffer is padded, copy everything at once.
+        unsigned int nRows = height * depth;
+        if (srcPitch == width && destPitch == width)
+        {
+            if (useMemcpy)
+                memcpy(dest, src, width * nRows * sizeof(ArrayType));
+            else for (unsigned int i = 0; i < width * nRows; ++i)
+                dest[i] = src[i];
+            return;
+        }
+
+        for (unsigned int row = 0; row < nRows; ++row)
+        {
+            const ArrayType* srcRow = src + (row * srcPitch);
+            ArrayType* destRow = dest + (row * destPitch);
+
+            if (useMemcpy)
+                memcpy(destRow, srcRow, width * sizeof(ArrayType));
+            else for (unsigned int x = 0; x < width; ++x)
+                destRow[x] = srcRow[x];
+        }
+    }
+
+
     unsigned int width, height, depth;
+    //The number of elements from the start of one row to the start of the next.
+    unsigned int pitch;
+    //Whether rows are padded out to "RowAlignment" bytes.
+    bool padRows;
+
 	ArrayType* arrayVals;
+    //The number of elements "arrayVals" has room for.
+    unsigned int capacity;
+
+    //Whether "arrayVals" was allocated by this array and should be deleted by it.
+    bool ownsValues;
+    //Keeps external memory alive while this array uses it.
+    std::shared_ptr<void> externalOwner;
 };
 
 #pragma warning(default: 4018)
\ No newline at end of file
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <string.h>
+#include "SIMD.h"
+
+
+//A 16-bit ("half-precision") floating-point number, stored as its raw bits.
+//This is the same format OpenGL uses for "GL_HALF_FLOAT" data.
+//It has about 3 decimal digits of precision and a max value of 65504,
+//    which is enough for most noise and height data at half the size of a normal float.
+struct HalfFloat
+{
+public:
+
+    //Converts the given float to the nearest half-float, rounding ties to even.
+    //Values too large to fit become infinity.
+    //NaN stays NaN with the same sign; like F16C, it keeps the top bits of its payload and becomes a quiet NaN.
+    //Based on Fabian Giesen's "float_to_half_fast3_rtne".
+    static unsigned short ToBits(float f)
+    {
+        unsigned int fBits;
+        memcpy(&fBits, &f, sizeof(float));
+
+        unsigned int sign = fBits & 0x80000000U;
+        fBits ^= sign;
+
+        unsigned int outBits;
+        if (fBits >= HalfMaxBits)
+        {
+            //Infinity or NaN.
+            outBits = (fBits > FloatInfinityBits) ? (HalfQuietNaNBits | ((fBits >> 13) & 0x3ffU)) : 0x7c00U;
+        }
+        else if (fBits < HalfMinNormalBits)
+        {
+            //A denormalized half or zero. Adding a "magic" value lets the FPU do the rounding.
+            float magic = GetDenormMagic(),
+                  fAbs;
+            memcpy(&fAbs, &fBits, sizeof(float));
+            fAbs += magic;
+            memcpy(&outBits, &fAbs, sizeof(float));
+            outBits -= DenormMagicBits;
+        }
+        else
+        {
+            //A normalized half. Re-bias the exponent and round the mantissa.
+            unsigned int isMantissaOdd = (fBits >> 13) & 1;
+            fBits += ExponentRebias + 0xfffU + isMantissaOdd;
+            outBits = fBits >> 13;
+        }
+
+        return (unsigned short)(outBits | (sign >> 16));
+    }
+    //Converts each float in the given pack to a half-float, exactly like the scalar "ToBits".
+    //Each half-float is stored in the bottom 16 bits of its integer.
+    static SIMDInts ToBits(const SIMDFloats& f)
+    {
+        SIMDInts fBits = f.AsInts(),
+                 sign = fBits & SIMDInts((int)0x80000000U);
+        fBits = fBits ^ sign;
+
+        //After the sign is removed, the bits can be compared as signed integers.
+        SIMDInts infOrNaN = SIMDInts::Select(fBits.GreaterThan(SIMDInts((int)FloatInfinityBits)),
+                                             SIMDInts((int)HalfQuietNaNBits) |
+                                                 (fBits.ShiftRightLogical(13) & SIMDInts(0x3ff)),
+                                             SIMDInts(0x7c00)),
+                 denorm = (fBits.AsFloats() + SIMDFloats(GetDenormMagic())).AsInts() -
+                              SIMDInts((int)DenormMagicBits),
+                 normal = (fBits + SIMDInts((int)ExponentRebias + 0xfff) +
+                           (fBits.ShiftRightLogical(13) & SIMDInts(1))).ShiftRightLogical(13);
+
+        SIMDInts outBits = SIMDInts::Select(fBits.GreaterThan(SIMDInts((int)HalfMaxBits - 1)),
+                                            infOrNaN,
+                                            SIMDInts::Select(SIMDInts((int)HalfMinNormalBits).GreaterThan(fBits),
+                                                             denorm, normal));
+        return outBits | sign.ShiftRightLogical(16);
+    }
+
+    //Converts the given half-float back to a float. Every half-float can be represented exactly,
+    //    except that (like F16C) a signaling NaN becomes a quiet one.
+    //Based on Fabian Giesen's "half_to_float".
+    static float ToFloat(unsigned short bits)
+    {
+        const unsigned int shiftedExponent = 0x7c00U << 13;
+
+        unsigned int outBits = ((unsigned int)bits & 0x7fffU) << 13,
+                     exponent = outBits & shiftedExponent;
+        outBits += (127 - 15) << 23;
+
+        if (exponent == shiftedExponent)
+        {
+            //Infinity or NaN.
+            outBits += (128 - 16) << 23;
+            if ((bits & 0x3ffU) != 0)
+                outBits |= FloatQuietNaNBit;
+        }
+        else if (exponent == 0)
+        {
+            //Zero or a denormalized half; renormalize it.
+            outBits += 1 << 23;
+            float magic, outF;
+            unsigned int magicBits = 113 << 23;
+            memcpy(&magic, &magicBits, sizeof(float));
+            memcpy(&outF, &outBits, sizeof(float));
+            outF -= magic;
+            memcpy(&outBits, &outF, sizeof(float));
+        }
+
+        outBits |= ((unsigned int)bits & 0x8000U) << 16;
+
+        float outF;
+        memcpy(&outF, &outBits, sizeof(float));
+        return outF;
+    }
+
+
+    unsigned short Bits;
+
+    HalfFloat(void) : Bits(0) { }
+    explicit HalfFloat(float f) : Bits(ToBits(f)) { }
+
+    float ToFloat(void) const { return ToFloat(Bits); }
+
+
+private:
+
+    //The bits of a float with the smallest magnitude that is too big for a half-float.
+    static const unsigned int HalfMaxBits = (127 + 16) << 23;
+    //The bits of the smallest float that is a normalized half-float.
+    static const unsigned int HalfMinNormalBits = 113 << 23;
+    static const unsigned int FloatInfinityBits = 255 << 23;
+    //The bits of a positive, quiet half-float NaN with an empty payload.
+    static const unsigned int HalfQuietNaNBits = 0x7e00U;
+    //The bit that marks a float NaN as quiet.
+    static const unsigned int FloatQuietNaNBit = 0x400000U;
+    //The bits of the float that moves a denormalized half-float's mantissa into the bottom bits.
+    static const unsigned int DenormMagicBits = ((127 - 15) + (23 - 10) + 1) << 23;
+    //Changes a float's exponent bias to a half-float's, with the exponent still in the float's position.
+    static const unsigned int ExponentRebias = (unsigned int)(15 - 127) << 23;
+
+    static float GetDenormMagic(void)
+    {
+        float magic;
+        unsigned int magicBits = DenormMagicBits;
+        memcpy(&magic, &magicBits, sizeof(float));
+        return magic;
+    }
+};
@@ -0,0 +1,83 @@
+#pragma once
+
+#include "SIMD.h"
+
+
+//A counter-based PRNG: each random value is just a hash of a seed and an integer position,
+//    so values don't depend on each other and can be computed in any order, in parallel, or in SIMD packs.
+//Unlike "FastRand", nothing needs to be constructed or seeded for each value.
+//Only uses 32-bit unsigned integer math and exact int-to-float conversions,
+//    so every platform and compiler gives bit-identical values.
+namespace HashRand
+{
+    //Scrambles the bits of the given value.
+    //This is Chris Wellons' "lowbias32" integer hash.
+    inline unsigned int Mix(unsigned int x)
+    {
+        x ^= x >> 16;
+        x *= 0x7feb352dU;
+        x ^= x >> 15;
+        x *= 0x846ca68bU;
+        x ^= x >> 16;
+        return x;
+    }
+    //Scrambles the bits of each value in the given pack, exactly like the scalar "Mix".
+    inline SIMDInts Mix(SIMDInts x)
+    {
+        x = x ^ x.ShiftRightLogical(16);
+        x = x * SIMDInts((int)0x7feb352dU);
+        x = x ^ x.ShiftRightLogical(15);
+        x = x * SIMDInts((int)0x846ca68bU);
+        x = x ^ x.ShiftRightLogical(16);
+        return x;
+    }
+
+
+    //Gets the hash of the given seed and position.
+    //Each coordinate is folded into the hash of the ones after it, so the X coordinate is mixed in last.
+    //This means a whole row of values along X only costs one "Mix" per value.
+    inline unsigned int Hash(int seed, int x) { return Mix((unsigned int)x + Mix((unsigned int)seed)); }
+    inline unsigned int Hash(int seed, int x, int y) { return Hash((int)Hash(seed, y), x); }
+    inline unsigned int Hash(int seed, int x, int y, int z) { return Hash((int)Hash(seed, y, z), x); }
+    inline unsigned int Hash(int seed, int x, int y, int z, int w) { return Hash((int)Hash(seed, y, z, w), x); }
+
+
+    //Converts the given hash into a float from 0 to 1 (not including 1).
+    //Uses the top 24 bits of the hash, which a float can hold exactly,
+    //    and scales them by a power of two, which is also exact.
+    inline float ToZeroToOne(unsigned int hash) { return (float)(int)(hash >> 8) * (1.0f / 16777216.0f); }
+    inline SIMDFloats ToZeroToOne(SIMDInts hash) { return hash.ShiftRightLogical(8).ToFloats() * SIMDFloats(1.0f / 16777216.0f); }
+
+    //Gets a random float from 0 to 1 (not including 1) for the given seed and position.
+    inline float GetZeroToOne(int seed, int x) { return ToZeroToOne(Hash(seed, x)); }
+    inline float GetZeroToOne(int seed, int x, int y) { return ToZeroToOne(Hash(seed, x, y)); }
+    inline float GetZeroToOne(int seed, int x, int y, int z) { return ToZeroToOne(Hash(seed, x, y, z)); }
+    inline float GetZeroToOne(int seed, int x, int y, int z, int w) { return ToZeroToOne(Hash(seed, x, y, z, w)); }
+
+
+    //Fills "outValues" with the random 0-1 values for positions "startX" through "startX + count - 1",
+    //    exactly as "GetZeroToOne(seed, x)" would give them.
+    //Whole packs of values are computed at once with SIMD.
+    inline void FillRow(float* outValues, unsigned int count, int seed, int startX)
+    {
+        SIMDInts rowHash((int)Mix((unsigned int)seed));
+
+        unsigned int i = 0;
+        for (; i + SIMDInts::Width <= count; i += SIMDInts::Width)
+            ToZeroToOne(Mix(SIMDInts::Range(startX + (int)i) + rowHash)).Store(outValues + i);
+        for (; i < count; ++i)
+            outValues[i] = GetZeroToOne(seed, startX + (int)i);
+    }
+    //Fills "outValues" with the random 0-1 values for positions {startX, y} through {startX + count - 1, y},
+    //    exactly as "GetZeroToOne(seed, x, y)" would give them.
+    inline void FillRow(float* outValues, unsigned int count, int seed, int startX, int y)
+    {
+        FillRow(outValues, count, (int)Hash(seed, y), startX);
+    }
+    //Fills "outValues" with the random 0-1 values for positions {startX, y, z} through {startX + count - 1, y, z},
+    //    exactly as "GetZeroToOne(seed, x, y, z)" would give them.
+    inline void FillRow(float* outValues, unsigned int count, int seed, int startX, int y, int z)
+    {
+        FillRow(outValues, count, (int)Hash(seed, y, z), startX);
+    }
+}
@@ -0,0 +1,248 @@
+#pragma once
+
+//Thin wrappers around the SSE2/AVX2 intrinsics.
+//If the program is compiled with AVX2 enabled ("/arch:AVX2"), each pack holds 8 values.
+//Otherwise, each pack holds 4 values using SSE2, which every x86/x64 target supports.
+
+#if defined(__AVX2__)
+    #include <immintrin.h>
+    #define MANBIL_SIMD_WIDTH 8
+#else
+    #include <emmintrin.h>
+    #define MANBIL_SIMD_WIDTH 4
+#endif
+
+
+struct SIMDFloats;
+
+
+//A pack of 32-bit integers that are operated on together.
+struct SIMDInts
+{
+public:
+
+    static const unsigned int Width = MANBIL_SIMD_WIDTH;
+
+#if MANBIL_SIMD_WIDTH == 8
+    __m256i Values;
+
+    SIMDInts(void) { }
+    SIMDInts(__m256i values) : Values(values) { }
+    SIMDInts(int value) : Values(_mm256_set1_epi32(value)) { }
+
+    //Gets the values {start, start + 1, start + 2, ...}.
+    static SIMDInts Range(int start) { return SIMDInts(_mm256_add_epi32(_mm256_set1_epi32(start),
+                                                                         _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7))); }
+
+    static SIMDInts Load(const int* values) { return SIMDInts(_mm256_loadu_si256((const __m256i*)values)); }
+    void Store(int* outValues) const { _mm256_storeu_si256((__m256i*)outValues, Values); }
+
+    SIMDInts operator+(const SIMDInts& other) const { return SIMDInts(_mm256_add_epi32(Values, other.Values)); }
+    SIMDInts operator-(const SIMDInts& other) const { return SIMDInts(_mm256_sub_epi32(Values, other.Values)); }
+    SIMDInts operator*(const SIMDInts& other) const { return SIMDInts(_mm256_mullo_epi32(Values, other.Values)); }
+    SIMDInts operator^(const SIMDInts& other) const { return SIMDInts(_mm256_xor_si256(Values, other.Values)); }
+    SIMDInts operator&(const SIMDInts& other) const { return SIMDInts(_mm256_and_si256(Values, other.Values)); }
+    SIMDInts operator|(const SIMDInts& other) const { return SIMDInts(_mm256_or_si256(Values, other.Values)); }
+    SIMDInts ShiftLeft(int bits) const { return SIMDInts(_mm256_slli_epi32(Values, bits)); }
+    SIMDInts ShiftRightLogical(int bits) const { return SIMDInts(_mm256_srli_epi32(Values, bits)); }
+    SIMDInts ShiftRightArithmetic(int bits) const { return SIMDInts(_mm256_srai_epi32(Values, bits)); }
+
+    //Gets -1 (all bits set) for each element that's larger than the other one, and 0 for the rest.
+    SIMDInts GreaterThan(const SIMDInts& other) const { return SIMDInts(_mm256_cmpgt_epi32(Values, other.Values)); }
+
+    //For each element, picks the value from "ifTrue" where "mask" is -1, and from "ifFalse" where it's 0.
+    static SIMDInts Select(const SIMDInts& mask, const SIMDInts& ifTrue, const SIMDInts& ifFalse)
+    {
+        return SIMDInts(_mm256_or_si256(_mm256_and_si256(mask.Values, ifTrue.Values),
+                                        _mm256_andnot_si256(mask.Values, ifFalse.Values)));
+    }
+#else
+    __m128i Values;
+
+    SIMDInts(void) { }
+    SIMDInts(__m128i values) : Values(values) { }
+    SIMDInts(int value) : Values(_mm_set1_epi32(value)) { }
+
+    //Gets the values {start, start + 1, start + 2, ...}.
+    static SIMDInts Range(int start) { return SIMDInts(_mm_add_epi32(_mm_set1_epi32(start),
+                                                                      _mm_setr_epi32(0, 1, 2, 3))); }
+
+    static SIMDInts Load(const int* values) { return SIMDInts(_mm_loadu_si128((const __m128i*)values)); }
+    void Store(int* outValues) const { _mm_storeu_si128((__m128i*)outValues, Values); }
+
+    SIMDInts operator+(const SIMDInts& other) const { return SIMDInts(_mm_add_epi32(Values, other.Values)); }
+    SIMDInts operator-(const SIMDInts& other) const { return SIMDInts(_mm_sub_epi32(Values, other.Values)); }
+    SIMDInts operator*(const SIMDInts& other) const
+    {
+        //SSE2 has no 32-bit "mullo", so multiply the even and odd lanes separately and shuffle them together.
+        __m128i evens = _mm_mul_epu32(Values, other.Values),
+                odds = _mm_mul_epu32(_mm_srli_si128(Values, 4), _mm_srli_si128(other.Values, 4));
+        return SIMDInts(_mm_unpacklo_epi32(_mm_shuffle_epi32(evens, _MM_SHUFFLE(0, 0, 2, 0)),
+                                           _mm_shuffle_epi32(odds, _MM_SHUFFLE(0, 0, 2, 0))));
+    }
+    SIMDInts operator^(const SIMDInts& other) const { return SIMDInts(_mm_xor_si128(Values, other.Values)); }
+    SIMDInts operator&(const SIMDInts& other) const { return SIMDInts(_mm_and_si128(Values, other.Values)); }
+    SIMDInts operator|(const SIMDInts& other) const { return SIMDInts(_mm_or_si128(Values, other.Values)); }
+    SIMDInts ShiftLeft(int bits) const { return SIMDInts(_mm_slli_epi32(Values, bits)); }
+    SIMDInts ShiftRightLogical(int bits) const { return SIMDInts(_mm_srli_epi32(Values, bits)); }
+    SIMDInts ShiftRightArithmetic(int bits) const { return SIMDInts(_mm_srai_epi32(Values, bits)); }
+
+    //Gets -1 (all bits set) for each element that's larger than the other one, and 0 for the rest.
+    SIMDInts GreaterThan(const SIMDInts& other) const { return SIMDInts(_mm_cmpgt_epi32(Values, other.Values)); }
+
+    //For each element, picks the value from "ifTrue" where "mask" is -1, and from "ifFalse" where it's 0.
+    static SIMDInts Select(const SIMDInts& mask, const SIMDInts& ifTrue, const SIMDInts& ifFalse)
+    {
+        return SIMDInts(_mm_or_si128(_mm_and_si128(mask.Values, ifTrue.Values),
+                                     _mm_andnot_si128(mask.Values, ifFalse.Values)));
+    }
+#endif
+
+    //Converts each integer to a float.
+    SIMDFloats ToFloats(void) const;
+    //Reinterprets the bits of each integer as a float, without converting anything.
+    SIMDFloats AsFloats(void) const;
+};
+
+
+//A pack of floats that are operated on together.
+//The arithmetic operators round exactly like the equivalent scalar float operations,
+//    so a SIMD version of a calculation gives the same results as the scalar one
+//    as long as it does the same operations in the same order.
+struct SIMDFloats
+{
+public:
+
+    static const unsigned int Width = MANBIL_SIMD_WIDTH;
+
+#if MANBIL_SIMD_WIDTH == 8
+    __m256 Values;
+
+    SIMDFloats(void) { }
+    SIMDFloats(__m256 values) : Values(values) { }
+    SIMDFloats(float value) : Values(_mm256_set1_ps(value)) { }
+
+    static SIMDFloats Load(const float* values) { return SIMDFloats(_mm256_loadu_ps(values)); }
+    void Store(float* outValues) const { _mm256_storeu_ps(outValues, Values); }
+
+    //Loads "values[indices[i] * stride]" into each element "i".
+    static SIMDFloats Gather(const float* values, const int* indices, int stride)
+    {
+        return SIMDFloats(_mm256_i32gather_ps(values, _mm256_mullo_epi32(_mm256_loadu_si256((const __m256i*)indices),
+                                                                         _mm256_set1_epi32(stride)),
+                                              4));
+    }
+
+    SIMDFloats operator+(const SIMDFloats& other) const { return SIMDFloats(_mm256_add_ps(Values, other.Values)); }
+    SIMDFloats operator-(const SIMDFloats& other) const { return SIMDFloats(_mm256_sub_ps(Values, other.Values)); }
+    SIMDFloats operator*(const SIMDFloats& other) const { return SIMDFloats(_mm256_mul_ps(Values, other.Values)); }
+    SIMDFloats operator/(const SIMDFloats& other) const { return SIMDFloats(_mm256_div_ps(Values, other.Values)); }
+
+    //If either element is NaN, the element from "b" is used.
+    static SIMDFloats Min(const SIMDFloats& a, const SIMDFloats& b) { return SIMDFloats(_mm256_min_ps(a.Values, b.Values)); }
+    static SIMDFloats Max(const SIMDFloats& a, const SIMDFloats& b) { return SIMDFloats(_mm256_max_ps(a.Values, b.Values)); }
+
+    //Converts each float to an integer by truncating it towards 0.
+    SIMDInts Truncate(void) const { return SIMDInts(_mm256_cvttps_epi32(Values)); }
+    //Converts each float to an integer by rounding it down.
+    SIMDInts Floor(void) const
+    {
+        //Truncating rounds negative numbers up, so subtract 1 from those (a "true" comparison is all 1 bits, i.e. -1).
+        __m256i truncated = _mm256_cvttps_epi32(Values);
+        __m256 isRoundedUp = _mm256_cmp_ps(_mm256_cvtepi32_ps(truncated), Values, _CMP_GT_OQ);
+        return SIMDInts(_mm256_add_epi32(truncated, _mm256_castps_si256(isRoundedUp)));
+    }
+
+    //Gets -1 (all bits set) for each element that's larger than the other one, and 0 for the rest.
+    SIMDInts GreaterThan(const SIMDFloats& other) const
+    {
+        return SIMDInts(_mm256_castps_si256(_mm256_cmp_ps(Values, other.Values, _CMP_GT_OQ)));
+    }
+#else
+    __m128 Values;
+
+    SIMDFloats(void) { }
+    SIMDFloats(__m128 values) : Values(values) { }
+    SIMDFloats(float value) : Values(_mm_set1_ps(value)) { }
+
+    static SIMDFloats Load(const float* values) { return SIMDFloats(_mm_loadu_ps(values)); }
+    void Store(float* outValues) const { _mm_storeu_ps(outValues, Values); }
+
+    //Loads "values[indices[i] * stride]" into each element "i".
+    static SIMDFloats Gather(const float* values, const int* indices, int stride)
+    {
+        return SIMDFloats(_mm_setr_ps(values[indices[0] * stride], values[indices[1] * stride],
+                                      values[indices[2] * stride], values[indices[3] * stride]));
+    }
+
+    SIMDFloats operator+(const SIMDFloats& other) const { return SIMDFloats(_mm_add_ps(Values, other.Values)); }
+    SIMDFloats operator-(const SIMDFloats& other) const { return SIMDFloats(_mm_sub_ps(Values, other.Values)); }
+    SIMDFloats operator*(const SIMDFloats& other) const { return SIMDFloats(_mm_mul_ps(Values, other.Values)); }
+    SIMDFloats operator/(const SIMDFloats& other) const { return SIMDFloats(_mm_div_ps(Values, other.Values)); }
+
+    //If either element is NaN, the element from "b" is used.
+    static SIMDFloats Min(const SIMDFloats& a, const SIMDFloats& b) { return SIMDFloats(_mm_min_ps(a.Values, b.Values)); }
+    static SIMDFloats Max(const SIMDFloats& a, const SIMDFloats& b) { return SIMDFloats(_mm_max_ps(a.Values, b.Values)); }
+
+    //Converts each float to an integer by truncating it towards 0.
+    SIMDInts Truncate(void) const { return SIMDInts(_mm_cvttps_epi32(Values)); }
+    //Converts each float to an integer by rounding it down.
+    SIMDInts Floor(void) const
+    {
+        //Truncating rounds negative numbers up, so subtract 1 from those (a "true" comparison is all 1 bits, i.e. -1).
+        __m128i truncated = _mm_cvttps_epi32(Values);
+        __m128 isRoundedUp = _mm_cmpgt_ps(_mm_cvtepi32_ps(truncated), Values);
+        return SIMDInts(_mm_add_epi32(truncated, _mm_castps_si128(isRoundedUp)));
+    }
+
+    //Gets -1 (all bits set) for each element that's larger than the other one, and 0 for the rest.
+    SIMDInts GreaterThan(const SIMDFloats& other) const { return SIMDInts(_mm_castps_si128(_mm_cmpgt_ps(Values, other.Values))); }
+#endif
+
+    //Reinterprets the bits of each float as an integer, without converting anything.
+    SIMDInts AsInts(void) const;
+
+    //For each element, picks the value from "ifTrue" where "mask" is -1, and from "ifFalse" where it's 0.
+    static SIMDFloats Select(const SIMDInts& mask, const SIMDFloats& ifTrue, const SIMDFloats& ifFalse)
+    {
+        return SIMDInts::Select(mask, ifTrue.AsInts(), ifFalse.AsInts()).AsFloats();
+    }
+
+    //Linear interpolation, done in the same order as "Mathf::Lerp".
+    static SIMDFloats Lerp(const SIMDFloats& start, const SIMDFloats& end, const SIMDFloats& t)
+    {
+        return (t * (end - start)) + start;
+    }
+
+    //Gets the smallest of the values in this pack.
+    float GetMin(void) const
+    {
+        float vals[Width];
+        Store(vals);
+        float min = vals[0];
+        for (unsigned int i = 1; i < Width; ++i)
+            min = (vals[i] < min) ? vals[i] : min;
+        return min;
+    }
+    //Gets the largest of the values in this pack.
+    float GetMax(void) const
+    {
+        float vals[Width];
+        Store(vals);
+        float max = vals[0];
+        for (unsigned int i = 1; i < Width; ++i)
+            max = (vals[i] > max) ? vals[i] : max;
+        return max;
+    }
+};
+
+
+#if MANBIL_SIMD_WIDTH == 8
+inline SIMDFloats SIMDInts::ToFloats(void) const { return SIMDFloats(_mm256_cvtepi32_ps(Values)); }
+inline SIMDFloats SIMDInts::AsFloats(void) const { return SIMDFloats(_mm256_castsi256_ps(Values)); }
+inline SIMDInts SIMDFloats::AsInts(void) const { return SIMDInts(_mm256_castps_si256(Values)); }
+#else
+inline SIMDFloats SIMDInts::ToFloats(void) const { return SIMDFloats(_mm_cvtepi32_ps(Values)); }
+inline SIMDFloats SIMDInts::AsFloats(void) const { return SIMDFloats(_mm_castsi128_ps(Values)); }
+inline SIMDInts SIMDFloats::AsInts(void) const { return SIMDInts(_mm_castps_si128(Values)); }
+#endif
@@ -1,72 +1,210 @@
 #include "BasicGenerators.h"
 
-namespace NoiseAnalysis2D
+
+namespace
 {
-	MinMax GetMinAndMax(const Noise2D & nse)
-	{
-		MinMax ret(999999.0f, -999999.0f);
+    //The stats of one chunk of values.
+    struct ChunkStats
+    {
+        NoiseMinMax MinMax;
+        unsigned int Count;
+        //"M2" is the sum of the squared differences from the mean.
+        double Mean, M2;
+        std::vector<unsigned int> Histogram;
 
-		float tempVal;
-        int size = nse.GetWidth() * nse.GetHeight();
-        for (unsigned int i = 0; i < size; ++i)
+        ChunkStats(void) : Count(0), Mean(0.0), M2(0.0) { }
+    };
+
+    //Calls "func" on the values in the range [start, end), counting along the given rows.
+    //Each row is "rowLength" values long and starts "rowPitch" values after the one before it,
+    //    so any padding between the rows is skipped.
+    template<typename Func>
+    void ForEachValue(const float* values, unsigned int rowLength, unsigned int rowPitch,
+                      unsigned int start, unsigned int end, Func func)
+    {
+        if (start == end)
+            return;
+
+        unsigned int x = start % rowLength;
+        const float* row = values + ((size_t)(start / rowLength) * rowPitch);
+        for (unsigned int i = start; i < end; ++i)
         {
-            tempVal = nse.GetArray()[i];
+            func(row[x]);
 
-            if (tempVal > ret.Max)
-            {
-                ret.Max = tempVal;
-            }
-            if (tempVal < ret.Min)
+            x += 1;
+            if (x == rowLength)
             {
-                ret.Min = tempVal;
+                x = 0;
+                row += rowPitch;
             }
         }
+    }
 
-		return ret;
-	}
-	float GetAverage(const Noise2D & nse)
-	{
-		float av = 0.0f;
+    //Gets the min/max of the given rows of values, split into the given number of chunks that run in parallel.
+    NoiseMinMax GetMinMax(const float* values, unsigned int rowLength, unsigned int rowPitch,
+                          unsigned int nRows, unsigned int nThreads)
+    {
+        std::vector<NoiseMinMax> chunks(Mathf::Max(nThreads, (unsigned int)1));
+        ThreadPool::GetGlobalPool().RunChunks(rowLength * nRows, (unsigned int)chunks.size(),
+                                              [&](unsigned int chunk, unsigned int start, unsigned int end)
+        {
+            NoiseMinMax minMax;
+            ForEachValue(values, rowLength, rowPitch, start, end, [&minMax](float value) { minMax.Add(value); });
+            chunks[chunk] = minMax;
+        });
+        return NoiseMinMax::Combine(chunks);
+    }
+}
 
-        int size = nse.GetWidth() * nse.GetHeight();
-        for (unsigned int i = 0; i < size; ++i)
-            av += nse.GetArray()[i];
 
-		return av / (float)(nse.GetWidth() * nse.GetHeight());
-	}
+NoiseMinMax NoiseMinMax::Combine(const std::vector<NoiseMinMax>& pieces)
+{
+    NoiseMinMax total;
+    for (unsigned int i = 0; i < pieces.size(); ++i)
+        total.Add(pieces[i]);
+    return total;
 }
-namespace NoiseAnalysis3D
+
+float NoiseStats::GetPercentile(float fraction) const
 {
-    MinMax GetMinAndMax(Noise3D & nse)
+    assert(!Histogram.empty());
+
+    //Find the bucket that the given fraction of the values falls into,
+    //    and assume the values are spread evenly across it.
+    double target = (double)fraction * (double)Count;
+    float bucketSize = (HistogramMax - HistogramMin) / (float)Histogram.size();
+    unsigned int nBelow = 0;
+    for (unsigned int i = 0; i < Histogram.size(); ++i)
+    {
+        unsigned int nBelowNext = nBelow + Histogram[i];
+        if (Histogram[i] > 0 && (double)nBelowNext >= target)
+        {
+            float t = (float)((target - (double)nBelow) / (double)Histogram[i]);
+            return Mathf::Clamp(HistogramMin + (bucketSize * ((float)i + t)), Min, Max);
+        }
+        nBelow = nBelowNext;
+    }
+    return Max;
+}
+
+NoiseStats NoiseStats::Compute(const float* values, unsigned int nValues, unsigned int nThreads,
+                               unsigned int nHistogramBuckets, float histogramMin, float histogramMax)
+{
+    return ComputeRows(values, nValues, nValues, (nValues == 0) ? 0 : 1, nThreads,
+                       nHistogramBuckets, histogramMin, histogramMax);
+}
+NoiseStats NoiseStats::ComputeRows(const float* values, unsigned int rowLength, unsigned int rowPitch,
+                                   unsigned int nRows, unsigned int nThreads,
+                                   unsigned int nHistogramBuckets, float histogramMin, float histogramMax)
+{
+    std::vector<ChunkStats> chunks(Mathf::Max(nThreads, (unsigned int)1));
+    float bucketScale = (histogramMax > histogramMin) ?
+                            ((float)nHistogramBuckets / (histogramMax - histogramMin)) :
+                            0.0f,
+          lastBucket = (float)nHistogramBuckets - 1.0f;
+
+    ThreadPool::GetGlobalPool().RunChunks(rowLength * nRows, (unsigned int)chunks.size(),
+                                          [&](unsigned int chunkI, unsigned int start, unsigned int end)
     {
-        MinMax ret(std::numeric_limits<float>::max(), std::numeric_limits<float>::min());
+        ChunkStats& chunk = chunks[chunkI];
+        chunk.Histogram.resize(nHistogramBuckets, 0);
+        if (start == end)
+            return;
 
-        Vector3i loc;
-        float tempVal;
-        int size = nse.GetWidth() * nse.GetHeight() * nse.GetDepth();
-        for (int i = 0; i < size; ++i)
+        //Sum up each value's offset from the first value instead of the value itself,
+        //    which keeps the variance accurate even if the values are far from 0.
+        double shift = (double)values[((size_t)(start / rowLength) * rowPitch) + (start % rowLength)],
+               sum = 0.0,
+               sumSquares = 0.0;
+        ForEachValue(values, rowLength, rowPitch, start, end, [&](float value)
         {
-            tempVal = nse.GetArray()[i];
-            if (tempVal > ret.Max)
-            {
-                ret.Max = tempVal;
-            }
-            if (tempVal < ret.Min)
+            chunk.MinMax.Add(value);
+
+            double offset = (double)value - shift;
+            sum += offset;
+            sumSquares += offset * offset;
+
+            if (nHistogramBuckets > 0)
             {
-                ret.Min = tempVal;
+                float bucket = Mathf::Clamp((value - histogramMin) * bucketScale, 0.0f, lastBucket);
+                chunk.Histogram[(unsigned int)bucket] += 1;
             }
-        }
+        });
+
+        chunk.Count = end - start;
+        chunk.Mean = shift + (sum / (double)chunk.Count);
+        chunk.M2 = sumSquares - (sum * sum / (double)chunk.Count);
+    });
+
+
+    //Combine the chunks' stats.
+    NoiseStats stats;
+    stats.Histogram.resize(nHistogramBuckets, 0);
+    stats.HistogramMin = histogramMin;
+    stats.HistogramMax = histogramMax;
 
-        return ret;
+    NoiseMinMax minMax;
+    double m2 = 0.0;
+    for (unsigned int i = 0; i < chunks.size(); ++i)
+    {
+        const ChunkStats& chunk = chunks[i];
+        if (chunk.Count == 0)
+            continue;
+
+        minMax.Add(chunk.MinMax);
+        for (unsigned int j = 0; j < nHistogramBuckets; ++j)
+            stats.Histogram[j] += chunk.Histogram[j];
+
+        //Merge the means and variances using Chan et al.'s parallel algorithm.
+        double nTotal = (double)stats.Count + (double)chunk.Count,
+               delta = chunk.Mean - stats.Mean;
+        stats.Mean += delta * ((double)chunk.Count / nTotal);
+        m2 += chunk.M2 + (delta * delta * ((double)stats.Count * (double)chunk.Count / nTotal));
+        stats.Count += chunk.Count;
     }
-    float GetAverage(Noise3D & nse)
+
+    if (stats.Count > 0)
     {
-        float avg = 0.0f;
+        stats.Min = minMax.Min;
+        stats.Max = minMax.Max;
+        stats.Variance = m2 / (double)stats.Count;
+    }
+    return stats;
+}
 
-        int size = nse.GetWidth() * nse.GetHeight() * nse.GetDepth();
-        for (int i = 0; i < size; ++i)
-            avg += nse.GetArray()[i];
 
-        return avg / (float)size;
+namespace NoiseAnalysis2D
+{
+	MinMax GetMinAndMax(const Noise2D & nse, unsigned int nThreads)
+	{
+        return GetMinMax(nse.GetArray(), nse.GetWidth(), nse.GetRowPitch(), nse.GetHeight(), nThreads);
+	}
+	float GetAverage(const Noise2D & nse, unsigned int nThreads)
+	{
+        return (float)GetStats(nse, nThreads).Mean;
+	}
+    NoiseStats GetStats(const Noise2D & nse, unsigned int nThreads, unsigned int nHistogramBuckets,
+                        float histogramMin, float histogramMax)
+    {
+        return NoiseStats::ComputeRows(nse.GetArray(), nse.GetWidth(), nse.GetRowPitch(), nse.GetHeight(),
+                                       nThreads, nHistogramBuckets, histogramMin, histogramMax);
     }
-}
\ No newline at end of file
+}
+namespace NoiseAnalysis3D
+{
+    MinMax GetMinAndMax(const Noise3D & nse, unsigned int nThreads)
+    {
+        return GetMinMax(nse.GetArray(), nse.GetWidth(), nse.GetRowPitch(), nse.GetHeight() * nse.GetDepth(), nThreads);
+    }
+    float GetAverage(const Noise3D & nse, unsigned int nThreads)
+    {
+        return (float)GetStats(nse, nThreads).Mean;
+    }
+    NoiseStats GetStats(const Noise3D & nse, unsigned int nThreads, unsigned int nHistogramBuckets,
+                        float histogramMin, float histogramMax)
+    {
+        return NoiseStats::ComputeRows(nse.GetArray(), nse.GetWidth(), nse.GetRowPitch(),
+                                       nse.GetHeight() * nse.GetDepth(),
+                                       nThreads, nHistogramBuckets, histogramMin, histogramMax);
+    }
+}
@@ -1,6 +1,10 @@
 #pragma once
 
+#include <string.h>
+#include <vector>
 #include "../LowerMath.hpp"
+#include "../Lower Math/HashRand.h"
+#include "../../ThreadPool.h"
 
 typedef Array2D<float> Noise2D;
 typedef Array3D<float> Noise3D;
@@ -12,16 +16,103 @@ typedef Array3D<float> Noise3D;
 //******************************************************************************************
 
 
+//Builds a hash of a generator's type and settings, for "Generator2D::GetHash" and "Generator3D::GetHash".
+//Uses the 64-bit FNV-1a hash.
+struct GeneratorHasher
+{
+public:
+
+    unsigned long long Value;
+
+    //Starts the hash with the given generator type name.
+    GeneratorHasher(const char* typeName) : Value(14695981039346656037ULL) { AddBytes(typeName, strlen(typeName)); }
+
+    //Adds a plain value (e.x. a number, a vector, or a function pointer) to the hash.
+    template<typename T>
+    GeneratorHasher& Add(const T& value) { AddBytes(&value, sizeof(T)); return *this; }
+
+    void AddBytes(const void* bytes, unsigned int nBytes)
+    {
+        const unsigned char* byteVals = (const unsigned char*)bytes;
+        for (unsigned int i = 0; i < nBytes; ++i)
+        {
+            Value ^= byteVals[i];
+            Value *= 1099511628211ULL;
+        }
+    }
+};
+
+
+//The smallest and largest of a set of noise values.
+struct NoiseMinMax
+{
+    float Min, Max;
+
+    //Creates an empty min/max, which any value will replace.
+    NoiseMinMax(void) : Min(std::numeric_limits<float>::max()), Max(-std::numeric_limits<float>::max()) { }
+    NoiseMinMax(float min, float max) : Min(min), Max(max) { }
+
+    void Add(float value) { Min = Mathf::Min(value, Min); Max = Mathf::Max(value, Max); }
+    void Add(const NoiseMinMax& other) { Min = Mathf::Min(other.Min, Min); Max = Mathf::Max(other.Max, Max); }
+
+    //Combines the min/max of separate pieces of noise (e.x. each band of rows that was generated in parallel).
+    static NoiseMinMax Combine(const std::vector<NoiseMinMax>& pieces);
+};
+
+//Statistics about a set of noise values, all computed together in one pass.
+struct NoiseStats
+{
+    //The number of values.
+    unsigned int Count;
+    float Min, Max;
+    //The mean and variance are accumulated with double precision.
+    double Mean, Variance;
+
+    //If requested, the number of values in each of a number of equally-sized buckets
+    //    spanning "HistogramMin" to "HistogramMax".
+    //Values outside that range are counted in the first or last bucket.
+    std::vector<unsigned int> Histogram;
+    float HistogramMin, HistogramMax;
+
+
+    NoiseStats(void) : Count(0), Min(0.0f), Max(0.0f), Mean(0.0), Variance(0.0), HistogramMin(0.0f), HistogramMax(1.0f) { }
+
+    double GetStandardDeviation(void) const { return sqrt(Variance); }
+    //Estimates the value that the given fraction (0-1) of the values are below,
+    //    by interpolating within the histogram. Only valid if the histogram was computed.
+    float GetPercentile(float fraction) const;
+
+    //Computes the stats of the given values.
+    //The values are split into "nThreads" chunks, which are processed in parallel and then combined.
+    //If "nHistogramBuckets" is 0, no histogram is computed.
+    static NoiseStats Compute(const float* values, unsigned int nValues, unsigned int nThreads = 1,
+                              unsigned int nHistogramBuckets = 0,
+                              float histogramMin = 0.0f, float histogramMax = 1.0f);
+    //Computes the stats of the given rows of values, each of which starts "rowPitch" values
+    //    after the one before it (e.x. the rows of an array with row padding).
+    //The padding between rows is skipped.
+    static NoiseStats ComputeRows(const float* values, unsigned int rowLength, unsigned int rowPitch,
+                                  unsigned int nRows, unsigned int nThreads = 1,
+                                  unsigned int nHistogramBuckets = 0,
+                                  float histogramMin = 0.0f, float histogramMax = 1.0f);
+};
+
+
 #pragma region TwoD
 
 
 //Analysis of 2D noise.
+//Each function goes through the noise once, split into "nThreads" chunks that run in parallel.
 namespace NoiseAnalysis2D
 {
-    struct MinMax { float Min, Max; MinMax(float min, float max) : Min(min), Max(max) { } };
-    MinMax GetMinAndMax(const Noise2D & noise);
+    typedef NoiseMinMax MinMax;
+    MinMax GetMinAndMax(const Noise2D & noise, unsigned int nThreads = 1);
 
-    float GetAverage(const Noise2D & noise);
+    float GetAverage(const Noise2D & noise, unsigned int nThreads = 1);
+
+    //Gets the min, max, mean, variance, and (if "nHistogramBuckets" isn't 0) histogram of the given noise.
+    NoiseStats GetStats(const Noise2D & noise, unsigned int nThreads = 1, unsigned int nHistogramBuckets = 0,
+                        float histogramMin = 0.0f, float histogramMax = 1.0f);
 }
 
 
@@ -30,10 +121,86 @@ struct Generator2D
 {
 public:
 
+    //The number of bands of rows the noise is split into when generating.
+    //Each band is generated in parallel on the global ThreadPool.
+    //The generated noise is exactly the same no matter how many bands are used.
+    unsigned int NumbThreads;
+
+    Generator2D(void) : NumbThreads(1) { }
     virtual ~Generator2D(void) { }
 
 	//The "generate noise" function. Given the coordinates of the noise, gives a noise value.
 	virtual void Generate(Noise2D & outNoise) const = 0;
+
+    //Gets whether this generator can compute the noise value at individual points with "Sample".
+    //Generators that need to look at neighboring values (e.x. filters and interpolators) can't.
+    virtual bool CanSample(void) const { return false; }
+    //Computes the noise value at the given position, as "Generate" would compute it for that pixel.
+    //Positions don't have to be whole numbers. Only valid if "CanSample" returns true.
+    virtual float Sample(Vector2f pos) const { assert(false); return 0.0f; }
+    //Computes the noise value at each of the given positions.
+    //Only valid if "CanSample" returns true.
+    virtual void SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const
+    {
+        for (unsigned int i = 0; i < nPositions; ++i)
+            outValues[i] = Sample(positions[i]);
+    }
+
+    //Gets whether this generator can compute the exact gradient of its noise with "SampleGradients".
+    virtual bool CanSampleGradients(void) const { return false; }
+    //Computes the noise value and its gradient (the change in value per pixel along X and Y)
+    //    at each of the given positions, as "SampleMany" would compute the values.
+    //The gradient comes from the same calculation as the value instead of from neighboring values,
+    //    so it can be turned straight into a normal without a separate pass over the noise.
+    //Only valid if "CanSampleGradients" returns true.
+    virtual void SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients,
+                                 unsigned int nPositions) const
+    {
+        assert(false);
+    }
+    //Computes the noise value and gradient of every pixel with "SampleGradients",
+    //    one row at a time, with each band of rows running in parallel.
+    //The gradients array must be the same size as the noise array.
+    //Only valid if "CanSampleGradients" returns true.
+    void GenerateWithGradients(Noise2D& outNoise, Array2D<Vector2f>& outGradients) const
+    {
+        assert(outGradients.GetWidth() == outNoise.GetWidth() && outGradients.GetHeight() == outNoise.GetHeight());
+
+        ForEachRowBand(outNoise.GetHeight(), [&](unsigned int band, unsigned int startY, unsigned int endY)
+        {
+            std::vector<Vector2f> positions(outNoise.GetWidth());
+            for (unsigned int y = startY; y < endY; ++y)
+            {
+                for (unsigned int x = 0; x < positions.size(); ++x)
+                    positions[x] = Vector2f((float)x, (float)y);
+                SampleGradients(positions.data(), &outNoise[Vector2u(0, y)], &outGradients[Vector2u(0, y)],
+                                outNoise.GetWidth());
+            }
+        });
+    }
+
+    //Gets whether this generator can describe its type and settings with "GetHash".
+    virtual bool CanHash(void) const { return false; }
+    //Gets a hash of this generator's type and all the settings that affect its output
+    //    (e.x. seed, scale, and offset, but not "NumbThreads").
+    //Generators with the same hash generate the same noise, so the hash can be used to cache the noise.
+    //Settings that are pointers (e.x. function pointers) are hashed by address,
+    //    so the hash only stays the same for as long as the program is running.
+    //Only valid if "CanHash" returns true.
+    virtual unsigned long long GetHash(void) const { assert(false); return 0; }
+
+protected:
+
+    //A function with signature "void DoRows(unsigned int bandIndex, unsigned int startY, unsigned int endY)".
+    template<typename Func>
+    //Splits the given number of rows into "NumbThreads" bands and runs the given function on each band.
+    //Returns once every band is finished.
+    void ForEachRowBand(unsigned int nRows, Func doRows) const
+    {
+        ThreadPool::GetGlobalPool().RunChunks(nRows, GetNumbBands(), doRows);
+    }
+    //Gets the number of bands that "ForEachRowBand" splits the rows into.
+    unsigned int GetNumbBands(void) const { return Mathf::Max(NumbThreads, (unsigned int)1); }
 };
 
 
@@ -44,10 +211,27 @@ public:
 	float FlatValue;
 	FlatNoise2D(float flatValue = 0.0f) : FlatValue(flatValue) { }
 	virtual void Generate(Noise2D & outNoise) const override { outNoise.Fill(FlatValue); }
+
+    virtual bool CanSample(void) const override { return true; }
+    virtual float Sample(Vector2f pos) const override { return FlatValue; }
+
+    virtual bool CanSampleGradients(void) const override { return true; }
+    virtual void SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients,
+                                 unsigned int nPositions) const override
+    {
+        for (unsigned int i = 0; i < nPositions; ++i)
+        {
+            outValues[i] = FlatValue;
+            outGradients[i] = Vector2f();
+        }
+    }
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override { return GeneratorHasher("FlatNoise2D").Add(FlatValue).Value; }
 };
 
 
-//Generates random noise using a fast PRNG.
+//Generates random noise using "HashRand".
 struct WhiteNoise2D : public Generator2D
 {
 public:
@@ -56,14 +240,29 @@ public:
 	WhiteNoise2D(int seed = 12345, Vector2i seedOffset = Vector2i()) : Seed(seed), SeedOffset(seedOffset) { }
 	virtual void Generate(Noise2D & outNoise) const override
     {
-        int seed = Seed;
-        Vector2i offset = SeedOffset;
-        outNoise.FillFunc([seed, offset](Vector2u loc, float * fOut)
+        ForEachRowBand(outNoise.GetHeight(), [this, &outNoise](unsigned int band, unsigned int startY, unsigned int endY)
         {
-            Vector3i seed3(ToV2i(loc) + offset, seed);
-           *fOut = FastRand(seed3.GetHashCode()).GetZeroToOne();
+            for (unsigned int y = startY; y < endY; ++y)
+            {
+                HashRand::FillRow(&outNoise[Vector2u(0, y)], outNoise.GetWidth(),
+                                  Seed, SeedOffset.x, (int)y + SeedOffset.y);
+            }
         });
     }
+
+    //Each pixel's value comes from the integer position it falls into.
+    virtual bool CanSample(void) const override { return true; }
+    virtual float Sample(Vector2f pos) const override
+    {
+        Vector2i posI = Vector2i((int)floorf(pos.x), (int)floorf(pos.y)) + SeedOffset;
+        return HashRand::GetZeroToOne(Seed, posI.x, posI.y);
+    }
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("WhiteNoise2D").Add(Seed).Add(SeedOffset).Value;
+    }
 };
 
 
@@ -74,12 +273,17 @@ public:
 
 
 //Analysis of 3D noise.
+//Each function goes through the noise once, split into "nThreads" chunks that run in parallel.
 namespace NoiseAnalysis3D
 {
-    struct MinMax { float Min, Max; MinMax(float min, float max) : Min(min), Max(max) { } };
-    MinMax GetMinAndMax(Noise3D & noise);
+    typedef NoiseMinMax MinMax;
+    MinMax GetMinAndMax(const Noise3D & noise, unsigned int nThreads = 1);
+
+    float GetAverage(const Noise3D & noise, unsigned int nThreads = 1);
 
-    float GetAverage(Noise3D & noise);
+    //Gets the min, max, mean, variance, and (if "nHistogramBuckets" isn't 0) histogram of the given noise.
+    NoiseStats GetStats(const Noise3D & noise, unsigned int nThreads = 1, unsigned int nHistogramBuckets = 0,
+                        float histogramMin = 0.0f, float histogramMax = 1.0f);
 }
 
 
@@ -87,11 +291,132 @@ namespace NoiseAnalysis3D
 struct Generator3D
 {
 public:
-    
+
+    //The number of slabs of Z slices the noise is split into when generating.
+    //Each slab is generated in parallel on the global ThreadPool.
+    //The generated noise is exactly the same no matter how many slabs are used.
+    unsigned int NumbThreads;
+
+    Generator3D(void) : NumbThreads(1) { }
     virtual ~Generator3D(void) { }
 
     //The "generate noise" function. Given the coordinates of the noise, gives a noise value.
     virtual void Generate(Noise3D & outNoise) const = 0;
+
+    //Gets whether this generator can compute the noise value at individual points with "Sample".
+    //Generators that need to look at neighboring values (e.x. filters and interpolators) can't.
+    virtual bool CanSample(void) const { return false; }
+    //Computes the noise value at the given position, as "Generate" would compute it for that pixel.
+    //Positions don't have to be whole numbers. Only valid if "CanSample" returns true.
+    virtual float Sample(Vector3f pos) const { assert(false); return 0.0f; }
+    //Computes the noise value at each of the given positions.
+    //Only valid if "CanSample" returns true.
+    virtual void SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const
+    {
+        for (unsigned int i = 0; i < nPositions; ++i)
+            outValues[i] = Sample(positions[i]);
+    }
+
+    //Gets whether this generator can compute the exact gradient of its noise with "SampleGradients".
+    virtual bool CanSampleGradients(void) const { return false; }
+    //Computes the noise value and its gradient (the change in value per pixel along X, Y, and Z)
+    //    at each of the given positions, as "SampleMany" would compute the values.
+    //The gradient comes from the same calculation as the value instead of from neighboring values,
+    //    so it can be turned straight into a normal without a separate pass over the noise.
+    //Only valid if "CanSampleGradients" returns true.
+    virtual void SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                 unsigned int nPositions) const
+    {
+        assert(false);
+    }
+    //Computes the noise value and gradient of every pixel with "SampleGradients",
+    //    one row at a time, with each slab of Z slices running in parallel.
+    //The gradients array must be the same size as the noise array.
+    //Only valid if "CanSampleGradients" returns true.
+    void GenerateWithGradients(Noise3D& outNoise, Array3D<Vector3f>& outGradients) const
+    {
+        assert(outGradients.GetDimensions() == outNoise.GetDimensions());
+
+        ForEachZSlab(outNoise.GetDepth(), [&](unsigned int slab, unsigned int startZ, unsigned int endZ)
+        {
+            std::vector<Vector3f> positions(outNoise.GetWidth());
+            for (Vector3u loc(0, 0, startZ); loc.z < endZ; ++loc.z)
+            {
+                for (loc.y = 0; loc.y < outNoise.GetHeight(); ++loc.y)
+                {
+                    for (unsigned int x = 0; x < positions.size(); ++x)
+                        positions[x] = Vector3f((float)x, (float)loc.y, (float)loc.z);
+                    SampleGradients(positions.data(), &outNoise[loc], &outGradients[loc], outNoise.GetWidth());
+                }
+            }
+        });
+    }
+
+    //Gets whether this generator can describe its type and settings with "GetHash".
+    virtual bool CanHash(void) const { return false; }
+    //Gets a hash of this generator's type and all the settings that affect its output
+    //    (e.x. seed, scale, and offset, but not "NumbThreads").
+    //Generators with the same hash generate the same noise, so the hash can be used to cache the noise.
+    //Settings that are pointers (e.x. function pointers) are hashed by address,
+    //    so the hash only stays the same for as long as the program is running.
+    //Only valid if "CanHash" returns true.
+    virtual unsigned long long GetHash(void) const { assert(false); return 0; }
+
+    //Gets whether "GenerateSlab" only computes the requested slab of Z slices.
+    //If not, "GenerateSlab" still works, but it has to generate the whole volume and copy the slab out of it.
+    //Generators that remap their values using the min/max of the whole volume can't compute slabs on their own.
+    virtual bool CanGenerateSlab(void) const { return false; }
+    //Generates the Z slices "startZ" through "endZ - 1" of a volume with the given size,
+    //    with exactly the same values that "Generate" would give those slices of the whole volume.
+    //The slices are put into "outSlab", which is resized to "volumeSize.x" by "volumeSize.y" by "endZ - startZ".
+    //Resizing doesn't allocate anything if the number of elements stays the same,
+    //    so the same array can be reused for every slab.
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+    {
+        assert(startZ < endZ && endZ <= volumeSize.z);
+
+        Noise3D volume(volumeSize.x, volumeSize.y, volumeSize.z);
+        Generate(volume);
+
+        //Copy one row at a time, since either array may have padded rows.
+        outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+        for (unsigned int z = 0; z < outSlab.GetDepth(); ++z)
+        {
+            for (unsigned int y = 0; y < volumeSize.y; ++y)
+                memcpy(outSlab.GetRow(y, z), volume.GetRow(y, startZ + z), volumeSize.x * sizeof(float));
+        }
+    }
+
+    //A function with signature "void OnSlab(const Noise3D& slab, unsigned int startZ)".
+    template<typename Func>
+    //Generates a volume of the given size one slab of "slabDepth" Z slices at a time,
+    //    passing each slab to the given function before generating the next one.
+    //Only one slab is held in memory at a time (as long as "CanGenerateSlab" is true).
+    //The last slab may be thinner than the rest.
+    void GenerateSlabs(Vector3u volumeSize, unsigned int slabDepth, Func onSlab) const
+    {
+        assert(slabDepth > 0);
+
+        Noise3D slab(volumeSize.x, volumeSize.y, Mathf::Min(slabDepth, volumeSize.z));
+        for (unsigned int startZ = 0; startZ < volumeSize.z; startZ += slabDepth)
+        {
+            GenerateSlab(volumeSize, startZ, Mathf::Min(startZ + slabDepth, volumeSize.z), slab);
+            onSlab((const Noise3D&)slab, startZ);
+        }
+    }
+
+protected:
+
+    //A function with signature "void DoSlices(unsigned int slabIndex, unsigned int startZ, unsigned int endZ)".
+    template<typename Func>
+    //Splits the given number of Z slices into "NumbThreads" slabs and runs the given function on each slab.
+    //Returns once every slab is finished.
+    void ForEachZSlab(unsigned int nSlices, Func doSlices) const
+    {
+        ThreadPool::GetGlobalPool().RunChunks(nSlices, GetNumbSlabs(), doSlices);
+    }
+    //Gets the number of slabs that "ForEachZSlab" splits the Z slices into.
+    unsigned int GetNumbSlabs(void) const { return Mathf::Max(NumbThreads, (unsigned int)1); }
 };
 
 
@@ -102,10 +427,34 @@ public:
     float FlatValue;
     FlatNoise3D(float flatValue = 0.0f) : FlatValue(flatValue) { }
     virtual void Generate(Noise3D & outNoise) const override { outNoise.Fill(FlatValue); }
+
+    virtual bool CanSample(void) const override { return true; }
+    virtual float Sample(Vector3f pos) const override { return FlatValue; }
+
+    virtual bool CanSampleGradients(void) const override { return true; }
+    virtual void SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                 unsigned int nPositions) const override
+    {
+        for (unsigned int i = 0; i < nPositions; ++i)
+        {
+            outValues[i] = FlatValue;
+            outGradients[i] = Vector3f();
+        }
+    }
+
+    virtual bool CanGenerateSlab(void) const override { return true; }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override
+    {
+        outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+        outSlab.Fill(FlatValue);
+    }
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override { return GeneratorHasher("FlatNoise3D").Add(FlatValue).Value; }
 };
 
 
-//Generates random noise using a fast PRNG.
+//Generates random noise using "HashRand".
 struct WhiteNoise3D : public Generator3D
 {
 public:
@@ -114,14 +463,39 @@ public:
 	WhiteNoise3D(int seed = 12345, Vector3i seedOffset = Vector3i()) : Seed(seed), SeedOffset(seedOffset) { }
 	virtual void Generate(Noise3D & outNoise) const override
     {
-        int seed = Seed;
-        Vector3i offset = SeedOffset;
-        outNoise.FillFunc([seed, offset](Vector3u loc, float * fOut)
+        GenerateSlab(outNoise.GetDimensions(), 0, outNoise.GetDepth(), outNoise);
+    }
+
+    virtual bool CanGenerateSlab(void) const override { return true; }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override
+    {
+        outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+        ForEachZSlab(endZ - startZ, [&](unsigned int slab, unsigned int slabStartZ, unsigned int slabEndZ)
         {
-            Vector4i seed4(ToV3i(loc) + offset, seed);
-           *fOut = FastRand(seed4.GetHashCode()).GetZeroToOne();
+            for (unsigned int z = slabStartZ; z < slabEndZ; ++z)
+            {
+                for (unsigned int y = 0; y < volumeSize.y; ++y)
+                {
+                    HashRand::FillRow(&outSlab[Vector3u(0, y, z)], volumeSize.x, Seed, SeedOffset.x,
+                                      (int)y + SeedOffset.y, (int)(z + startZ) + SeedOffset.z);
+                }
+            }
         });
     }
+
+    //Each pixel's value comes from the integer position it falls into.
+    virtual bool CanSample(void) const override { return true; }
+    virtual float Sample(Vector3f pos) const override
+    {
+        Vector3i posI = Vector3i((int)floorf(pos.x), (int)floorf(pos.y), (int)floorf(pos.z)) + SeedOffset;
+        return HashRand::GetZeroToOne(Seed, posI.x, posI.y, posI.z);
+    }
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("WhiteNoise3D").Add(Seed).Add(SeedOffset).Value;
+    }
 };
 
 
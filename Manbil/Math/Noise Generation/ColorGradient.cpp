@@ -1,7 +1,27 @@
 #include "ColorGradient.h"
 
+#include <algorithm>
+#include <assert.h>
+#include "../Lower Math/SIMD.h"
+
 char ColorGradient::Exception_NodesNotOrdered = 4;
 
+
+namespace
+{
+    //Scales the given 0-1 color to 0-255, then clamps and rounds it.
+    //Mirrors what "ColorGradient::GetBakedColors" does for a whole pack of colors at once.
+    Vector4b ToBytes(Vector4f col)
+    {
+        col = col * 255.0f;
+        return Vector4b((unsigned char)(int)(Mathf::Min(Mathf::Max(col.x, 0.0f), 255.0f) + 0.4999f),
+                        (unsigned char)(int)(Mathf::Min(Mathf::Max(col.y, 0.0f), 255.0f) + 0.4999f),
+                        (unsigned char)(int)(Mathf::Min(Mathf::Max(col.z, 0.0f), 255.0f) + 0.4999f),
+                        (unsigned char)(int)(Mathf::Min(Mathf::Max(col.w, 0.0f), 255.0f) + 0.4999f));
+    }
+}
+
+
 void ColorGradient::CheckErrors(void) const
 {
 	for (int index = OrderedNodes.size() - 1; index >= 0; --index)
@@ -16,6 +36,12 @@ void ColorGradient::CheckErrors(void) const
 
 void ColorGradient::GetColors(Vector4f* outColors, const float* inValues, unsigned int numbElements) const
 {
+    if (IsBaked())
+    {
+        GetBakedColors(outColors, 0, inValues, numbElements);
+        return;
+    }
+
 	CheckErrors();
 
     for (unsigned int i = 0; i < numbElements; ++i)
@@ -23,44 +49,152 @@ void ColorGradient::GetColors(Vector4f* outColors, const float* inValues, unsign
         outColors[i] = GetColorWOErrorChecking(inValues[i]);
     }
 }
+void ColorGradient::GetColors(Vector4b* outColors, const float* inValues, unsigned int numbElements) const
+{
+    if (IsBaked())
+    {
+        GetBakedColors(0, outColors, inValues, numbElements);
+        return;
+    }
+
+	CheckErrors();
+
+    for (unsigned int i = 0; i < numbElements; ++i)
+    {
+        outColors[i] = ToBytes(GetColorWOErrorChecking(inValues[i]));
+    }
+}
 Vector4f ColorGradient::GetColorWOErrorChecking(float f) const
 {
-    f = Mathf::Clamp(f, OrderedNodes[0].Position, OrderedNodes[OrderedNodes.size() - 1].Position);
+    const ColorNode& firstNode = OrderedNodes[0],
+                   & lastNode = OrderedNodes[OrderedNodes.size() - 1];
 
-	//Edge cases. Choose a random node side if the given value sits right on a Node.
-	if (f == OrderedNodes[0].Position)
-	{
-		return ((rand() % 9) < 5) ? OrderedNodes[0].LeftColor : OrderedNodes[0].RightColor;
-	}
-	if (f == OrderedNodes[OrderedNodes.size() - 1].Position)
-	{
-		return ((rand() % 9) < 5) ? OrderedNodes[OrderedNodes.size() - 1].LeftColor : OrderedNodes[OrderedNodes.size() - 1].RightColor;
-	}
+	//Edge cases. A value that sits right on the first or last node gets the color on the inside of the gradient.
+    //NaN fails every comparison below, so it's treated as the first node's position.
+    if (Mathf::IsNaN(f))
+        return firstNode.RightColor;
+    if (f < firstNode.Position)
+        return firstNode.LeftColor;
+    if (f > lastNode.Position)
+        return lastNode.RightColor;
+    if (f == firstNode.Position)
+        return firstNode.RightColor;
+    if (f == lastNode.Position)
+        return lastNode.LeftColor;
 
-	//Count to the first node above the given position.
-	int index;
-	for (index = OrderedNodes.size() - 1; OrderedNodes[index].Position > f && index > 0; --index) { }
+	//Binary-search for the first node above the given position.
+    auto above = std::upper_bound(OrderedNodes.begin(), OrderedNodes.end(), f,
+                                  [](float pos, const ColorNode& node) { return pos < node.Position; });
+    const ColorNode& rightNode = *above,
+                   & leftNode = *(above - 1);
 
 	//Lerp between the two color values.
+    float t = (f - leftNode.Position) / (rightNode.Position - leftNode.Position);
+    return Vector4f(Mathf::Lerp(leftNode.RightColor.x, rightNode.LeftColor.x, t),
+                    Mathf::Lerp(leftNode.RightColor.y, rightNode.LeftColor.y, t),
+                    Mathf::Lerp(leftNode.RightColor.z, rightNode.LeftColor.z, t),
+                    Mathf::Lerp(leftNode.RightColor.w, rightNode.LeftColor.w, t));
+}
 
-	Vector4f leftCol = OrderedNodes[index].RightColor;
-	Vector4f rightCol = OrderedNodes[index + 1].LeftColor;
-	Interval posInt(OrderedNodes[index].Position, OrderedNodes[index + 1].Position, 0.001f, true, true);
-	Vector4b needReversed((unsigned char)(leftCol.x > rightCol.x), leftCol.y > rightCol.y, leftCol.z > rightCol.z, leftCol.w > rightCol.w);
-	float ref = posInt.Reflect(f);
-	float rx = (needReversed.x) ? ref : f,
-		  ry = (needReversed.y) ? ref : f,
-		  rz = (needReversed.z) ? ref : f,
-		  rw = (needReversed.w) ? ref : f;
-	Interval ix(leftCol.x, rightCol.x, 0.001f, true, true),
-			 iy(leftCol.y, rightCol.y, 0.001f, true, true),
-			 iz(leftCol.z, rightCol.z, 0.001f, true, true),
-			 iw(leftCol.w, rightCol.w, 0.001f, true, true);
-	rx = posInt.MapValue(ix, rx);
-	ry = posInt.MapValue(iy, ry);
-	rz = posInt.MapValue(iz, rz);
-	rw = posInt.MapValue(iw, rw);
-	Vector4f ret(rx, ry, rz, rw);
-
-	return ret;
-}
\ No newline at end of file
+
+void ColorGradient::Bake(unsigned int nSamples)
+{
+    assert(nSamples >= 2);
+    assert(OrderedNodes.size() > 0);
+    CheckErrors();
+
+    float start = OrderedNodes[0].Position,
+          end = OrderedNodes[OrderedNodes.size() - 1].Position;
+    bakedStart = start;
+    bakedScale = (end > start) ? ((float)(nSamples - 1) / (end - start)) : 0.0f;
+
+    for (unsigned int i = 0; i < 4; ++i)
+        bakedColors[i].resize(nSamples + 1);
+    for (unsigned int i = 0; i < nSamples; ++i)
+    {
+        float pos = (i == nSamples - 1) ? end : Mathf::Lerp(start, end, (float)i / (float)(nSamples - 1));
+        Vector4f col = GetColorWOErrorChecking(pos);
+
+        bakedColors[0][i] = col.x;
+        bakedColors[1][i] = col.y;
+        bakedColors[2][i] = col.z;
+        bakedColors[3][i] = col.w;
+    }
+    for (unsigned int i = 0; i < 4; ++i)
+        bakedColors[i][nSamples] = bakedColors[i][nSamples - 1];
+}
+
+Vector4f ColorGradient::GetBakedColor(float value) const
+{
+    float maxT = (float)(bakedColors[0].size() - 2);
+    float t = (value - bakedStart) * bakedScale;
+    //NaN gets the first sample, the same as in "GetBakedColors".
+    t = (Mathf::IsNaN(t) ? 0.0f : Mathf::Min(Mathf::Max(t, 0.0f), maxT));
+
+    int index = (int)t;
+    float frac = t - (float)index;
+    return Vector4f(Mathf::Lerp(bakedColors[0][index], bakedColors[0][index + 1], frac),
+                    Mathf::Lerp(bakedColors[1][index], bakedColors[1][index + 1], frac),
+                    Mathf::Lerp(bakedColors[2][index], bakedColors[2][index + 1], frac),
+                    Mathf::Lerp(bakedColors[3][index], bakedColors[3][index + 1], frac));
+}
+void ColorGradient::GetBakedColors(Vector4f* outColors, Vector4b* outBytes, const float* values, unsigned int numbElements) const
+{
+    const unsigned int width = SIMDFloats::Width;
+
+    const float* channels[4] = { bakedColors[0].data(), bakedColors[1].data(),
+                                 bakedColors[2].data(), bakedColors[3].data() };
+    SIMDFloats start(bakedStart), scale(bakedScale),
+               zero(0.0f), maxT((float)(bakedColors[0].size() - 2)),
+               byteMax(255.0f), byteRounding(0.4999f);
+
+    int indices[width];
+    float channelVals[4][width];
+
+    //Look up a whole pack of values at once.
+    unsigned int i = 0;
+    for (; i + width <= numbElements; i += width)
+    {
+        //"Max" gives its second argument for NaN elements, so NaN values get the first sample.
+        SIMDFloats t = (SIMDFloats::Load(values + i) - start) * scale;
+        t = SIMDFloats::Min(SIMDFloats::Max(t, zero), maxT);
+
+        SIMDInts index = t.Truncate();
+        SIMDFloats frac = t - index.ToFloats();
+        index.Store(indices);
+
+        SIMDFloats cols[4];
+        for (unsigned int c = 0; c < 4; ++c)
+            cols[c] = SIMDFloats::Lerp(SIMDFloats::Gather(channels[c], indices, 1),
+                                       SIMDFloats::Gather(channels[c] + 1, indices, 1),
+                                       frac);
+
+        if (outBytes != 0)
+        {
+            //Pack the four bytes of each color into one integer, with the X component in the lowest byte.
+            SIMDInts packed(0);
+            for (unsigned int c = 0; c < 4; ++c)
+            {
+                SIMDFloats byteVal = SIMDFloats::Min(SIMDFloats::Max(cols[c] * byteMax, zero), byteMax);
+                packed = packed | (byteVal + byteRounding).Truncate().ShiftLeft(8 * c);
+            }
+            packed.Store((int*)(outBytes + i));
+        }
+        else
+        {
+            for (unsigned int c = 0; c < 4; ++c)
+                cols[c].Store(channelVals[c]);
+            for (unsigned int j = 0; j < width; ++j)
+                outColors[i + j] = Vector4f(channelVals[0][j], channelVals[1][j], channelVals[2][j], channelVals[3][j]);
+        }
+    }
+
+    //Handle the leftover values one at a time.
+    for (; i < numbElements; ++i)
+    {
+        if (outBytes != 0)
+            outBytes[i] = ToBytes(GetBakedColor(values[i]));
+        else
+            outColors[i] = GetBakedColor(values[i]);
+    }
+}
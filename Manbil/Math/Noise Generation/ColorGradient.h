@@ -5,6 +5,7 @@
 #include "../LowerMath.hpp"
 
 //Maps an interval of floats to colors.
+//For speed, the gradient can be "baked" into a table of colors that are looked up instead of computed.
 class ColorGradient
 {
 public:
@@ -17,10 +18,34 @@ public:
 	~ColorGradient(void) {  }
 
 	void GetColors(Vector4f * outColors, const float * noiseValues, unsigned int numbElements) const;
+	//Gets the colors as bytes (each component is scaled from 0-1 to 0-255, clamped, and rounded).
+	void GetColors(Vector4b * outColors, const float * noiseValues, unsigned int numbElements) const;
 	Vector4f GetColor(float value) const { CheckErrors(); return GetColorWOErrorChecking(value); }
 
+
+	//Precomputes the colors at "nSamples" evenly-spaced positions from the first node to the last one,
+	//    so "GetColors" can look up colors in a table instead of searching through the nodes.
+	//Colors between two samples are linearly interpolated, so a hard edge
+	//    (a node with different left and right colors) is smeared across the width of one sample.
+	//Must be called again after changing "OrderedNodes".
+	void Bake(unsigned int nSamples = 1024);
+	//Throws away the baked colors, so that colors are computed from the nodes again.
+	void ClearBake(void) { for (unsigned int i = 0; i < 4; ++i) bakedColors[i].clear(); }
+	bool IsBaked(void) const { return !bakedColors[0].empty(); }
+
 private:
 
 	void CheckErrors(void) const;
 	Vector4f GetColorWOErrorChecking(float value) const;
-};
\ No newline at end of file
+
+	//Gets the color from the baked table. Mirrors what "GetColors" does for a whole pack of values at once.
+	Vector4f GetBakedColor(float value) const;
+	//Gets the colors from the baked table, either as floats or as bytes.
+	void GetBakedColors(Vector4f* outColors, Vector4b* outBytes, const float* values, unsigned int numbElements) const;
+
+	//Each color component of the baked table is stored in its own array (R, G, B, and A).
+	//Each array has an extra copy of the last sample on the end, so a sample always has a "next" one.
+	std::vector<float> bakedColors[4];
+	//The position of the first baked sample, and the number of samples per unit of position.
+	float bakedStart, bakedScale;
+};
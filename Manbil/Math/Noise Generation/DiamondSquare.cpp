@@ -4,83 +4,10 @@
 #include <assert.h>
 
 
-void DiamondSquare::IterateAlgorithm(unsigned int size, Vector2u topLeft,
-                                     Interval* variances, Noise2D& noise) const
+void DiamondSquare::SetPoint(Noise2D& noise, Vector2u pos, float neighborAverage, const Interval& variance) const
 {
-    assert(size > 0);
-
-	Interval var = variances[0];
-	unsigned int halfSize = size / 2;
-	float f, f2;
-	
-	Vector2u tl = topLeft,
-			 tm = tl + Vector2u(halfSize, 0),
-			 tr = tl + Vector2u(size - 1, 0),
-			 l = topLeft + Vector2u(0, halfSize),
-			 m = l + Vector2u(halfSize, 0),
-			 r = l + Vector2u(size - 1, 0),
-			 bl = topLeft + Vector2u(0, size - 1),
-			 bm = bl + Vector2u(halfSize, 0),
-			 br = bl + Vector2u(size - 1, 0);
-
-
-	//"Diamond" part of the algorithm.
-	if (Mathf::IsNaN(noise[m]))
-	{
-		f = noise[tl] + noise[tr] + noise[bl] + noise[br];
-		f *= 0.25f;
-		f2 = var.RandomInsideRange(FastRand(Vector3i((int)m.x, (int)m.y, Seed).GetHashCode()));
-
-		noise[m] = f + f2;
-	}
-
-	//"Square" part of the algorithm.
-
-	//Left point.
-	if (Mathf::IsNaN(noise[l]))
-	{
-		f = (noise[tl] + noise[bl]) * 0.5f;
-        f2 = var.RandomInsideRange(FastRand(Vector3i((int)l.x, (int)l.y, Seed).GetHashCode()));
-		noise[l] = f + f2;
-	}
-
-	//Top point.
-	if (Mathf::IsNaN(noise[tm]))
-	{
-		f = (noise[tl] + noise[tr]) * 0.5f;
-        f2 = var.RandomInsideRange(FastRand(Vector3i((int)tm.x, (int)tm.y, Seed).GetHashCode()));
-		noise[tm] = f + f2;
-	}
-
-	//Right point.
-	if (Mathf::IsNaN(noise[r]))
-	{
-		f = (noise[tr] + noise[br]) * 0.5f;
-        f2 = var.RandomInsideRange(FastRand(Vector3i((int)r.x, (int)r.y, Seed).GetHashCode()));
-		noise[r] = f + f2;
-	}
-
-	//Bottom point.
-	if (Mathf::IsNaN(noise[bm]))
-	{
-		f = (noise[bl] + noise[br]) * 0.5f;
-        f2 = var.RandomInsideRange(FastRand(Vector3i((int)bm.x, (int)bm.y, Seed).GetHashCode()));
-		noise[bm] = f + f2;
-	}
-
-
-	//Recursive calls.
-	if (size > 3)
-	{
-		size = ((size - 1) / 2) + 1;
-
-		variances = &variances[1];
-
-		IterateAlgorithm(size, tl, variances, noise);
-		IterateAlgorithm(size, tm, variances, noise);
-		IterateAlgorithm(size, l, variances, noise);
-		IterateAlgorithm(size, m, variances, noise);
-	}
+	if (Mathf::IsNaN(noise[pos]))
+		noise[pos] = neighborAverage + variance.Lerp(HashRand::GetZeroToOne(Seed, (int)pos.x, (int)pos.y));
 }
 void DiamondSquare::Generate(Noise2D& noise) const
 {
@@ -106,7 +33,7 @@ void DiamondSquare::Generate(Noise2D& noise) const
 	}
 	//If there aren't enough hard-coded variances, add the default variance.
 	unsigned int steps = (unsigned int)Mathf::RoundToInt(Mathf::Log(noiseSize, 2.0f)) + 1;
-	for (unsigned int i = steps - variances.size(); i > 0; --i)
+	while (variances.size() < steps)
 		variances.insert(variances.end(), DefaultVariance);
 
 
@@ -120,6 +47,51 @@ void DiamondSquare::Generate(Noise2D& noise) const
 	if (Mathf::IsNaN(noise[Vector2u(noiseSize - 1, noiseSize - 1)]))
 		noise[Vector2u(noiseSize - 1, noiseSize - 1)] = StartingCornerValues;
 
-    //Start the iteration algorithm.
-	IterateAlgorithm(noiseSize, Vector2u(), variances.data(), noise);
+    //Go through each level of detail, halving the size of the squares each time.
+    //Every new point in a level is set from the corners of its square (for the "diamond" step)
+    //    or the two ends of its edge (for the "square" step). Those were all set in earlier levels,
+    //    so every point in a level can be computed at once, in any order.
+    unsigned int level = 0;
+    for (unsigned int squareSize = noiseSize - 1; squareSize > 1; squareSize /= 2, ++level)
+    {
+        const Interval& variance = variances[level];
+        unsigned int halfSize = squareSize / 2,
+                     nHalfRows = (2 * ((noiseSize - 1) / squareSize)) + 1;
+
+        ForEachRowBand(nHalfRows, [&](unsigned int band, unsigned int startRow, unsigned int endRow)
+        {
+            for (unsigned int row = startRow; row < endRow; ++row)
+            {
+                unsigned int y = row * halfSize;
+
+                if (row % 2 == 0)
+                {
+                    //This row runs along the tops/bottoms of squares. Set the middle of each edge.
+                    for (unsigned int x = halfSize; x < noiseSize; x += squareSize)
+                    {
+                        float average = (noise[Vector2u(x - halfSize, y)] + noise[Vector2u(x + halfSize, y)]) * 0.5f;
+                        SetPoint(noise, Vector2u(x, y), average, variance);
+                    }
+                }
+                else
+                {
+                    //This row runs through the middle of squares.
+                    //Set the middle of each left/right edge, and the center of each square.
+                    for (unsigned int x = 0; x < noiseSize; x += squareSize)
+                    {
+                        float average = (noise[Vector2u(x, y - halfSize)] + noise[Vector2u(x, y + halfSize)]) * 0.5f;
+                        SetPoint(noise, Vector2u(x, y), average, variance);
+
+                        if (x + halfSize < noiseSize)
+                        {
+                            average = noise[Vector2u(x, y - halfSize)] + noise[Vector2u(x + squareSize, y - halfSize)] +
+                                      noise[Vector2u(x, y + halfSize)] + noise[Vector2u(x + squareSize, y + halfSize)];
+                            average *= 0.25f;
+                            SetPoint(noise, Vector2u(x + halfSize, y), average, variance);
+                        }
+                    }
+                }
+            }
+        });
+    }
 }
\ No newline at end of file
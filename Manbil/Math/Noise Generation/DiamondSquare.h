@@ -20,7 +20,10 @@ struct DiamondSquareStep
 //The noise array should be pre-filled with NaN; any values that aren't NaN will be left alone.
 //This allows the user to seed values to effect the this algorithm.
 //The noise array that uses this generator must be a square whose sides are one more than a power of two.
-class DiamondSquare : Generator2D
+//Each level of detail is split into "NumbThreads" bands of rows, which are computed in parallel.
+//The random offset for each point comes from hashing its position and the seed,
+//    so the noise is exactly the same no matter how many threads are used.
+class DiamondSquare : public Generator2D
 {
 public:
 
@@ -45,5 +48,7 @@ public:
 
 private:
 
-	void DiamondSquare::IterateAlgorithm(unsigned int size, Vector2u topLeft, Interval* variances, Array2D<float>& noise) const;
+	//If the given point hasn't been set yet, sets it to the given average of its neighbors
+	//    plus a random offset inside the given variance.
+	void SetPoint(Noise2D& noise, Vector2u pos, float neighborAverage, const Interval& variance) const;
 };
\ No newline at end of file
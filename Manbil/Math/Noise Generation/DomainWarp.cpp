@@ -0,0 +1,187 @@
+#include "DomainWarp.h"
+
+
+namespace
+{
+    //Positions are warped and sampled this many at a time, so the temporary values fit on the stack.
+    const unsigned int BatchSize = 128;
+}
+
+
+void DomainWarp2D::Generate(Noise2D& outNoise) const
+{
+    assert(CanSample());
+
+    ForEachRowBand(outNoise.GetHeight(), [this, &outNoise](unsigned int band, unsigned int startY, unsigned int endY)
+    {
+        std::vector<Vector2f> positions(outNoise.GetWidth());
+        for (unsigned int y = startY; y < endY; ++y)
+        {
+            for (unsigned int x = 0; x < positions.size(); ++x)
+                positions[x] = Vector2f((float)x, (float)y);
+            SampleMany(positions.data(), &outNoise[Vector2u(0, y)], outNoise.GetWidth());
+        }
+    });
+}
+
+float DomainWarp2D::Sample(Vector2f pos) const
+{
+    Vector2f warp(Warp->Sample(pos), Warp->Sample(pos + WarpOffsetY));
+    return Base->Sample(pos + Vector2f(Strength * (warp.x - WarpCenter), Strength * (warp.y - WarpCenter)));
+}
+void DomainWarp2D::SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const
+{
+    Vector2f shifted[BatchSize], warped[BatchSize];
+    float warpX[BatchSize], warpY[BatchSize];
+
+    for (unsigned int start = 0; start < nPositions; start += BatchSize)
+    {
+        const Vector2f* batch = positions + start;
+        unsigned int count = Mathf::Min(BatchSize, nPositions - start);
+
+        for (unsigned int i = 0; i < count; ++i)
+            shifted[i] = batch[i] + WarpOffsetY;
+        Warp->SampleMany(batch, warpX, count);
+        Warp->SampleMany(shifted, warpY, count);
+
+        for (unsigned int i = 0; i < count; ++i)
+            warped[i] = batch[i] + Vector2f(Strength * (warpX[i] - WarpCenter), Strength * (warpY[i] - WarpCenter));
+        Base->SampleMany(warped, outValues + start, count);
+    }
+}
+void DomainWarp2D::SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients,
+                                   unsigned int nPositions) const
+{
+    Vector2f shifted[BatchSize], warped[BatchSize],
+             warpGradX[BatchSize], warpGradY[BatchSize], baseGrad[BatchSize];
+    float warpX[BatchSize], warpY[BatchSize];
+
+    for (unsigned int start = 0; start < nPositions; start += BatchSize)
+    {
+        const Vector2f* batch = positions + start;
+        unsigned int count = Mathf::Min(BatchSize, nPositions - start);
+
+        for (unsigned int i = 0; i < count; ++i)
+            shifted[i] = batch[i] + WarpOffsetY;
+        Warp->SampleGradients(batch, warpX, warpGradX, count);
+        Warp->SampleGradients(shifted, warpY, warpGradY, count);
+
+        for (unsigned int i = 0; i < count; ++i)
+            warped[i] = batch[i] + Vector2f(Strength * (warpX[i] - WarpCenter), Strength * (warpY[i] - WarpCenter));
+        Base->SampleGradients(warped, outValues + start, baseGrad, count);
+
+        //The warped position's derivative is "I + (Strength * warpJacobian)",
+        //    so the chain rule adds the warp gradients weighted by the base gradient.
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Vector2f g = baseGrad[i];
+            outGradients[start + i] = g + (((warpGradX[i] * g.x) + (warpGradY[i] * g.y)) * Strength);
+        }
+    }
+}
+
+
+void DomainWarp3D::Generate(Noise3D& outNoise) const
+{
+    assert(CanSample());
+
+    ForEachZSlab(outNoise.GetDepth(), [this, &outNoise](unsigned int slab, unsigned int startZ, unsigned int endZ)
+    {
+        if (startZ < endZ)
+            SampleSlices(outNoise.GetDimensions(), startZ, endZ, 0, outNoise);
+    });
+}
+void DomainWarp3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    assert(CanSample());
+    assert(startZ < endZ && endZ <= volumeSize.z);
+
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+    ForEachZSlab(endZ - startZ, [&](unsigned int slab, unsigned int slabStartZ, unsigned int slabEndZ)
+    {
+        if (slabStartZ < slabEndZ)
+            SampleSlices(volumeSize, startZ + slabStartZ, startZ + slabEndZ, startZ, outSlab);
+    });
+}
+void DomainWarp3D::SampleSlices(Vector3u volumeSize, unsigned int startZ, unsigned int endZ,
+                                unsigned int outStartZ, Noise3D& outNoise) const
+{
+    std::vector<Vector3f> positions(volumeSize.x);
+    for (unsigned int z = startZ; z < endZ; ++z)
+    {
+        for (unsigned int y = 0; y < volumeSize.y; ++y)
+        {
+            for (unsigned int x = 0; x < volumeSize.x; ++x)
+                positions[x] = Vector3f((float)x, (float)y, (float)z);
+            SampleMany(positions.data(), outNoise.GetRow(y, z - outStartZ), volumeSize.x);
+        }
+    }
+}
+
+float DomainWarp3D::Sample(Vector3f pos) const
+{
+    Vector3f warp(Warp->Sample(pos), Warp->Sample(pos + WarpOffsetY), Warp->Sample(pos + WarpOffsetZ));
+    return Base->Sample(pos + Vector3f(Strength * (warp.x - WarpCenter),
+                                       Strength * (warp.y - WarpCenter),
+                                       Strength * (warp.z - WarpCenter)));
+}
+void DomainWarp3D::SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const
+{
+    Vector3f shifted[BatchSize], warped[BatchSize];
+    float warpX[BatchSize], warpY[BatchSize], warpZ[BatchSize];
+
+    for (unsigned int start = 0; start < nPositions; start += BatchSize)
+    {
+        const Vector3f* batch = positions + start;
+        unsigned int count = Mathf::Min(BatchSize, nPositions - start);
+
+        Warp->SampleMany(batch, warpX, count);
+        for (unsigned int i = 0; i < count; ++i)
+            shifted[i] = batch[i] + WarpOffsetY;
+        Warp->SampleMany(shifted, warpY, count);
+        for (unsigned int i = 0; i < count; ++i)
+            shifted[i] = batch[i] + WarpOffsetZ;
+        Warp->SampleMany(shifted, warpZ, count);
+
+        for (unsigned int i = 0; i < count; ++i)
+            warped[i] = batch[i] + Vector3f(Strength * (warpX[i] - WarpCenter),
+                                            Strength * (warpY[i] - WarpCenter),
+                                            Strength * (warpZ[i] - WarpCenter));
+        Base->SampleMany(warped, outValues + start, count);
+    }
+}
+void DomainWarp3D::SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                   unsigned int nPositions) const
+{
+    Vector3f shifted[BatchSize], warped[BatchSize],
+             warpGradX[BatchSize], warpGradY[BatchSize], warpGradZ[BatchSize], baseGrad[BatchSize];
+    float warpX[BatchSize], warpY[BatchSize], warpZ[BatchSize];
+
+    for (unsigned int start = 0; start < nPositions; start += BatchSize)
+    {
+        const Vector3f* batch = positions + start;
+        unsigned int count = Mathf::Min(BatchSize, nPositions - start);
+
+        Warp->SampleGradients(batch, warpX, warpGradX, count);
+        for (unsigned int i = 0; i < count; ++i)
+            shifted[i] = batch[i] + WarpOffsetY;
+        Warp->SampleGradients(shifted, warpY, warpGradY, count);
+        for (unsigned int i = 0; i < count; ++i)
+            shifted[i] = batch[i] + WarpOffsetZ;
+        Warp->SampleGradients(shifted, warpZ, warpGradZ, count);
+
+        for (unsigned int i = 0; i < count; ++i)
+            warped[i] = batch[i] + Vector3f(Strength * (warpX[i] - WarpCenter),
+                                            Strength * (warpY[i] - WarpCenter),
+                                            Strength * (warpZ[i] - WarpCenter));
+        Base->SampleGradients(warped, outValues + start, baseGrad, count);
+
+        //The warped position's derivative is "I + (Strength * warpJacobian)",
+        //    so the chain rule adds the warp gradients weighted by the base gradient.
+        for (unsigned int i = 0; i < count; ++i)
+        {
+            Vector3f g = baseGrad[i];
+            outGradients[start + i] = g + (((warpGradX[i] * g.x) + (warpGradY[i] * g.y) + (warpGradZ[i] * g.z)) * Strength);
+        }
+    }
+}
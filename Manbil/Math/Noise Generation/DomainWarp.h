@@ -0,0 +1,117 @@
+#pragma once
+
+#include "BasicGenerators.h"
+
+
+//Distorts a base generator by moving each sample position by an amount taken from a "warp" generator:
+//    "value(pos) = Base(pos + (Strength * (warpOffset(pos) - WarpCenter)))".
+//The X offset is the warp noise at "pos", and the Y offset is the warp noise at "pos + WarpOffsetY",
+//    so a single warp generator gives two unrelated offsets.
+//Both generators are sampled together in batches through "SampleMany",
+//    so no full-size temporary arrays are needed and SIMD-sampled generators stay vectorized.
+//Both generators must be able to sample (see "Generator2D::CanSample").
+class DomainWarp2D : public Generator2D
+{
+public:
+
+    const Generator2D* Base;
+    const Generator2D* Warp;
+
+    //How far (in pixels) the warp noise moves each sample.
+    float Strength;
+    //The warp noise value that doesn't move the sample at all.
+    //Use 0.5 for noise in the range [0, 1], or 0 for noise centered around 0.
+    float WarpCenter;
+    //The offset of the second warp noise sample, which is used to move the Y coordinate.
+    //Should be big enough that the two samples aren't related to each other.
+    Vector2f WarpOffsetY;
+
+
+    DomainWarp2D(const Generator2D* base, const Generator2D* warp, float strength,
+                 float warpCenter = 0.5f, Vector2f warpOffsetY = Vector2f(5123.7f, 1327.3f))
+        : Base(base), Warp(warp), Strength(strength), WarpCenter(warpCenter), WarpOffsetY(warpOffsetY) { }
+
+
+    virtual void Generate(Noise2D& outNoise) const override;
+
+    virtual bool CanSample(void) const override { return Base->CanSample() && Warp->CanSample(); }
+    virtual float Sample(Vector2f pos) const override;
+    virtual void SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //The gradient comes from the chain rule, so it can be computed if both generators' gradients can.
+    virtual bool CanSampleGradients(void) const override { return Base->CanSampleGradients() && Warp->CanSampleGradients(); }
+    virtual void SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients,
+                                 unsigned int nPositions) const override;
+
+    //Can be hashed if both generators can be hashed.
+    virtual bool CanHash(void) const override { return Base->CanHash() && Warp->CanHash(); }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("DomainWarp2D").Add(Base->GetHash()).Add(Warp->GetHash())
+                                               .Add(Strength).Add(WarpCenter).Add(WarpOffsetY).Value;
+    }
+};
+
+
+//Distorts a base generator by moving each sample position by an amount taken from a "warp" generator:
+//    "value(pos) = Base(pos + (Strength * (warpOffset(pos) - WarpCenter)))".
+//The X offset is the warp noise at "pos", the Y offset is the warp noise at "pos + WarpOffsetY",
+//    and the Z offset is the warp noise at "pos + WarpOffsetZ".
+//Both generators are sampled together in batches through "SampleMany",
+//    so no full-size temporary arrays are needed and SIMD-sampled generators stay vectorized.
+//Both generators must be able to sample (see "Generator3D::CanSample").
+class DomainWarp3D : public Generator3D
+{
+public:
+
+    const Generator3D* Base;
+    const Generator3D* Warp;
+
+    //How far (in pixels) the warp noise moves each sample.
+    float Strength;
+    //The warp noise value that doesn't move the sample at all.
+    //Use 0.5 for noise in the range [0, 1], or 0 for noise centered around 0.
+    float WarpCenter;
+    //The offsets of the second and third warp noise samples, which are used to move the Y and Z coordinates.
+    //Should be big enough that the samples aren't related to each other.
+    Vector3f WarpOffsetY, WarpOffsetZ;
+
+
+    DomainWarp3D(const Generator3D* base, const Generator3D* warp, float strength, float warpCenter = 0.5f,
+                 Vector3f warpOffsetY = Vector3f(5123.7f, 1327.3f, 3671.1f),
+                 Vector3f warpOffsetZ = Vector3f(2741.9f, 6203.1f, 4517.3f))
+        : Base(base), Warp(warp), Strength(strength), WarpCenter(warpCenter),
+          WarpOffsetY(warpOffsetY), WarpOffsetZ(warpOffsetZ) { }
+
+
+    virtual void Generate(Noise3D& outNoise) const override;
+
+    //Every slab is sampled on its own.
+    virtual bool CanGenerateSlab(void) const override { return CanSample(); }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    virtual bool CanSample(void) const override { return Base->CanSample() && Warp->CanSample(); }
+    virtual float Sample(Vector3f pos) const override;
+    virtual void SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //The gradient comes from the chain rule, so it can be computed if both generators' gradients can.
+    virtual bool CanSampleGradients(void) const override { return Base->CanSampleGradients() && Warp->CanSampleGradients(); }
+    virtual void SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                 unsigned int nPositions) const override;
+
+    //Can be hashed if both generators can be hashed.
+    virtual bool CanHash(void) const override { return Base->CanHash() && Warp->CanHash(); }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("DomainWarp3D").Add(Base->GetHash()).Add(Warp->GetHash()).Add(Strength)
+                                               .Add(WarpCenter).Add(WarpOffsetY).Add(WarpOffsetZ).Value;
+    }
+
+
+private:
+
+    //Samples every row of Z slices "startZ" through "endZ - 1",
+    //    putting each slice "z" into slice "z - outStartZ" of "outNoise".
+    void SampleSlices(Vector3u volumeSize, unsigned int startZ, unsigned int endZ,
+                      unsigned int outStartZ, Noise3D& outNoise) const;
+};
@@ -0,0 +1,156 @@
+#include "FusedGenerator.h"
+
+
+unsigned int FusedGenerator2D::AddStages(const Generator2D* gen, Vector2u noiseSize, std::vector<Stage>& outStages)
+{
+    //If this generator is used more than once in the tree, reuse its stage.
+    for (unsigned int i = 0; i < outStages.size(); ++i)
+        if (outStages[i].Gen == gen)
+            return i;
+
+    Stage stage(Stage::ST_SAMPLE, gen);
+
+    const LayeredOctave2D* octaves = dynamic_cast<const LayeredOctave2D*>(gen);
+    const Combine2Noises2D* combine2 = dynamic_cast<const Combine2Noises2D*>(gen);
+    const Combine3Noises2D* combine3 = dynamic_cast<const Combine3Noises2D*>(gen);
+    if (octaves != 0)
+    {
+        stage.Type = Stage::ST_OCTAVES;
+        for (unsigned int i = 0; i < octaves->GetNumbOctaves(); ++i)
+        {
+            stage.Inputs.push_back(AddStages(octaves->GetOctave(i), noiseSize, outStages));
+            stage.Weights.push_back(octaves->GetOctaveWeight(i));
+        }
+    }
+    else if (combine2 != 0)
+    {
+        stage.Type = Stage::ST_COMBINE2;
+        stage.Combine2 = combine2->CombineOp;
+        stage.Inputs.push_back(AddStages(combine2->First, noiseSize, outStages));
+        stage.Inputs.push_back(AddStages(combine2->Second, noiseSize, outStages));
+    }
+    else if (combine3 != 0)
+    {
+        stage.Type = Stage::ST_COMBINE3;
+        stage.Combine3 = combine3->CombineOp;
+        stage.Inputs.push_back(AddStages(combine3->First, noiseSize, outStages));
+        stage.Inputs.push_back(AddStages(combine3->Second, noiseSize, outStages));
+        stage.Inputs.push_back(AddStages(combine3->Third, noiseSize, outStages));
+    }
+    else if (!gen->CanSample())
+    {
+        //This generator needs the whole array, so generate it up-front.
+        stage.Type = Stage::ST_MATERIALIZED;
+        stage.Materialized = std::make_shared<Noise2D>(noiseSize.x, noiseSize.y);
+        gen->Generate(*stage.Materialized);
+    }
+
+    outStages.push_back(stage);
+    return outStages.size() - 1;
+}
+
+void FusedGenerator2D::Generate(Noise2D& outNoise) const
+{
+    assert(TileSize > 0);
+
+    //If the root needs the whole array anyway, there's nothing to fuse.
+    if (dynamic_cast<const LayeredOctave2D*>(Root) == 0 &&
+        dynamic_cast<const Combine2Noises2D*>(Root) == 0 &&
+        dynamic_cast<const Combine3Noises2D*>(Root) == 0 &&
+        !Root->CanSample())
+    {
+        Root->Generate(outNoise);
+        return;
+    }
+
+    //Walk the tree to get every stage. The root's stage is always the last one.
+    std::vector<Stage> stages;
+    AddStages(Root, outNoise.GetDimensions(), stages);
+    unsigned int rootStage = stages.size() - 1;
+
+    //Evaluate every tile, splitting the rows of tiles into bands.
+    Vector2u nTiles((outNoise.GetWidth() + TileSize - 1) / TileSize,
+                    (outNoise.GetHeight() + TileSize - 1) / TileSize);
+    ForEachRowBand(nTiles.y, [&](unsigned int band, unsigned int startTileY, unsigned int endTileY)
+    {
+        //Each stage keeps one tile's worth of values.
+        unsigned int maxTileValues = TileSize * TileSize;
+        std::vector<std::vector<float>> stageValues(stages.size(), std::vector<float>(maxTileValues));
+        std::vector<Vector2f> positions(maxTileValues);
+
+        for (Vector2u tile(0, startTileY); tile.y < endTileY; ++tile.y)
+        {
+            for (tile.x = 0; tile.x < nTiles.x; ++tile.x)
+            {
+                Vector2u tileStart(tile.x * TileSize, tile.y * TileSize),
+                         tileSize(Mathf::Min(TileSize, outNoise.GetWidth() - tileStart.x),
+                                  Mathf::Min(TileSize, outNoise.GetHeight() - tileStart.y));
+                unsigned int nValues = tileSize.x * tileSize.y;
+
+                Vector2u loc;
+                unsigned int i = 0;
+                for (loc.y = 0; loc.y < tileSize.y; ++loc.y)
+                    for (loc.x = 0; loc.x < tileSize.x; ++loc.x)
+                        positions[i++] = ToV2f(tileStart + loc);
+
+                //Run each stage on this tile.
+                for (unsigned int stageI = 0; stageI < stages.size(); ++stageI)
+                {
+                    const Stage& stage = stages[stageI];
+                    float* values = stageValues[stageI].data();
+
+                    switch (stage.Type)
+                    {
+                        case Stage::ST_SAMPLE:
+                            stage.Gen->SampleMany(positions.data(), values, nValues);
+                            break;
+
+                        case Stage::ST_MATERIALIZED:
+                            i = 0;
+                            for (loc.y = 0; loc.y < tileSize.y; ++loc.y)
+                                for (loc.x = 0; loc.x < tileSize.x; ++loc.x)
+                                    values[i++] = (*stage.Materialized)[tileStart + loc];
+                            break;
+
+                        //Add up the octaves in the same order as "LayeredOctave2D::Generate".
+                        case Stage::ST_OCTAVES:
+                            for (i = 0; i < nValues; ++i)
+                                values[i] = 0.0f;
+                            for (unsigned int input = 0; input < stage.Inputs.size(); ++input)
+                            {
+                                const float* inValues = stageValues[stage.Inputs[input]].data();
+                                float weight = stage.Weights[input];
+                                for (i = 0; i < nValues; ++i)
+                                    values[i] += inValues[i] * weight;
+                            }
+                            break;
+
+                        case Stage::ST_COMBINE2: {
+                            const float* first = stageValues[stage.Inputs[0]].data(),
+                                       * second = stageValues[stage.Inputs[1]].data();
+                            for (i = 0; i < nValues; ++i)
+                                values[i] = stage.Combine2(first[i], second[i]);
+                            } break;
+
+                        case Stage::ST_COMBINE3: {
+                            const float* first = stageValues[stage.Inputs[0]].data(),
+                                       * second = stageValues[stage.Inputs[1]].data(),
+                                       * third = stageValues[stage.Inputs[2]].data();
+                            for (i = 0; i < nValues; ++i)
+                                values[i] = stage.Combine3(first[i], second[i], third[i]);
+                            } break;
+
+                        default: assert(false);
+                    }
+                }
+
+                //Copy the root's values into the output.
+                const float* rootValues = stageValues[rootStage].data();
+                for (loc.y = 0; loc.y < tileSize.y; ++loc.y)
+                    memcpy(&outNoise[tileStart + Vector2u(0, loc.y)],
+                           &rootValues[loc.y * tileSize.x],
+                           sizeof(float) * tileSize.x);
+            }
+        }
+    });
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vector>
+#include <memory>
+#include "LayeredOctave.h"
+#include "NoiseCombinations.h"
+
+
+//Evaluates a whole tree of 2D generators in a single pass, one small tile of noise at a time,
+//    instead of generating a full temporary array for every stage of the tree.
+//The tree is walked once at the start of each "Generate" call:
+//    * LayeredOctave2D, Combine2Noises2D, and Combine3Noises2D are fused into the tile pass.
+//    * Any other generator that can be sampled (see "Generator2D::CanSample") is sampled in the tile pass.
+//    * Any other generator (e.x. filters, interpolators, or remapped Perlin/Worley noise)
+//          is generated into its own full-size array once, and the tile pass reads from that array.
+//A stage that is sampled gives slightly different values than generating it by itself
+//    at the very edges of the noise; see the generator's "Sample" function for details.
+class FusedGenerator2D : public Generator2D
+{
+public:
+
+    //The generator at the top of the tree.
+    const Generator2D* Root;
+    //The width/height of each tile. Every stage of the tree keeps one tile's worth of values,
+    //    so smaller tiles stay in the cache better but have more overhead.
+    unsigned int TileSize;
+
+
+    FusedGenerator2D(const Generator2D* root, unsigned int tileSize = 64)
+        : Root(root), TileSize(tileSize) { }
+
+
+    virtual void Generate(Noise2D& outNoise) const override;
+
+    virtual bool CanSample(void) const override { return Root->CanSample(); }
+    virtual float Sample(Vector2f pos) const override { return Root->Sample(pos); }
+    virtual void SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const override
+    {
+        Root->SampleMany(positions, outValues, nPositions);
+    }
+
+    //Generates the same noise as the root, so it has the same hash.
+    virtual bool CanHash(void) const override { return Root->CanHash(); }
+    virtual unsigned long long GetHash(void) const override { return Root->GetHash(); }
+
+
+private:
+
+    //A single stage of the generator tree.
+    struct Stage
+    {
+        enum Types
+        {
+            //Calls "SampleMany" on the generator.
+            ST_SAMPLE,
+            //Reads from a pre-generated array.
+            ST_MATERIALIZED,
+            //Adds up the weighted inputs.
+            ST_OCTAVES,
+            //Combines two inputs with "Combine2".
+            ST_COMBINE2,
+            //Combines three inputs with "Combine3".
+            ST_COMBINE3,
+        };
+
+        Types Type;
+        const Generator2D* Gen;
+
+        //The indices of the stages this stage reads from. They always come before this stage.
+        std::vector<unsigned int> Inputs;
+        //The weight of each input for "ST_OCTAVES".
+        std::vector<float> Weights;
+        Combine2Noises2D::CombinationFunc Combine2;
+        Combine3Noises2D::CombinationFunc Combine3;
+
+        //The generated noise for "ST_MATERIALIZED".
+        std::shared_ptr<Noise2D> Materialized;
+
+        Stage(Types type, const Generator2D* gen)
+            : Type(type), Gen(gen), Combine2(0), Combine3(0) { }
+    };
+
+    //Adds the stages needed to compute the given generator into the given list.
+    //Returns the index of the generator's final stage.
+    static unsigned int AddStages(const Generator2D* gen, Vector2u noiseSize, std::vector<Stage>& outStages);
+};
@@ -29,60 +29,110 @@ void Interpolator2D::Generate(Array2D<float>& outN) const
 
 	unsigned int w = outN.GetWidth(),
                  h = outN.GetHeight();
-    float wF = (float)w,
-          hF = (float)h;
+    //Grid positions wrap around before the last grid point, so the point after them always exists.
+    float gridW = (float)(toInterpSize.x - 1),
+          gridH = (float)(toInterpSize.y - 1);
 	float invScale = 1.0f / InterpolateScale;
-	Vector2u loc;
-    Vector2u srcLocMin, srcLocMax;
-    Vector2f lerpVal;
 
-    for (loc.y = 0; loc.y < h; ++loc.y)
+    ForEachRowBand(h, [&](unsigned int band, unsigned int startY, unsigned int endY)
     {
-        float srcY = (float)loc.y / InterpolateScale;
-        srcY += GridOffset.y;
+        Vector2u srcLocMin, srcLocMax;
+        Vector2f lerpVal;
 
-        //Wrap srcY to be inside the grid.
-        while (srcY < 0.0f)
-            srcY += hF;
-        srcY = fmodf(srcY, hF);
+        for (Vector2u loc(0, startY); loc.y < endY; ++loc.y)
+        {
+            float srcY = (float)loc.y / InterpolateScale;
+            srcY += GridOffset.y;
 
-        srcLocMin.y = (unsigned int)srcY;
+            //Wrap srcY to be inside the grid.
+            while (srcY < 0.0f)
+                srcY += gridH;
+            srcY = fmodf(srcY, gridH);
 
-        srcLocMax.y = srcLocMin.y + 1;
-        lerpVal.y = smoothStepper(srcY - (float)srcLocMin.y);
+            srcLocMin.y = (unsigned int)srcY;
 
-        for (loc.x = 0; loc.x < w; ++loc.x)
-        {
-            float srcX = (float)loc.x / InterpolateScale;
-            srcX += GridOffset.x;
-
-            //Wrap srcX to be inside the grid.
-            while (srcX < 0.0f)
-                srcX += wF;
-            srcX = fmodf(srcX, wF);
-
-            srcLocMin.x = (unsigned int)srcX;
-            srcLocMax.x = srcLocMin.x + 1;
-            lerpVal.x = smoothStepper(srcX - (float)srcLocMin.x);
-
-            outN[loc] = Mathf::Lerp(Mathf::Lerp(toInterp[srcLocMin],
-                                                        toInterp[Vector2u(srcLocMax.x, srcLocMin.y)],
-                                                        lerpVal.x),
-                                        Mathf::Lerp(toInterp[Vector2u(srcLocMin.x, srcLocMax.y)],
-                                                        toInterp[srcLocMax],
-                                                        lerpVal.x),
-                                        lerpVal.y);
+            srcLocMax.y = srcLocMin.y + 1;
+            lerpVal.y = smoothStepper(srcY - (float)srcLocMin.y);
+
+            for (loc.x = 0; loc.x < w; ++loc.x)
+            {
+                float srcX = (float)loc.x / InterpolateScale;
+                srcX += GridOffset.x;
+
+                //Wrap srcX to be inside the grid.
+                while (srcX < 0.0f)
+                    srcX += gridW;
+                srcX = fmodf(srcX, gridW);
+
+                srcLocMin.x = (unsigned int)srcX;
+                srcLocMax.x = srcLocMin.x + 1;
+                lerpVal.x = smoothStepper(srcX - (float)srcLocMin.x);
+
+                outN[loc] = Mathf::Lerp(Mathf::Lerp(toInterp[srcLocMin],
+                                                            toInterp[Vector2u(srcLocMax.x, srcLocMin.y)],
+                                                            lerpVal.x),
+                                            Mathf::Lerp(toInterp[Vector2u(srcLocMin.x, srcLocMax.y)],
+                                                            toInterp[srcLocMax],
+                                                            lerpVal.x),
+                                            lerpVal.y);
+            }
         }
-    }
+    });
 }
 void Interpolator3D::Generate(Array3D<float>& outN) const
 {
-    Vector3u toInterpSize((unsigned int)ceilf(outN.GetWidth() / InterpolateScale) + 1,
-                          (unsigned int)ceilf(outN.GetHeight() / InterpolateScale) + 1,
-                          (unsigned int)ceilf(outN.GetDepth() / InterpolateScale) + 1);
+    Vector3u toInterpSize = GetSizeToInterpolate(outN.GetDimensions());
 	Noise3D toInterp(toInterpSize.x, toInterpSize.y, toInterpSize.z);
     NoiseToInterpolate->Generate(toInterp);
 
+    InterpolateSlices(toInterp, 0, outN.GetDimensions(), 0, outN.GetDepth(), outN);
+}
+void Interpolator3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+
+    //Find the range of Z slices of the grid that these noise slices interpolate between.
+    //If the noise wraps around the grid partway through the slab, this range covers the whole grid.
+    Vector3u toInterpSize = GetSizeToInterpolate(volumeSize);
+    unsigned int toInterpStartZ = std::numeric_limits<unsigned int>::max(),
+                 toInterpEndZ = 0;
+    for (unsigned int z = startZ; z < endZ; ++z)
+    {
+        unsigned int minZ = (unsigned int)GetGridPos(z, GridOffset.z, toInterpSize.z);
+        toInterpStartZ = Mathf::Min(toInterpStartZ, minZ);
+        toInterpEndZ = Mathf::Max(toInterpEndZ, minZ + 2);
+    }
+    assert(toInterpEndZ <= toInterpSize.z);
+
+    //Generate just that part of the grid.
+    Noise3D toInterp(toInterpSize.x, toInterpSize.y, toInterpEndZ - toInterpStartZ);
+    NoiseToInterpolate->GenerateSlab(toInterpSize, toInterpStartZ, toInterpEndZ, toInterp);
+
+    InterpolateSlices(toInterp, toInterpStartZ, volumeSize, startZ, endZ, outSlab);
+}
+
+Vector3u Interpolator3D::GetSizeToInterpolate(Vector3u noiseSize) const
+{
+    return Vector3u((unsigned int)ceilf(noiseSize.x / InterpolateScale) + 1,
+                    (unsigned int)ceilf(noiseSize.y / InterpolateScale) + 1,
+                    (unsigned int)ceilf(noiseSize.z / InterpolateScale) + 1);
+}
+float Interpolator3D::GetGridPos(unsigned int noisePos, float gridOffset, unsigned int gridSize) const
+{
+    float gridPos = (float)noisePos / InterpolateScale;
+    gridPos += gridOffset;
+
+    //Wrap the position to be inside the grid.
+    //It wraps around before the last grid point, so the point after it always exists.
+    float wrapSize = (float)(gridSize - 1);
+    while (gridPos < 0.0f)
+        gridPos += wrapSize;
+    return fmodf(gridPos, wrapSize);
+}
+void Interpolator3D::InterpolateSlices(const Noise3D& toInterp, unsigned int toInterpStartZ, Vector3u noiseSize,
+                                       unsigned int startZ, unsigned int endZ, Noise3D& outN) const
+{
     float(*smoothStepper)(float inVal);
     switch (SmoothAmount)
     {
@@ -100,78 +150,61 @@ void Interpolator3D::Generate(Array3D<float>& outN) const
     }
 
 
-	unsigned int w = outN.GetWidth(),
-                 h = outN.GetHeight(),
-                 d = outN.GetDepth();
-    float wF = (float)w,
-          hF = (float)h,
-          dF = (float)d;
-	float invScale = 1.0f / InterpolateScale;
-	Vector3u loc;
-    Vector3u min, max;
-    Vector3f lerpVal;
+	unsigned int w = noiseSize.x,
+                 h = noiseSize.y;
+    Vector3u gridSize = GetSizeToInterpolate(noiseSize);
 
-    for (loc.z = 0; loc.z < d; ++loc.z)
+    ForEachZSlab(endZ - startZ, [&](unsigned int slab, unsigned int slabStartZ, unsigned int slabEndZ)
     {
-        float srcZ = (float)loc.z / InterpolateScale;
-        srcZ += GridOffset.z;
-
-        //Wrap srcZ to be inside the grid.
-        while (srcZ < 0.0f)
-            srcZ += dF;
-        srcZ = fmodf(srcZ, dF);
+        Vector3u min, max;
+        Vector3f lerpVal;
 
-        min.z = (unsigned int)srcZ;
-        max.z = min.z + 1;
-        lerpVal.z = smoothStepper(srcZ - (float)min.z);
-
-        for (loc.y = 0; loc.y < h; ++loc.y)
+        for (Vector3u loc(0, 0, slabStartZ); loc.z < slabEndZ; ++loc.z)
         {
-            float srcY = (float)loc.y / InterpolateScale;
-            srcY += GridOffset.y;
-
-            //Wrap srcY to be inside the grid.
-            while (srcY < 0.0f)
-                srcY += hF;
-            srcY = fmodf(srcY, hF);
+            float srcZ = GetGridPos(loc.z + startZ, GridOffset.z, gridSize.z);
 
-            min.y = (unsigned int)srcY;
-            max.y = min.y + 1;
-            lerpVal.y = smoothStepper(srcY - (float)min.y);
+            min.z = (unsigned int)srcZ;
+            max.z = min.z + 1;
+            lerpVal.z = smoothStepper(srcZ - (float)min.z);
+            min.z -= toInterpStartZ;
+            max.z -= toInterpStartZ;
 
-            for (loc.x = 0; loc.x < w; ++loc.x)
+            for (loc.y = 0; loc.y < h; ++loc.y)
             {
-                float srcX = (float)loc.x / InterpolateScale;
-                srcX += GridOffset.x;
-
-                //Wrap srcX to be inside the grid.
-                while (srcX < 0.0f)
-                    srcX += wF;
-                srcX = fmodf(srcX, wF);
-
-                min.x = (unsigned int)srcX;
-                max.x = min.x + 1;
-                lerpVal.x = smoothStepper(srcX - (float)min.x);
-
-                //Interpolate along the X, then along the Y, then along the Z.
-                float x1, x2, x3, x4;
-                x1 = Mathf::Lerp(toInterp[Vector3u(min.x, min.y, min.z)],
-                                 toInterp[Vector3u(max.x, min.y, min.z)],
-                                 lerpVal.x);
-                x2 = Mathf::Lerp(toInterp[Vector3u(min.x, max.y, min.z)],
-                                 toInterp[Vector3u(max.x, max.y, min.z)],
-                                 lerpVal.x);
-                x3 = Mathf::Lerp(toInterp[Vector3u(min.x, min.y, max.z)],
-                                 toInterp[Vector3u(max.x, min.y, max.z)],
-                                 lerpVal.x);
-                x4 = Mathf::Lerp(toInterp[Vector3u(min.x, max.y, max.z)],
-                                 toInterp[Vector3u(max.x, max.y, max.z)],
-                                 lerpVal.x);
-                float y1, y2;
-                y1 = Mathf::Lerp(x1, x2, lerpVal.y);
-                y2 = Mathf::Lerp(x3, x4, lerpVal.y);
-                outN[loc] = Mathf::Lerp(y1, y2, lerpVal.z);
+                float srcY = GetGridPos(loc.y, GridOffset.y, gridSize.y);
+
+                min.y = (unsigned int)srcY;
+                max.y = min.y + 1;
+                lerpVal.y = smoothStepper(srcY - (float)min.y);
+
+                for (loc.x = 0; loc.x < w; ++loc.x)
+                {
+                    float srcX = GetGridPos(loc.x, GridOffset.x, gridSize.x);
+
+                    min.x = (unsigned int)srcX;
+                    max.x = min.x + 1;
+                    lerpVal.x = smoothStepper(srcX - (float)min.x);
+
+                    //Interpolate along the X, then along the Y, then along the Z.
+                    float x1, x2, x3, x4;
+                    x1 = Mathf::Lerp(toInterp[Vector3u(min.x, min.y, min.z)],
+                                     toInterp[Vector3u(max.x, min.y, min.z)],
+                                     lerpVal.x);
+                    x2 = Mathf::Lerp(toInterp[Vector3u(min.x, max.y, min.z)],
+                                     toInterp[Vector3u(max.x, max.y, min.z)],
+                                     lerpVal.x);
+                    x3 = Mathf::Lerp(toInterp[Vector3u(min.x, min.y, max.z)],
+                                     toInterp[Vector3u(max.x, min.y, max.z)],
+                                     lerpVal.x);
+                    x4 = Mathf::Lerp(toInterp[Vector3u(min.x, max.y, max.z)],
+                                     toInterp[Vector3u(max.x, max.y, max.z)],
+                                     lerpVal.x);
+                    float y1, y2;
+                    y1 = Mathf::Lerp(x1, x2, lerpVal.y);
+                    y2 = Mathf::Lerp(x3, x4, lerpVal.y);
+                    outN[loc] = Mathf::Lerp(y1, y2, lerpVal.z);
+                }
             }
         }
-    }
+    });
 }
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "BasicGenerators.h"
 
 //Scales up a noise grid and interpolates between the grid values to be smooth.
+//If "GridOffset" pushes the noise past the end of the grid, it wraps back around to the start.
 class Interpolator2D : public Generator2D
 {
 public:
@@ -33,6 +34,7 @@ public:
 
 
 //Scales up a noise grid and interpolates between the grid values to be smooth.
+//If "GridOffset" pushes the noise past the end of the grid, it wraps back around to the start.
 class Interpolator3D : public Generator3D
 {
 public:
@@ -59,4 +61,23 @@ public:
 
 
 	virtual void Generate(Noise3D& outNoise) const override;
+
+    //Each slab only generates the slices of the interpolated noise that it needs,
+    //    so it can be generated on its own if that noise can.
+    virtual bool CanGenerateSlab(void) const override { return NoiseToInterpolate->CanGenerateSlab(); }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+
+private:
+
+    //Gets the size of the grid of noise that gets interpolated for noise of the given size.
+    Vector3u GetSizeToInterpolate(Vector3u noiseSize) const;
+    //Gets the grid position along one axis of the given noise position,
+    //    wrapped around a grid with the given number of points along that axis.
+    float GetGridPos(unsigned int noisePos, float gridOffset, unsigned int gridSize) const;
+    //Interpolates the Z slices "startZ" through "endZ - 1" of noise with the given size.
+    //The first Z slice of "toInterp" is grid slice "toInterpStartZ",
+    //    and the first Z slice of "outN" is noise slice "startZ".
+    void InterpolateSlices(const Noise3D& toInterp, unsigned int toInterpStartZ, Vector3u noiseSize,
+                           unsigned int startZ, unsigned int endZ, Noise3D& outN) const;
 };
\ No newline at end of file
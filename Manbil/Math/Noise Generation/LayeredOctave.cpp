@@ -1,5 +1,7 @@
 #include "LayeredOctave.h"
 
+#include <vector>
+
 LayeredOctave2D::LayeredOctave2D(unsigned int numbOctaves, const float octaveWeights[], const Generator2D *const*const octaves)
 {
 	Octaves = numbOctaves;
@@ -21,28 +23,104 @@ LayeredOctave2D::~LayeredOctave2D(void)
 
 void LayeredOctave2D::Generate(Array2D<float> & outNoiseArray) const
 {
-	//Put this temp array on the heap; it won't fit on the stack.
-	Array2D<float> * tempNoiseArray = new Array2D<float>(outNoiseArray.GetWidth(),
-											             outNoiseArray.GetHeight(),
-														 0.0f);
+	Array2D<float> tempNoiseArray(outNoiseArray.GetWidth(),
+                                  outNoiseArray.GetHeight(),
+                                  0.0f);
 	outNoiseArray.Fill(0.0f);
 
 	//Add successive octave noise into the "out" array.
-	unsigned int i;
-    Vector2u loc;
-    for (i = 0; i < Octaves; ++i)
+    for (unsigned int i = 0; i < Octaves; ++i)
     {
         //Put the octave into the temp array.
-        noises[i]->Generate(*tempNoiseArray);
+        noises[i]->Generate(tempNoiseArray);
 
         //Weight it and add it to the "out" array.
-        for (loc.y = 0; loc.y < outNoiseArray.GetHeight(); ++loc.y)
-            for (loc.x = 0; loc.x < outNoiseArray.GetWidth(); ++loc.x)
-                outNoiseArray[loc] += (*tempNoiseArray)[loc] * OctaveStrengths[i];
+        float strength = OctaveStrengths[i];
+        ForEachRowBand(outNoiseArray.GetHeight(),
+                       [&outNoiseArray, &tempNoiseArray, strength](unsigned int band, unsigned int startY, unsigned int endY)
+        {
+            for (Vector2u loc(0, startY); loc.y < endY; ++loc.y)
+                for (loc.x = 0; loc.x < outNoiseArray.GetWidth(); ++loc.x)
+                    outNoiseArray[loc] += tempNoiseArray[loc] * strength;
+        });
+    }
+}
+
+bool LayeredOctave2D::CanSample(void) const
+{
+    for (unsigned int i = 0; i < Octaves; ++i)
+        if (!noises[i]->CanSample())
+            return false;
+    return true;
+}
+float LayeredOctave2D::Sample(Vector2f pos) const
+{
+    float value;
+    SampleMany(&pos, &value, 1);
+    return value;
+}
+void LayeredOctave2D::SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const
+{
+    std::vector<float> octaveValues(nPositions);
+
+    //Add successive octave samples in the same order as "Generate".
+    for (unsigned int i = 0; i < nPositions; ++i)
+        outValues[i] = 0.0f;
+    for (unsigned int i = 0; i < Octaves; ++i)
+    {
+        noises[i]->SampleMany(positions, octaveValues.data(), nPositions);
+
+        float strength = OctaveStrengths[i];
+        for (unsigned int j = 0; j < nPositions; ++j)
+            outValues[j] += octaveValues[j] * strength;
+    }
+}
+
+bool LayeredOctave2D::CanSampleGradients(void) const
+{
+    for (unsigned int i = 0; i < Octaves; ++i)
+        if (!noises[i]->CanSampleGradients())
+            return false;
+    return true;
+}
+void LayeredOctave2D::SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients,
+                                      unsigned int nPositions) const
+{
+    std::vector<float> octaveValues(nPositions);
+    std::vector<Vector2f> octaveGradients(nPositions);
+
+    //Add successive octave samples in the same order as "Generate".
+    for (unsigned int i = 0; i < nPositions; ++i)
+    {
+        outValues[i] = 0.0f;
+        outGradients[i] = Vector2f();
     }
+    for (unsigned int i = 0; i < Octaves; ++i)
+    {
+        noises[i]->SampleGradients(positions, octaveValues.data(), octaveGradients.data(), nPositions);
 
-	//Clean up.
-	delete tempNoiseArray;
+        float strength = OctaveStrengths[i];
+        for (unsigned int j = 0; j < nPositions; ++j)
+        {
+            outValues[j] += octaveValues[j] * strength;
+            outGradients[j] += octaveGradients[j] * strength;
+        }
+    }
+}
+
+bool LayeredOctave2D::CanHash(void) const
+{
+    for (unsigned int i = 0; i < Octaves; ++i)
+        if (!noises[i]->CanHash())
+            return false;
+    return true;
+}
+unsigned long long LayeredOctave2D::GetHash(void) const
+{
+    GeneratorHasher hasher("LayeredOctave2D");
+    for (unsigned int i = 0; i < Octaves; ++i)
+        hasher.Add(noises[i]->GetHash()).Add(OctaveStrengths[i]);
+    return hasher.Value;
 }
 
 
@@ -75,17 +153,128 @@ void LayeredOctave3D::Generate(Array3D<float> & outNoiseArray) const
 
     //Add successive octave noise into the "out" array.
     outNoiseArray.Fill(0.0f);
-    unsigned int i;
-    Vector3u loc;
-    for (i = 0; i < Octaves; ++i)
+    for (unsigned int i = 0; i < Octaves; ++i)
     {
         //Put the octave into the temp array.
         noises[i]->Generate(tempNoiseArray);
 
         //Weight it and add it to the "out" array.
-        for (loc.z = 0; loc.z < outNoiseArray.GetDepth(); ++loc.z)
-            for (loc.y = 0; loc.y < outNoiseArray.GetHeight(); ++loc.y)
-                for (loc.x = 0; loc.x < outNoiseArray.GetWidth(); ++loc.x)
-                    outNoiseArray[loc] += (tempNoiseArray)[loc] * OctaveStrengths[i];
+        float strength = OctaveStrengths[i];
+        ForEachZSlab(outNoiseArray.GetDepth(),
+                     [&outNoiseArray, &tempNoiseArray, strength](unsigned int slab, unsigned int startZ, unsigned int endZ)
+        {
+            for (Vector3u loc(0, 0, startZ); loc.z < endZ; ++loc.z)
+                for (loc.y = 0; loc.y < outNoiseArray.GetHeight(); ++loc.y)
+                    for (loc.x = 0; loc.x < outNoiseArray.GetWidth(); ++loc.x)
+                        outNoiseArray[loc] += tempNoiseArray[loc] * strength;
+        });
+    }
+}
+
+bool LayeredOctave3D::CanGenerateSlab(void) const
+{
+    for (unsigned int i = 0; i < Octaves; ++i)
+        if (!noises[i]->CanGenerateSlab())
+            return false;
+    return true;
+}
+void LayeredOctave3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+    Array3D<float> tempSlab(outSlab.GetWidth(), outSlab.GetHeight(), outSlab.GetDepth());
+
+    //Add successive octave slabs in the same order as "Generate".
+    outSlab.Fill(0.0f);
+    for (unsigned int i = 0; i < Octaves; ++i)
+    {
+        noises[i]->GenerateSlab(volumeSize, startZ, endZ, tempSlab);
+
+        float strength = OctaveStrengths[i];
+        ForEachZSlab(outSlab.GetDepth(),
+                     [&outSlab, &tempSlab, strength](unsigned int slab, unsigned int slabStartZ, unsigned int slabEndZ)
+        {
+            for (Vector3u loc(0, 0, slabStartZ); loc.z < slabEndZ; ++loc.z)
+                for (loc.y = 0; loc.y < outSlab.GetHeight(); ++loc.y)
+                    for (loc.x = 0; loc.x < outSlab.GetWidth(); ++loc.x)
+                        outSlab[loc] += tempSlab[loc] * strength;
+        });
+    }
+}
+
+bool LayeredOctave3D::CanSample(void) const
+{
+    for (unsigned int i = 0; i < Octaves; ++i)
+        if (!noises[i]->CanSample())
+            return false;
+    return true;
+}
+float LayeredOctave3D::Sample(Vector3f pos) const
+{
+    float value;
+    SampleMany(&pos, &value, 1);
+    return value;
+}
+void LayeredOctave3D::SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const
+{
+    std::vector<float> octaveValues(nPositions);
+
+    //Add successive octave samples in the same order as "Generate".
+    for (unsigned int i = 0; i < nPositions; ++i)
+        outValues[i] = 0.0f;
+    for (unsigned int i = 0; i < Octaves; ++i)
+    {
+        noises[i]->SampleMany(positions, octaveValues.data(), nPositions);
+
+        float strength = OctaveStrengths[i];
+        for (unsigned int j = 0; j < nPositions; ++j)
+            outValues[j] += octaveValues[j] * strength;
     }
+}
+
+bool LayeredOctave3D::CanSampleGradients(void) const
+{
+    for (unsigned int i = 0; i < Octaves; ++i)
+        if (!noises[i]->CanSampleGradients())
+            return false;
+    return true;
+}
+void LayeredOctave3D::SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                      unsigned int nPositions) const
+{
+    std::vector<float> octaveValues(nPositions);
+    std::vector<Vector3f> octaveGradients(nPositions);
+
+    //Add successive octave samples in the same order as "Generate".
+    for (unsigned int i = 0; i < nPositions; ++i)
+    {
+        outValues[i] = 0.0f;
+        outGradients[i] = Vector3f();
+    }
+    for (unsigned int i = 0; i < Octaves; ++i)
+    {
+        noises[i]->SampleGradients(positions, octaveValues.data(), octaveGradients.data(), nPositions);
+
+        float strength = OctaveStrengths[i];
+        for (unsigned int j = 0; j < nPositions; ++j)
+        {
+            outValues[j] += octaveValues[j] * strength;
+            outGradients[j] += octaveGradients[j] * strength;
+        }
+    }
+}
+
+bool LayeredOctave3D::CanHash(void) const
+{
+    for (unsigned int i = 0; i < Octaves; ++i)
+        if (!noises[i]->CanHash())
+            return false;
+    return true;
+}
+unsigned long long LayeredOctave3D::GetHash(void) const
+{
+    GeneratorHasher hasher("LayeredOctave3D");
+    for (unsigned int i = 0; i < Octaves; ++i)
+        hasher.Add(noises[i]->GetHash()).Add(OctaveStrengths[i]);
+    return hasher.Value;
 }
\ No newline at end of file
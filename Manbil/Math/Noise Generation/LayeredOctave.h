@@ -13,10 +13,27 @@ public:
 	~LayeredOctave2D(void);
 
 	unsigned int GetNumbOctaves(void) const { return Octaves; }
+	const Generator2D* GetOctave(unsigned int i) const { return noises[i]; }
+	float GetOctaveWeight(unsigned int i) const { return OctaveStrengths[i]; }
 
 	//Generates the layered noise and puts it into the given array.
 	virtual void Generate(Noise2D & outNoiseArray) const override;
 
+    //Layered noise can be sampled if every octave can be sampled.
+    virtual bool CanSample(void) const override;
+    virtual float Sample(Vector2f pos) const override;
+    virtual void SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //The gradient of layered noise is the weighted sum of its octaves' gradients,
+    //    so it can be computed if every octave's gradient can be computed.
+    virtual bool CanSampleGradients(void) const override;
+    virtual void SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients,
+                                 unsigned int nPositions) const override;
+
+    //Layered noise can be hashed if every octave can be hashed.
+    virtual bool CanHash(void) const override;
+    virtual unsigned long long GetHash(void) const override;
+
 private:
 
 	Generator2D ** noises;
@@ -34,10 +51,31 @@ public:
     ~LayeredOctave3D(void);
 
     unsigned int GetNumbOctaves(void) const { return Octaves; }
+    const Generator3D* GetOctave(unsigned int i) const { return noises[i]; }
+    float GetOctaveWeight(unsigned int i) const { return OctaveStrengths[i]; }
 
     //Generates the layered noise and puts it into the given array.
     virtual void Generate(Noise3D & outNoiseArray) const override;
 
+    //Each slab of layered noise can be generated on its own if every octave's can.
+    virtual bool CanGenerateSlab(void) const override;
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    //Layered noise can be sampled if every octave can be sampled.
+    virtual bool CanSample(void) const override;
+    virtual float Sample(Vector3f pos) const override;
+    virtual void SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //The gradient of layered noise is the weighted sum of its octaves' gradients,
+    //    so it can be computed if every octave's gradient can be computed.
+    virtual bool CanSampleGradients(void) const override;
+    virtual void SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                 unsigned int nPositions) const override;
+
+    //Layered noise can be hashed if every octave can be hashed.
+    virtual bool CanHash(void) const override;
+    virtual unsigned long long GetHash(void) const override;
+
 private:
 
     Generator3D ** noises;
@@ -7,10 +7,12 @@ void Combine2Noises2D::Generate(Noise2D & nse) const
     First->Generate(first);
     Second->Generate(second);
 
-	Vector2u loc;
-    for (loc.y = 0; loc.y < nse.GetHeight(); ++loc.y)
-        for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
-            nse[loc] = CombineOp(first[loc], second[loc]);
+    ForEachRowBand(nse.GetHeight(), [&](unsigned int band, unsigned int startY, unsigned int endY)
+    {
+        for (Vector2u loc(0, startY); loc.y < endY; ++loc.y)
+            for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
+                nse[loc] = CombineOp(first[loc], second[loc]);
+    });
 }
 
 void Combine3Noises2D::Generate(Noise2D & nse) const
@@ -22,10 +24,12 @@ void Combine3Noises2D::Generate(Noise2D & nse) const
     Second->Generate(second);
     Third->Generate(third);
 
-    Vector2u loc;
-    for (loc.y = 0; loc.y < nse.GetHeight(); ++loc.y)
-        for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
-			nse[loc] = CombineOp(first[loc], second[loc], third[loc]);
+    ForEachRowBand(nse.GetHeight(), [&](unsigned int band, unsigned int startY, unsigned int endY)
+    {
+        for (Vector2u loc(0, startY); loc.y < endY; ++loc.y)
+            for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
+			    nse[loc] = CombineOp(first[loc], second[loc], third[loc]);
+    });
 }
 
 void Combine2Noises3D::Generate(Noise3D & nse) const
@@ -35,11 +39,13 @@ void Combine2Noises3D::Generate(Noise3D & nse) const
     First->Generate(first);
     Second->Generate(second);
 
-    Vector3u loc;
-    for (loc.z = 0; loc.z < nse.GetDepth(); ++loc.z)
-        for (loc.y = 0; loc.y < nse.GetHeight(); ++loc.y)
-            for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
-                nse[loc] = CombineOp(first[loc], second[loc]);
+    ForEachZSlab(nse.GetDepth(), [&](unsigned int slab, unsigned int startZ, unsigned int endZ)
+    {
+        for (Vector3u loc(0, 0, startZ); loc.z < endZ; ++loc.z)
+            for (loc.y = 0; loc.y < nse.GetHeight(); ++loc.y)
+                for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
+                    nse[loc] = CombineOp(first[loc], second[loc]);
+    });
 }
 
 void Combine3Noises3D::Generate(Noise3D & nse) const
@@ -51,9 +57,51 @@ void Combine3Noises3D::Generate(Noise3D & nse) const
     Second->Generate(second);
     Third->Generate(third);
 
-    Vector3u loc;
-    for (loc.z = 0; loc.z < nse.GetDepth(); ++loc.z)
-        for (loc.y = 0; loc.y < nse.GetHeight(); ++loc.y)
-            for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
-                nse[loc] = CombineOp(first[loc], second[loc], third[loc]);
+    ForEachZSlab(nse.GetDepth(), [&](unsigned int slab, unsigned int startZ, unsigned int endZ)
+    {
+        for (Vector3u loc(0, 0, startZ); loc.z < endZ; ++loc.z)
+            for (loc.y = 0; loc.y < nse.GetHeight(); ++loc.y)
+                for (loc.x = 0; loc.x < nse.GetWidth(); ++loc.x)
+                    nse[loc] = CombineOp(first[loc], second[loc], third[loc]);
+    });
+}
+
+void Combine2Noises3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+
+    Noise3D first(outSlab.GetWidth(), outSlab.GetHeight(), outSlab.GetDepth());
+    Noise3D second(outSlab.GetWidth(), outSlab.GetHeight(), outSlab.GetDepth());
+    First->GenerateSlab(volumeSize, startZ, endZ, first);
+    Second->GenerateSlab(volumeSize, startZ, endZ, second);
+
+    ForEachZSlab(outSlab.GetDepth(), [&](unsigned int slab, unsigned int slabStartZ, unsigned int slabEndZ)
+    {
+        for (Vector3u loc(0, 0, slabStartZ); loc.z < slabEndZ; ++loc.z)
+            for (loc.y = 0; loc.y < outSlab.GetHeight(); ++loc.y)
+                for (loc.x = 0; loc.x < outSlab.GetWidth(); ++loc.x)
+                    outSlab[loc] = CombineOp(first[loc], second[loc]);
+    });
+}
+
+void Combine3Noises3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+
+    Noise3D first(outSlab.GetWidth(), outSlab.GetHeight(), outSlab.GetDepth());
+    Noise3D second(outSlab.GetWidth(), outSlab.GetHeight(), outSlab.GetDepth());
+    Noise3D third(outSlab.GetWidth(), outSlab.GetHeight(), outSlab.GetDepth());
+    First->GenerateSlab(volumeSize, startZ, endZ, first);
+    Second->GenerateSlab(volumeSize, startZ, endZ, second);
+    Third->GenerateSlab(volumeSize, startZ, endZ, third);
+
+    ForEachZSlab(outSlab.GetDepth(), [&](unsigned int slab, unsigned int slabStartZ, unsigned int slabEndZ)
+    {
+        for (Vector3u loc(0, 0, slabStartZ); loc.z < slabEndZ; ++loc.z)
+            for (loc.y = 0; loc.y < outSlab.GetHeight(); ++loc.y)
+                for (loc.x = 0; loc.x < outSlab.GetWidth(); ++loc.x)
+                    outSlab[loc] = CombineOp(first[loc], second[loc], third[loc]);
+    });
 }
\ No newline at end of file
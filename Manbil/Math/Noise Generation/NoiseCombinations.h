@@ -37,6 +37,17 @@ public:
 		: CombineOp(combOp), First(first), Second(second) { }
 
 	virtual void Generate(Noise2D & noise) const override;
+
+    //Can be sampled if every combined generator can be sampled.
+    virtual bool CanSample(void) const override { return First->CanSample() && Second->CanSample(); }
+    virtual float Sample(Vector2f pos) const override { return CombineOp(First->Sample(pos), Second->Sample(pos)); }
+
+    //Can be hashed if every combined generator can be hashed.
+    virtual bool CanHash(void) const override { return First->CanHash() && Second->CanHash(); }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Combine2Noises2D").Add(CombineOp).Add(First->GetHash()).Add(Second->GetHash()).Value;
+    }
 };
 
 class Combine3Noises2D : public Generator2D
@@ -51,6 +62,18 @@ public:
     Combine3Noises2D(CombinationFunc combOp, Generator2D * first, Generator2D * second, Generator2D * third) : CombineOp(combOp), First(first), Second(second), Third(third) { }
 
 	virtual void Generate(Noise2D & noise) const override;
+
+    //Can be sampled if every combined generator can be sampled.
+    virtual bool CanSample(void) const override { return First->CanSample() && Second->CanSample() && Third->CanSample(); }
+    virtual float Sample(Vector2f pos) const override { return CombineOp(First->Sample(pos), Second->Sample(pos), Third->Sample(pos)); }
+
+    //Can be hashed if every combined generator can be hashed.
+    virtual bool CanHash(void) const override { return First->CanHash() && Second->CanHash() && Third->CanHash(); }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Combine3Noises2D").Add(CombineOp).Add(First->GetHash())
+                                                   .Add(Second->GetHash()).Add(Third->GetHash()).Value;
+    }
 };
 
 
@@ -68,6 +91,21 @@ public:
     { }
 
     virtual void Generate(Noise3D & noise) const override;
+
+    //Can be sampled if every combined generator can be sampled.
+    virtual bool CanSample(void) const override { return First->CanSample() && Second->CanSample(); }
+    virtual float Sample(Vector3f pos) const override { return CombineOp(First->Sample(pos), Second->Sample(pos)); }
+
+    //Can generate slabs on their own if every combined generator can.
+    virtual bool CanGenerateSlab(void) const override { return First->CanGenerateSlab() && Second->CanGenerateSlab(); }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    //Can be hashed if every combined generator can be hashed.
+    virtual bool CanHash(void) const override { return First->CanHash() && Second->CanHash(); }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Combine2Noises3D").Add(CombineOp).Add(First->GetHash()).Add(Second->GetHash()).Value;
+    }
 };
 
 class Combine3Noises3D : public Generator3D
@@ -82,4 +120,20 @@ public:
     Combine3Noises3D(CombinationFunc combOp, Generator3D * first, Generator3D * second, Generator3D * third) : CombineOp(combOp), First(first), Second(second), Third(third) { }
 
     virtual void Generate(Noise3D & noise) const override;
+
+    //Can be sampled if every combined generator can be sampled.
+    virtual bool CanSample(void) const override { return First->CanSample() && Second->CanSample() && Third->CanSample(); }
+    virtual float Sample(Vector3f pos) const override { return CombineOp(First->Sample(pos), Second->Sample(pos), Third->Sample(pos)); }
+
+    //Can generate slabs on their own if every combined generator can.
+    virtual bool CanGenerateSlab(void) const override { return First->CanGenerateSlab() && Second->CanGenerateSlab() && Third->CanGenerateSlab(); }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    //Can be hashed if every combined generator can be hashed.
+    virtual bool CanHash(void) const override { return First->CanHash() && Second->CanHash() && Third->CanHash(); }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Combine3Noises3D").Add(CombineOp).Add(First->GetHash())
+                                                   .Add(Second->GetHash()).Add(Third->GetHash()).Value;
+    }
 };
\ No newline at end of file
@@ -1,11 +1,132 @@
 #include "NoiseFilterer.h"
 
 #include <assert.h>
+#include <vector>
 
 
 #pragma warning(disable: 4100)
 
 
+//Helpers for the sliding-window blur used by "Smooth".
+namespace
+{
+    //Gets the index of the given position along an axis with the given number of positions.
+    //If the position is outside the axis, it's either wrapped around or (if not wrapping) -1 is returned.
+    int GetBlurPos(int pos, int axisSize, bool wrap)
+    {
+        if (pos >= 0 && pos < axisSize)
+            return pos;
+        if (!wrap)
+            return -1;
+
+        pos %= axisSize;
+        return (pos < 0) ? (pos + axisSize) : pos;
+    }
+
+    //Box-blurs each line in the range [startLine, endLine) along its length.
+    //"values" and "outValues" are split into lines that are each "lineLength" values long,
+    //    and each line starts "linePitch" values after the one before it (e.x. an array's row pitch).
+    void BoxBlurAlongLines(const float* values, float* outValues, unsigned int startLine, unsigned int endLine,
+                           unsigned int lineLength, unsigned int linePitch, unsigned int radius, bool wrap)
+    {
+        int length = (int)lineLength,
+            r = (int)radius;
+
+        for (unsigned int line = startLine; line < endLine; ++line)
+        {
+            const float* lineVals = values + ((size_t)line * linePitch);
+            float* outLineVals = outValues + ((size_t)line * linePitch);
+
+            //Start with the window around the first value, then slide it along the line.
+            double sum = 0.0;
+            unsigned int count = 0;
+            for (int i = -r; i <= r; ++i)
+            {
+                int pos = GetBlurPos(i, length, wrap);
+                if (pos >= 0)
+                {
+                    sum += lineVals[pos];
+                    count += 1;
+                }
+            }
+
+            for (int i = 0; i < length; ++i)
+            {
+                outLineVals[i] = (float)(sum / count);
+
+                int addedPos = GetBlurPos(i + r + 1, length, wrap),
+                    removedPos = GetBlurPos(i - r, length, wrap);
+                if (addedPos >= 0)
+                {
+                    sum += lineVals[addedPos];
+                    count += 1;
+                }
+                if (removedPos >= 0)
+                {
+                    sum -= lineVals[removedPos];
+                    count -= 1;
+                }
+            }
+        }
+    }
+    //Box-blurs the given lines across each other, so that every value is averaged
+    //    with the values in the same spot of the nearby lines.
+    //Each line starts "lineLength" values after the one before it, so padded rows can be blurred
+    //    by passing the row pitch.
+    //Only the values in the range [start, end) of each line are blurred.
+    //"sums" is used as scratch space.
+    void BoxBlurAcrossLines(const float* values, float* outValues, unsigned int nLines, unsigned int lineLength,
+                            unsigned int start, unsigned int end, unsigned int radius, bool wrap,
+                            std::vector<double>& sums)
+    {
+        int nLinesI = (int)nLines,
+            r = (int)radius;
+        unsigned int segmentLength = end - start;
+
+        //Keep a running sum for every value in the segment, and slide the window across the lines.
+        sums.assign(segmentLength, 0.0);
+        unsigned int count = 0;
+        auto addLine = [&](int line, double sign)
+        {
+            const float* lineVals = values + ((size_t)line * lineLength) + start;
+            for (unsigned int i = 0; i < segmentLength; ++i)
+                sums[i] += sign * lineVals[i];
+        };
+
+        for (int i = -r; i <= r; ++i)
+        {
+            int line = GetBlurPos(i, nLinesI, wrap);
+            if (line >= 0)
+            {
+                addLine(line, 1.0);
+                count += 1;
+            }
+        }
+
+        for (int line = 0; line < nLinesI; ++line)
+        {
+            float* outLineVals = outValues + ((size_t)line * lineLength) + start;
+            double invCount = 1.0 / count;
+            for (unsigned int i = 0; i < segmentLength; ++i)
+                outLineVals[i] = (float)(sums[i] * invCount);
+
+            int addedLine = GetBlurPos(line + r + 1, nLinesI, wrap),
+                removedLine = GetBlurPos(line - r, nLinesI, wrap);
+            if (addedLine >= 0)
+            {
+                addLine(addedLine, 1.0);
+                count += 1;
+            }
+            if (removedLine >= 0)
+            {
+                addLine(removedLine, -1.0);
+                count -= 1;
+            }
+        }
+    }
+}
+
+
 #pragma region TwoD Noise
 
 typedef NoiseFilterer2D NF2;
@@ -32,6 +153,11 @@ void NF2::RemapValues(Noise2D* _nse) const
 
 	Interval newVals = RemapValues_NewVals;
 	Interval oldVals = RemapValues_OldVals;
+    if (RemapValues_UseNoiseRange)
+    {
+        NoiseAnalysis2D::MinMax minMax = NoiseAnalysis2D::GetMinAndMax(*noise, GetNumbBands());
+        oldVals = Interval(minMax.Min, minMax.Max, 0.00001f);
+    }
 
 	struct RemapValuesStruct { Interval oldVs, newVs; Noise2D* nse; };
 	RemapValuesStruct rvs;
@@ -126,47 +252,48 @@ void NF2::Smooth(Noise2D* _nse) const
     if (_nse != 0)
 		noise = _nse;
 
-	SetAtEveryPoint((void*)0, [](void *pData, Vector2u loc, Noise2D* _noise)
-	{
-		float average = 0.0f;
-		unsigned int count = 0;
-
-#define ADD_NOISE(noiseX, noiseY) \
-	{ average += (*_noise)[Vector2u(noiseX, noiseY)]; \
-	  count += 1; }
-
-		ADD_NOISE(loc.x, loc.y);
-		if (loc.y > 0)
-			ADD_NOISE(loc.x, loc.y - 1);
-		if (loc.y < _noise->GetHeight() - 1)
-			ADD_NOISE(loc.x, loc.y + 1);
-
-		if (loc.x > 0)
-		{
-			ADD_NOISE(loc.x - 1, loc.y);
-			if (loc.y > 0)
-				ADD_NOISE(loc.x - 1, loc.y - 1);
-			if (loc.y < _noise->GetHeight() - 1)
-				ADD_NOISE(loc.x - 1, loc.y + 1);
-		}
-
-		if (loc.x < _noise->GetWidth() - 1)
-		{
-			ADD_NOISE(loc.x + 1, loc.y);
-			if (loc.y > 0)
-				ADD_NOISE(loc.x + 1, loc.y - 1);
-			if (loc.y < _noise->GetHeight() - 1)
-				ADD_NOISE(loc.x + 1, loc.y + 1);
-		}
+    unsigned int width = noise->GetWidth(),
+                 height = noise->GetHeight(),
+                 nPasses = (Smooth_Kernel == SmoothKernels::GAUSSIAN ? 3 : 1);
+    bool wrap = FillRegion->Wrap;
+
+    //Blur along the X and then along the Y, ping-ponging between two buffers.
+    //The buffers are laid out just like the noise (including any row padding).
+    Noise2D buffer1(width, height), buffer2(width, height);
+    buffer1.SetRowPadding(noise->HasRowPadding());
+    buffer2.SetRowPadding(noise->HasRowPadding());
+    unsigned int pitch = noise->GetRowPitch();
+    float* buffers[2] = { buffer1.GetArray(), buffer2.GetArray() };
+    const float* blurred = noise->GetArray();
+    for (unsigned int pass = 0; pass < nPasses * 2; ++pass)
+    {
+        float* outBlurred = buffers[pass % 2];
 
-#undef ADD_NOISE
+        if (pass < nPasses)
+        {
+            ForEachRowBand(height, [&](unsigned int band, unsigned int startY, unsigned int endY)
+            {
+                BoxBlurAlongLines(blurred, outBlurred, startY, endY, width, pitch, Smooth_Radius, wrap);
+            });
+        }
+        else
+        {
+            //Split the columns into bands instead of the rows, so each band can slide down the whole noise.
+            ThreadPool::GetGlobalPool().RunChunks(width, GetNumbBands(),
+                                                  [&](unsigned int band, unsigned int startX, unsigned int endX)
+            {
+                std::vector<double> sums;
+                BoxBlurAcrossLines(blurred, outBlurred, height, pitch, startX, endX, Smooth_Radius, wrap, sums);
+            });
+        }
 
-		if (count > 0)
-		{
-			average /= (float)count;
-		}
+        blurred = outBlurred;
+    }
 
-		return average;
+    //Blend the blurred values into the noise.
+	SetAtEveryPoint((void*)blurred, [](void *pData, Vector2u loc, Noise2D* _noise)
+	{
+        return ((const float*)pData)[_noise->GetIndex(loc.x, loc.y)];
 	});
 }
 
@@ -218,18 +345,15 @@ void NF2::Noise(Noise2D* _nse) const
     if (_nse != 0)
 		noise = _nse;
 
-	struct NoiseStruct { float amount; int seed; FastRand fr; };
+	struct NoiseStruct { float amount; int seed; };
 	NoiseStruct ns;
 	ns.amount = Noise_Amount;
 	ns.seed = Noise_Seed;
-	ns.fr = FastRand(Noise_Seed);
 
 	SetAtEveryPoint((void*)&ns, [](void* pData, Vector2u loc, Noise2D* _noise)
 	{
 		NoiseStruct* nS = (NoiseStruct*)pData;
-
-		nS->fr.Seed = Vector3i((int)loc.x, (int)loc.y, nS->seed).GetHashCode();
-		return (*_noise)[loc] + (nS->amount * nS->fr.GetZeroToOne());
+		return (*_noise)[loc] + (nS->amount * HashRand::GetZeroToOne(nS->seed, (int)loc.x, (int)loc.y));
 	});
 }
 
@@ -322,6 +446,11 @@ void NF3::RemapValues(Noise3D* _nse) const
 
     Interval newVals = RemapValues_NewVals;
     Interval oldVals = RemapValues_OldVals;
+    if (RemapValues_UseNoiseRange)
+    {
+        NoiseAnalysis3D::MinMax minMax = NoiseAnalysis3D::GetMinAndMax(*noise, GetNumbSlabs());
+        oldVals = Interval(minMax.Min, minMax.Max, 0.00001f);
+    }
 
     struct RemapValuesStruct { Interval oldVs, newVs; Noise3D* nse; };
     RemapValuesStruct rvs;
@@ -415,45 +544,66 @@ void NF3::Smooth(Noise3D* _nse) const
     if (_nse != 0)
         noise = _nse;
 
-    SetAtEveryPoint((void*)0, [](void *pData, Vector3u lc, Noise3D* _noise)
+    unsigned int width = noise->GetWidth(),
+                 height = noise->GetHeight(),
+                 depth = noise->GetDepth(),
+                 nPasses = (Smooth_Kernel == SmoothKernels::GAUSSIAN ? 3 : 1);
+    bool wrap = FillVolume->Wrap;
+
+    //Blur along the X, then the Y, then the Z, ping-ponging between two buffers.
+    //The buffers are laid out just like the noise (including any row padding).
+    Noise3D buffer1(width, height, depth), buffer2(width, height, depth);
+    buffer1.SetRowPadding(noise->HasRowPadding());
+    buffer2.SetRowPadding(noise->HasRowPadding());
+    unsigned int pitch = noise->GetRowPitch(),
+                 slicePitch = noise->GetSlicePitch();
+    float* buffers[2] = { buffer1.GetArray(), buffer2.GetArray() };
+    const float* blurred = noise->GetArray();
+    for (unsigned int pass = 0; pass < nPasses * 3; ++pass)
     {
-        //Average the surrounding values.
-        Vector3i noiseLoc;
-        float avg = 0.0f;
-        unsigned int count = 0;
-        for (Vector3i loc(0, 0, -1); loc.z <= 1; ++loc.z)
-        {
-            noiseLoc.z = loc.z + lc.z;
+        float* outBlurred = buffers[pass % 2];
 
-            if (noiseLoc.z < 0 || noiseLoc.z >= (int)_noise->GetDepth())
-                continue;
-
-            for (loc.y = -1; loc.y <= 1; ++loc.y)
+        if (pass < nPasses)
+        {
+            //Each row is a line along the X.
+            ThreadPool::GetGlobalPool().RunChunks(height * depth, GetNumbSlabs(),
+                                                  [&](unsigned int slab, unsigned int startRow, unsigned int endRow)
             {
-                noiseLoc.y = loc.y + lc.y;
-
-                if (noiseLoc.y < 0 || noiseLoc.y >= (int)_noise->GetHeight())
-                    continue;
-
-                for (loc.x = -1; loc.x <= 1; ++loc.x)
+                BoxBlurAlongLines(blurred, outBlurred, startRow, endRow, width, pitch, Smooth_Radius, wrap);
+            });
+        }
+        else if (pass < nPasses * 2)
+        {
+            //Each Z slice is blurred separately, by sliding down its rows.
+            ForEachZSlab(depth, [&](unsigned int slab, unsigned int startZ, unsigned int endZ)
+            {
+                std::vector<double> sums;
+                for (unsigned int z = startZ; z < endZ; ++z)
                 {
-                    noiseLoc.x = loc.x + lc.x;
-
-                    if ((noiseLoc.x >= 0 && noiseLoc.x < (int)_noise->GetWidth()) &&
-                        (loc.x != 0 || loc.y != 0 || loc.z != 0))
-                    {
-                        avg += (*_noise)[Vector3u((unsigned int)noiseLoc.x, (unsigned int)noiseLoc.y, (unsigned int)noiseLoc.z)];
-                        count += 1;
-                    }
+                    BoxBlurAcrossLines(blurred + ((size_t)z * slicePitch), outBlurred + ((size_t)z * slicePitch),
+                                       height, pitch, 0, width, Smooth_Radius, wrap, sums);
                 }
-            }
+            });
+        }
+        else
+        {
+            //Treat each Z slice as one long line, and split the slices into bands.
+            //Any row padding just gets blurred along with everything else.
+            ThreadPool::GetGlobalPool().RunChunks(slicePitch, GetNumbSlabs(),
+                                                  [&](unsigned int band, unsigned int start, unsigned int end)
+            {
+                std::vector<double> sums;
+                BoxBlurAcrossLines(blurred, outBlurred, depth, slicePitch, start, end, Smooth_Radius, wrap, sums);
+            });
         }
 
-        if (count > 0)
-            avg /= (float)count;
-        else avg = 0.5f;
+        blurred = outBlurred;
+    }
 
-        return avg;
+    //Blend the blurred values into the noise.
+    SetAtEveryPoint((void*)blurred, [](void *pData, Vector3u lc, Noise3D* _noise)
+    {
+        return ((const float*)pData)[_noise->GetIndex(lc.x, lc.y, lc.z)];
     });
 }
 
@@ -505,19 +655,16 @@ void NF3::Noise(Noise3D* _nse) const
     if (_nse != 0)
         noise = _nse;
 
-    struct NoiseStruct { float amount; int seed; FastRand fr; };
+    struct NoiseStruct { float amount; int seed; };
     NoiseStruct ns;
     ns.amount = Noise_Amount;
     ns.seed = Noise_Seed;
-    ns.fr = FastRand(Noise_Seed);
 
     SetAtEveryPoint((void*)&ns, [](void *pData, Vector3u loc, Noise3D* _noise)
     {
         NoiseStruct* nS = (NoiseStruct*)pData;
-
-        nS->fr.Seed = Vector4i(loc.x, loc.y, loc.z, nS->seed).GetHashCode();
-
-        return (*_noise)[loc] + (nS->amount * (-1.0f + (2.0f * nS->fr.GetZeroToOne())));
+        float rand = HashRand::GetZeroToOne(nS->seed, (int)loc.x, (int)loc.y, (int)loc.z);
+        return (*_noise)[loc] + (nS->amount * (-1.0f + (2.0f * rand)));
     });
 }
 
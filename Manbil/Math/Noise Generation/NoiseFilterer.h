@@ -19,6 +19,7 @@ public:
     {
         RemapValues_OldVals = Interval::GetZeroToOne();
         RemapValues_NewVals = Interval::GetZeroToOne();
+        RemapValues_UseNoiseRange = false;
 		InvertFunc = false;
 		FillRegion = 0;
 		NoiseToFilter = 0;
@@ -26,6 +27,9 @@ public:
 
 		Flatten_FlatValue = 0.0f;
 
+		Smooth_Radius = 1;
+		Smooth_Kernel = SmoothKernels::BOX;
+
 		Noise_Amount = 1.0f;
 		Noise_Seed = 12345;
 
@@ -50,6 +54,9 @@ public:
 	//Remaps the noise from the given original range to the given new range.
 	void RemapValues(Noise2D* nse = 0) const;
 	Interval RemapValues_OldVals, RemapValues_NewVals;
+    //If true, "RemapValues_OldVals" is ignored and the noise's actual min/max is used instead.
+    //The min/max is found in parallel, with one chunk per band of rows.
+    bool RemapValues_UseNoiseRange;
 
 
 	//Reflects the noise's values around the center of the noise range. The strength will always be 1.0 regardless of what is passed in.
@@ -87,8 +94,24 @@ public:
     float Min_Value, Max_Value;
 
 
-	//Smooths the area.
+	//Smooths the area by blurring it.
+    //The blur is split into one pass along each axis, and each pass keeps a running sum
+    //    as it slides along the noise, so the cost doesn't depend on "Smooth_Radius".
+    //If "FillRegion" wraps, the blur wraps around the edges of the noise;
+    //    otherwise, it only averages the values that are inside the noise.
     void Smooth(Noise2D* nse = 0) const;
+    //The number of pixels on each side of a pixel that get blurred into it.
+    unsigned int Smooth_Radius;
+    //The shape of the blur.
+    enum SmoothKernels
+    {
+        //Evenly averages every pixel within "Smooth_Radius".
+        BOX,
+        //Applies the box blur three times, which closely approximates a Gaussian blur
+        //    with a standard deviation of "sqrt(Smooth_Radius * (Smooth_Radius + 1))".
+        GAUSSIAN,
+    };
+    SmoothKernels Smooth_Kernel;
 
 
 	//Adds random noise to the area.
@@ -138,6 +161,7 @@ public:
     {
         RemapValues_OldVals = Interval::GetZeroToOne();
         RemapValues_NewVals = Interval::GetZeroToOne();
+        RemapValues_UseNoiseRange = false;
         InvertFunc = false;
         FillVolume = 0;
         NoiseToFilter = 0;
@@ -145,6 +169,9 @@ public:
 
         Set_Value = 0.5f;
 
+        Smooth_Radius = 1;
+        Smooth_Kernel = SmoothKernels::BOX;
+
         Noise_Amount = 1.0f;
         Noise_Seed = 12345;
 
@@ -166,6 +193,9 @@ public:
     //Remaps the noise from the given original range to the range 0.0-1.0.
     void RemapValues(Noise3D* nse = 0) const;
     Interval RemapValues_OldVals, RemapValues_NewVals;
+    //If true, "RemapValues_OldVals" is ignored and the noise's actual min/max is used instead.
+    //The min/max is found in parallel, with one chunk per slab.
+    bool RemapValues_UseNoiseRange;
 
 
     //Reflects the noise's values around the center of the noise range. The strength will always be 1.0 regardless of what is passed in.
@@ -203,8 +233,24 @@ public:
     float Min_Value, Max_Value;
 
 
-    //Smooths an area.
+    //Smooths an area by blurring it.
+    //The blur is split into one pass along each axis, and each pass keeps a running sum
+    //    as it slides along the noise, so the cost doesn't depend on "Smooth_Radius".
+    //If "FillVolume" wraps, the blur wraps around the edges of the noise;
+    //    otherwise, it only averages the values that are inside the noise.
     void Smooth(Noise3D* nse = 0) const;
+    //The number of pixels on each side of a pixel that get blurred into it.
+    unsigned int Smooth_Radius;
+    //The shape of the blur.
+    enum SmoothKernels
+    {
+        //Evenly averages every pixel within "Smooth_Radius".
+        BOX,
+        //Applies the box blur three times, which closely approximates a Gaussian blur
+        //    with a standard deviation of "sqrt(Smooth_Radius * (Smooth_Radius + 1))".
+        GAUSSIAN,
+    };
+    SmoothKernels Smooth_Kernel;
 
 
     //Adds random noise to an area.
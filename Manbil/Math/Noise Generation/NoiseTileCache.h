@@ -0,0 +1,412 @@
+#pragma once
+
+#include <unordered_map>
+#include <list>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include "BasicGenerators.h"
+
+
+//Describes square 2D tiles of noise for "NoiseTileCache".
+struct NoiseTile2D
+{
+    typedef Generator2D Generator;
+    typedef Noise2D Noise;
+    typedef Vector2i TileCoord;
+
+    static unsigned int GetNumbValues(unsigned int tileSize) { return tileSize * tileSize; }
+    static Noise* MakeTile(unsigned int tileSize) { return new Noise(tileSize, tileSize); }
+
+    //Fills the given tile by sampling the given generator.
+    //The tile's values are written as one contiguous block, so it can't have row padding
+    //    (tiles from "MakeTile" never do).
+    static void SampleTile(const Generator& gen, TileCoord tile, Noise& outTile)
+    {
+        assert(!outTile.HasRowPadding());
+
+        unsigned int tileSize = outTile.GetWidth();
+        Vector2f tileStart((float)(tile.x * (int)tileSize), (float)(tile.y * (int)tileSize));
+
+        std::vector<Vector2f> positions(outTile.GetNumbElements());
+        unsigned int i = 0;
+        for (Vector2u loc(0, 0); loc.y < tileSize; ++loc.y)
+            for (loc.x = 0; loc.x < tileSize; ++loc.x)
+                positions[i++] = tileStart + ToV2f(loc);
+
+        gen.SampleMany(positions.data(), outTile.GetArray(), positions.size());
+    }
+};
+
+//Describes cubic 3D tiles of noise for "NoiseTileCache".
+struct NoiseTile3D
+{
+    typedef Generator3D Generator;
+    typedef Noise3D Noise;
+    typedef Vector3i TileCoord;
+
+    static unsigned int GetNumbValues(unsigned int tileSize) { return tileSize * tileSize * tileSize; }
+    static Noise* MakeTile(unsigned int tileSize) { return new Noise(tileSize, tileSize, tileSize); }
+
+    //Fills the given tile by sampling the given generator.
+    //The tile's values are written as one contiguous block, so it can't have row padding
+    //    (tiles from "MakeTile" never do).
+    static void SampleTile(const Generator& gen, TileCoord tile, Noise& outTile)
+    {
+        assert(!outTile.HasRowPadding());
+
+        unsigned int tileSize = outTile.GetWidth();
+        Vector3f tileStart((float)(tile.x * (int)tileSize),
+                           (float)(tile.y * (int)tileSize),
+                           (float)(tile.z * (int)tileSize));
+
+        std::vector<Vector3f> positions(outTile.GetNumbElements());
+        unsigned int i = 0;
+        for (Vector3u loc(0, 0, 0); loc.z < tileSize; ++loc.z)
+            for (loc.y = 0; loc.y < tileSize; ++loc.y)
+                for (loc.x = 0; loc.x < tileSize; ++loc.x)
+                    positions[i++] = tileStart + ToV3f(loc);
+
+        gen.SampleMany(positions.data(), outTile.GetArray(), positions.size());
+    }
+};
+
+
+//Keeps recently-used tiles of noise in memory so they don't have to be generated again
+//    (e.x. when a streaming terrain moves back and forth over the same area).
+//Each tile is identified by the hash of whatever generated it (see "Generator2D::GetHash")
+//    plus the tile's coordinate. Tile "t" covers the noise positions from "t * TileSize"
+//    up to (but not including) "(t + 1) * TileSize". Generators fill their tiles with "SampleMany",
+//    so neighboring tiles line up seamlessly.
+//Tiles are handed out as shared pointers, and a tile is pinned for as long as anybody outside the cache
+//    holds a pointer to it. Once the tiles take up more than the byte budget,
+//    the least-recently-used tiles that aren't pinned are thrown out.
+//Tiles can be generated in the background on the cache's worker threads with "RequestTile".
+//All functions are thread-safe.
+template<typename TileType>
+class NoiseTileCache
+{
+public:
+
+    typedef typename TileType::Generator Generator;
+    typedef typename TileType::Noise Noise;
+    typedef typename TileType::TileCoord TileCoord;
+
+    typedef std::shared_ptr<const Noise> TilePtr;
+    //Fills in a tile of noise. Used for noise that doesn't come straight from a generator's "SampleMany"
+    //    (e.x. filtered noise, or remapped noise with the offset set to the tile's position).
+    typedef std::function<void(TileCoord tile, Noise& outTile)> FillFunc;
+
+
+    //Creates a cache with the given tile size and byte budget,
+    //    plus the given number of threads for generating requested tiles in the background.
+    NoiseTileCache(unsigned int tileSize, size_t byteBudget,
+                   unsigned int nWorkerThreads = Mathf::Max(std::thread::hardware_concurrency(), (unsigned int)2) - 1)
+        : tileSize(tileSize), byteBudget(byteBudget), usedBytes(0), nBusyWorkers(0), shouldStop(false)
+    {
+        assert(tileSize > 0);
+        for (unsigned int i = 0; i < nWorkerThreads; ++i)
+            workers.push_back(std::thread(&NoiseTileCache::WorkerLoop, this));
+    }
+    ~NoiseTileCache(void)
+    {
+        {
+            std::unique_lock<std::mutex> lck(lock);
+            shouldStop = true;
+        }
+        requestAdded.notify_all();
+
+        for (unsigned int i = 0; i < workers.size(); ++i)
+            workers[i].join();
+    }
+
+    NoiseTileCache(const NoiseTileCache& cpy) = delete;
+    NoiseTileCache& operator=(const NoiseTileCache& cpy) = delete;
+
+
+    unsigned int GetTileSize(void) const { return tileSize; }
+    //Gets the number of bytes one tile takes up.
+    size_t GetTileBytes(void) const { return sizeof(float) * TileType::GetNumbValues(tileSize); }
+
+    //Gets the number of bytes all the cached tiles (including pinned ones) take up.
+    size_t GetUsedBytes(void) const { std::unique_lock<std::mutex> lck(lock); return usedBytes; }
+
+    size_t GetByteBudget(void) const { std::unique_lock<std::mutex> lck(lock); return byteBudget; }
+    //Changes the byte budget, throwing out unpinned tiles if the cache is now over the budget.
+    void SetByteBudget(size_t newBudget)
+    {
+        std::unique_lock<std::mutex> lck(lock);
+        byteBudget = newBudget;
+        EvictTiles();
+    }
+
+
+    //Gets the given tile of noise from the given generator.
+    //If it isn't cached, it's generated on this thread. If it's being generated on another thread, waits for it.
+    //The generator must be able to sample and hash.
+    TilePtr GetTile(const Generator& gen, TileCoord tile)
+    {
+        assert(gen.CanSample() && gen.CanHash());
+        return GetTile(gen.GetHash(), tile, GetSampleFunc(gen));
+    }
+    //Gets the given tile of noise, using the given function to generate it if it isn't cached.
+    //"sourceHash" must describe everything that affects the noise "fill" generates.
+    TilePtr GetTile(unsigned long long sourceHash, TileCoord tile, FillFunc fill)
+    {
+        Key key(sourceHash, tile);
+        std::unique_lock<std::mutex> lck(lock);
+
+        typename EntryMap::iterator found = entries.find(key);
+        if (found != entries.end())
+        {
+            MarkUsed(found->second);
+
+            //Hold onto the tile while waiting so it can't be evicted.
+            std::shared_ptr<Noise> tilePtr = found->second.Tile;
+            while (!found->second.IsReady)
+            {
+                tileFinished.wait(lck);
+                found = entries.find(key);
+            }
+            return tilePtr;
+        }
+
+        std::shared_ptr<Noise> tilePtr = AddEntry(key);
+
+        lck.unlock();
+        fill(tile, *tilePtr);
+        lck.lock();
+
+        FinishEntry(key);
+        return tilePtr;
+    }
+
+    //Gets the given tile of noise from the given generator if it's cached and finished.
+    //Otherwise, returns null without generating anything.
+    TilePtr TryGetTile(const Generator& gen, TileCoord tile) { return TryGetTile(gen.GetHash(), tile); }
+    //Gets the given tile of noise if it's cached and finished.
+    //Otherwise, returns null without generating anything.
+    TilePtr TryGetTile(unsigned long long sourceHash, TileCoord tile)
+    {
+        std::unique_lock<std::mutex> lck(lock);
+
+        typename EntryMap::iterator found = entries.find(Key(sourceHash, tile));
+        if (found == entries.end() || !found->second.IsReady)
+            return TilePtr();
+
+        MarkUsed(found->second);
+        return found->second.Tile;
+    }
+
+    //Starts generating the given tile of noise from the given generator on a worker thread,
+    //    unless it's already cached or being generated.
+    //The generator must not be changed or destroyed until the tile is finished (see "WaitForRequests").
+    void RequestTile(const Generator& gen, TileCoord tile)
+    {
+        assert(gen.CanSample() && gen.CanHash());
+        RequestTile(gen.GetHash(), tile, GetSampleFunc(gen));
+    }
+    //Starts generating the given tile of noise with the given function on a worker thread,
+    //    unless it's already cached or being generated.
+    void RequestTile(unsigned long long sourceHash, TileCoord tile, FillFunc fill)
+    {
+        Key key(sourceHash, tile);
+        {
+            std::unique_lock<std::mutex> lck(lock);
+
+            typename EntryMap::iterator found = entries.find(key);
+            if (found != entries.end())
+            {
+                MarkUsed(found->second);
+                return;
+            }
+
+            AddEntry(key);
+
+            //If there are no workers, just do it now.
+            if (workers.size() == 0)
+            {
+                std::shared_ptr<Noise> tilePtr = entries.find(key)->second.Tile;
+                lck.unlock();
+                fill(tile, *tilePtr);
+                lck.lock();
+                FinishEntry(key);
+                return;
+            }
+
+            requests.push_back(Request(key, fill));
+        }
+        requestAdded.notify_one();
+    }
+
+    //Waits until every requested tile is finished.
+    void WaitForRequests(void)
+    {
+        std::unique_lock<std::mutex> lck(lock);
+        while (requests.size() > 0 || nBusyWorkers > 0)
+            tileFinished.wait(lck);
+    }
+
+    //Throws out every tile that isn't pinned or still being generated.
+    void Clear(void)
+    {
+        std::unique_lock<std::mutex> lck(lock);
+
+        typename std::list<Key>::iterator it = lruOrder.begin();
+        while (it != lruOrder.end())
+        {
+            typename EntryMap::iterator entry = entries.find(*it);
+            if (CanEvict(entry->second))
+            {
+                usedBytes -= GetTileBytes();
+                it = lruOrder.erase(it);
+                entries.erase(entry);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+    }
+
+
+private:
+
+    //Identifies a tile.
+    struct Key
+    {
+        unsigned long long SourceHash;
+        TileCoord Tile;
+
+        Key(unsigned long long sourceHash, TileCoord tile) : SourceHash(sourceHash), Tile(tile) { }
+        bool operator==(const Key& other) const { return SourceHash == other.SourceHash && Tile == other.Tile; }
+    };
+    struct KeyHasher
+    {
+        size_t operator()(const Key& key) const
+        {
+            return (size_t)(key.SourceHash ^ ((unsigned long long)(unsigned int)key.Tile.GetHashCode() * 2654435761ULL));
+        }
+    };
+
+    struct Entry
+    {
+        std::shared_ptr<Noise> Tile;
+        //False while the tile is still being generated.
+        bool IsReady;
+        //This entry's position in "lruOrder".
+        typename std::list<Key>::iterator LRUPos;
+    };
+    typedef std::unordered_map<Key, Entry, KeyHasher> EntryMap;
+
+    struct Request
+    {
+        Key TileKey;
+        FillFunc Fill;
+        Request(Key tileKey, FillFunc fill) : TileKey(tileKey), Fill(fill) { }
+    };
+
+
+    unsigned int tileSize;
+    size_t byteBudget, usedBytes;
+
+    EntryMap entries;
+    //The keys of every entry, from most-recently used to least-recently used.
+    std::list<Key> lruOrder;
+
+    std::deque<Request> requests;
+    std::vector<std::thread> workers;
+    unsigned int nBusyWorkers;
+    bool shouldStop;
+
+    //Guards all the above data.
+    mutable std::mutex lock;
+    std::condition_variable requestAdded, tileFinished;
+
+
+    static FillFunc GetSampleFunc(const Generator& gen)
+    {
+        const Generator* genPtr = &gen;
+        return [genPtr](TileCoord tile, Noise& outTile) { TileType::SampleTile(*genPtr, tile, outTile); };
+    }
+
+    //The following functions assume "lock" is already locked.
+
+    //Adds an unfinished entry for the given key and returns its tile.
+    std::shared_ptr<Noise> AddEntry(const Key& key)
+    {
+        lruOrder.push_front(key);
+
+        Entry& entry = entries[key];
+        entry.Tile = std::shared_ptr<Noise>(TileType::MakeTile(tileSize));
+        entry.IsReady = false;
+        entry.LRUPos = lruOrder.begin();
+
+        usedBytes += GetTileBytes();
+        return entry.Tile;
+    }
+    //Marks the given entry as finished, then evicts tiles if the cache is over budget.
+    void FinishEntry(const Key& key)
+    {
+        entries.find(key)->second.IsReady = true;
+        tileFinished.notify_all();
+        EvictTiles();
+    }
+    //Moves the given entry to the front of the LRU order.
+    void MarkUsed(Entry& entry)
+    {
+        lruOrder.splice(lruOrder.begin(), lruOrder, entry.LRUPos);
+    }
+
+    //A tile is pinned if anything besides this cache has a pointer to it.
+    bool CanEvict(const Entry& entry) const { return entry.IsReady && entry.Tile.use_count() == 1; }
+
+    //Throws out the least-recently-used unpinned tiles until the cache is within its budget.
+    void EvictTiles(void)
+    {
+        typename std::list<Key>::iterator it = lruOrder.end();
+        while (usedBytes > byteBudget && it != lruOrder.begin())
+        {
+            --it;
+
+            typename EntryMap::iterator entry = entries.find(*it);
+            if (CanEvict(entry->second))
+            {
+                usedBytes -= GetTileBytes();
+                it = lruOrder.erase(it);
+                entries.erase(entry);
+            }
+        }
+    }
+
+    void WorkerLoop(void)
+    {
+        std::unique_lock<std::mutex> lck(lock);
+        while (true)
+        {
+            while (!shouldStop && requests.size() == 0)
+                requestAdded.wait(lck);
+            if (shouldStop)
+                return;
+
+            Request request = requests.front();
+            requests.pop_front();
+            nBusyWorkers += 1;
+
+            std::shared_ptr<Noise> tilePtr = entries.find(request.TileKey)->second.Tile;
+            lck.unlock();
+            request.Fill(request.TileKey.Tile, *tilePtr);
+            tilePtr.reset();
+            lck.lock();
+
+            nBusyWorkers -= 1;
+            FinishEntry(request.TileKey);
+        }
+    }
+};
+
+typedef NoiseTileCache<NoiseTile2D> NoiseTileCache2D;
+typedef NoiseTileCache<NoiseTile3D> NoiseTileCache3D;
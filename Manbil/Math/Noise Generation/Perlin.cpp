@@ -1,168 +1,358 @@
 #include "Perlin.h"
 
 #include <iostream>
+#include <vector>
 #include <assert.h>
 #include "NoiseFilterer.h"
+#include "../Lower Math/SIMD.h"
 
 
-void Perlin2D::Generate(Array2D<float> & outValues) const
+namespace
 {
-	FastRand fr(RandSeed);
-
-	Vector2u noiseDim = outValues.GetDimensions();
-
-
-    //First compute the gradient at each grid point.
+    //Compile-time versions of the different smoothing functions for Perlin noise.
+    //The SIMD versions do the same operations in the same order as the scalar versions,
+    //    so they give exactly the same results.
+    //"Derivative" gives the slope of the smoothing function, for computing the noise's gradient.
 
-    //Calculate the number of gradients that will be needed.
-	unsigned int gradientWidth = Mathf::RoundToInt(noiseDim.x / Scale.x),
-		         gradientHeight = Mathf::RoundToInt(noiseDim.y / Scale.y);
-    if (gradientWidth == 0 || gradientHeight == 0)
+    struct LinearSmoother
     {
-        outValues.Fill(0.0f);
-        return;
-    }
-	Array2D<Vector2f> gradients(gradientWidth + 2, gradientHeight + 2);
-
-    //Generate the gradients. by hashing the grid coordinate and using that hash in a look-up table.
-	const unsigned int numGradients = 8;
-	const Vector2f gradientTable[numGradients] = 
-	{
-		Vector2f(1.0f, 1.0f),
-		Vector2f(-1.0f, 1.0f),
-		Vector2f(1.0f, -1.0f),
-		Vector2f(-1.0f, -1.0f),
-		Vector2f(1.0f, 0.0f),
-		Vector2f(0.0f, 1.0f),
-		Vector2f(-1.0f, 0.0f),
-		Vector2f(0.0f, -1.0f),
-	};
-
-	Vector2u loc;
-    Vector2i offLoc;
-    Vector2i scaledOffset((int)(Offset.x / Scale.x), (int)(Offset.y / Scale.y));
-    for (loc.y = 0; loc.y < gradients.GetHeight(); ++loc.y)
-    {
-        offLoc.y = loc.y + scaledOffset.y;
-        offLoc.y %= GradientWrapInterval.y;
-
-        for (loc.x = 0; loc.x < gradients.GetWidth(); ++loc.x)
+        static float Smooth(float f) { return f; }
+        static SIMDFloats Smooth(const SIMDFloats& f) { return f; }
+        static float Derivative(float f) { return 1.0f; }
+    };
+    struct CubicSmoother
+    {
+        static float Smooth(float f) { return Mathf::Smooth(f); }
+        static float Derivative(float f) { return 6.0f * f * (1.0f - f); }
+        static SIMDFloats Smooth(const SIMDFloats& f)
         {
-            offLoc.x = loc.x + scaledOffset.x;
-            offLoc.x %= GradientWrapInterval.x;
-
-            fr.Seed = offLoc.GetHashCode() + RandSeed;
-			gradients[loc] = gradientTable[Mathf::Abs(fr.GetRandInt()) % numGradients];
-		}
-	}
+            return f * f * ((f * SIMDFloats(-2.0f)) + SIMDFloats(3.0f));
+        }
+    };
+    struct QuinticSmoother
+    {
+        static float Smooth(float f) { return Mathf::Supersmooth(f); }
+        static float Derivative(float f) { return 30.0f * f * f * (f - 1.0f) * (f - 1.0f); }
+        static SIMDFloats Smooth(const SIMDFloats& f)
+        {
+            return f * f * f * (SIMDFloats(10.0f) + (f * (SIMDFloats(-15.0f) + (f * SIMDFloats(6.0f)))));
+        }
+    };
 
 
-	//Now compute the noise for every point.
+    //Gathers one component of the gradient at each of the given grid X positions along a row of gradients.
+    //The "offset" is added to each X position before looking it up.
+    template<typename VectorType>
+    SIMDFloats GatherGradients(const VectorType* gradientRow, const int* gridXs, int offset, unsigned int component)
+    {
+        const float* firstValue = &gradientRow[offset].x + component;
+        return SIMDFloats::Gather(firstValue, gridXs, sizeof(VectorType) / sizeof(float));
+    }
 
-	float (*smoothStepper)(float inF) = 0;
-	switch (SmoothAmount)
-	{
-		case Smoothness::Linear:
-			smoothStepper = [](float inF) { return inF; };
-			break;
-		case Smoothness::Cubic:
-			smoothStepper = &Mathf::Smooth;
-			break;
-		case Smoothness::Quintic:
-			smoothStepper = &Mathf::Supersmooth;
-			break;
-
-		default: assert(false);
-	}
-
-    //Keep track of the min/max in case the noise should be normalized.
-    float min = std::numeric_limits<float>().max(),
-          max = std::numeric_limits<float>().min();
-	Vector2f lerpGrid, relGrid;
-	Vector2u tlGrid;
-	Vector2f invScale(1.0f / Scale.x, 1.0f / Scale.y);
-	float tlDot, trDot, blDot, brDot;
-    Vector2f withinGridOffset(fmodf(Offset.x, Scale.x), fmodf(Offset.y, Scale.y));
 
-    for (loc.y = 0; loc.y < noiseDim.y; ++loc.y)
+    //Computes 2D Perlin noise for every row in the range [startY, endY).
+    //Updates the given min/max with the generated values.
+    template<typename Smoother>
+    void GeneratePerlinRows2D(const Array2D<Vector2f>& gradients, Vector2f invScale, Vector2f withinGridOffset,
+                              unsigned int startY, unsigned int endY,
+                              Array2D<float>& outValues, float& min, float& max)
     {
-        lerpGrid.y = ((float)loc.y + withinGridOffset.y) * invScale.y;
-
-        tlGrid.y = (unsigned int)lerpGrid.y;
-        relGrid.y = lerpGrid.y - tlGrid.y;
+        const unsigned int simdWidth = SIMDFloats::Width;
+        unsigned int width = outValues.GetWidth();
 
-        for (loc.x = 0; loc.x < noiseDim.x; ++loc.x)
+        //Gets whether the grid cell that the given grid position falls into
+        //    is completely inside the gradient array, so no clamping is needed.
+        auto isCellInside = [](float lerpGrid, unsigned int tlGrid, unsigned int nGradients)
         {
-            lerpGrid.x = ((float)loc.x + withinGridOffset.x) * invScale.x;
+            return lerpGrid >= 0.0f && (tlGrid + 1) < nGradients;
+        };
 
-            tlGrid.x = (unsigned int)lerpGrid.x;
-            relGrid.x = lerpGrid.x - tlGrid.x;
-
-            //TODO: This bit caused artifacts in the 3D version. See if this can be removed.
-            //The noise value at every grid point is 0.
-            if (false && relGrid.x == 0.0f && relGrid.y == 0.0f)
-            {
-                outValues[loc] = 0.0f;
-                continue;
-            }
+        //Computes one noise value using scalar math.
+        auto computeScalar = [&](Vector2u loc, float lerpGridY, unsigned int tlGridY, float relGridY, float smoothedY)
+        {
+            Vector2f lerpGrid(((float)loc.x + withinGridOffset.x) * invScale.x, lerpGridY);
+            Vector2u tlGrid((unsigned int)lerpGrid.x, tlGridY);
+            Vector2f relGrid(lerpGrid.x - tlGrid.x, relGridY);
 
             //Get the dot of each grid corner's gradient and the vector from the coordinate to that grid corner.
             Vector2f tl = gradients[gradients.Clamp(tlGrid)],
                      tr = gradients[gradients.Clamp(tlGrid.MoreX())],
                      bl = gradients[gradients.Clamp(tlGrid.MoreY())],
                      br = gradients[gradients.Clamp(tlGrid + Vector2u(1, 1))];
-            Vector2f tTL = relGrid,
-                     tTR = relGrid - Vector2f(1.0f, 0.0f),
-                     tBL = relGrid - Vector2f(0.0f, 1.0f),
-                     tBR = relGrid - Vector2f(1.0f, 1.0f);
-            tlDot = tl.Dot(tTL);
-            trDot = tr.Dot(tTR);
-            blDot = bl.Dot(tBL);
-            brDot = br.Dot(tBR);
+            float tlDot = tl.Dot(relGrid),
+                  trDot = tr.Dot(relGrid - Vector2f(1.0f, 0.0f)),
+                  blDot = bl.Dot(relGrid - Vector2f(0.0f, 1.0f)),
+                  brDot = br.Dot(relGrid - Vector2f(1.0f, 1.0f));
 
             //Interpolate the values.
-            float smoothedX = smoothStepper(relGrid.x);
+            float smoothedX = Smoother::Smooth(relGrid.x);
             float val = Mathf::Lerp(Mathf::Lerp(tlDot, trDot, smoothedX),
-                                        Mathf::Lerp(blDot, brDot, smoothedX),
-                                        smoothStepper(relGrid.y));
+                                    Mathf::Lerp(blDot, brDot, smoothedX),
+                                    smoothedY);
             outValues[loc] = val;
 
             min = Mathf::Min(val, min);
             max = Mathf::Max(val, max);
+        };
+
+        SIMDFloats simdMin(min), simdMax(max);
+        SIMDFloats simdInvScaleX(invScale.x), simdOffsetX(withinGridOffset.x),
+                   one(1.0f);
+
+        for (Vector2u loc(0, startY); loc.y < endY; ++loc.y)
+        {
+            float lerpGridY = ((float)loc.y + withinGridOffset.y) * invScale.y;
+            unsigned int tlGridY = (unsigned int)lerpGridY;
+            float relGridY = lerpGridY - tlGridY;
+            float smoothedY = Smoother::Smooth(relGridY);
+
+            loc.x = 0;
+
+            //If every sample in this row might need its gradients clamped, just use scalar math.
+            if (!isCellInside(lerpGridY, tlGridY, gradients.GetHeight()))
+            {
+                for (; loc.x < width; ++loc.x)
+                    computeScalar(loc, lerpGridY, tlGridY, relGridY, smoothedY);
+                continue;
+            }
+
+            //Use scalar math for any samples at the start of the row that need clamped gradients.
+            for (; loc.x < width; ++loc.x)
+            {
+                float lerpGridX = ((float)loc.x + withinGridOffset.x) * invScale.x;
+                if (isCellInside(lerpGridX, (unsigned int)lerpGridX, gradients.GetWidth()))
+                    break;
+                computeScalar(loc, lerpGridY, tlGridY, relGridY, smoothedY);
+            }
+
+            //Use SIMD for blocks of samples until a block would need clamped gradients.
+            const Vector2f* gradientsT = &gradients[Vector2u(0, tlGridY)],
+                          * gradientsB = &gradients[Vector2u(0, tlGridY + 1)];
+            SIMDFloats relY(relGridY), relYLess(relGridY - 1.0f), smoothY(smoothedY);
+            int tlXs[simdWidth];
+            for (; loc.x + simdWidth <= width; loc.x += simdWidth)
+            {
+                unsigned int lastX = loc.x + simdWidth - 1;
+                float lastLerpGridX = ((float)lastX + withinGridOffset.x) * invScale.x;
+                if (!isCellInside(lastLerpGridX, (unsigned int)lastLerpGridX, gradients.GetWidth()))
+                    break;
+
+                SIMDFloats lerpX = (SIMDInts::Range((int)loc.x).ToFloats() + simdOffsetX) * simdInvScaleX;
+                SIMDInts tlX = lerpX.Truncate();
+                SIMDFloats relX = lerpX - tlX.ToFloats(),
+                           relXLess = relX - one;
+                tlX.Store(tlXs);
+
+                SIMDFloats tlDot = (GatherGradients(gradientsT, tlXs, 0, 0) * relX) +
+                                   (GatherGradients(gradientsT, tlXs, 0, 1) * relY),
+                           trDot = (GatherGradients(gradientsT, tlXs, 1, 0) * relXLess) +
+                                   (GatherGradients(gradientsT, tlXs, 1, 1) * relY),
+                           blDot = (GatherGradients(gradientsB, tlXs, 0, 0) * relX) +
+                                   (GatherGradients(gradientsB, tlXs, 0, 1) * relYLess),
+                           brDot = (GatherGradients(gradientsB, tlXs, 1, 0) * relXLess) +
+                                   (GatherGradients(gradientsB, tlXs, 1, 1) * relYLess);
+
+                SIMDFloats smoothX = Smoother::Smooth(relX);
+                SIMDFloats val = SIMDFloats::Lerp(SIMDFloats::Lerp(tlDot, trDot, smoothX),
+                                                  SIMDFloats::Lerp(blDot, brDot, smoothX),
+                                                  smoothY);
+                val.Store(&outValues[loc]);
+
+                simdMin = SIMDFloats::Min(val, simdMin);
+                simdMax = SIMDFloats::Max(val, simdMax);
+            }
+
+            //Finish the rest of the row with scalar math.
+            for (; loc.x < width; ++loc.x)
+                computeScalar(loc, lerpGridY, tlGridY, relGridY, smoothedY);
         }
+
+        min = Mathf::Min(simdMin.GetMin(), min);
+        max = Mathf::Max(simdMax.GetMax(), max);
     }
 
-    if (RemapValues)
+
+    //Computes 3D Perlin noise for every Z slice in the range [startZ, endZ).
+    //The first Z slice of "gradients" is grid slice "gradientStartZ",
+    //    and the first Z slice of "outNoise" is noise slice "outStartZ".
+    //Updates the given min/max with the generated values.
+    template<typename Smoother>
+    void GeneratePerlinSlices3D(const Array3D<Vector3f>& gradients, unsigned int gradientStartZ,
+                                Vector3f invScale, Vector3f withinGridOffset,
+                                unsigned int startZ, unsigned int endZ,
+                                Array3D<float>& outNoise, unsigned int outStartZ, float& min, float& max)
     {
-        NoiseFilterer2D nf;
-        MaxFilterRegion mfr;
-        nf.FillRegion = &mfr;
-        nf.RemapValues_OldVals = Interval(min, max, 0.00001f);
-        nf.RemapValues(&outValues);
-    }
-}
+        const unsigned int simdWidth = SIMDFloats::Width;
+        Vector3u dimensions = outNoise.GetDimensions();
 
+        //Gets whether the grid cell that the given grid position falls into
+        //    is completely inside the gradient array, so no clamping is needed.
+        auto isCellInside = [](float lerpGrid, unsigned int minGrid, unsigned int nGradients)
+        {
+            return lerpGrid >= 0.0f && (minGrid + 1) < nGradients;
+        };
 
-void Perlin3D::Generate(Array3D<float> & outNoise) const
-{
-    FastRand fr(RandSeed);
+        //Computes one noise value using scalar math.
+        auto computeScalar = [&](Vector3u loc, Vector3f lerpGrid, Vector3u minGrid, Vector3f relGrid)
+        {
+            lerpGrid.x = ((float)loc.x + withinGridOffset.x) * invScale.x;
+            minGrid.x = (unsigned int)lerpGrid.x;
+            relGrid.x = lerpGrid.x - (float)minGrid.x;
+            Vector3f relGridLess = relGrid - Vector3f(1.0f, 1.0f, 1.0f);
+
+            //Get the dot of each grid corner's gradient and the vector from the coordinate to that grid corner.
+
+            float minXYZ_dot = gradients[gradients.Clamp(minGrid)].Dot(relGrid),
+                  minXY_maxZ_dot = gradients[gradients.Clamp(minGrid.MoreZ())].Dot(Vector3f(relGrid.x, relGrid.y, relGridLess.z)),
+                  minX_maxY_minZ_dot = gradients[gradients.Clamp(minGrid.MoreY())].Dot(Vector3f(relGrid.x, relGridLess.y, relGrid.z)),
+                  minX_maxYZ_dot = gradients[gradients.Clamp(minGrid.MoreY().MoreZ())].Dot(Vector3f(relGrid.x, relGridLess.y, relGridLess.z));
+
+            float maxX_minYZ_dot = gradients[gradients.Clamp(minGrid.MoreX())].Dot(Vector3f(relGridLess.x, relGrid.y, relGrid.z)),
+                  maxX_minY_maxZ_dot = gradients[gradients.Clamp(minGrid.MoreX().MoreZ())].Dot(Vector3f(relGridLess.x, relGrid.y, relGridLess.z)),
+                  maxXY_minZ_dot = gradients[gradients.Clamp(minGrid.MoreX().MoreY())].Dot(Vector3f(relGridLess.x, relGridLess.y, relGrid.z)),
+                  maxXYZ_dot = gradients[gradients.Clamp(minGrid.MoreX().MoreY().MoreZ())].Dot(relGridLess);
+
+            //Interpolate the values one axis at a time.
+            Vector3f smoothed(Smoother::Smooth(relGrid.x), Smoother::Smooth(relGrid.y), Smoother::Smooth(relGrid.z));
+            float val = Mathf::Lerp(Mathf::Lerp(Mathf::Lerp(minXYZ_dot, maxX_minYZ_dot, smoothed.x),
+                                                Mathf::Lerp(minX_maxY_minZ_dot, maxXY_minZ_dot, smoothed.x),
+                                                smoothed.y),
+                                    Mathf::Lerp(Mathf::Lerp(minXY_maxZ_dot, maxX_minY_maxZ_dot, smoothed.x),
+                                                Mathf::Lerp(minX_maxYZ_dot, maxXYZ_dot, smoothed.x),
+                                                smoothed.y),
+                                    smoothed.z);
+            outNoise[loc] = val;
+
+            min = Mathf::Min(val, min);
+            max = Mathf::Max(val, max);
+        };
+
+        SIMDFloats simdMin(min), simdMax(max);
+        SIMDFloats simdInvScaleX(invScale.x), simdOffsetX(withinGridOffset.x),
+                   one(1.0f);
+        int minXs[simdWidth];
+
+        Vector3f lerpGrid, relGrid;
+        Vector3u minGrid, loc;
+        for (unsigned int z = startZ; z < endZ; ++z)
+        {
+            loc.z = z - outStartZ;
+
+            lerpGrid.z = ((float)z + withinGridOffset.z) * invScale.z;
+            unsigned int gridZ = (unsigned int)lerpGrid.z;
+            relGrid.z = lerpGrid.z - (float)gridZ;
+            minGrid.z = gridZ - gradientStartZ;
+            bool zInside = isCellInside(lerpGrid.z, minGrid.z, gradients.GetDepth());
+
+            for (loc.y = 0; loc.y < dimensions.y; ++loc.y)
+            {
+                lerpGrid.y = ((float)loc.y + withinGridOffset.y) * invScale.y;
+                minGrid.y = (unsigned int)lerpGrid.y;
+                relGrid.y = lerpGrid.y - (float)minGrid.y;
 
-    Vector3u dimensions = outNoise.GetDimensions();
+                loc.x = 0;
 
+                //If every sample in this row might need its gradients clamped, just use scalar math.
+                if (!zInside || !isCellInside(lerpGrid.y, minGrid.y, gradients.GetHeight()))
+                {
+                    for (; loc.x < dimensions.x; ++loc.x)
+                        computeScalar(loc, lerpGrid, minGrid, relGrid);
+                    continue;
+                }
 
-    //First compute the gradient at every grid.
+                //Use scalar math for any samples at the start of the row that need clamped gradients.
+                for (; loc.x < dimensions.x; ++loc.x)
+                {
+                    float lerpGridX = ((float)loc.x + withinGridOffset.x) * invScale.x;
+                    if (isCellInside(lerpGridX, (unsigned int)lerpGridX, gradients.GetWidth()))
+                        break;
+                    computeScalar(loc, lerpGrid, minGrid, relGrid);
+                }
 
-    //Calculate the number of gradient points that will be needed.
-    Vector3u gradientDims((unsigned int)Mathf::RoundToInt(dimensions.x / Scale.x) + 2,
-                          (unsigned int)Mathf::RoundToInt(dimensions.y / Scale.y) + 2,
-                          (unsigned int)Mathf::RoundToInt(dimensions.z / Scale.z) + 2);
+                //Use SIMD for blocks of samples until a block would need clamped gradients.
+                const Vector3f* gradientRows[4] =
+                {
+                    &gradients[Vector3u(0, minGrid.y, minGrid.z)],
+                    &gradients[Vector3u(0, minGrid.y + 1, minGrid.z)],
+                    &gradients[Vector3u(0, minGrid.y, minGrid.z + 1)],
+                    &gradients[Vector3u(0, minGrid.y + 1, minGrid.z + 1)],
+                };
+                SIMDFloats relY(relGrid.y), relZ(relGrid.z),
+                           relYLess(relGrid.y - 1.0f), relZLess(relGrid.z - 1.0f),
+                           smoothY(Smoother::Smooth(relGrid.y)), smoothZ(Smoother::Smooth(relGrid.z));
+                for (; loc.x + simdWidth <= dimensions.x; loc.x += simdWidth)
+                {
+                    unsigned int lastX = loc.x + simdWidth - 1;
+                    float lastLerpGridX = ((float)lastX + withinGridOffset.x) * invScale.x;
+                    if (!isCellInside(lastLerpGridX, (unsigned int)lastLerpGridX, gradients.GetWidth()))
+                        break;
 
-    Array3D<Vector3f> gradients(gradientDims.x, gradientDims.y, gradientDims.z);
+                    SIMDFloats lerpX = (SIMDInts::Range((int)loc.x).ToFloats() + simdOffsetX) * simdInvScaleX;
+                    SIMDInts minX = lerpX.Truncate();
+                    SIMDFloats relX = lerpX - minX.ToFloats(),
+                               relXLess = relX - one;
+                    minX.Store(minXs);
 
-    //Compute the gradient by hashing the grid coordinate
-    //  and using the hash to look up a select few pre-made gradients.
-    const unsigned int numGradients = 16;
-    const Vector3f gradientTable[numGradients] =
+                    //Gets the dot product of a corner's gradient with the vector from that corner to the sample.
+                    auto cornerDot = [&](unsigned int rowIndex, int xOffset, const SIMDFloats& toX,
+                                         const SIMDFloats& toY, const SIMDFloats& toZ)
+                    {
+                        const Vector3f* row = gradientRows[rowIndex];
+                        return (GatherGradients(row, minXs, xOffset, 0) * toX) +
+                               (GatherGradients(row, minXs, xOffset, 1) * toY) +
+                               (GatherGradients(row, minXs, xOffset, 2) * toZ);
+                    };
+
+                    SIMDFloats minXYZ_dot = cornerDot(0, 0, relX, relY, relZ),
+                               minXY_maxZ_dot = cornerDot(2, 0, relX, relY, relZLess),
+                               minX_maxY_minZ_dot = cornerDot(1, 0, relX, relYLess, relZ),
+                               minX_maxYZ_dot = cornerDot(3, 0, relX, relYLess, relZLess),
+                               maxX_minYZ_dot = cornerDot(0, 1, relXLess, relY, relZ),
+                               maxX_minY_maxZ_dot = cornerDot(2, 1, relXLess, relY, relZLess),
+                               maxXY_minZ_dot = cornerDot(1, 1, relXLess, relYLess, relZ),
+                               maxXYZ_dot = cornerDot(3, 1, relXLess, relYLess, relZLess);
+
+                    SIMDFloats smoothX = Smoother::Smooth(relX);
+                    SIMDFloats val = SIMDFloats::Lerp(SIMDFloats::Lerp(SIMDFloats::Lerp(minXYZ_dot, maxX_minYZ_dot, smoothX),
+                                                                       SIMDFloats::Lerp(minX_maxY_minZ_dot, maxXY_minZ_dot, smoothX),
+                                                                       smoothY),
+                                                      SIMDFloats::Lerp(SIMDFloats::Lerp(minXY_maxZ_dot, maxX_minY_maxZ_dot, smoothX),
+                                                                       SIMDFloats::Lerp(minX_maxYZ_dot, maxXYZ_dot, smoothX),
+                                                                       smoothY),
+                                                      smoothZ);
+                    val.Store(&outNoise[loc]);
+
+                    simdMin = SIMDFloats::Min(val, simdMin);
+                    simdMax = SIMDFloats::Max(val, simdMax);
+                }
+
+                //Finish the rest of the row with scalar math.
+                for (; loc.x < dimensions.x; ++loc.x)
+                    computeScalar(loc, lerpGrid, minGrid, relGrid);
+            }
+        }
+
+        min = Mathf::Min(simdMin.GetMin(), min);
+        max = Mathf::Max(simdMax.GetMax(), max);
+    }
+
+
+    //The possible gradients at each grid point of 2D Perlin noise.
+    const unsigned int nGradients2D = 8;
+    const Vector2f gradientTable2D[nGradients2D] =
+    {
+        Vector2f(1.0f, 1.0f),
+        Vector2f(-1.0f, 1.0f),
+        Vector2f(1.0f, -1.0f),
+        Vector2f(-1.0f, -1.0f),
+        Vector2f(1.0f, 0.0f),
+        Vector2f(0.0f, 1.0f),
+        Vector2f(-1.0f, 0.0f),
+        Vector2f(0.0f, -1.0f),
+    };
+    //The possible gradients at each grid point of 3D Perlin noise.
+    const unsigned int nGradients3D = 16;
+    const Vector3f gradientTable3D[nGradients3D] =
     {
         Vector3f(1, 1, 0),
         Vector3f(-1, 1, 0),
@@ -184,114 +374,525 @@ void Perlin3D::Generate(Array3D<float> & outNoise) const
         Vector3f(-1, 1, 0),
         Vector3f(0, -1, -1),
     };
-    Vector3u loc;
-    Vector3i offLoc;
-    Vector3i scaledOffset((int)(Offset.x / Scale.x), (int)(Offset.y / Scale.y), (int)(Offset.z / Scale.z));
-    for (loc.z = 0; loc.z < gradientDims.z; ++loc.z)
+
+    //Wraps the given grid coordinate into the range [0, wrapInterval).
+    //Just using "%" would turn a negative coordinate into an unsigned int first, which wraps it to the wrong spot.
+    //Intervals too big for an int (e.x. the default, the max unsigned int) leave the coordinate alone.
+    int WrapGridPos(int pos, unsigned int wrapInterval)
+    {
+        if (wrapInterval > (unsigned int)std::numeric_limits<int>::max())
+            return pos;
+
+        int wrapped = pos % (int)wrapInterval;
+        return (wrapped < 0) ? (wrapped + (int)wrapInterval) : wrapped;
+    }
+
+    //Splits one axis of a pixel offset into a whole number of grid cells plus the offset within a cell.
+    //The offset within a cell is never negative, so even with a negative "Offset",
+    //    "Generate" only needs the grid points from the first cell onward.
+    void SplitOffset(int offset, float scale, int& outScaledOffset, float& outWithinGridOffset)
+    {
+        outScaledOffset = (int)(offset / scale);
+        outWithinGridOffset = fmodf((float)offset, scale);
+        if (outWithinGridOffset < 0.0f)
+        {
+            outScaledOffset -= 1;
+            outWithinGridOffset += scale;
+        }
+    }
+    void SplitOffset(Vector2i offset, Vector2f scale, Vector2i& outScaledOffset, Vector2f& outWithinGridOffset)
     {
-        offLoc.z = loc.z + scaledOffset.z;
-        offLoc.z %= GradientWrapInterval.z;
+        SplitOffset(offset.x, scale.x, outScaledOffset.x, outWithinGridOffset.x);
+        SplitOffset(offset.y, scale.y, outScaledOffset.y, outWithinGridOffset.y);
+    }
+    void SplitOffset(Vector3i offset, Vector3f scale, Vector3i& outScaledOffset, Vector3f& outWithinGridOffset)
+    {
+        SplitOffset(offset.x, scale.x, outScaledOffset.x, outWithinGridOffset.x);
+        SplitOffset(offset.y, scale.y, outScaledOffset.y, outWithinGridOffset.y);
+        SplitOffset(offset.z, scale.z, outScaledOffset.z, outWithinGridOffset.z);
+    }
+
+    //Gets the gradient at the given grid point by hashing its (offset and wrapped) coordinate
+    //    and using that hash in the look-up table.
+    Vector2f GetGradient2D(Vector2i gridPos, Vector2i scaledOffset, Vector2u wrapInterval, int seed)
+    {
+        Vector2i offLoc = gridPos + scaledOffset;
+        offLoc.x = WrapGridPos(offLoc.x, wrapInterval.x);
+        offLoc.y = WrapGridPos(offLoc.y, wrapInterval.y);
+
+        FastRand fr(offLoc.GetHashCode() + seed);
+        return gradientTable2D[Mathf::Abs(fr.GetRandInt()) % nGradients2D];
+    }
+    //Gets the gradient at the given grid point by hashing its (offset and wrapped) coordinate
+    //    and using that hash in the look-up table.
+    Vector3f GetGradient3D(Vector3i gridPos, Vector3i scaledOffset, Vector3u wrapInterval, int seed)
+    {
+        Vector3i offLoc = gridPos + scaledOffset;
+        offLoc.x = WrapGridPos(offLoc.x, wrapInterval.x);
+        offLoc.y = WrapGridPos(offLoc.y, wrapInterval.y);
+        offLoc.z = WrapGridPos(offLoc.z, wrapInterval.z);
+
+        FastRand fr(offLoc.GetHashCode() + seed);
+        return gradientTable3D[Mathf::Abs(fr.GetRandInt()) % nGradients3D];
+    }
+
 
-        for (loc.y = 0; loc.y < gradientDims.y; ++loc.y)
+    //The grid gradients that a batch of 2D sample positions need.
+    //If the positions are close together (e.x. a tile of noise), the gradients they need are computed up-front.
+    //Otherwise, each gradient is computed as it's needed.
+    struct SampleGrid2D
+    {
+        Vector2i ScaledOffset;
+        Vector2f InvScale, WithinGridOffset;
+        Vector2u WrapInterval;
+        int Seed;
+
+        bool UseGrid;
+        Vector2i MinGrid, Size;
+        std::vector<Vector2f> Gradients;
+
+
+        SampleGrid2D(const Perlin2D& perlin, const Vector2f* positions, unsigned int nPositions)
+            : InvScale(1.0f / perlin.Scale.x, 1.0f / perlin.Scale.y),
+              WrapInterval(perlin.GradientWrapInterval), Seed(perlin.RandSeed)
         {
-            offLoc.y = loc.y + scaledOffset.y;
-            offLoc.y %= GradientWrapInterval.y;
+            SplitOffset(perlin.Offset, perlin.Scale, ScaledOffset, WithinGridOffset);
+
+            const unsigned int simdWidth = SIMDFloats::Width;
+            const int laneIndices[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
 
-            for (loc.x = 0; loc.x < gradientDims.x; ++loc.x)
+            //Find the range of grid points the positions touch.
+            //Rounding down doesn't change the order of numbers, so just find the range of grid positions.
+            Vector2f minLerpGrid(std::numeric_limits<float>::max(), std::numeric_limits<float>::max()),
+                     maxLerpGrid(-std::numeric_limits<float>::max(), -std::numeric_limits<float>::max());
+            unsigned int i = 0;
+            if (nPositions >= simdWidth)
             {
-                offLoc.x = loc.x + scaledOffset.x;
-                offLoc.x %= GradientWrapInterval.x;
+                SIMDFloats simdInvScaleX(InvScale.x), simdInvScaleY(InvScale.y),
+                           simdOffsetX(WithinGridOffset.x), simdOffsetY(WithinGridOffset.y);
+                SIMDFloats minX(minLerpGrid.x), minY(minLerpGrid.y),
+                           maxX(maxLerpGrid.x), maxY(maxLerpGrid.y);
+                for (; i + simdWidth <= nPositions; i += simdWidth)
+                {
+                    SIMDFloats lerpX = (SIMDFloats::Gather(&positions[i].x, laneIndices, 2) + simdOffsetX) * simdInvScaleX,
+                               lerpY = (SIMDFloats::Gather(&positions[i].y, laneIndices, 2) + simdOffsetY) * simdInvScaleY;
+                    minX = SIMDFloats::Min(lerpX, minX);
+                    minY = SIMDFloats::Min(lerpY, minY);
+                    maxX = SIMDFloats::Max(lerpX, maxX);
+                    maxY = SIMDFloats::Max(lerpY, maxY);
+                }
+                minLerpGrid = Vector2f(minX.GetMin(), minY.GetMin());
+                maxLerpGrid = Vector2f(maxX.GetMax(), maxY.GetMax());
+            }
+            for (; i < nPositions; ++i)
+            {
+                Vector2f lerpGrid = GetLerpGrid(positions[i]);
+                minLerpGrid = Vector2f(Mathf::Min(minLerpGrid.x, lerpGrid.x), Mathf::Min(minLerpGrid.y, lerpGrid.y));
+                maxLerpGrid = Vector2f(Mathf::Max(maxLerpGrid.x, lerpGrid.x), Mathf::Max(maxLerpGrid.y, lerpGrid.y));
+            }
+            MinGrid = Vector2i((int)floorf(minLerpGrid.x), (int)floorf(minLerpGrid.y));
+            Vector2i maxGrid((int)floorf(maxLerpGrid.x), (int)floorf(maxLerpGrid.y));
+            Size = maxGrid - MinGrid + Vector2i(2, 2);
+            UseGrid = (nPositions > 0 && (long long)Size.x * (long long)Size.y <= 4 * (long long)nPositions);
 
-                fr.Seed = offLoc.GetHashCode() + RandSeed;
-                gradients[loc] = gradientTable[Mathf::Abs(fr.GetRandInt()) % numGradients];
+            if (UseGrid)
+            {
+                Gradients.resize(Size.x * Size.y);
+                for (Vector2i loc(0, 0); loc.y < Size.y; ++loc.y)
+                    for (loc.x = 0; loc.x < Size.x; ++loc.x)
+                        Gradients[loc.x + (loc.y * Size.x)] = GetGradient2D(MinGrid + loc, ScaledOffset,
+                                                                            WrapInterval, Seed);
             }
         }
-    }
 
+        Vector2f GetLerpGrid(Vector2f pos) const
+        {
+            return Vector2f((pos.x + WithinGridOffset.x) * InvScale.x,
+                            (pos.y + WithinGridOffset.y) * InvScale.y);
+        }
+        Vector2f GetGradient(Vector2i gridPos) const
+        {
+            if (UseGrid)
+                return Gradients[(gridPos.x - MinGrid.x) + ((gridPos.y - MinGrid.y) * Size.x)];
+            return GetGradient2D(gridPos, ScaledOffset, WrapInterval, Seed);
+        }
+    };
+    //The grid gradients that a batch of 3D sample positions need.
+    //If the positions are close together (e.x. a tile of noise), the gradients they need are computed up-front.
+    //Otherwise, each gradient is computed as it's needed.
+    struct SampleGrid3D
+    {
+        Vector3i ScaledOffset;
+        Vector3f InvScale, WithinGridOffset;
+        Vector3u WrapInterval;
+        int Seed;
 
-    //Now compute the noise for every point.
+        bool UseGrid;
+        Vector3i MinGrid, Size;
+        std::vector<Vector3f> Gradients;
 
-    float(*smoothStepper)(float inF);
-    switch (SmoothAmount)
+
+        SampleGrid3D(const Perlin3D& perlin, const Vector3f* positions, unsigned int nPositions)
+            : InvScale(1.0f / perlin.Scale.x, 1.0f / perlin.Scale.y, 1.0f / perlin.Scale.z),
+              WrapInterval(perlin.GradientWrapInterval), Seed(perlin.RandSeed)
+        {
+            SplitOffset(perlin.Offset, perlin.Scale, ScaledOffset, WithinGridOffset);
+
+            //Find the range of grid points the positions touch.
+            Vector3i minCorner(std::numeric_limits<int>::max(), std::numeric_limits<int>::max(), std::numeric_limits<int>::max()),
+                     maxCorner(std::numeric_limits<int>::min(), std::numeric_limits<int>::min(), std::numeric_limits<int>::min());
+            for (unsigned int i = 0; i < nPositions; ++i)
+            {
+                Vector3f lerpGrid = GetLerpGrid(positions[i]);
+                Vector3i minGrid((int)floorf(lerpGrid.x), (int)floorf(lerpGrid.y), (int)floorf(lerpGrid.z));
+                minCorner = Vector3i(Mathf::Min(minCorner.x, minGrid.x), Mathf::Min(minCorner.y, minGrid.y), Mathf::Min(minCorner.z, minGrid.z));
+                maxCorner = Vector3i(Mathf::Max(maxCorner.x, minGrid.x), Mathf::Max(maxCorner.y, minGrid.y), Mathf::Max(maxCorner.z, minGrid.z));
+            }
+            MinGrid = minCorner;
+            Size = maxCorner - minCorner + Vector3i(2, 2, 2);
+            UseGrid = (nPositions > 0 &&
+                       (long long)Size.x * (long long)Size.y * (long long)Size.z <= 4 * (long long)nPositions);
+
+            if (UseGrid)
+            {
+                Gradients.resize(Size.x * Size.y * Size.z);
+                for (Vector3i loc(0, 0, 0); loc.z < Size.z; ++loc.z)
+                    for (loc.y = 0; loc.y < Size.y; ++loc.y)
+                        for (loc.x = 0; loc.x < Size.x; ++loc.x)
+                            Gradients[loc.x + (Size.x * (loc.y + (Size.y * loc.z)))] =
+                                GetGradient3D(MinGrid + loc, ScaledOffset, WrapInterval, Seed);
+            }
+        }
+
+        Vector3f GetLerpGrid(Vector3f pos) const
+        {
+            return Vector3f((pos.x + WithinGridOffset.x) * InvScale.x,
+                            (pos.y + WithinGridOffset.y) * InvScale.y,
+                            (pos.z + WithinGridOffset.z) * InvScale.z);
+        }
+        Vector3f GetGradient(Vector3i gridPos) const
+        {
+            if (UseGrid)
+            {
+                Vector3i loc = gridPos - MinGrid;
+                return Gradients[loc.x + (Size.x * (loc.y + (Size.y * loc.z)))];
+            }
+            return GetGradient3D(gridPos, ScaledOffset, WrapInterval, Seed);
+        }
+    };
+
+
+    //Lerps between two values, and also computes the gradient of the result
+    //    given the gradients of the two values and of the lerp factor.
+    template<typename VectorType>
+    void LerpWithGradient(float a, const VectorType& gradA, float b, const VectorType& gradB,
+                          float t, const VectorType& gradT,
+                          float& outValue, VectorType& outGradient)
     {
-        case Smoothness::Linear:
-            smoothStepper = [](float inF) { return inF; };
-            break;
-        case Smoothness::Cubic:
-            smoothStepper = &Mathf::Smooth;
-            break;
-        case Smoothness::Quintic:
-            smoothStepper = &Mathf::Supersmooth;
-            break;
+        outValue = Mathf::Lerp(a, b, t);
+        outGradient = gradA + ((gradB - gradA) * t) + (gradT * (b - a));
+    }
+
+
+    //Computes 2D Perlin noise at each of the given positions, without any remapping.
+    template<typename Smoother>
+    void SamplePerlin2D(const Perlin2D& perlin, const Vector2f* positions, float* outValues, unsigned int nPositions)
+    {
+        SampleGrid2D grid(perlin, positions, nPositions);
+
+        const unsigned int simdWidth = SIMDFloats::Width;
+        const int laneIndices[] = { 0, 1, 2, 3, 4, 5, 6, 7 };
+        unsigned int i = 0;
+
+        //If the gradients are in a grid, blocks of positions can be done with SIMD.
+        if (grid.UseGrid)
+        {
+            SIMDFloats simdInvScaleX(grid.InvScale.x), simdInvScaleY(grid.InvScale.y),
+                       simdOffsetX(grid.WithinGridOffset.x), simdOffsetY(grid.WithinGridOffset.y),
+                       one(1.0f);
+            int gridIndices[simdWidth];
+            SIMDInts simdMinGridX(grid.MinGrid.x), simdMinGridY(grid.MinGrid.y), simdGridWidth(grid.Size.x);
+            const Vector2f* gradientsT = grid.Gradients.data(),
+                          * gradientsB = grid.Gradients.data() + grid.Size.x;
+
+            for (; i + simdWidth <= nPositions; i += simdWidth)
+            {
+                SIMDFloats lerpX = (SIMDFloats::Gather(&positions[i].x, laneIndices, 2) + simdOffsetX) * simdInvScaleX,
+                           lerpY = (SIMDFloats::Gather(&positions[i].y, laneIndices, 2) + simdOffsetY) * simdInvScaleY;
+                SIMDInts tlX = lerpX.Floor(),
+                         tlY = lerpY.Floor();
+                SIMDFloats relX = lerpX - tlX.ToFloats(),
+                           relY = lerpY - tlY.ToFloats(),
+                           relXLess = relX - one,
+                           relYLess = relY - one;
+                ((tlX - simdMinGridX) + ((tlY - simdMinGridY) * simdGridWidth)).Store(gridIndices);
+
+                SIMDFloats tlDot = (GatherGradients(gradientsT, gridIndices, 0, 0) * relX) +
+                                   (GatherGradients(gradientsT, gridIndices, 0, 1) * relY),
+                           trDot = (GatherGradients(gradientsT, gridIndices, 1, 0) * relXLess) +
+                                   (GatherGradients(gradientsT, gridIndices, 1, 1) * relY),
+                           blDot = (GatherGradients(gradientsB, gridIndices, 0, 0) * relX) +
+                                   (GatherGradients(gradientsB, gridIndices, 0, 1) * relYLess),
+                           brDot = (GatherGradients(gradientsB, gridIndices, 1, 0) * relXLess) +
+                                   (GatherGradients(gradientsB, gridIndices, 1, 1) * relYLess);
+
+                SIMDFloats smoothX = Smoother::Smooth(relX),
+                           smoothY = Smoother::Smooth(relY);
+                SIMDFloats::Lerp(SIMDFloats::Lerp(tlDot, trDot, smoothX),
+                                 SIMDFloats::Lerp(blDot, brDot, smoothX),
+                                 smoothY).Store(&outValues[i]);
+            }
+        }
 
-        default:
-            assert(false);
-            smoothStepper = [](float inF) { return inF; };
+        //Do the rest of the positions with scalar math.
+        for (; i < nPositions; ++i)
+        {
+            Vector2f lerpGrid = grid.GetLerpGrid(positions[i]);
+            Vector2i tlGrid((int)floorf(lerpGrid.x), (int)floorf(lerpGrid.y));
+            Vector2f relGrid(lerpGrid.x - (float)tlGrid.x, lerpGrid.y - (float)tlGrid.y);
+
+            //Get the dot of each grid corner's gradient and the vector from the coordinate to that grid corner.
+            Vector2f tl = grid.GetGradient(tlGrid),
+                     tr = grid.GetGradient(tlGrid.MoreX()),
+                     bl = grid.GetGradient(tlGrid.MoreY()),
+                     br = grid.GetGradient(tlGrid + Vector2i(1, 1));
+            float tlDot = tl.Dot(relGrid),
+                  trDot = tr.Dot(relGrid - Vector2f(1.0f, 0.0f)),
+                  blDot = bl.Dot(relGrid - Vector2f(0.0f, 1.0f)),
+                  brDot = br.Dot(relGrid - Vector2f(1.0f, 1.0f));
+
+            //Interpolate the values.
+            float smoothedX = Smoother::Smooth(relGrid.x),
+                  smoothedY = Smoother::Smooth(relGrid.y);
+            outValues[i] = Mathf::Lerp(Mathf::Lerp(tlDot, trDot, smoothedX),
+                                       Mathf::Lerp(blDot, brDot, smoothedX),
+                                       smoothedY);
+        }
     }
+    //Computes 2D Perlin noise and its gradient at each of the given positions, without any remapping.
+    //The values are computed exactly like the scalar part of "SamplePerlin2D",
+    //    and the gradient is carried through each step of the interpolation alongside them.
+    template<typename Smoother>
+    void SamplePerlinGradients2D(const Perlin2D& perlin, const Vector2f* positions,
+                                 float* outValues, Vector2f* outGradients, unsigned int nPositions)
+    {
+        SampleGrid2D grid(perlin, positions, nPositions);
 
+        for (unsigned int i = 0; i < nPositions; ++i)
+        {
+            Vector2f lerpGrid = grid.GetLerpGrid(positions[i]);
+            Vector2i tlGrid((int)floorf(lerpGrid.x), (int)floorf(lerpGrid.y));
+            Vector2f relGrid(lerpGrid.x - (float)tlGrid.x, lerpGrid.y - (float)tlGrid.y);
 
-    //Keep track of the min/max in case the noise should be normalized.
-    float min = std::numeric_limits<float>().max(),
-          max = std::numeric_limits<float>().min();
-    Vector3f lerpGrid, relGrid, relGridLess;
-    Vector3u minGrid;
-    Vector3f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z);
-    float minXYZ_dot, minXY_maxZ_dot, minX_maxY_minZ_dot, minX_maxYZ_dot,
-          maxX_minYZ_dot, maxX_minY_maxZ_dot, maxXY_minZ_dot, maxXYZ_dot;
-    Vector3f withinGridOffset(fmodf(Offset.x, Scale.x), fmodf(Offset.y, Scale.y), fmodf(Offset.z, Scale.z));
+            //Get the dot of each grid corner's gradient and the vector from the coordinate to that grid corner.
+            //The gradient of each dot product is just the corner's gradient.
+            Vector2f tl = grid.GetGradient(tlGrid),
+                     tr = grid.GetGradient(tlGrid.MoreX()),
+                     bl = grid.GetGradient(tlGrid.MoreY()),
+                     br = grid.GetGradient(tlGrid + Vector2i(1, 1));
+            float tlDot = tl.Dot(relGrid),
+                  trDot = tr.Dot(relGrid - Vector2f(1.0f, 0.0f)),
+                  blDot = bl.Dot(relGrid - Vector2f(0.0f, 1.0f)),
+                  brDot = br.Dot(relGrid - Vector2f(1.0f, 1.0f));
+
+            //Interpolate the values.
+            Vector2f smoothedX(Smoother::Smooth(relGrid.x), Smoother::Derivative(relGrid.x)),
+                     smoothedY(Smoother::Smooth(relGrid.y), Smoother::Derivative(relGrid.y));
+            float top, bottom;
+            Vector2f topGradient, bottomGradient, gradient;
+            LerpWithGradient(tlDot, tl, trDot, tr, smoothedX.x, Vector2f(smoothedX.y, 0.0f), top, topGradient);
+            LerpWithGradient(blDot, bl, brDot, br, smoothedX.x, Vector2f(smoothedX.y, 0.0f), bottom, bottomGradient);
+            LerpWithGradient(top, topGradient, bottom, bottomGradient, smoothedY.x, Vector2f(0.0f, smoothedY.y),
+                             outValues[i], gradient);
 
-    for (loc.z = 0; loc.z < dimensions.z; ++loc.z)
+            //Convert the gradient from grid units to pixels.
+            gradient.MultiplyComponents(grid.InvScale);
+            outGradients[i] = gradient;
+        }
+    }
+
+    //Computes 3D Perlin noise at each of the given positions, without any remapping.
+    template<typename Smoother>
+    void SamplePerlin3D(const Perlin3D& perlin, const Vector3f* positions, float* outValues, unsigned int nPositions)
     {
-        lerpGrid.z = ((float)loc.z + withinGridOffset.z) * invScale.z;
+        SampleGrid3D grid(perlin, positions, nPositions);
+
+        for (unsigned int i = 0; i < nPositions; ++i)
+        {
+            Vector3f lerpGrid = grid.GetLerpGrid(positions[i]);
+            Vector3i minGrid((int)floorf(lerpGrid.x), (int)floorf(lerpGrid.y), (int)floorf(lerpGrid.z));
+            Vector3f relGrid(lerpGrid.x - (float)minGrid.x, lerpGrid.y - (float)minGrid.y, lerpGrid.z - (float)minGrid.z);
+            Vector3f relGridLess = relGrid - Vector3f(1.0f, 1.0f, 1.0f);
+
+            //Get the dot of each grid corner's gradient and the vector from the coordinate to that grid corner.
 
-        minGrid.z = (unsigned int)lerpGrid.z;
-        relGrid.z = lerpGrid.z - (float)minGrid.z;
-        relGridLess.z = relGrid.z - 1.0f;
+            float minXYZ_dot = grid.GetGradient(minGrid).Dot(relGrid),
+                  minXY_maxZ_dot = grid.GetGradient(minGrid.MoreZ()).Dot(Vector3f(relGrid.x, relGrid.y, relGridLess.z)),
+                  minX_maxY_minZ_dot = grid.GetGradient(minGrid.MoreY()).Dot(Vector3f(relGrid.x, relGridLess.y, relGrid.z)),
+                  minX_maxYZ_dot = grid.GetGradient(minGrid.MoreY().MoreZ()).Dot(Vector3f(relGrid.x, relGridLess.y, relGridLess.z));
 
-        for (loc.y = 0; loc.y < dimensions.y; ++loc.y)
+            float maxX_minYZ_dot = grid.GetGradient(minGrid.MoreX()).Dot(Vector3f(relGridLess.x, relGrid.y, relGrid.z)),
+                  maxX_minY_maxZ_dot = grid.GetGradient(minGrid.MoreX().MoreZ()).Dot(Vector3f(relGridLess.x, relGrid.y, relGridLess.z)),
+                  maxXY_minZ_dot = grid.GetGradient(minGrid.MoreX().MoreY()).Dot(Vector3f(relGridLess.x, relGridLess.y, relGrid.z)),
+                  maxXYZ_dot = grid.GetGradient(minGrid.MoreX().MoreY().MoreZ()).Dot(relGridLess);
+
+            //Interpolate the values one axis at a time.
+            Vector3f smoothed(Smoother::Smooth(relGrid.x), Smoother::Smooth(relGrid.y), Smoother::Smooth(relGrid.z));
+            outValues[i] = Mathf::Lerp(Mathf::Lerp(Mathf::Lerp(minXYZ_dot, maxX_minYZ_dot, smoothed.x),
+                                                   Mathf::Lerp(minX_maxY_minZ_dot, maxXY_minZ_dot, smoothed.x),
+                                                   smoothed.y),
+                                       Mathf::Lerp(Mathf::Lerp(minXY_maxZ_dot, maxX_minY_maxZ_dot, smoothed.x),
+                                                   Mathf::Lerp(minX_maxYZ_dot, maxXYZ_dot, smoothed.x),
+                                                   smoothed.y),
+                                       smoothed.z);
+        }
+    }
+    //Computes 3D Perlin noise and its gradient at each of the given positions, without any remapping.
+    //The values are computed exactly like "SamplePerlin3D",
+    //    and the gradient is carried through each step of the interpolation alongside them.
+    template<typename Smoother>
+    void SamplePerlinGradients3D(const Perlin3D& perlin, const Vector3f* positions,
+                                 float* outValues, Vector3f* outGradients, unsigned int nPositions)
+    {
+        SampleGrid3D grid(perlin, positions, nPositions);
+
+        for (unsigned int i = 0; i < nPositions; ++i)
         {
-            lerpGrid.y = ((float)loc.y + withinGridOffset.y) * invScale.y;
+            Vector3f lerpGrid = grid.GetLerpGrid(positions[i]);
+            Vector3i minGrid((int)floorf(lerpGrid.x), (int)floorf(lerpGrid.y), (int)floorf(lerpGrid.z));
+            Vector3f relGrid(lerpGrid.x - (float)minGrid.x, lerpGrid.y - (float)minGrid.y, lerpGrid.z - (float)minGrid.z);
+            Vector3f relGridLess = relGrid - Vector3f(1.0f, 1.0f, 1.0f);
 
-            minGrid.y = (unsigned int)lerpGrid.y;
-            relGrid.y = lerpGrid.y - (float)minGrid.y;
-            relGridLess.y = relGrid.y - 1.0f;
+            //Get the dot of each grid corner's gradient and the vector from the coordinate to that grid corner.
+            //The gradient of each dot product is just the corner's gradient.
 
-            for (loc.x = 0; loc.x < dimensions.x; ++loc.x)
-            {
-                lerpGrid.x = ((float)loc.x + withinGridOffset.x) * invScale.x;
-
-                minGrid.x = (unsigned int)lerpGrid.x;
-                relGrid.x = lerpGrid.x - (float)minGrid.x;
-                relGridLess.x = relGrid.x - 1.0f;
-
-                //Get the dot of each grid corner's gradient and the vector from the coordinate to that grid corner.
-
-                minXYZ_dot = gradients[gradients.Clamp(minGrid)].Dot(relGrid);
-                minXY_maxZ_dot = gradients[gradients.Clamp(minGrid.MoreZ())].Dot(Vector3f(relGrid.x, relGrid.y, relGridLess.z));
-                minX_maxY_minZ_dot = gradients[gradients.Clamp(minGrid.MoreY())].Dot(Vector3f(relGrid.x, relGridLess.y, relGrid.z));
-                minX_maxYZ_dot = gradients[gradients.Clamp(minGrid.MoreY().MoreZ())].Dot(Vector3f(relGrid.x, relGridLess.y, relGridLess.z));
-                
-                maxX_minYZ_dot = gradients[gradients.Clamp(minGrid.MoreX())].Dot(Vector3f(relGridLess.x, relGrid.y, relGrid.z));
-                maxX_minY_maxZ_dot = gradients[gradients.Clamp(minGrid.MoreX().MoreZ())].Dot(Vector3f(relGridLess.x, relGrid.y, relGridLess.z));
-                maxXY_minZ_dot = gradients[gradients.Clamp(minGrid.MoreX().MoreY())].Dot(Vector3f(relGridLess.x, relGridLess.y, relGrid.z));
-                maxXYZ_dot = gradients[gradients.Clamp(minGrid.MoreX().MoreY().MoreZ())].Dot(relGridLess);
-
-                //Interpolate the values one axis at a time.
-                Vector3f smoothed(smoothStepper(relGrid.x), smoothStepper(relGrid.y), smoothStepper(relGrid.z));
-                float val = Mathf::Lerp(Mathf::Lerp(Mathf::Lerp(minXYZ_dot, maxX_minYZ_dot, smoothed.x),
-                                                            Mathf::Lerp(minX_maxY_minZ_dot, maxXY_minZ_dot, smoothed.x),
-                                                            smoothed.y),
-                                            Mathf::Lerp(Mathf::Lerp(minXY_maxZ_dot, maxX_minY_maxZ_dot, smoothed.x),
-                                                            Mathf::Lerp(minX_maxYZ_dot, maxXYZ_dot, smoothed.x),
-                                                            smoothed.y),
-                                            smoothed.z);
-                outNoise[loc] = val;
-
-                min = Mathf::Min(val, min);
-                max = Mathf::Max(val, max);
-            }
+            Vector3f minXYZ = grid.GetGradient(minGrid),
+                     minXY_maxZ = grid.GetGradient(minGrid.MoreZ()),
+                     minX_maxY_minZ = grid.GetGradient(minGrid.MoreY()),
+                     minX_maxYZ = grid.GetGradient(minGrid.MoreY().MoreZ()),
+                     maxX_minYZ = grid.GetGradient(minGrid.MoreX()),
+                     maxX_minY_maxZ = grid.GetGradient(minGrid.MoreX().MoreZ()),
+                     maxXY_minZ = grid.GetGradient(minGrid.MoreX().MoreY()),
+                     maxXYZ = grid.GetGradient(minGrid.MoreX().MoreY().MoreZ());
+
+            float minXYZ_dot = minXYZ.Dot(relGrid),
+                  minXY_maxZ_dot = minXY_maxZ.Dot(Vector3f(relGrid.x, relGrid.y, relGridLess.z)),
+                  minX_maxY_minZ_dot = minX_maxY_minZ.Dot(Vector3f(relGrid.x, relGridLess.y, relGrid.z)),
+                  minX_maxYZ_dot = minX_maxYZ.Dot(Vector3f(relGrid.x, relGridLess.y, relGridLess.z));
+
+            float maxX_minYZ_dot = maxX_minYZ.Dot(Vector3f(relGridLess.x, relGrid.y, relGrid.z)),
+                  maxX_minY_maxZ_dot = maxX_minY_maxZ.Dot(Vector3f(relGridLess.x, relGrid.y, relGridLess.z)),
+                  maxXY_minZ_dot = maxXY_minZ.Dot(Vector3f(relGridLess.x, relGridLess.y, relGrid.z)),
+                  maxXYZ_dot = maxXYZ.Dot(relGridLess);
+
+            //Interpolate the values one axis at a time.
+            Vector3f smoothed(Smoother::Smooth(relGrid.x), Smoother::Smooth(relGrid.y), Smoother::Smooth(relGrid.z));
+            Vector3f smoothedX(Smoother::Derivative(relGrid.x), 0.0f, 0.0f),
+                     smoothedY(0.0f, Smoother::Derivative(relGrid.y), 0.0f),
+                     smoothedZ(0.0f, 0.0f, Smoother::Derivative(relGrid.z));
+
+            float minYZ, maxY_minZ, minY_maxZ, maxYZ, minZ, maxZ;
+            Vector3f minYZ_grad, maxY_minZ_grad, minY_maxZ_grad, maxYZ_grad, minZ_grad, maxZ_grad, gradient;
+            LerpWithGradient(minXYZ_dot, minXYZ, maxX_minYZ_dot, maxX_minYZ,
+                             smoothed.x, smoothedX, minYZ, minYZ_grad);
+            LerpWithGradient(minX_maxY_minZ_dot, minX_maxY_minZ, maxXY_minZ_dot, maxXY_minZ,
+                             smoothed.x, smoothedX, maxY_minZ, maxY_minZ_grad);
+            LerpWithGradient(minXY_maxZ_dot, minXY_maxZ, maxX_minY_maxZ_dot, maxX_minY_maxZ,
+                             smoothed.x, smoothedX, minY_maxZ, minY_maxZ_grad);
+            LerpWithGradient(minX_maxYZ_dot, minX_maxYZ, maxXYZ_dot, maxXYZ,
+                             smoothed.x, smoothedX, maxYZ, maxYZ_grad);
+            LerpWithGradient(minYZ, minYZ_grad, maxY_minZ, maxY_minZ_grad,
+                             smoothed.y, smoothedY, minZ, minZ_grad);
+            LerpWithGradient(minY_maxZ, minY_maxZ_grad, maxYZ, maxYZ_grad,
+                             smoothed.y, smoothedY, maxZ, maxZ_grad);
+            LerpWithGradient(minZ, minZ_grad, maxZ, maxZ_grad,
+                             smoothed.z, smoothedZ, outValues[i], gradient);
+
+            //Convert the gradient from grid units to pixels.
+            gradient.MultiplyComponents(grid.InvScale);
+            outGradients[i] = gradient;
         }
     }
+}
+
+
+
+void Perlin2D::Generate(Array2D<float> & outValues) const
+{
+	Vector2u noiseDim = outValues.GetDimensions();
+
+
+    //First compute the gradient at each grid point.
+
+    //Calculate the number of gradients that will be needed.
+	unsigned int gradientWidth = Mathf::RoundToInt(noiseDim.x / Scale.x),
+		         gradientHeight = Mathf::RoundToInt(noiseDim.y / Scale.y);
+    if (gradientWidth == 0 || gradientHeight == 0)
+    {
+        outValues.Fill(0.0f);
+        return;
+    }
+	Array2D<Vector2f> gradients(gradientWidth + 2, gradientHeight + 2);
+
+    //Generate the gradients.
+    Vector2i scaledOffset;
+    Vector2f withinGridOffset;
+    SplitOffset(Offset, Scale, scaledOffset, withinGridOffset);
+    gradients.FillFunc([&](Vector2u loc, Vector2f* outGradient)
+    {
+        *outGradient = GetGradient2D(ToV2i(loc), scaledOffset, GradientWrapInterval, RandSeed);
+    });
+
+
+	//Now compute the noise for every point.
+
+    //Keep track of the min/max of each band of rows in case the noise should be normalized.
+    std::vector<NoiseAnalysis2D::MinMax> bandMinMaxes(GetNumbBands());
+	Vector2f invScale(1.0f / Scale.x, 1.0f / Scale.y);
+
+    ForEachRowBand(noiseDim.y, [&](unsigned int band, unsigned int startY, unsigned int endY)
+    {
+        float min = bandMinMaxes[band].Min,
+              max = bandMinMaxes[band].Max;
+
+	    switch (SmoothAmount)
+	    {
+		    case Smoothness::Linear:
+                GeneratePerlinRows2D<LinearSmoother>(gradients, invScale, withinGridOffset,
+                                                     startY, endY, outValues, min, max);
+			    break;
+		    case Smoothness::Cubic:
+                GeneratePerlinRows2D<CubicSmoother>(gradients, invScale, withinGridOffset,
+                                                    startY, endY, outValues, min, max);
+			    break;
+		    case Smoothness::Quintic:
+                GeneratePerlinRows2D<QuinticSmoother>(gradients, invScale, withinGridOffset,
+                                                      startY, endY, outValues, min, max);
+			    break;
+
+		    default: assert(false);
+	    }
+
+        bandMinMaxes[band] = NoiseAnalysis2D::MinMax(min, max);
+    });
+
+    if (RemapValues)
+    {
+        NoiseAnalysis2D::MinMax minMax = NoiseAnalysis2D::MinMax::Combine(bandMinMaxes);
+
+        NoiseFilterer2D nf;
+        MaxFilterRegion mfr;
+        nf.FillRegion = &mfr;
+        nf.RemapValues_OldVals = Interval(minMax.Min, minMax.Max, 0.00001f);
+        nf.RemapValues(&outValues);
+    }
+}
+
+
+void Perlin3D::Generate(Array3D<float> & outNoise) const
+{
+    float min, max;
+    GenerateSlices(outNoise.GetDimensions(), 0, outNoise.GetDepth(), outNoise, min, max);
 
     if (RemapValues)
     {
@@ -301,4 +902,171 @@ void Perlin3D::Generate(Array3D<float> & outNoise) const
         nf.RemapValues_OldVals = Interval(min, max, 0.00001f);
         nf.RemapValues(&outNoise);
     }
+}
+void Perlin3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    if (RemapValues)
+    {
+        Generator3D::GenerateSlab(volumeSize, startZ, endZ, outSlab);
+        return;
+    }
+
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+
+    float min, max;
+    GenerateSlices(volumeSize, startZ, endZ, outSlab, min, max);
+}
+void Perlin3D::GenerateSlices(Vector3u volumeSize, unsigned int startZ, unsigned int endZ,
+                              Noise3D& outNoise, float& outMin, float& outMax) const
+{
+    //First compute the gradient at every grid point these slices need.
+
+    //Calculate the number of gradient points that the whole volume would need.
+    Vector3u gradientDims((unsigned int)Mathf::RoundToInt(volumeSize.x / Scale.x) + 2,
+                          (unsigned int)Mathf::RoundToInt(volumeSize.y / Scale.y) + 2,
+                          (unsigned int)Mathf::RoundToInt(volumeSize.z / Scale.z) + 2);
+
+    Vector3f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z);
+    Vector3i scaledOffset;
+    Vector3f withinGridOffset;
+    SplitOffset(Offset, Scale, scaledOffset, withinGridOffset);
+
+    //Only the grid slices between the first and last slice's grid cells are needed.
+    //They're clamped the same way the noise clamps its grid positions,
+    //    so the noise values are the same as if every grid slice had been computed.
+    unsigned int gradientStartZ = (unsigned int)(((float)startZ + withinGridOffset.z) * invScale.z),
+                 gradientEndZ = (unsigned int)(((float)(endZ - 1) + withinGridOffset.z) * invScale.z) + 1;
+    gradientStartZ = Mathf::Min(gradientStartZ, gradientDims.z - 1);
+    gradientEndZ = Mathf::Min(gradientEndZ, gradientDims.z - 1);
+
+    Array3D<Vector3f> gradients(gradientDims.x, gradientDims.y, gradientEndZ - gradientStartZ + 1);
+
+    //Generate the gradients.
+    gradients.FillFunc([&](Vector3u loc, Vector3f* outGradient)
+    {
+        *outGradient = GetGradient3D(ToV3i(loc) + Vector3i(0, 0, (int)gradientStartZ),
+                                     scaledOffset, GradientWrapInterval, RandSeed);
+    });
+
+
+    //Now compute the noise for every point.
+
+    //Keep track of the min/max of each slab in case the noise should be normalized.
+    std::vector<NoiseAnalysis3D::MinMax> slabMinMaxes(GetNumbSlabs());
+
+    ForEachZSlab(endZ - startZ, [&](unsigned int slab, unsigned int slabStartZ, unsigned int slabEndZ)
+    {
+        float min = slabMinMaxes[slab].Min,
+              max = slabMinMaxes[slab].Max;
+
+        switch (SmoothAmount)
+        {
+            case Smoothness::Linear:
+                GeneratePerlinSlices3D<LinearSmoother>(gradients, gradientStartZ, invScale, withinGridOffset,
+                                                       startZ + slabStartZ, startZ + slabEndZ,
+                                                       outNoise, startZ, min, max);
+                break;
+            case Smoothness::Cubic:
+                GeneratePerlinSlices3D<CubicSmoother>(gradients, gradientStartZ, invScale, withinGridOffset,
+                                                      startZ + slabStartZ, startZ + slabEndZ,
+                                                      outNoise, startZ, min, max);
+                break;
+            case Smoothness::Quintic:
+                GeneratePerlinSlices3D<QuinticSmoother>(gradients, gradientStartZ, invScale, withinGridOffset,
+                                                        startZ + slabStartZ, startZ + slabEndZ,
+                                                        outNoise, startZ, min, max);
+                break;
+
+            default: assert(false);
+        }
+
+        slabMinMaxes[slab] = NoiseAnalysis3D::MinMax(min, max);
+    });
+
+    NoiseAnalysis3D::MinMax minMax = NoiseAnalysis3D::MinMax::Combine(slabMinMaxes);
+    outMin = minMax.Min;
+    outMax = minMax.Max;
+}
+
+float Perlin2D::Sample(Vector2f pos) const
+{
+    float value;
+    SampleMany(&pos, &value, 1);
+    return value;
+}
+void Perlin2D::SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const
+{
+    switch (SmoothAmount)
+    {
+        case Smoothness::Linear:
+            SamplePerlin2D<LinearSmoother>(*this, positions, outValues, nPositions);
+            break;
+        case Smoothness::Cubic:
+            SamplePerlin2D<CubicSmoother>(*this, positions, outValues, nPositions);
+            break;
+        case Smoothness::Quintic:
+            SamplePerlin2D<QuinticSmoother>(*this, positions, outValues, nPositions);
+            break;
+
+        default: assert(false);
+    }
+}
+void Perlin2D::SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients, unsigned int nPositions) const
+{
+    switch (SmoothAmount)
+    {
+        case Smoothness::Linear:
+            SamplePerlinGradients2D<LinearSmoother>(*this, positions, outValues, outGradients, nPositions);
+            break;
+        case Smoothness::Cubic:
+            SamplePerlinGradients2D<CubicSmoother>(*this, positions, outValues, outGradients, nPositions);
+            break;
+        case Smoothness::Quintic:
+            SamplePerlinGradients2D<QuinticSmoother>(*this, positions, outValues, outGradients, nPositions);
+            break;
+
+        default: assert(false);
+    }
+}
+
+float Perlin3D::Sample(Vector3f pos) const
+{
+    float value;
+    SampleMany(&pos, &value, 1);
+    return value;
+}
+void Perlin3D::SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const
+{
+    switch (SmoothAmount)
+    {
+        case Smoothness::Linear:
+            SamplePerlin3D<LinearSmoother>(*this, positions, outValues, nPositions);
+            break;
+        case Smoothness::Cubic:
+            SamplePerlin3D<CubicSmoother>(*this, positions, outValues, nPositions);
+            break;
+        case Smoothness::Quintic:
+            SamplePerlin3D<QuinticSmoother>(*this, positions, outValues, nPositions);
+            break;
+
+        default: assert(false);
+    }
+}
+void Perlin3D::SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients, unsigned int nPositions) const
+{
+    switch (SmoothAmount)
+    {
+        case Smoothness::Linear:
+            SamplePerlinGradients3D<LinearSmoother>(*this, positions, outValues, outGradients, nPositions);
+            break;
+        case Smoothness::Cubic:
+            SamplePerlinGradients3D<CubicSmoother>(*this, positions, outValues, outGradients, nPositions);
+            break;
+        case Smoothness::Quintic:
+            SamplePerlinGradients3D<QuinticSmoother>(*this, positions, outValues, outGradients, nPositions);
+            break;
+
+        default: assert(false);
+    }
 }
\ No newline at end of file
@@ -38,6 +38,25 @@ public:
         : Scale(scale, scale), SmoothAmount(amount), Offset(offset), RandSeed(seed), GradientWrapInterval(gradientWrapInterval), RemapValues(remapValues) { }
 
 	virtual void Generate(Array2D<float> & outValues) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so it can only be sampled
+    //    if "RemapValues" is off. Samples give the same values as "Generate"
+    //    except near the far edges of the noise, where "Generate" clamps its grid of gradients.
+    virtual bool CanSample(void) const override { return !RemapValues; }
+    virtual float Sample(Vector2f pos) const override;
+    virtual void SampleMany(const Vector2f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //Gradients are computed alongside the values, so they have the same limitations as "Sample".
+    //The Linear smoothness gives noise whose gradient jumps at the edges of each grid cell.
+    virtual bool CanSampleGradients(void) const override { return !RemapValues; }
+    virtual void SampleGradients(const Vector2f* positions, float* outValues, Vector2f* outGradients, unsigned int nPositions) const override;
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Perlin2D").Add(SmoothAmount).Add(RandSeed).Add(Scale).Add(Offset)
+                                          .Add(GradientWrapInterval).Add(RemapValues).Value;
+    }
 };
 
 //3D Perlin noise generator.
@@ -75,4 +94,35 @@ public:
         : Scale(scale), SmoothAmount(amount), Offset(offset), RandSeed(seed), GradientWrapInterval(gradientWrapInterval), RemapValues(remapValues) { }
 
     virtual void Generate(Array3D<float> & outValues) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so it can only be sampled
+    //    if "RemapValues" is off. Samples give the same values as "Generate"
+    //    except near the far edges of the noise, where "Generate" clamps its grid of gradients.
+    virtual bool CanSample(void) const override { return !RemapValues; }
+    virtual float Sample(Vector3f pos) const override;
+    virtual void SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //Gradients are computed alongside the values, so they have the same limitations as "Sample".
+    //The Linear smoothness gives noise whose gradient jumps at the edges of each grid cell.
+    virtual bool CanSampleGradients(void) const override { return !RemapValues; }
+    virtual void SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients, unsigned int nPositions) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so slabs can only be generated
+    //    on their own if "RemapValues" is off. Each slab only computes the gradients it needs.
+    virtual bool CanGenerateSlab(void) const override { return !RemapValues; }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Perlin3D").Add(SmoothAmount).Add(RandSeed).Add(Scale).Add(Offset)
+                                          .Add(GradientWrapInterval).Add(RemapValues).Value;
+    }
+
+private:
+
+    //Generates the Z slices "startZ" through "endZ - 1" of a volume with the given size, without remapping them.
+    //The first Z slice of "outNoise" is slice "startZ". Outputs the min/max of the generated values.
+    void GenerateSlices(Vector3u volumeSize, unsigned int startZ, unsigned int endZ,
+                        Noise3D& outNoise, float& outMin, float& outMax) const;
 };
\ No newline at end of file
@@ -0,0 +1,722 @@
+#include "PoissonDisk.h"
+
+#include "../../ThreadPool.h"
+
+
+namespace
+{
+    const float TwoPi = 6.28318531f;
+    //Candidates are placed this much farther out than a point's radius,
+    //    so that rounding never puts them just inside it.
+    const float CandidateSpacing = 1.0001f;
+    //The most times a candidate is pushed further out to make room for its own radius.
+    const unsigned int MaxCandidatePushes = 8;
+    //Marks a grid cell that doesn't have a point in it. Points are never at negative positions.
+    //Empty cells are treated as a point so far away that it's never too close to anything,
+    //    so distance checks don't need a (hard to predict) branch for each cell.
+    const float EmptyCell = -1.0e18f;
+
+
+    //Gets the given map's value at the given position (in pixels), clamping it to the map's edges.
+    float SampleBilinear(const Noise2D& map, Vector2f pos)
+    {
+        Vector2f maxPos((float)(map.GetWidth() - 1), (float)(map.GetHeight() - 1));
+        pos = Vector2f(Mathf::Clamp(pos.x, 0.0f, maxPos.x), Mathf::Clamp(pos.y, 0.0f, maxPos.y));
+
+        Vector2u minP((unsigned int)pos.x, (unsigned int)pos.y),
+                 maxP(Mathf::Min(minP.x + 1, map.GetWidth() - 1), Mathf::Min(minP.y + 1, map.GetHeight() - 1));
+        Vector2f t(pos.x - (float)minP.x, pos.y - (float)minP.y);
+
+        return Mathf::Lerp(Mathf::Lerp(map[minP], map[Vector2u(maxP.x, minP.y)], t.x),
+                           Mathf::Lerp(map[Vector2u(minP.x, maxP.y)], map[maxP], t.x),
+                           t.y);
+    }
+    //Gets the given map's value at the given position (in pixels), clamping it to the map's edges.
+    float SampleTrilinear(const Noise3D& map, Vector3f pos)
+    {
+        Vector3f maxPos((float)(map.GetWidth() - 1), (float)(map.GetHeight() - 1), (float)(map.GetDepth() - 1));
+        pos = Vector3f(Mathf::Clamp(pos.x, 0.0f, maxPos.x),
+                       Mathf::Clamp(pos.y, 0.0f, maxPos.y),
+                       Mathf::Clamp(pos.z, 0.0f, maxPos.z));
+
+        Vector3u minP((unsigned int)pos.x, (unsigned int)pos.y, (unsigned int)pos.z),
+                 maxP(Mathf::Min(minP.x + 1, map.GetWidth() - 1),
+                      Mathf::Min(minP.y + 1, map.GetHeight() - 1),
+                      Mathf::Min(minP.z + 1, map.GetDepth() - 1));
+        Vector3f t(pos.x - (float)minP.x, pos.y - (float)minP.y, pos.z - (float)minP.z);
+
+        float near = Mathf::Lerp(Mathf::Lerp(map[minP], map[Vector3u(maxP.x, minP.y, minP.z)], t.x),
+                                 Mathf::Lerp(map[Vector3u(minP.x, maxP.y, minP.z)],
+                                             map[Vector3u(maxP.x, maxP.y, minP.z)], t.x),
+                                 t.y),
+              far = Mathf::Lerp(Mathf::Lerp(map[Vector3u(minP.x, minP.y, maxP.z)],
+                                            map[Vector3u(maxP.x, minP.y, maxP.z)], t.x),
+                                Mathf::Lerp(map[Vector3u(minP.x, maxP.y, maxP.z)], map[maxP], t.x),
+                                t.y);
+        return Mathf::Lerp(near, far, t.z);
+    }
+
+    //Wraps the given cell coordinate into the range [0, nCells) if "wrap" is true,
+    //    and gets how far the points in that cell have to be moved to line up with the unwrapped cell.
+    //Returns false if the cell is outside the grid and "wrap" is false.
+    bool WrapCell(int cell, unsigned int nCells, float areaSize, bool wrap, int& outCell, float& outOffset)
+    {
+        if (cell >= 0 && cell < (int)nCells)
+        {
+            outCell = cell;
+            outOffset = 0.0f;
+            return true;
+        }
+        if (!wrap)
+            return false;
+
+        int nWraps = (cell >= 0) ? (cell / (int)nCells) : -(((-cell) + (int)nCells - 1) / (int)nCells);
+        outCell = cell - (nWraps * (int)nCells);
+        outOffset = (float)nWraps * areaSize;
+        return true;
+    }
+
+    //Gets the number of tiles along an axis of the background grid, and the cell that each tile starts at.
+    //If wrapping, the number of tiles has to be even (or 1) so that the tiles at each end are in different passes.
+    void GetTiles(unsigned int nCells, unsigned int tileSize, bool wrap, std::vector<int>& outTileStarts)
+    {
+        unsigned int nTiles = Mathf::Max(nCells / tileSize, (unsigned int)1);
+        if (wrap && nTiles > 1 && nTiles % 2 == 1)
+            nTiles -= 1;
+
+        outTileStarts.resize(nTiles + 1);
+        for (unsigned int i = 0; i <= nTiles; ++i)
+            outTileStarts[i] = (int)ThreadPool::GetChunkStart(nCells, nTiles, i);
+    }
+
+
+    //A point whose surroundings still need to be filled in.
+    struct ActivePoint2D
+    {
+        Vector2f Pos;
+        float Radius;
+        ActivePoint2D(Vector2f pos, float radius) : Pos(pos), Radius(radius) { }
+    };
+
+    //The background grid for 2D sampling. Each cell holds at most one point.
+    struct SampleGrid2D
+    {
+        Vector2u NCells;
+        Vector2f AreaSize, CellSize, InvCellSize;
+        //The largest radius any point can have.
+        float MaxRadius;
+        //The number of cells away from a point that another point could be too close to it.
+        Vector2i SearchRange;
+        bool Wrap, VariableRadius;
+
+        //The point in each cell, or "EmptyCell" for the X if there isn't one.
+        std::vector<Vector2f> Points;
+        //The radius of the point in each cell. Only used if "VariableRadius" is true.
+        std::vector<float> Radii;
+
+
+        unsigned int GetIndex(Vector2i cell) const { return (unsigned int)cell.x + ((unsigned int)cell.y * NCells.x); }
+        //Gets the cell containing the given position, which must not be negative.
+        Vector2i GetCell(Vector2f pos) const
+        {
+            return Vector2i((int)Mathf::Min(pos.x * InvCellSize.x, (float)NCells.x),
+                            (int)Mathf::Min(pos.y * InvCellSize.y, (float)NCells.y));
+        }
+
+        //Gets whether the given point is far enough from every other point.
+        bool IsFarEnough(Vector2f pos, Vector2i cell, float radius) const
+        {
+            //Only look at the cells that touch the square around the point that could have a point too close to it.
+            Vector2i minCell((int)floorf((pos.x - MaxRadius) * InvCellSize.x), (int)floorf((pos.y - MaxRadius) * InvCellSize.y)),
+                     maxCell((int)floorf((pos.x + MaxRadius) * InvCellSize.x), (int)floorf((pos.y + MaxRadius) * InvCellSize.y));
+
+            //Most points aren't near the edge of the grid, so they don't need any wrapping or bounds checks.
+            //The rows closest to the point are checked first, since they're the most likely to be too close.
+            if (minCell.x >= 0 && minCell.y >= 0 && maxCell.x < (int)NCells.x && maxCell.y < (int)NCells.y)
+            {
+                for (int dist = 0; cell.y - dist >= minCell.y || cell.y + dist <= maxCell.y; ++dist)
+                {
+                    if ((cell.y - dist >= minCell.y &&
+                         IsRowTooClose(pos, radius, GetIndex(Vector2i(0, cell.y - dist)), minCell.x, maxCell.x)) ||
+                        (dist > 0 && cell.y + dist <= maxCell.y &&
+                         IsRowTooClose(pos, radius, GetIndex(Vector2i(0, cell.y + dist)), minCell.x, maxCell.x)))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            for (int y = minCell.y; y <= maxCell.y; ++y)
+            {
+                Vector2i wrapped;
+                Vector2f offset;
+                if (!WrapCell(y, NCells.y, AreaSize.y, Wrap, wrapped.y, offset.y))
+                    continue;
+
+                for (int x = minCell.x; x <= maxCell.x; ++x)
+                    if (WrapCell(x, NCells.x, AreaSize.x, Wrap, wrapped.x, offset.x) &&
+                        IsTooClose(pos, radius, GetIndex(wrapped), offset))
+                    {
+                        return false;
+                    }
+            }
+            return true;
+        }
+        //Gets whether the given point is too close to any point in the cells from "minX" to "maxX" of the given row.
+        bool IsRowTooClose(Vector2f pos, float radius, unsigned int rowStart, int minX, int maxX) const
+        {
+            bool tooClose = false;
+            for (int x = minX; x <= maxX; ++x)
+                tooClose |= IsTooClose(pos, radius, rowStart + (unsigned int)x, Vector2f());
+            return tooClose;
+        }
+        //Gets whether the given point is too close to the point in the given cell (if there is one).
+        //The point in the cell is moved by the given offset first.
+        bool IsTooClose(Vector2f pos, float radius, unsigned int cellIndex, Vector2f offset) const
+        {
+            float minDist = VariableRadius ? Mathf::Max(radius, Radii[cellIndex]) : radius;
+            return pos.DistanceSquared(Points[cellIndex] + offset) < (minDist * minDist);
+        }
+    };
+
+    //Fills in the given tile of cells (from "tileMin" to "tileMax", not including "tileMax") with points.
+    //"directions" is the unit vector for each candidate around a point, before it's rotated.
+    void FillTile(const PoissonDisk2D& sampler, SampleGrid2D& grid, const std::vector<Vector2f>& directions,
+                  Vector2i tile, Vector2i tileMin, Vector2i tileMax)
+    {
+        //Every random value for this tile comes from this seed and a counter.
+        int tileSeed = (int)HashRand::Hash(sampler.Seed, tile.x, tile.y);
+        unsigned int nRandoms = 0;
+        auto nextRandom = [&]() { return HashRand::GetZeroToOne(tileSeed, (int)(nRandoms++)); };
+
+        std::vector<ActivePoint2D> active;
+        auto tryAdd = [&](Vector2f pos, float radius) -> bool
+        {
+            if (pos.x < 0.0f || pos.y < 0.0f)
+                return false;
+            Vector2i cell = grid.GetCell(pos);
+            if (cell.x < tileMin.x || cell.y < tileMin.y || cell.x >= tileMax.x || cell.y >= tileMax.y)
+                return false;
+
+            unsigned int index = grid.GetIndex(cell);
+            if (grid.Points[index].x != EmptyCell || !grid.IsFarEnough(pos, cell, radius))
+                return false;
+
+            grid.Points[index] = pos;
+            if (grid.VariableRadius)
+                grid.Radii[index] = radius;
+            active.push_back(ActivePoint2D(pos, radius));
+            return true;
+        };
+
+        //Start by growing from the points that neighboring tiles already placed near this one.
+        for (int y = tileMin.y - grid.SearchRange.y; y < tileMax.y + grid.SearchRange.y; ++y)
+        {
+            Vector2i wrapped;
+            Vector2f offset;
+            if (!WrapCell(y, grid.NCells.y, grid.AreaSize.y, grid.Wrap, wrapped.y, offset.y))
+                continue;
+
+            for (int x = tileMin.x - grid.SearchRange.x; x < tileMax.x + grid.SearchRange.x; ++x)
+            {
+                if (!WrapCell(x, grid.NCells.x, grid.AreaSize.x, grid.Wrap, wrapped.x, offset.x))
+                    continue;
+
+                unsigned int index = grid.GetIndex(wrapped);
+                if (grid.Points[index].x != EmptyCell)
+                    active.push_back(ActivePoint2D(grid.Points[index] + offset,
+                                                   grid.VariableRadius ? grid.Radii[index] : sampler.MinRadius));
+            }
+        }
+
+        //Grow outward from random active points until there aren't any left.
+        //Each active point tries every candidate around it once, then it's done.
+        //Growth can't reach every gap (e.x. if the neighbors didn't leave any points nearby),
+        //    so afterwards, random spots in the tile are tried, and growth starts again from any that fit.
+        //This stops once a whole round of random spots fails.
+        Vector2f tileMinPos((float)tileMin.x * grid.CellSize.x, (float)tileMin.y * grid.CellSize.y),
+                 tileSizePos((float)(tileMax.x - tileMin.x) * grid.CellSize.x,
+                             (float)(tileMax.y - tileMin.y) * grid.CellSize.y);
+        while (true)
+        {
+            if (active.empty())
+            {
+                for (unsigned int i = 0; i < sampler.NumbCandidates && active.empty(); ++i)
+                {
+                    Vector2f pos = tileMinPos + Vector2f(nextRandom() * tileSizePos.x, nextRandom() * tileSizePos.y);
+                    tryAdd(pos, grid.VariableRadius ? sampler.GetRadius(pos, grid.AreaSize) : sampler.MinRadius);
+                }
+                if (active.empty())
+                    break;
+            }
+
+            unsigned int activeI = Mathf::Min((unsigned int)(nextRandom() * (float)active.size()),
+                                              (unsigned int)active.size() - 1);
+            ActivePoint2D point = active[activeI];
+            active[activeI] = active.back();
+            active.pop_back();
+
+            float angle = nextRandom() * TwoPi,
+                  rotCos = cosf(angle),
+                  rotSin = sinf(angle);
+
+            //If every point has the same radius, candidates less than 60 degrees away from one that was added
+            //    are always too close to it, so they can be skipped.
+            unsigned int nSkipped = grid.VariableRadius ? 0 : ((directions.size() - 1) / 6);
+            int firstAdded = -1;
+
+            for (unsigned int i = 0; i < directions.size(); ++i)
+            {
+                if (firstAdded >= 0 && i + nSkipped >= directions.size() + (unsigned int)firstAdded)
+                    break;
+
+                Vector2f dir((directions[i].x * rotCos) - (directions[i].y * rotSin),
+                             (directions[i].x * rotSin) + (directions[i].y * rotCos));
+                Vector2f pos = point.Pos + (dir * (point.Radius * CandidateSpacing));
+
+                float radius = sampler.MinRadius;
+                if (grid.VariableRadius)
+                {
+                    //If the candidate needs more room than this point, push it out to its own radius.
+                    //Its radius changes as it moves, so keep pushing until it settles.
+                    float dist = point.Radius;
+                    radius = sampler.GetRadius(pos, grid.AreaSize);
+                    for (unsigned int j = 0; j < MaxCandidatePushes && radius > dist; ++j)
+                    {
+                        dist = radius;
+                        pos = point.Pos + (dir * (dist * CandidateSpacing));
+                        radius = sampler.GetRadius(pos, grid.AreaSize);
+                    }
+                }
+
+                if (tryAdd(pos, radius))
+                {
+                    if (firstAdded < 0)
+                        firstAdded = (int)i;
+                    i += nSkipped;
+                }
+            }
+        }
+    }
+
+
+    //A point whose surroundings still need to be filled in.
+    struct ActivePoint3D
+    {
+        Vector3f Pos;
+        float Radius;
+        ActivePoint3D(Vector3f pos, float radius) : Pos(pos), Radius(radius) { }
+    };
+
+    //The background grid for 3D sampling. Each cell holds at most one point.
+    struct SampleGrid3D
+    {
+        Vector3u NCells;
+        Vector3f AreaSize, CellSize, InvCellSize;
+        //The largest radius any point can have.
+        float MaxRadius;
+        //The number of cells away from a point that another point could be too close to it.
+        Vector3i SearchRange;
+        bool Wrap, VariableRadius;
+
+        //The point in each cell, or "EmptyCell" for the X if there isn't one.
+        std::vector<Vector3f> Points;
+        //The radius of the point in each cell. Only used if "VariableRadius" is true.
+        std::vector<float> Radii;
+
+
+        unsigned int GetIndex(Vector3i cell) const
+        {
+            return (unsigned int)cell.x + (NCells.x * ((unsigned int)cell.y + (NCells.y * (unsigned int)cell.z)));
+        }
+        //Gets the cell containing the given position, which must not be negative.
+        Vector3i GetCell(Vector3f pos) const
+        {
+            return Vector3i((int)Mathf::Min(pos.x * InvCellSize.x, (float)NCells.x),
+                            (int)Mathf::Min(pos.y * InvCellSize.y, (float)NCells.y),
+                            (int)Mathf::Min(pos.z * InvCellSize.z, (float)NCells.z));
+        }
+
+        //Gets whether the given point is far enough from every other point.
+        bool IsFarEnough(Vector3f pos, Vector3i cell, float radius) const
+        {
+            //Only look at the cells that touch the cube around the point that could have a point too close to it.
+            Vector3i minCell((int)floorf((pos.x - MaxRadius) * InvCellSize.x),
+                             (int)floorf((pos.y - MaxRadius) * InvCellSize.y),
+                             (int)floorf((pos.z - MaxRadius) * InvCellSize.z)),
+                     maxCell((int)floorf((pos.x + MaxRadius) * InvCellSize.x),
+                             (int)floorf((pos.y + MaxRadius) * InvCellSize.y),
+                             (int)floorf((pos.z + MaxRadius) * InvCellSize.z));
+
+            //Most points aren't near the edge of the grid, so they don't need any wrapping or bounds checks.
+            //The slices closest to the point are checked first, since they're the most likely to be too close.
+            if (minCell.x >= 0 && minCell.y >= 0 && minCell.z >= 0 &&
+                maxCell.x < (int)NCells.x && maxCell.y < (int)NCells.y && maxCell.z < (int)NCells.z)
+            {
+                for (int dist = 0; cell.z - dist >= minCell.z || cell.z + dist <= maxCell.z; ++dist)
+                {
+                    if ((cell.z - dist >= minCell.z && IsSliceTooClose(pos, radius, cell.z - dist, minCell, maxCell)) ||
+                        (dist > 0 && cell.z + dist <= maxCell.z &&
+                         IsSliceTooClose(pos, radius, cell.z + dist, minCell, maxCell)))
+                    {
+                        return false;
+                    }
+                }
+                return true;
+            }
+
+            for (int z = minCell.z; z <= maxCell.z; ++z)
+            {
+                Vector3i wrapped;
+                Vector3f offset;
+                if (!WrapCell(z, NCells.z, AreaSize.z, Wrap, wrapped.z, offset.z))
+                    continue;
+
+                for (int y = minCell.y; y <= maxCell.y; ++y)
+                {
+                    if (!WrapCell(y, NCells.y, AreaSize.y, Wrap, wrapped.y, offset.y))
+                        continue;
+
+                    for (int x = minCell.x; x <= maxCell.x; ++x)
+                        if (WrapCell(x, NCells.x, AreaSize.x, Wrap, wrapped.x, offset.x) &&
+                            IsTooClose(pos, radius, GetIndex(wrapped), offset))
+                        {
+                            return false;
+                        }
+                }
+            }
+            return true;
+        }
+        //Gets whether the given point is too close to any point in the given Z slice of cells
+        //    from "minCell" to "maxCell" (along X and Y).
+        bool IsSliceTooClose(Vector3f pos, float radius, int z, Vector3i minCell, Vector3i maxCell) const
+        {
+            bool tooClose = false;
+            for (int y = minCell.y; y <= maxCell.y; ++y)
+            {
+                unsigned int rowStart = GetIndex(Vector3i(0, y, z));
+                for (int x = minCell.x; x <= maxCell.x; ++x)
+                    tooClose |= IsTooClose(pos, radius, rowStart + (unsigned int)x, Vector3f());
+            }
+            return tooClose;
+        }
+        //Gets whether the given point is too close to the point in the given cell (if there is one).
+        //The point in the cell is moved by the given offset first.
+        bool IsTooClose(Vector3f pos, float radius, unsigned int cellIndex, Vector3f offset) const
+        {
+            float minDist = VariableRadius ? Mathf::Max(radius, Radii[cellIndex]) : radius;
+            return pos.DistanceSquared(Points[cellIndex] + offset) < (minDist * minDist);
+        }
+    };
+
+    //Fills in the given tile of cells (from "tileMin" to "tileMax", not including "tileMax") with points.
+    //"directions" is the unit vector for each candidate around a point, before it's rotated.
+    void FillTile(const PoissonDisk3D& sampler, SampleGrid3D& grid, const std::vector<Vector3f>& directions,
+                  Vector3i tile, Vector3i tileMin, Vector3i tileMax)
+    {
+        //Every random value for this tile comes from this seed and a counter.
+        int tileSeed = (int)HashRand::Hash(sampler.Seed, tile.x, tile.y, tile.z);
+        unsigned int nRandoms = 0;
+        auto nextRandom = [&]() { return HashRand::GetZeroToOne(tileSeed, (int)(nRandoms++)); };
+
+        std::vector<ActivePoint3D> active;
+        auto tryAdd = [&](Vector3f pos, float radius)
+        {
+            if (pos.x < 0.0f || pos.y < 0.0f || pos.z < 0.0f)
+                return;
+            Vector3i cell = grid.GetCell(pos);
+            if (cell.x < tileMin.x || cell.y < tileMin.y || cell.z < tileMin.z ||
+                cell.x >= tileMax.x || cell.y >= tileMax.y || cell.z >= tileMax.z)
+            {
+                return;
+            }
+
+            unsigned int index = grid.GetIndex(cell);
+            if (grid.Points[index].x != EmptyCell || !grid.IsFarEnough(pos, cell, radius))
+                return;
+
+            grid.Points[index] = pos;
+            if (grid.VariableRadius)
+                grid.Radii[index] = radius;
+            active.push_back(ActivePoint3D(pos, radius));
+        };
+
+        //Start by growing from the points that neighboring tiles already placed near this one.
+        for (int z = tileMin.z - grid.SearchRange.z; z < tileMax.z + grid.SearchRange.z; ++z)
+        {
+            Vector3i wrapped;
+            Vector3f offset;
+            if (!WrapCell(z, grid.NCells.z, grid.AreaSize.z, grid.Wrap, wrapped.z, offset.z))
+                continue;
+
+            for (int y = tileMin.y - grid.SearchRange.y; y < tileMax.y + grid.SearchRange.y; ++y)
+            {
+                if (!WrapCell(y, grid.NCells.y, grid.AreaSize.y, grid.Wrap, wrapped.y, offset.y))
+                    continue;
+
+                for (int x = tileMin.x - grid.SearchRange.x; x < tileMax.x + grid.SearchRange.x; ++x)
+                {
+                    if (!WrapCell(x, grid.NCells.x, grid.AreaSize.x, grid.Wrap, wrapped.x, offset.x))
+                        continue;
+
+                    unsigned int index = grid.GetIndex(wrapped);
+                    if (grid.Points[index].x != EmptyCell)
+                        active.push_back(ActivePoint3D(grid.Points[index] + offset,
+                                                       grid.VariableRadius ? grid.Radii[index] : sampler.MinRadius));
+                }
+            }
+        }
+
+        //Grow outward from random active points until there aren't any left,
+        //    then try random spots in the tile until a whole round of them fails, like the 2D version.
+        Vector3f tileMinPos((float)tileMin.x * grid.CellSize.x,
+                            (float)tileMin.y * grid.CellSize.y,
+                            (float)tileMin.z * grid.CellSize.z),
+                 tileSizePos((float)(tileMax.x - tileMin.x) * grid.CellSize.x,
+                             (float)(tileMax.y - tileMin.y) * grid.CellSize.y,
+                             (float)(tileMax.z - tileMin.z) * grid.CellSize.z);
+        while (true)
+        {
+            if (active.empty())
+            {
+                for (unsigned int i = 0; i < sampler.NumbCandidates && active.empty(); ++i)
+                {
+                    Vector3f pos = tileMinPos + Vector3f(nextRandom() * tileSizePos.x,
+                                                         nextRandom() * tileSizePos.y,
+                                                         nextRandom() * tileSizePos.z);
+                    tryAdd(pos, grid.VariableRadius ? sampler.GetRadius(pos, grid.AreaSize) : sampler.MinRadius);
+                }
+                if (active.empty())
+                    break;
+            }
+
+            unsigned int activeI = Mathf::Min((unsigned int)(nextRandom() * (float)active.size()),
+                                              (unsigned int)active.size() - 1);
+            ActivePoint3D point = active[activeI];
+            active[activeI] = active.back();
+            active.pop_back();
+
+            //Get a uniformly random rotation (using Ken Shoemake's method for random quaternions)
+            //    and turn it into a rotation matrix.
+            float u1 = nextRandom(),
+                  angle2 = nextRandom() * TwoPi,
+                  angle3 = nextRandom() * TwoPi,
+                  s1 = sqrtf(1.0f - u1),
+                  s2 = sqrtf(u1);
+            float qx = s1 * sinf(angle2), qy = s1 * cosf(angle2),
+                  qz = s2 * sinf(angle3), qw = s2 * cosf(angle3);
+            Vector3f rotX(1.0f - (2.0f * ((qy * qy) + (qz * qz))), 2.0f * ((qx * qy) + (qz * qw)), 2.0f * ((qx * qz) - (qy * qw))),
+                     rotY(2.0f * ((qx * qy) - (qz * qw)), 1.0f - (2.0f * ((qx * qx) + (qz * qz))), 2.0f * ((qy * qz) + (qx * qw))),
+                     rotZ(2.0f * ((qx * qz) + (qy * qw)), 2.0f * ((qy * qz) - (qx * qw)), 1.0f - (2.0f * ((qx * qx) + (qy * qy))));
+
+            for (unsigned int i = 0; i < directions.size(); ++i)
+            {
+                Vector3f dir = (rotX * directions[i].x) + (rotY * directions[i].y) + (rotZ * directions[i].z);
+                Vector3f pos = point.Pos + (dir * (point.Radius * CandidateSpacing));
+
+                float radius = sampler.MinRadius;
+                if (grid.VariableRadius)
+                {
+                    //If the candidate needs more room than this point, push it out to its own radius.
+                    //Its radius changes as it moves, so keep pushing until it settles.
+                    float dist = point.Radius;
+                    radius = sampler.GetRadius(pos, grid.AreaSize);
+                    for (unsigned int j = 0; j < MaxCandidatePushes && radius > dist; ++j)
+                    {
+                        dist = radius;
+                        pos = point.Pos + (dir * (dist * CandidateSpacing));
+                        radius = sampler.GetRadius(pos, grid.AreaSize);
+                    }
+                }
+
+                tryAdd(pos, radius);
+            }
+        }
+    }
+
+
+    //Gathers every point in the given grid of cells, in order, skipping the empty cells.
+    //Splits the cells into chunks that count and then copy their points in parallel.
+    template<typename VectorType>
+    void GatherPoints(const std::vector<VectorType>& cells, unsigned int nThreads, std::vector<VectorType>& outPoints)
+    {
+        nThreads = Mathf::Max(nThreads, (unsigned int)1);
+        ThreadPool& pool = ThreadPool::GetGlobalPool();
+
+        std::vector<unsigned int> chunkCounts(nThreads + 1, 0);
+        pool.RunChunks(cells.size(), nThreads, [&](unsigned int chunk, unsigned int start, unsigned int end)
+        {
+            unsigned int count = 0;
+            for (unsigned int i = start; i < end; ++i)
+                count += (cells[i].x != EmptyCell) ? 1 : 0;
+            chunkCounts[chunk + 1] = count;
+        });
+        for (unsigned int i = 1; i <= nThreads; ++i)
+            chunkCounts[i] += chunkCounts[i - 1];
+
+        outPoints.resize(chunkCounts.back());
+        pool.RunChunks(cells.size(), nThreads, [&](unsigned int chunk, unsigned int start, unsigned int end)
+        {
+            unsigned int outI = chunkCounts[chunk];
+            for (unsigned int i = start; i < end; ++i)
+                if (cells[i].x != EmptyCell)
+                    outPoints[outI++] = cells[i];
+        });
+    }
+}
+
+
+float PoissonDisk2D::GetRadius(Vector2f pos, Vector2f areaSize) const
+{
+    if (Density == nullptr)
+        return MinRadius;
+
+    float density = SampleBilinear(*Density, Vector2f(pos.x * (float)Density->GetWidth() / areaSize.x,
+                                                      pos.y * (float)Density->GetHeight() / areaSize.y));
+    return Mathf::Lerp(MaxRadius, MinRadius, Mathf::Clamp(density, 0.0f, 1.0f));
+}
+void PoissonDisk2D::Generate(Vector2f areaSize, std::vector<Vector2f>& outPoints) const
+{
+    assert(MinRadius > 0.0f && MaxRadius >= MinRadius);
+    assert(areaSize.x > 0.0f && areaSize.y > 0.0f);
+    assert(NumbCandidates > 0);
+
+    //Set up the background grid. Each cell is small enough that it can only hold one point,
+    //    and the cells fit the area exactly so that it can wrap around.
+    SampleGrid2D grid;
+    float maxCellSize = MinRadius * 0.70710678f;
+    grid.NCells = Vector2u((unsigned int)ceilf(areaSize.x / maxCellSize),
+                           (unsigned int)ceilf(areaSize.y / maxCellSize));
+    grid.AreaSize = areaSize;
+    grid.CellSize = Vector2f(areaSize.x / (float)grid.NCells.x, areaSize.y / (float)grid.NCells.y);
+    grid.InvCellSize = Vector2f(1.0f / grid.CellSize.x, 1.0f / grid.CellSize.y);
+    grid.SearchRange = Vector2i((int)ceilf(MaxRadius * grid.InvCellSize.x),
+                                (int)ceilf(MaxRadius * grid.InvCellSize.y));
+    grid.MaxRadius = MaxRadius;
+    grid.Wrap = Wrap;
+    grid.VariableRadius = (Density != nullptr && MaxRadius > MinRadius);
+
+    grid.Points.resize(grid.NCells.x * grid.NCells.y, Vector2f(EmptyCell, EmptyCell));
+    if (grid.VariableRadius)
+        grid.Radii.resize(grid.Points.size());
+
+    //Tiles must be at least as wide as the search range, so that tiles in the same pass never look at each other.
+    std::vector<int> tileStartsX, tileStartsY;
+    GetTiles(grid.NCells.x, Mathf::Max(TileSize, (unsigned int)grid.SearchRange.x), Wrap, tileStartsX);
+    GetTiles(grid.NCells.y, Mathf::Max(TileSize, (unsigned int)grid.SearchRange.y), Wrap, tileStartsY);
+    Vector2u nTiles(tileStartsX.size() - 1, tileStartsY.size() - 1);
+
+    //Evenly space the candidates around a circle.
+    std::vector<Vector2f> directions(NumbCandidates);
+    for (unsigned int i = 0; i < NumbCandidates; ++i)
+    {
+        float angle = TwoPi * (float)i / (float)NumbCandidates;
+        directions[i] = Vector2f(cosf(angle), sinf(angle));
+    }
+
+    //Do the four checkerboard passes of tiles.
+    for (unsigned int pass = 0; pass < 4; ++pass)
+    {
+        std::vector<Vector2i> passTiles;
+        for (unsigned int y = pass / 2; y < nTiles.y; y += 2)
+            for (unsigned int x = pass % 2; x < nTiles.x; x += 2)
+                passTiles.push_back(Vector2i((int)x, (int)y));
+
+        ThreadPool::GetGlobalPool().RunChunks(passTiles.size(), Mathf::Max(NumbThreads, (unsigned int)1),
+                                              [&](unsigned int chunk, unsigned int start, unsigned int end)
+        {
+            for (unsigned int i = start; i < end; ++i)
+            {
+                Vector2i tile = passTiles[i];
+                FillTile(*this, grid, directions, tile,
+                         Vector2i(tileStartsX[tile.x], tileStartsY[tile.y]),
+                         Vector2i(tileStartsX[tile.x + 1], tileStartsY[tile.y + 1]));
+            }
+        });
+    }
+
+    GatherPoints(grid.Points, NumbThreads, outPoints);
+}
+
+
+float PoissonDisk3D::GetRadius(Vector3f pos, Vector3f volumeSize) const
+{
+    if (Density == nullptr)
+        return MinRadius;
+
+    float density = SampleTrilinear(*Density, Vector3f(pos.x * (float)Density->GetWidth() / volumeSize.x,
+                                                       pos.y * (float)Density->GetHeight() / volumeSize.y,
+                                                       pos.z * (float)Density->GetDepth() / volumeSize.z));
+    return Mathf::Lerp(MaxRadius, MinRadius, Mathf::Clamp(density, 0.0f, 1.0f));
+}
+void PoissonDisk3D::Generate(Vector3f volumeSize, std::vector<Vector3f>& outPoints) const
+{
+    assert(MinRadius > 0.0f && MaxRadius >= MinRadius);
+    assert(volumeSize.x > 0.0f && volumeSize.y > 0.0f && volumeSize.z > 0.0f);
+    assert(NumbCandidates > 0);
+
+    //Set up the background grid. Each cell is small enough that it can only hold one point,
+    //    and the cells fit the volume exactly so that it can wrap around.
+    SampleGrid3D grid;
+    float maxCellSize = MinRadius * 0.57735027f;
+    grid.NCells = Vector3u((unsigned int)ceilf(volumeSize.x / maxCellSize),
+                           (unsigned int)ceilf(volumeSize.y / maxCellSize),
+                           (unsigned int)ceilf(volumeSize.z / maxCellSize));
+    grid.AreaSize = volumeSize;
+    grid.CellSize = Vector3f(volumeSize.x / (float)grid.NCells.x,
+                             volumeSize.y / (float)grid.NCells.y,
+                             volumeSize.z / (float)grid.NCells.z);
+    grid.InvCellSize = Vector3f(1.0f / grid.CellSize.x, 1.0f / grid.CellSize.y, 1.0f / grid.CellSize.z);
+    grid.SearchRange = Vector3i((int)ceilf(MaxRadius * grid.InvCellSize.x),
+                                (int)ceilf(MaxRadius * grid.InvCellSize.y),
+                                (int)ceilf(MaxRadius * grid.InvCellSize.z));
+    grid.MaxRadius = MaxRadius;
+    grid.Wrap = Wrap;
+    grid.VariableRadius = (Density != nullptr && MaxRadius > MinRadius);
+
+    grid.Points.resize(grid.NCells.x * grid.NCells.y * grid.NCells.z, Vector3f(EmptyCell, EmptyCell, EmptyCell));
+    if (grid.VariableRadius)
+        grid.Radii.resize(grid.Points.size());
+
+    //Tiles must be at least as wide as the search range, so that tiles in the same pass never look at each other.
+    std::vector<int> tileStartsX, tileStartsY, tileStartsZ;
+    GetTiles(grid.NCells.x, Mathf::Max(TileSize, (unsigned int)grid.SearchRange.x), Wrap, tileStartsX);
+    GetTiles(grid.NCells.y, Mathf::Max(TileSize, (unsigned int)grid.SearchRange.y), Wrap, tileStartsY);
+    GetTiles(grid.NCells.z, Mathf::Max(TileSize, (unsigned int)grid.SearchRange.z), Wrap, tileStartsZ);
+    Vector3u nTiles(tileStartsX.size() - 1, tileStartsY.size() - 1, tileStartsZ.size() - 1);
+
+    //Evenly space the candidates around a sphere using a Fibonacci spiral.
+    std::vector<Vector3f> directions(NumbCandidates);
+    for (unsigned int i = 0; i < NumbCandidates; ++i)
+    {
+        float z = 1.0f - ((2.0f * (float)i + 1.0f) / (float)NumbCandidates),
+              ringRadius = sqrtf(Mathf::Max(0.0f, 1.0f - (z * z))),
+              angle = 2.39996323f * (float)i;
+        directions[i] = Vector3f(ringRadius * cosf(angle), ringRadius * sinf(angle), z);
+    }
+
+    //Do the eight checkerboard passes of tiles.
+    for (unsigned int pass = 0; pass < 8; ++pass)
+    {
+        std::vector<Vector3i> passTiles;
+        for (unsigned int z = pass / 4; z < nTiles.z; z += 2)
+            for (unsigned int y = (pass / 2) % 2; y < nTiles.y; y += 2)
+                for (unsigned int x = pass % 2; x < nTiles.x; x += 2)
+                    passTiles.push_back(Vector3i((int)x, (int)y, (int)z));
+
+        ThreadPool::GetGlobalPool().RunChunks(passTiles.size(), Mathf::Max(NumbThreads, (unsigned int)1),
+                                              [&](unsigned int chunk, unsigned int start, unsigned int end)
+        {
+            for (unsigned int i = start; i < end; ++i)
+            {
+                Vector3i tile = passTiles[i];
+                FillTile(*this, grid, directions, tile,
+                         Vector3i(tileStartsX[tile.x], tileStartsY[tile.y], tileStartsZ[tile.z]),
+                         Vector3i(tileStartsX[tile.x + 1], tileStartsY[tile.y + 1], tileStartsZ[tile.z + 1]));
+            }
+        });
+    }
+
+    GatherPoints(grid.Points, NumbThreads, outPoints);
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <vector>
+#include "BasicGenerators.h"
+
+
+//Scatters points so that no two of them are closer than a minimum distance ("Poisson-disk" sampling),
+//    for placing things like vegetation/props or Worley cell centers.
+//Uses Bridson's algorithm: points are grown outward from existing ones, and a background grid
+//    (with cells small enough to hold at most one point each) makes each distance check only look at nearby cells.
+//Candidates are placed just outside each point's radius at evenly-spaced directions from a random start angle
+//    (Martin Roberts' improvement), which packs points tighter and needs fewer candidates than random spots.
+//If a candidate needs more room than the point it grew from, it's pushed out to its own radius.
+//The radius around each point can vary with an optional density map. Two points are always at least
+//    the larger of their two radii apart.
+//The grid is split into square tiles that are filled in four checkerboard passes, like "HydraulicErosion".
+//Tiles in the same pass are far enough apart that they can't affect each other, so they run in parallel.
+//Each tile first grows outward from the points its neighbors already placed near it, so there are no seams.
+//Then random spots in the tile are tried until a whole round of them fails,
+//    so that gaps growth couldn't reach still get filled.
+//Each tile's random values come from hashing "Seed" and the tile's position,
+//    so the result is exactly the same no matter how many threads are used.
+struct PoissonDisk2D
+{
+public:
+
+    //The distance between points where the density is 1, and where it's 0.
+    float MinRadius, MaxRadius;
+    //If not null, the radius around each point is interpolated from "MaxRadius" to "MinRadius"
+    //    using this map's value (from 0 to 1) at that point. The map is stretched to cover the whole area.
+    //If null, every point uses "MinRadius".
+    const Noise2D* Density;
+
+    //The number of candidate points tried around each point before giving up on it.
+    unsigned int NumbCandidates;
+    int Seed;
+
+    //If true, the area wraps around at its edges, so the points can be tiled seamlessly.
+    bool Wrap;
+
+    //The width/height of each tile, in cells of the background grid (each one is up to "MinRadius / sqrt(2)" wide).
+    //Raised to the number of cells covered by "MaxRadius" if it's smaller than that.
+    unsigned int TileSize;
+    //The number of threads each pass of tiles is split across.
+    unsigned int NumbThreads;
+
+
+    PoissonDisk2D(float radius, int seed = 12345)
+        : MinRadius(radius), MaxRadius(radius), Density(nullptr), NumbCandidates(16), Seed(seed),
+          Wrap(false), TileSize(64), NumbThreads(1) { }
+    PoissonDisk2D(float minRadius, float maxRadius, const Noise2D* density, int seed = 12345)
+        : MinRadius(minRadius), MaxRadius(maxRadius), Density(density), NumbCandidates(16), Seed(seed),
+          Wrap(false), TileSize(64), NumbThreads(1) { }
+
+
+    //Scatters points across the area from {0, 0} to "areaSize" (not including "areaSize" itself).
+    //The points are output in row order of the background grid, so points near each other in the list
+    //    are near each other in space.
+    void Generate(Vector2f areaSize, std::vector<Vector2f>& outPoints) const;
+
+    //Gets the radius around a point at the given position in an area of the given size.
+    float GetRadius(Vector2f pos, Vector2f areaSize) const;
+};
+
+
+//Scatters points so that no two of them are closer than a minimum distance ("Poisson-disk" sampling).
+//Works exactly like "PoissonDisk2D", but in a volume.
+//Candidates are placed at a fixed set of evenly-spaced directions that get a random rotation for each point.
+//The tiles are filled in eight passes, like the eight colors of a 2x2x2 checkerboard.
+struct PoissonDisk3D
+{
+public:
+
+    //The distance between points where the density is 1, and where it's 0.
+    float MinRadius, MaxRadius;
+    //If not null, the radius around each point is interpolated from "MaxRadius" to "MinRadius"
+    //    using this map's value (from 0 to 1) at that point. The map is stretched to cover the whole volume.
+    //If null, every point uses "MinRadius".
+    const Noise3D* Density;
+
+    //The number of candidate points tried around each point before giving up on it.
+    unsigned int NumbCandidates;
+    int Seed;
+
+    //If true, the volume wraps around at its edges, so the points can be tiled seamlessly.
+    bool Wrap;
+
+    //The width/height/depth of each tile, in cells of the background grid
+    //    (each one is up to "MinRadius / sqrt(3)" wide).
+    //Raised to the number of cells covered by "MaxRadius" if it's smaller than that.
+    unsigned int TileSize;
+    //The number of threads each pass of tiles is split across.
+    unsigned int NumbThreads;
+
+
+    PoissonDisk3D(float radius, int seed = 12345)
+        : MinRadius(radius), MaxRadius(radius), Density(nullptr), NumbCandidates(24), Seed(seed),
+          Wrap(false), TileSize(24), NumbThreads(1) { }
+    PoissonDisk3D(float minRadius, float maxRadius, const Noise3D* density, int seed = 12345)
+        : MinRadius(minRadius), MaxRadius(maxRadius), Density(density), NumbCandidates(24), Seed(seed),
+          Wrap(false), TileSize(24), NumbThreads(1) { }
+
+
+    //Scatters points across the volume from {0, 0, 0} to "volumeSize" (not including "volumeSize" itself).
+    //The points are output in row order of the background grid, so points near each other in the list
+    //    are near each other in space.
+    void Generate(Vector3f volumeSize, std::vector<Vector3f>& outPoints) const;
+
+    //Gets the radius around a point at the given position in a volume of the given size.
+    float GetRadius(Vector3f pos, Vector3f volumeSize) const;
+};
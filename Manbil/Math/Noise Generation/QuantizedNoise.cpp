@@ -0,0 +1,214 @@
+#include "QuantizedNoise.h"
+
+
+namespace
+{
+    void Convert(const float* values, unsigned short* outValues, unsigned int nValues)
+    {
+        QuantizedNoise::ToUNorm16(values, outValues, nValues);
+    }
+    void Convert(const float* values, HalfFloat* outValues, unsigned int nValues)
+    {
+        QuantizedNoise::ToHalf(values, outValues, nValues);
+    }
+    void Convert(const unsigned short* values, float* outValues, unsigned int nValues)
+    {
+        QuantizedNoise::FromUNorm16(values, outValues, nValues);
+    }
+    void Convert(const HalfFloat* values, float* outValues, unsigned int nValues)
+    {
+        QuantizedNoise::FromHalf(values, outValues, nValues);
+    }
+
+    template<typename InType, typename OutType>
+    //Converts the given values in "nThreads" chunks, which run in parallel.
+    void ConvertInChunks(const InType* values, OutType* outValues, unsigned int nValues, unsigned int nThreads)
+    {
+        ThreadPool::GetGlobalPool().RunChunks(nValues, Mathf::Max(nThreads, (unsigned int)1),
+                                              [values, outValues](unsigned int chunk, unsigned int start, unsigned int end)
+        {
+            Convert(values + start, outValues + start, end - start);
+        });
+    }
+
+    template<typename InType, typename OutType>
+    //Converts the given rows of values in "nThreads" chunks, which run in parallel.
+    //Each input/output row starts "inPitch"/"outPitch" values after the one before it,
+    //    so arrays with row padding can be converted.
+    void ConvertRows(const InType* values, unsigned int inPitch, OutType* outValues, unsigned int outPitch,
+                     unsigned int rowLength, unsigned int nRows, unsigned int nThreads)
+    {
+        //Without any padding, the rows are just one long line of values.
+        if (inPitch == rowLength && outPitch == rowLength)
+        {
+            ConvertInChunks(values, outValues, rowLength * nRows, nThreads);
+            return;
+        }
+
+        ThreadPool::GetGlobalPool().RunChunks(nRows, Mathf::Max(nThreads, (unsigned int)1),
+                                              [=](unsigned int chunk, unsigned int start, unsigned int end)
+        {
+            for (unsigned int row = start; row < end; ++row)
+                Convert(values + ((size_t)row * inPitch), outValues + ((size_t)row * outPitch), rowLength);
+        });
+    }
+
+    template<typename InType, typename OutType>
+    void ConvertArray(const Array2D<InType>& inArray, Array2D<OutType>& outArray, unsigned int nThreads)
+    {
+        outArray.Reset(inArray.GetWidth(), inArray.GetHeight());
+        ConvertRows(inArray.GetArray(), inArray.GetRowPitch(), outArray.GetArray(), outArray.GetRowPitch(),
+                    inArray.GetWidth(), inArray.GetHeight(), nThreads);
+    }
+    template<typename InType, typename OutType>
+    void ConvertArray(const Array3D<InType>& inArray, Array3D<OutType>& outArray, unsigned int nThreads)
+    {
+        outArray.Reset(inArray.GetWidth(), inArray.GetHeight(), inArray.GetDepth());
+        ConvertRows(inArray.GetArray(), inArray.GetRowPitch(), outArray.GetArray(), outArray.GetRowPitch(),
+                    inArray.GetWidth(), inArray.GetHeight() * inArray.GetDepth(), nThreads);
+    }
+
+
+    template<typename OutType>
+    void GenerateCompact(const Generator2D& gen, Array2D<OutType>& outNoise)
+    {
+        if (!gen.CanSample())
+        {
+            Noise2D noise(outNoise.GetWidth(), outNoise.GetHeight());
+            gen.Generate(noise);
+            ConvertArray(noise, outNoise, gen.NumbThreads);
+            return;
+        }
+
+        unsigned int width = outNoise.GetWidth();
+        ThreadPool::GetGlobalPool().RunChunks(outNoise.GetHeight(), Mathf::Max(gen.NumbThreads, (unsigned int)1),
+                                              [&](unsigned int band, unsigned int startY, unsigned int endY)
+        {
+            std::vector<Vector2f> positions(width);
+            std::vector<float> values(width);
+            for (unsigned int y = startY; y < endY; ++y)
+            {
+                for (unsigned int x = 0; x < width; ++x)
+                    positions[x] = Vector2f((float)x, (float)y);
+                gen.SampleMany(positions.data(), values.data(), width);
+                Convert(values.data(), &outNoise[Vector2u(0, y)], width);
+            }
+        });
+    }
+    template<typename OutType>
+    void GenerateCompact(const Generator3D& gen, Array3D<OutType>& outNoise, unsigned int slabDepth)
+    {
+        if (!gen.CanGenerateSlab())
+        {
+            Noise3D noise(outNoise.GetWidth(), outNoise.GetHeight(), outNoise.GetDepth());
+            gen.Generate(noise);
+            ConvertArray(noise, outNoise, gen.NumbThreads);
+            return;
+        }
+
+        gen.GenerateSlabs(outNoise.GetDimensions(), slabDepth, [&gen, &outNoise](const Noise3D& slab, unsigned int startZ)
+        {
+            ConvertRows(slab.GetArray(), slab.GetRowPitch(), &outNoise[Vector3u(0, 0, startZ)], outNoise.GetRowPitch(),
+                        slab.GetWidth(), slab.GetHeight() * slab.GetDepth(), gen.NumbThreads);
+        });
+    }
+}
+
+
+void QuantizedNoise::ToUNorm16(const float* values, unsigned short* outValues, unsigned int nValues)
+{
+    //The scalar version clamps with the same comparisons as the SIMD min/max,
+    //    so NaN becomes 0 either way.
+    unsigned int i = 0;
+    int packed[SIMDInts::Width];
+    for (; i + SIMDFloats::Width <= nValues; i += SIMDFloats::Width)
+    {
+        SIMDFloats clamped = SIMDFloats::Min(SIMDFloats::Max(SIMDFloats::Load(values + i), SIMDFloats(0.0f)),
+                                             SIMDFloats(1.0f));
+        ((clamped * SIMDFloats(65535.0f)) + SIMDFloats(0.5f)).Truncate().Store(packed);
+        for (unsigned int j = 0; j < SIMDInts::Width; ++j)
+            outValues[i + j] = (unsigned short)packed[j];
+    }
+    for (; i < nValues; ++i)
+    {
+        float clamped = (values[i] > 0.0f) ? values[i] : 0.0f;
+        clamped = (clamped < 1.0f) ? clamped : 1.0f;
+        outValues[i] = (unsigned short)(int)((clamped * 65535.0f) + 0.5f);
+    }
+}
+void QuantizedNoise::ToHalf(const float* values, HalfFloat* outValues, unsigned int nValues)
+{
+    unsigned int i = 0;
+    int packed[SIMDInts::Width];
+    for (; i + SIMDFloats::Width <= nValues; i += SIMDFloats::Width)
+    {
+        HalfFloat::ToBits(SIMDFloats::Load(values + i)).Store(packed);
+        for (unsigned int j = 0; j < SIMDInts::Width; ++j)
+            outValues[i + j].Bits = (unsigned short)packed[j];
+    }
+    for (; i < nValues; ++i)
+        outValues[i].Bits = HalfFloat::ToBits(values[i]);
+}
+
+void QuantizedNoise::FromUNorm16(const unsigned short* values, float* outValues, unsigned int nValues)
+{
+    for (unsigned int i = 0; i < nValues; ++i)
+        outValues[i] = (float)values[i] * (1.0f / 65535.0f);
+}
+void QuantizedNoise::FromHalf(const HalfFloat* values, float* outValues, unsigned int nValues)
+{
+    for (unsigned int i = 0; i < nValues; ++i)
+        outValues[i] = values[i].ToFloat();
+}
+
+
+void QuantizedNoise::Quantize(const Noise2D& noise, Noise2D_16U& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+void QuantizedNoise::Quantize(const Noise2D& noise, Noise2D_16F& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+void QuantizedNoise::Quantize(const Noise3D& noise, Noise3D_16U& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+void QuantizedNoise::Quantize(const Noise3D& noise, Noise3D_16F& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+
+void QuantizedNoise::Dequantize(const Noise2D_16U& noise, Noise2D& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+void QuantizedNoise::Dequantize(const Noise2D_16F& noise, Noise2D& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+void QuantizedNoise::Dequantize(const Noise3D_16U& noise, Noise3D& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+void QuantizedNoise::Dequantize(const Noise3D_16F& noise, Noise3D& outNoise, unsigned int nThreads)
+{
+    ConvertArray(noise, outNoise, nThreads);
+}
+
+void QuantizedNoise::Generate(const Generator2D& gen, Noise2D_16U& outNoise)
+{
+    GenerateCompact(gen, outNoise);
+}
+void QuantizedNoise::Generate(const Generator2D& gen, Noise2D_16F& outNoise)
+{
+    GenerateCompact(gen, outNoise);
+}
+void QuantizedNoise::Generate(const Generator3D& gen, Noise3D_16U& outNoise, unsigned int slabDepth)
+{
+    GenerateCompact(gen, outNoise, slabDepth);
+}
+void QuantizedNoise::Generate(const Generator3D& gen, Noise3D_16F& outNoise, unsigned int slabDepth)
+{
+    GenerateCompact(gen, outNoise, slabDepth);
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include "BasicGenerators.h"
+#include "../Lower Math/HalfFloat.h"
+
+
+//Noise stored as 16-bit unsigned ints, with the range [0, 1] mapped to [0, 65535].
+//Takes half the memory of "Noise2D"/"Noise3D",
+//    and can be given straight to a greyscale texture with the "PS_16U_GREYSCALE" pixel size.
+typedef Array2D<unsigned short> Noise2D_16U;
+typedef Array3D<unsigned short> Noise3D_16U;
+
+//Noise stored as half-floats.
+//Takes half the memory of "Noise2D"/"Noise3D" and isn't limited to the range [0, 1],
+//    and can be given straight to a greyscale texture with the "PS_16F_GREYSCALE" pixel size.
+typedef Array2D<HalfFloat> Noise2D_16F;
+typedef Array3D<HalfFloat> Noise3D_16F;
+
+
+//Converting noise to and from the compact 16-bit formats.
+//The conversions use SIMD and give exactly the same values as converting one value at a time.
+namespace QuantizedNoise
+{
+    //Converts the given values to 16-bit unsigned ints, rounding to the nearest one.
+    //Values outside the range [0, 1] are clamped.
+    void ToUNorm16(const float* values, unsigned short* outValues, unsigned int nValues);
+    //Converts the given values to half-floats, rounding to the nearest one.
+    void ToHalf(const float* values, HalfFloat* outValues, unsigned int nValues);
+
+    void FromUNorm16(const unsigned short* values, float* outValues, unsigned int nValues);
+    void FromHalf(const HalfFloat* values, float* outValues, unsigned int nValues);
+
+
+    //Converts the given noise into the given compact array, which is resized to fit.
+    //The noise is split into "nThreads" chunks, which are converted in parallel.
+    void Quantize(const Noise2D& noise, Noise2D_16U& outNoise, unsigned int nThreads = 1);
+    void Quantize(const Noise2D& noise, Noise2D_16F& outNoise, unsigned int nThreads = 1);
+    void Quantize(const Noise3D& noise, Noise3D_16U& outNoise, unsigned int nThreads = 1);
+    void Quantize(const Noise3D& noise, Noise3D_16F& outNoise, unsigned int nThreads = 1);
+
+    //Converts the given compact noise back into floats. The noise array is resized to fit.
+    //The noise is split into "nThreads" chunks, which are converted in parallel.
+    void Dequantize(const Noise2D_16U& noise, Noise2D& outNoise, unsigned int nThreads = 1);
+    void Dequantize(const Noise2D_16F& noise, Noise2D& outNoise, unsigned int nThreads = 1);
+    void Dequantize(const Noise3D_16U& noise, Noise3D& outNoise, unsigned int nThreads = 1);
+    void Dequantize(const Noise3D_16F& noise, Noise3D& outNoise, unsigned int nThreads = 1);
+
+
+    //Generates noise straight into the given compact array, at its current size.
+    //If the generator can sample ("CanSample"), each band of rows is sampled and converted one row at a time,
+    //    so the full-size float noise never exists.
+    //Otherwise, the noise has to be generated as floats first and then converted.
+    //The rows are split into "gen.NumbThreads" bands, which run in parallel.
+    void Generate(const Generator2D& gen, Noise2D_16U& outNoise);
+    void Generate(const Generator2D& gen, Noise2D_16F& outNoise);
+
+    //Generates noise straight into the given compact array, at its current size.
+    //If the generator can generate slabs ("CanGenerateSlab"), the volume is generated
+    //    "slabDepth" Z slices at a time and each slab is converted before the next one is generated,
+    //    so the full-size float noise never exists.
+    //Otherwise, the noise has to be generated as floats first and then converted.
+    //Each slab is converted in "gen.NumbThreads" parallel chunks.
+    void Generate(const Generator3D& gen, Noise3D_16U& outNoise, unsigned int slabDepth = 16);
+    void Generate(const Generator3D& gen, Noise3D_16F& outNoise, unsigned int slabDepth = 16);
+}
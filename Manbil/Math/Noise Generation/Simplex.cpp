@@ -0,0 +1,709 @@
+#include "Simplex.h"
+
+#include <vector>
+#include "NoiseFilterer.h"
+#include "../Lower Math/SIMD.h"
+
+
+namespace
+{
+    //The gradients for 3D simplex noise: the midpoints of a cube's 12 edges.
+    const unsigned int nGradients3D = 12;
+    const float gradientTable3D[nGradients3D][3] =
+    {
+        { 1, 1, 0 }, { -1, 1, 0 }, { 1, -1, 0 }, { -1, -1, 0 },
+        { 1, 0, 1 }, { -1, 0, 1 }, { 1, 0, -1 }, { -1, 0, -1 },
+        { 0, 1, 1 }, { 0, -1, 1 }, { 0, 1, -1 }, { 0, -1, -1 },
+    };
+    //The gradients for 4D simplex noise: the midpoints of a tesseract's 32 edges.
+    const unsigned int nGradients4D = 32;
+    const float gradientTable4D[nGradients4D][4] =
+    {
+        { 0, 1, 1, 1 }, { 0, 1, 1, -1 }, { 0, 1, -1, 1 }, { 0, 1, -1, -1 },
+        { 0, -1, 1, 1 }, { 0, -1, 1, -1 }, { 0, -1, -1, 1 }, { 0, -1, -1, -1 },
+        { 1, 0, 1, 1 }, { 1, 0, 1, -1 }, { 1, 0, -1, 1 }, { 1, 0, -1, -1 },
+        { -1, 0, 1, 1 }, { -1, 0, 1, -1 }, { -1, 0, -1, 1 }, { -1, 0, -1, -1 },
+        { 1, 1, 0, 1 }, { 1, 1, 0, -1 }, { 1, -1, 0, 1 }, { 1, -1, 0, -1 },
+        { -1, 1, 0, 1 }, { -1, 1, 0, -1 }, { -1, -1, 0, 1 }, { -1, -1, 0, -1 },
+        { 1, 1, 1, 0 }, { 1, 1, -1, 0 }, { 1, -1, 1, 0 }, { 1, -1, -1, 0 },
+        { -1, 1, 1, 0 }, { -1, 1, -1, 0 }, { -1, -1, 1, 0 }, { -1, -1, -1, 0 },
+    };
+
+
+    //Wraps the given grid coordinate into the range [0, wrapInterval).
+    //Just using "%" would turn a negative coordinate into an unsigned int first, which wraps it to the wrong spot.
+    //Intervals too big for an int (e.x. the default, the max unsigned int) leave the coordinate alone.
+    int WrapGridPos(int pos, unsigned int wrapInterval)
+    {
+        if (wrapInterval > (unsigned int)std::numeric_limits<int>::max())
+            return pos;
+
+        int wrapped = pos % (int)wrapInterval;
+        return (wrapped < 0) ? (wrapped + (int)wrapInterval) : wrapped;
+    }
+
+
+    //The constants for each dimension of simplex noise.
+    //Based on Stefan Gustavson's "Simplex noise demystified".
+    struct Simplex3DInfo
+    {
+        static const unsigned int NDims = 3;
+
+        static float Skew(void) { return 1.0f / 3.0f; }
+        static float Unskew(void) { return 1.0f / 6.0f; }
+        //The squared distance from a corner at which its contribution fades to nothing.
+        //Any bigger, and the contribution doesn't reach 0 before the position leaves
+        //    the simplices around that corner, so the noise (and its gradient) jumps.
+        static float FalloffRadiusSq(void) { return 0.5f; }
+        //Scales the sum of the corners' contributions to roughly fit between -1 and 1.
+        static float OutputScale(void) { return 75.0f; }
+
+        //Gets the gradient table. Each gradient is "NDims" floats.
+        static const float* GetGradients(void) { return &gradientTable3D[0][0]; }
+        //Gets the index of the gradient at the given grid point by hashing its (wrapped) coordinate.
+        static unsigned int GetGradientIndex(const int* gridPos, const unsigned int* wrapInterval, int seed)
+        {
+            Vector3i pos(gridPos[0], gridPos[1], gridPos[2]);
+            pos.x = WrapGridPos(pos.x, wrapInterval[0]);
+            pos.y = WrapGridPos(pos.y, wrapInterval[1]);
+            pos.z = WrapGridPos(pos.z, wrapInterval[2]);
+
+            FastRand fr(pos.GetHashCode() + seed);
+            return Mathf::Abs(fr.GetRandInt()) % nGradients3D;
+        }
+    };
+    struct Simplex4DInfo
+    {
+        static const unsigned int NDims = 4;
+
+        static float Skew(void) { return 0.309016994f; } //(sqrt(5) - 1) / 4
+        static float Unskew(void) { return 0.138196601f; } //(5 - sqrt(5)) / 20
+        //The squared distance from a corner at which its contribution fades to nothing.
+        //See "Simplex3DInfo::FalloffRadiusSq".
+        static float FalloffRadiusSq(void) { return 0.5f; }
+        //Scales the sum of the corners' contributions to roughly fit between -1 and 1.
+        static float OutputScale(void) { return 62.0f; }
+
+        //Gets the gradient table. Each gradient is "NDims" floats.
+        static const float* GetGradients(void) { return &gradientTable4D[0][0]; }
+        //Gets the index of the gradient at the given grid point by hashing its (wrapped) coordinate.
+        static unsigned int GetGradientIndex(const int* gridPos, const unsigned int* wrapInterval, int seed)
+        {
+            Vector4i pos(gridPos[0], gridPos[1], gridPos[2], gridPos[3]);
+            pos.x = WrapGridPos(pos.x, wrapInterval[0]);
+            pos.y = WrapGridPos(pos.y, wrapInterval[1]);
+            pos.z = WrapGridPos(pos.z, wrapInterval[2]);
+            pos.w = WrapGridPos(pos.w, wrapInterval[3]);
+
+            FastRand fr(pos.GetHashCode() + seed);
+            return Mathf::Abs(fr.GetRandInt()) % nGradients4D;
+        }
+    };
+
+
+    //Hashing every corner of every simplex is slower than the rest of the noise calculation,
+    //    so the gradient indices for the block of grid points a batch of positions touches are computed up-front.
+    //If that block would be much bigger than the batch (e.x. very sparse samples),
+    //    the indices are just hashed as they're needed instead.
+    //Either way the gradients are identical, so "Generate" and "SampleMany" always give the same values.
+    template<typename Info>
+    struct GradientGrid
+    {
+        static const unsigned int NDims = Info::NDims;
+
+        unsigned int WrapInterval[NDims];
+        int Seed;
+
+        bool UseGrid;
+        int MinCell[NDims], Size[NDims];
+        std::vector<unsigned char> Indices;
+
+
+        //Prepares the gradients for grid positions between the given min and max.
+        GradientGrid(const float* minPos, const float* maxPos, unsigned int nPositions,
+                     const unsigned int* wrapInterval, int seed)
+            : Seed(seed), UseGrid(false)
+        {
+            //The skewed cell of a position is "floor(pos + (sum(pos) * skew))",
+            //    which only goes up as each component goes up.
+            //Each simplex also touches the cell's corners 1 unit further along each axis,
+            //    and an extra unit of padding guards against rounding.
+            float minSkew = minPos[0],
+                  maxSkew = maxPos[0];
+            for (unsigned int i = 1; i < NDims; ++i)
+            {
+                minSkew += minPos[i];
+                maxSkew += maxPos[i];
+            }
+            minSkew *= Info::Skew();
+            maxSkew *= Info::Skew();
+
+            long long nGridPoints = 1;
+            for (unsigned int i = 0; i < NDims; ++i)
+            {
+                WrapInterval[i] = wrapInterval[i];
+                MinCell[i] = (int)floorf(minPos[i] + minSkew) - 1;
+                Size[i] = (int)floorf(maxPos[i] + maxSkew) + 3 - MinCell[i];
+                nGridPoints *= (long long)Size[i];
+            }
+
+            UseGrid = (nPositions > 0 && nGridPoints <= 4 * (long long)nPositions);
+            if (UseGrid)
+            {
+                Indices.resize((unsigned int)nGridPoints);
+
+                int gridPos[NDims];
+                for (unsigned int i = 0; i < Indices.size(); ++i)
+                {
+                    unsigned int left = i;
+                    for (unsigned int axis = 0; axis < NDims; ++axis)
+                    {
+                        gridPos[axis] = MinCell[axis] + (int)(left % Size[axis]);
+                        left /= Size[axis];
+                    }
+                    Indices[i] = (unsigned char)Info::GetGradientIndex(gridPos, WrapInterval, Seed);
+                }
+            }
+        }
+
+        unsigned int GetIndex(const int* gridPos) const
+        {
+            if (UseGrid)
+            {
+                int index = 0;
+                for (int axis = NDims - 1; axis >= 0; --axis)
+                    index = (gridPos[axis] - MinCell[axis]) + (Size[axis] * index);
+                return Indices[index];
+            }
+            return Info::GetGradientIndex(gridPos, WrapInterval, Seed);
+        }
+        //Gets the gradient index for each element of the given grid positions.
+        void GetIndices(const SIMDInts* gridPos, int* outIndices) const
+        {
+            const unsigned int Width = SIMDInts::Width;
+
+            if (UseGrid)
+            {
+                SIMDInts index(0);
+                for (int axis = NDims - 1; axis >= 0; --axis)
+                    index = (gridPos[axis] - SIMDInts(MinCell[axis])) + (SIMDInts(Size[axis]) * index);
+                index.Store(outIndices);
+                for (unsigned int lane = 0; lane < Width; ++lane)
+                    outIndices[lane] = Indices[outIndices[lane]];
+            }
+            else
+            {
+                int lanePos[NDims][Width];
+                for (unsigned int axis = 0; axis < NDims; ++axis)
+                    gridPos[axis].Store(lanePos[axis]);
+                for (unsigned int lane = 0; lane < Width; ++lane)
+                {
+                    int pos[NDims];
+                    for (unsigned int axis = 0; axis < NDims; ++axis)
+                        pos[axis] = lanePos[axis][lane];
+                    outIndices[lane] = (int)Info::GetGradientIndex(pos, WrapInterval, Seed);
+                }
+            }
+        }
+    };
+
+
+    //Rounds the given value down to an int, the same way as "SIMDFloats::Floor".
+    //Faster than "floorf", which usually isn't inlined.
+    inline int FloorToInt(float f)
+    {
+        int truncated = (int)f;
+        return (f < (float)truncated) ? (truncated - 1) : truncated;
+    }
+
+    //Computes simplex noise at the given grid position.
+    //If "outGradient" isn't 0, it's filled with the gradient of the noise along each grid axis.
+    template<typename Info>
+    float GetSimplex(const float* pos, const GradientGrid<Info>& gradients, float* outGradient = 0)
+    {
+        const unsigned int NDims = Info::NDims;
+
+        //Find which skewed grid cell the position is in.
+        float s = pos[0];
+        for (unsigned int i = 1; i < NDims; ++i)
+            s += pos[i];
+        s *= Info::Skew();
+
+        int cell[NDims];
+        int cellSum = 0;
+        for (unsigned int i = 0; i < NDims; ++i)
+        {
+            cell[i] = FloorToInt(pos[i] + s);
+            cellSum += cell[i];
+        }
+        float t = (float)cellSum * Info::Unskew();
+
+        //Get the position relative to the cell's first corner.
+        float rel0[NDims];
+        for (unsigned int i = 0; i < NDims; ++i)
+            rel0[i] = pos[i] - ((float)cell[i] - t);
+
+        //Rank the axes by how far along them the position is.
+        //This determines which of the cell's simplices the position is in:
+        //    the simplex's corners step along the axes from the largest rank to the smallest.
+        int ranks[NDims];
+        for (unsigned int i = 0; i < NDims; ++i)
+            ranks[i] = 0;
+        for (unsigned int i = 0; i < NDims; ++i)
+            for (unsigned int j = i + 1; j < NDims; ++j)
+                if (rel0[i] > rel0[j])
+                    ranks[i] += 1;
+                else
+                    ranks[j] += 1;
+
+        //Add up the contribution from each corner.
+        //The first corner is the cell's min corner, and the last is its max corner.
+        float total = 0.0f;
+        if (outGradient != 0)
+            for (unsigned int i = 0; i < NDims; ++i)
+                outGradient[i] = 0.0f;
+        for (unsigned int corner = 0; corner <= NDims; ++corner)
+        {
+            float cornerUnskew = (float)corner * Info::Unskew();
+
+            int cornerPos[NDims];
+            float rel[NDims];
+            float falloff = Info::FalloffRadiusSq();
+            for (unsigned int i = 0; i < NDims; ++i)
+            {
+                int offset = (ranks[i] > (int)NDims - 1 - (int)corner) ? 1 : 0;
+                cornerPos[i] = cell[i] + offset;
+                rel[i] = rel0[i] - (float)offset + cornerUnskew;
+                falloff -= rel[i] * rel[i];
+            }
+
+            const float* gradient = Info::GetGradients() + (NDims * gradients.GetIndex(cornerPos));
+            float dot = gradient[0] * rel[0];
+            for (unsigned int i = 1; i < NDims; ++i)
+                dot += gradient[i] * rel[i];
+
+            falloff = Mathf::Max(0.0f, falloff);
+            float falloff2 = falloff * falloff;
+            total += falloff2 * falloff2 * dot;
+
+            //The contribution is "falloff^4 * dot", where "falloff = FalloffRadiusSq - |rel|^2" and "dot = gradient . rel".
+            //The offset from the position to "rel" is constant within the simplex,
+            //    so the contribution's gradient is "falloff^4 * gradient - 8 * falloff^3 * dot * rel".
+            if (outGradient != 0)
+            {
+                float falloff4 = falloff2 * falloff2,
+                      relScale = -8.0f * falloff2 * falloff * dot;
+                for (unsigned int i = 0; i < NDims; ++i)
+                    outGradient[i] += (falloff4 * gradient[i]) + (relScale * rel[i]);
+            }
+        }
+
+        if (outGradient != 0)
+            for (unsigned int i = 0; i < NDims; ++i)
+                outGradient[i] *= Info::OutputScale();
+        return total * Info::OutputScale();
+    }
+
+    //Computes simplex noise at many grid positions.
+    //"coords[i]" is the array of each position's "i"th component.
+    //Does the same operations in the same order as "GetSimplex", so the results are identical.
+    template<typename Info>
+    void GetSimplexMany(const float* const* coords, float* outValues, unsigned int nPositions,
+                        const GradientGrid<Info>& gradients)
+    {
+        const unsigned int NDims = Info::NDims,
+                           Width = SIMDFloats::Width;
+
+        unsigned int i = 0;
+        for (; i + Width <= nPositions; i += Width)
+        {
+            SIMDFloats pos[NDims];
+            for (unsigned int axis = 0; axis < NDims; ++axis)
+                pos[axis] = SIMDFloats::Load(coords[axis] + i);
+
+            //Find which skewed grid cell each position is in.
+            SIMDFloats s = pos[0];
+            for (unsigned int axis = 1; axis < NDims; ++axis)
+                s = s + pos[axis];
+            s = s * SIMDFloats(Info::Skew());
+
+            SIMDInts cell[NDims];
+            SIMDInts cellSum(0);
+            for (unsigned int axis = 0; axis < NDims; ++axis)
+            {
+                cell[axis] = (pos[axis] + s).Floor();
+                cellSum = cellSum + cell[axis];
+            }
+            SIMDFloats t = cellSum.ToFloats() * SIMDFloats(Info::Unskew());
+
+            SIMDFloats rel0[NDims];
+            for (unsigned int axis = 0; axis < NDims; ++axis)
+                rel0[axis] = pos[axis] - (cell[axis].ToFloats() - t);
+
+            //A comparison gives -1 for "true" and 0 for "false".
+            SIMDInts ranks[NDims];
+            for (unsigned int axis = 0; axis < NDims; ++axis)
+                ranks[axis] = SIMDInts(0);
+            for (unsigned int a = 0; a < NDims; ++a)
+            {
+                for (unsigned int b = a + 1; b < NDims; ++b)
+                {
+                    SIMDInts aIsBigger = rel0[a].GreaterThan(rel0[b]);
+                    ranks[a] = ranks[a] - aIsBigger;
+                    ranks[b] = ranks[b] + (aIsBigger + SIMDInts(1));
+                }
+            }
+
+            SIMDFloats total(0.0f);
+            for (unsigned int corner = 0; corner <= NDims; ++corner)
+            {
+                SIMDFloats cornerUnskew((float)corner * Info::Unskew());
+
+                SIMDInts cornerPos[NDims];
+                SIMDFloats rel[NDims];
+                SIMDFloats falloff(Info::FalloffRadiusSq());
+                for (unsigned int axis = 0; axis < NDims; ++axis)
+                {
+                    SIMDInts offset = SIMDInts(0) - ranks[axis].GreaterThan(SIMDInts((int)NDims - 1 - (int)corner));
+                    cornerPos[axis] = cell[axis] + offset;
+                    rel[axis] = rel0[axis] - offset.ToFloats() + cornerUnskew;
+                    falloff = falloff - (rel[axis] * rel[axis]);
+                }
+
+                int gradientIndices[Width];
+                gradients.GetIndices(cornerPos, gradientIndices);
+                SIMDFloats dot = SIMDFloats::Gather(Info::GetGradients(), gradientIndices, NDims) * rel[0];
+                for (unsigned int axis = 1; axis < NDims; ++axis)
+                    dot = dot + (SIMDFloats::Gather(Info::GetGradients() + axis, gradientIndices, NDims) * rel[axis]);
+
+                falloff = SIMDFloats::Max(falloff, SIMDFloats(0.0f));
+                falloff = falloff * falloff;
+                total = total + (falloff * falloff * dot);
+            }
+            (total * SIMDFloats(Info::OutputScale())).Store(outValues + i);
+        }
+
+        //Do the rest of the positions one at a time.
+        for (; i < nPositions; ++i)
+        {
+            float pos[NDims];
+            for (unsigned int axis = 0; axis < NDims; ++axis)
+                pos[axis] = coords[axis][i];
+            outValues[i] = GetSimplex(pos, gradients);
+        }
+    }
+
+
+    //Fills the given array one row at a time, then remaps it if requested.
+    //"gridPosX[x]" is the X grid position of each column.
+    //"GetRowGridPos" gets the rest of the grid position for a row, and has the signature
+    //    "void GetRowGridPos(unsigned int y, unsigned int z, float* outGridPos)".
+    template<typename Info, typename GetRowGridPos>
+    void GenerateSimplex(Array3D<float>& outNoise, bool remapValues, unsigned int nSlabs,
+                         const GradientGrid<Info>& gradients, const std::vector<float>& gridPosX,
+                         GetRowGridPos getRowGridPos)
+    {
+        const unsigned int NDims = Info::NDims;
+
+        //Keep track of the min/max of each slab in case the noise should be normalized.
+        std::vector<NoiseAnalysis3D::MinMax> slabMinMaxes(nSlabs);
+
+        ThreadPool::GetGlobalPool().RunChunks(outNoise.GetDepth(), nSlabs,
+                                              [&](unsigned int slab, unsigned int startZ, unsigned int endZ)
+        {
+            float min = slabMinMaxes[slab].Min,
+                  max = slabMinMaxes[slab].Max;
+
+            //Every position in a row has the same grid position along every axis but X.
+            std::vector<float> rowGridPos[NDims - 1];
+            const float* rowCoords[NDims];
+            rowCoords[0] = gridPosX.data();
+            for (unsigned int axis = 1; axis < NDims; ++axis)
+            {
+                rowGridPos[axis - 1].resize(outNoise.GetWidth());
+                rowCoords[axis] = rowGridPos[axis - 1].data();
+            }
+
+            for (Vector3u loc(0, 0, startZ); loc.z < endZ; ++loc.z)
+            {
+                for (loc.y = 0; loc.y < outNoise.GetHeight(); ++loc.y)
+                {
+                    float rowPos[NDims - 1];
+                    getRowGridPos(loc.y, loc.z, rowPos);
+                    for (unsigned int axis = 1; axis < NDims; ++axis)
+                        std::fill(rowGridPos[axis - 1].begin(), rowGridPos[axis - 1].end(), rowPos[axis - 1]);
+
+                    float* row = &outNoise[loc];
+                    GetSimplexMany(rowCoords, row, outNoise.GetWidth(), gradients);
+
+                    for (unsigned int x = 0; x < outNoise.GetWidth(); ++x)
+                    {
+                        min = Mathf::Min(row[x], min);
+                        max = Mathf::Max(row[x], max);
+                    }
+                }
+            }
+
+            slabMinMaxes[slab] = NoiseAnalysis3D::MinMax(min, max);
+        });
+
+        if (remapValues)
+        {
+            NoiseAnalysis3D::MinMax minMax = NoiseAnalysis3D::MinMax::Combine(slabMinMaxes);
+
+            NoiseFilterer3D nf;
+            MaxFilterVolume mfv;
+            nf.FillVolume = &mfv;
+            nf.RemapValues_OldVals = Interval(minMax.Min, minMax.Max, 0.00001f);
+            nf.RemapValues(&outNoise);
+        }
+    }
+
+    //Samples simplex noise at the given positions.
+    //"GetGridPos" converts a position to a grid position, and has the signature
+    //    "void GetGridPos(Vector3f pos, float* outGridPos)".
+    //If "outGradients" isn't 0, it's filled with the gradient of the noise along the first three grid axes.
+    template<typename Info, typename GetGridPos>
+    void SampleSimplex(const Vector3f* positions, float* outValues, unsigned int nPositions,
+                       const unsigned int* wrapInterval, int seed, GetGridPos getGridPos,
+                       Vector3f* outGradients = 0)
+    {
+        const unsigned int NDims = Info::NDims;
+
+        //Convert the positions in batches so the grid positions can be read one component at a time.
+        const unsigned int batchSize = 256;
+        float gridPositions[NDims][batchSize];
+        const float* coords[NDims];
+        for (unsigned int axis = 0; axis < NDims; ++axis)
+            coords[axis] = gridPositions[axis];
+
+        for (unsigned int batchStart = 0; batchStart < nPositions; batchStart += batchSize)
+        {
+            unsigned int nInBatch = Mathf::Min(batchSize, nPositions - batchStart);
+
+            float minPos[NDims], maxPos[NDims];
+            for (unsigned int axis = 0; axis < NDims; ++axis)
+            {
+                minPos[axis] = std::numeric_limits<float>::max();
+                maxPos[axis] = -std::numeric_limits<float>::max();
+            }
+            for (unsigned int i = 0; i < nInBatch; ++i)
+            {
+                float gridPos[NDims];
+                getGridPos(positions[batchStart + i], gridPos);
+                for (unsigned int axis = 0; axis < NDims; ++axis)
+                {
+                    gridPositions[axis][i] = gridPos[axis];
+                    minPos[axis] = Mathf::Min(minPos[axis], gridPos[axis]);
+                    maxPos[axis] = Mathf::Max(maxPos[axis], gridPos[axis]);
+                }
+            }
+
+            GradientGrid<Info> gradients(minPos, maxPos, nInBatch, wrapInterval, seed);
+            if (outGradients == 0)
+            {
+                GetSimplexMany(coords, outValues + batchStart, nInBatch, gradients);
+            }
+            else
+            {
+                for (unsigned int i = 0; i < nInBatch; ++i)
+                {
+                    float pos[NDims], gradient[NDims];
+                    for (unsigned int axis = 0; axis < NDims; ++axis)
+                        pos[axis] = gridPositions[axis][i];
+
+                    outValues[batchStart + i] = GetSimplex(pos, gradients, gradient);
+                    outGradients[batchStart + i] = Vector3f(gradient[0], gradient[1], gradient[2]);
+                }
+            }
+        }
+    }
+}
+
+
+void Simplex3D::Generate(Array3D<float> & outNoise) const
+{
+    GenerateSlices(outNoise, 0, RemapValues);
+}
+void Simplex3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    if (RemapValues)
+    {
+        Generator3D::GenerateSlab(volumeSize, startZ, endZ, outSlab);
+        return;
+    }
+
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+
+    GenerateSlices(outSlab, startZ, false);
+}
+void Simplex3D::GenerateSlices(Noise3D& outNoise, unsigned int startZ, bool remapValues) const
+{
+    Vector3f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z);
+    unsigned int wrapInterval[3] = { GradientWrapInterval.x, GradientWrapInterval.y, GradientWrapInterval.z };
+
+    //Get the grid position of each column/row/slice.
+    std::vector<float> gridPosX(outNoise.GetWidth()),
+                       gridPosY(outNoise.GetHeight()),
+                       gridPosZ(outNoise.GetDepth());
+    for (unsigned int x = 0; x < gridPosX.size(); ++x)
+        gridPosX[x] = ((float)x + (float)Offset.x) * invScale.x;
+    for (unsigned int y = 0; y < gridPosY.size(); ++y)
+        gridPosY[y] = ((float)y + (float)Offset.y) * invScale.y;
+    for (unsigned int z = 0; z < gridPosZ.size(); ++z)
+        gridPosZ[z] = ((float)(z + startZ) + (float)Offset.z) * invScale.z;
+
+    //The grid position only goes in one direction along each axis, so the corners of the volume bound it.
+    float minPos[3] = { Mathf::Min(gridPosX.front(), gridPosX.back()),
+                        Mathf::Min(gridPosY.front(), gridPosY.back()),
+                        Mathf::Min(gridPosZ.front(), gridPosZ.back()) },
+          maxPos[3] = { Mathf::Max(gridPosX.front(), gridPosX.back()),
+                        Mathf::Max(gridPosY.front(), gridPosY.back()),
+                        Mathf::Max(gridPosZ.front(), gridPosZ.back()) };
+    GradientGrid<Simplex3DInfo> gradients(minPos, maxPos, outNoise.GetNumbElements(), wrapInterval, RandSeed);
+
+    GenerateSimplex(outNoise, remapValues, GetNumbSlabs(), gradients, gridPosX,
+                    [&](unsigned int y, unsigned int z, float* outGridPos)
+    {
+        outGridPos[0] = gridPosY[y];
+        outGridPos[1] = gridPosZ[z];
+    });
+}
+float Simplex3D::Sample(Vector3f pos) const
+{
+    float value;
+    SampleMany(&pos, &value, 1);
+    return value;
+}
+void Simplex3D::SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const
+{
+    Vector3f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z);
+    unsigned int wrapInterval[3] = { GradientWrapInterval.x, GradientWrapInterval.y, GradientWrapInterval.z };
+
+    SampleSimplex<Simplex3DInfo>(positions, outValues, nPositions, wrapInterval, RandSeed,
+                                 [&](Vector3f pos, float* outGridPos)
+    {
+        outGridPos[0] = (pos.x + (float)Offset.x) * invScale.x;
+        outGridPos[1] = (pos.y + (float)Offset.y) * invScale.y;
+        outGridPos[2] = (pos.z + (float)Offset.z) * invScale.z;
+    });
+}
+void Simplex3D::SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                unsigned int nPositions) const
+{
+    Vector3f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z);
+    unsigned int wrapInterval[3] = { GradientWrapInterval.x, GradientWrapInterval.y, GradientWrapInterval.z };
+
+    SampleSimplex<Simplex3DInfo>(positions, outValues, nPositions, wrapInterval, RandSeed,
+                                 [&](Vector3f pos, float* outGridPos)
+    {
+        outGridPos[0] = (pos.x + (float)Offset.x) * invScale.x;
+        outGridPos[1] = (pos.y + (float)Offset.y) * invScale.y;
+        outGridPos[2] = (pos.z + (float)Offset.z) * invScale.z;
+    }, outGradients);
+
+    //Convert the gradients from grid units to pixels.
+    for (unsigned int i = 0; i < nPositions; ++i)
+        outGradients[i].MultiplyComponents(invScale);
+}
+
+
+void Simplex4D::Generate(Array3D<float> & outNoise) const
+{
+    GenerateSlices(outNoise, 0, RemapValues);
+}
+void Simplex4D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    if (RemapValues)
+    {
+        Generator3D::GenerateSlab(volumeSize, startZ, endZ, outSlab);
+        return;
+    }
+
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
+
+    GenerateSlices(outSlab, startZ, false);
+}
+void Simplex4D::GenerateSlices(Noise3D& outNoise, unsigned int startZ, bool remapValues) const
+{
+    Vector4f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z, 1.0f / Scale.w);
+    unsigned int wrapInterval[4] = { GradientWrapInterval.x, GradientWrapInterval.y,
+                                     GradientWrapInterval.z, GradientWrapInterval.w };
+    float gridPosW = W * invScale.w;
+
+    //Get the grid position of each column/row/slice.
+    std::vector<float> gridPosX(outNoise.GetWidth()),
+                       gridPosY(outNoise.GetHeight()),
+                       gridPosZ(outNoise.GetDepth());
+    for (unsigned int x = 0; x < gridPosX.size(); ++x)
+        gridPosX[x] = ((float)x + (float)Offset.x) * invScale.x;
+    for (unsigned int y = 0; y < gridPosY.size(); ++y)
+        gridPosY[y] = ((float)y + (float)Offset.y) * invScale.y;
+    for (unsigned int z = 0; z < gridPosZ.size(); ++z)
+        gridPosZ[z] = ((float)(z + startZ) + (float)Offset.z) * invScale.z;
+
+    //The grid position only goes in one direction along each axis, so the corners of the volume bound it.
+    float minPos[4] = { Mathf::Min(gridPosX.front(), gridPosX.back()),
+                        Mathf::Min(gridPosY.front(), gridPosY.back()),
+                        Mathf::Min(gridPosZ.front(), gridPosZ.back()),
+                        gridPosW },
+          maxPos[4] = { Mathf::Max(gridPosX.front(), gridPosX.back()),
+                        Mathf::Max(gridPosY.front(), gridPosY.back()),
+                        Mathf::Max(gridPosZ.front(), gridPosZ.back()),
+                        gridPosW };
+    GradientGrid<Simplex4DInfo> gradients(minPos, maxPos, outNoise.GetNumbElements(), wrapInterval, RandSeed);
+
+    GenerateSimplex(outNoise, remapValues, GetNumbSlabs(), gradients, gridPosX,
+                    [&](unsigned int y, unsigned int z, float* outGridPos)
+    {
+        outGridPos[0] = gridPosY[y];
+        outGridPos[1] = gridPosZ[z];
+        outGridPos[2] = gridPosW;
+    });
+}
+float Simplex4D::Sample(Vector3f pos) const
+{
+    float value;
+    SampleMany(&pos, &value, 1);
+    return value;
+}
+void Simplex4D::SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const
+{
+    Vector4f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z, 1.0f / Scale.w);
+    unsigned int wrapInterval[4] = { GradientWrapInterval.x, GradientWrapInterval.y,
+                                     GradientWrapInterval.z, GradientWrapInterval.w };
+    float gridPosW = W * invScale.w;
+
+    SampleSimplex<Simplex4DInfo>(positions, outValues, nPositions, wrapInterval, RandSeed,
+                                 [&](Vector3f pos, float* outGridPos)
+    {
+        outGridPos[0] = (pos.x + (float)Offset.x) * invScale.x;
+        outGridPos[1] = (pos.y + (float)Offset.y) * invScale.y;
+        outGridPos[2] = (pos.z + (float)Offset.z) * invScale.z;
+        outGridPos[3] = gridPosW;
+    });
+}
+void Simplex4D::SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                unsigned int nPositions) const
+{
+    Vector4f invScale(1.0f / Scale.x, 1.0f / Scale.y, 1.0f / Scale.z, 1.0f / Scale.w);
+    unsigned int wrapInterval[4] = { GradientWrapInterval.x, GradientWrapInterval.y,
+                                     GradientWrapInterval.z, GradientWrapInterval.w };
+    float gridPosW = W * invScale.w;
+
+    SampleSimplex<Simplex4DInfo>(positions, outValues, nPositions, wrapInterval, RandSeed,
+                                 [&](Vector3f pos, float* outGridPos)
+    {
+        outGridPos[0] = (pos.x + (float)Offset.x) * invScale.x;
+        outGridPos[1] = (pos.y + (float)Offset.y) * invScale.y;
+        outGridPos[2] = (pos.z + (float)Offset.z) * invScale.z;
+        outGridPos[3] = gridPosW;
+    }, outGradients);
+
+    //Convert the gradients from grid units to pixels.
+    Vector3f invScale3(invScale.x, invScale.y, invScale.z);
+    for (unsigned int i = 0; i < nPositions; ++i)
+        outGradients[i].MultiplyComponents(invScale3);
+}
@@ -0,0 +1,122 @@
+#pragma once
+
+#include "BasicGenerators.h"
+
+
+//3D Simplex noise generator.
+//Like Perlin noise, but uses a grid of tetrahedrons instead of cubes,
+//    so each pixel only needs the gradients at 4 corners instead of 8.
+//Has the same fields as Perlin3D, so it can be used in its place.
+class Simplex3D : public Generator3D
+{
+public:
+
+    int RandSeed;
+    //The scale of the noise (i.e. the number of noise pixels inside a single grid element along each axis).
+    Vector3f Scale;
+    //The offset of the noise (used to make different adjacent pieces of noise fit together without forcing the noise to be tileable).
+    Vector3i Offset;
+    //The gradients repeat every "GradientWrapInterval.x" grid points along the X,
+    //   every "GradientWrapInterval.y" grid points along the Y, and every "GradientWrapInterval.z" grid points along the Z.
+    //Note that the simplex grid is skewed, so this doesn't make the noise itself tile along the X, Y, and Z axes.
+    Vector3u GradientWrapInterval;
+    //The noise values are roughly between -1 and 1. If this flag is true, they will be normalized.
+    bool RemapValues;
+
+    Simplex3D(float scale, Vector3i offset = Vector3i(), int seed = 12345, bool remapValues = true,
+              Vector3u gradientWrapInterval = Vector3u(std::numeric_limits<unsigned int>().max(), std::numeric_limits<unsigned int>().max(), std::numeric_limits<unsigned int>().max()))
+        : Scale(scale, scale, scale), Offset(offset), RandSeed(seed), GradientWrapInterval(gradientWrapInterval), RemapValues(remapValues) { }
+    Simplex3D(Vector3f scale = Vector3f(1.0f, 1.0f, 1.0f), Vector3i offset = Vector3i(), int seed = 12345, bool remapValues = true,
+              Vector3u gradientWrapInterval = Vector3u(std::numeric_limits<unsigned int>().max(), std::numeric_limits<unsigned int>().max(), std::numeric_limits<unsigned int>().max()))
+        : Scale(scale), Offset(offset), RandSeed(seed), GradientWrapInterval(gradientWrapInterval), RemapValues(remapValues) { }
+
+    virtual void Generate(Array3D<float> & outValues) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so it can only be sampled
+    //    if "RemapValues" is off. Samples give exactly the same values as "Generate".
+    virtual bool CanSample(void) const override { return !RemapValues; }
+    virtual float Sample(Vector3f pos) const override;
+    virtual void SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //Gradients are computed alongside the values, so they have the same limitations as "Sample".
+    virtual bool CanSampleGradients(void) const override { return !RemapValues; }
+    virtual void SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                 unsigned int nPositions) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so slabs can only be generated
+    //    on their own if "RemapValues" is off. Each slab only computes the gradients it needs.
+    virtual bool CanGenerateSlab(void) const override { return !RemapValues; }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Simplex3D").Add(RandSeed).Add(Scale).Add(Offset)
+                                           .Add(GradientWrapInterval).Add(RemapValues).Value;
+    }
+
+private:
+
+    //Fills the given array with the Z slices of the noise starting at slice "startZ", remapping them if requested.
+    void GenerateSlices(Noise3D& outNoise, unsigned int startZ, bool remapValues) const;
+};
+
+
+//Generates a 3D slice of 4D Simplex noise.
+//Moving the slice along the fourth axis (e.x. with time) smoothly animates the 3D noise.
+//Each pixel needs the gradients at 5 corners, where 4D Perlin noise would need 16.
+class Simplex4D : public Generator3D
+{
+public:
+
+    int RandSeed;
+    //The scale of the noise (i.e. the number of noise pixels inside a single grid element along each axis).
+    //The W component is the scale along the fourth axis.
+    Vector4f Scale;
+    //The offset of the noise (used to make different adjacent pieces of noise fit together without forcing the noise to be tileable).
+    Vector3i Offset;
+    //The position of the slice along the fourth axis (e.x. the current time).
+    float W;
+    //The gradients repeat every "GradientWrapInterval" grid points along each of the four axes.
+    //Note that the simplex grid is skewed, so this doesn't make the noise itself tile along the X, Y, and Z axes.
+    Vector4u GradientWrapInterval;
+    //The noise values are roughly between -1 and 1. If this flag is true, they will be normalized.
+    bool RemapValues;
+
+    Simplex4D(Vector4f scale = Vector4f(1.0f, 1.0f, 1.0f, 1.0f), float w = 0.0f, Vector3i offset = Vector3i(),
+              int seed = 12345, bool remapValues = true,
+              Vector4u gradientWrapInterval = Vector4u(std::numeric_limits<unsigned int>().max(), std::numeric_limits<unsigned int>().max(),
+                                                       std::numeric_limits<unsigned int>().max(), std::numeric_limits<unsigned int>().max()))
+        : Scale(scale), W(w), Offset(offset), RandSeed(seed), GradientWrapInterval(gradientWrapInterval), RemapValues(remapValues) { }
+
+    virtual void Generate(Array3D<float> & outValues) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so it can only be sampled
+    //    if "RemapValues" is off. Samples give exactly the same values as "Generate".
+    virtual bool CanSample(void) const override { return !RemapValues; }
+    virtual float Sample(Vector3f pos) const override;
+    virtual void SampleMany(const Vector3f* positions, float* outValues, unsigned int nPositions) const override;
+
+    //Gradients are computed alongside the values, so they have the same limitations as "Sample".
+    //The gradient is only along the X, Y, and Z axes; the noise's change along W isn't computed.
+    virtual bool CanSampleGradients(void) const override { return !RemapValues; }
+    virtual void SampleGradients(const Vector3f* positions, float* outValues, Vector3f* outGradients,
+                                 unsigned int nPositions) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so slabs can only be generated
+    //    on their own if "RemapValues" is off. Each slab only computes the gradients it needs.
+    virtual bool CanGenerateSlab(void) const override { return !RemapValues; }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Simplex4D").Add(RandSeed).Add(Scale).Add(Offset).Add(W)
+                                           .Add(GradientWrapInterval).Add(RemapValues).Value;
+    }
+
+private:
+
+    //Fills the given array with the Z slices of the noise starting at slice "startZ", remapping them if requested.
+    void GenerateSlices(Noise3D& outNoise, unsigned int startZ, bool remapValues) const;
+};
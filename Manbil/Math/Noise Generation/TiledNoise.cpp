@@ -0,0 +1,109 @@
+#include "TiledNoise.h"
+
+#include "NoiseTileCache.h"
+
+
+void TiledNoise2D::Generate(const Generator2D& gen, TiledArray2D<float>& outNoise)
+{
+    assert(gen.CanSample());
+
+    Vector2u nTiles = outNoise.GetNumbTiles();
+    ThreadPool::GetGlobalPool().RunChunks(nTiles.x * nTiles.y, Mathf::Max(gen.NumbThreads, (unsigned int)1),
+                                          [&gen, &outNoise, nTiles](unsigned int chunk, unsigned int start, unsigned int end)
+    {
+        for (unsigned int i = start; i < end; ++i)
+        {
+            //Tiles are generated in place, padding included, using the same positions as "NoiseTileCache2D".
+            Vector2u tile(i % nTiles.x, i / nTiles.x);
+            Noise2D tileNoise = outNoise.GetTile(tile);
+            NoiseTile2D::SampleTile(gen, ToV2i(tile), tileNoise);
+        }
+    });
+}
+void TiledNoise2D::Filter(const NoiseFilterer2D& filter, const TiledArray2D<float>& inNoise,
+                          TiledArray2D<float>& outNoise, unsigned int haloSize)
+{
+    assert(filter.FilterFunc != 0);
+    assert(inNoise.GetDimensions() == outNoise.GetDimensions() &&
+           inNoise.GetTileSize() == outNoise.GetTileSize());
+
+    Vector2u nTiles = inNoise.GetNumbTiles();
+    unsigned int tileSize = inNoise.GetTileSize(),
+                 regionSize = tileSize + (2 * haloSize);
+
+    ThreadPool::GetGlobalPool().RunChunks(nTiles.x * nTiles.y, Mathf::Max(filter.NumbThreads, (unsigned int)1),
+                                          [&](unsigned int chunk, unsigned int start, unsigned int end)
+    {
+        //Filterers aren't thread-safe, so each chunk gets its own copy.
+        NoiseFilterer2D chunkFilter = filter;
+        Noise2D region(regionSize, regionSize);
+
+        for (unsigned int i = start; i < end; ++i)
+        {
+            Vector2u tile(i % nTiles.x, i / nTiles.x);
+            Vector2i regionStart = (ToV2i(tile) * (int)tileSize) - Vector2i((int)haloSize, (int)haloSize);
+
+            inNoise.ReadRegion(regionStart, region);
+            (chunkFilter.*chunkFilter.FilterFunc)(&region);
+
+            Noise2D outTile = outNoise.GetTile(tile);
+            outTile.FillFunc([&region, haloSize](Vector2u loc, float* outVal)
+            {
+                *outVal = region[loc + Vector2u(haloSize, haloSize)];
+            });
+        }
+    });
+}
+
+
+void TiledNoise3D::Generate(const Generator3D& gen, TiledArray3D<float>& outNoise)
+{
+    assert(gen.CanSample());
+
+    Vector3u nTiles = outNoise.GetNumbTiles();
+    ThreadPool::GetGlobalPool().RunChunks(nTiles.x * nTiles.y * nTiles.z, Mathf::Max(gen.NumbThreads, (unsigned int)1),
+                                          [&gen, &outNoise, nTiles](unsigned int chunk, unsigned int start, unsigned int end)
+    {
+        for (unsigned int i = start; i < end; ++i)
+        {
+            //Tiles are generated in place, padding included, using the same positions as "NoiseTileCache3D".
+            Vector3u tile(i % nTiles.x, (i / nTiles.x) % nTiles.y, i / (nTiles.x * nTiles.y));
+            Noise3D tileNoise = outNoise.GetTile(tile);
+            NoiseTile3D::SampleTile(gen, ToV3i(tile), tileNoise);
+        }
+    });
+}
+void TiledNoise3D::Filter(const NoiseFilterer3D& filter, const TiledArray3D<float>& inNoise,
+                          TiledArray3D<float>& outNoise, unsigned int haloSize)
+{
+    assert(filter.FilterFunc != 0);
+    assert(inNoise.GetDimensions() == outNoise.GetDimensions() &&
+           inNoise.GetTileSize() == outNoise.GetTileSize());
+
+    Vector3u nTiles = inNoise.GetNumbTiles();
+    unsigned int tileSize = inNoise.GetTileSize(),
+                 regionSize = tileSize + (2 * haloSize);
+
+    ThreadPool::GetGlobalPool().RunChunks(nTiles.x * nTiles.y * nTiles.z, Mathf::Max(filter.NumbThreads, (unsigned int)1),
+                                          [&](unsigned int chunk, unsigned int start, unsigned int end)
+    {
+        //Filterers aren't thread-safe, so each chunk gets its own copy.
+        NoiseFilterer3D chunkFilter = filter;
+        Noise3D region(regionSize, regionSize, regionSize);
+
+        for (unsigned int i = start; i < end; ++i)
+        {
+            Vector3u tile(i % nTiles.x, (i / nTiles.x) % nTiles.y, i / (nTiles.x * nTiles.y));
+            Vector3i regionStart = (ToV3i(tile) * (int)tileSize) - Vector3i((int)haloSize, (int)haloSize, (int)haloSize);
+
+            inNoise.ReadRegion(regionStart, region);
+            (chunkFilter.*chunkFilter.FilterFunc)(&region);
+
+            Noise3D outTile = outNoise.GetTile(tile);
+            outTile.FillFunc([&region, haloSize](Vector3u loc, float* outVal)
+            {
+                *outVal = region[loc + Vector3u(haloSize, haloSize, haloSize)];
+            });
+        }
+    });
+}
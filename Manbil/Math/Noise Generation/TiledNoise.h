@@ -0,0 +1,55 @@
+#pragma once
+
+#include "NoiseFilterer.h"
+#include "../../IO/TiledArray.h"
+
+
+//Generating and filtering 2D noise that's too big to fit in memory,
+//    by streaming it through a "TiledArray2D" one tile at a time.
+namespace TiledNoise2D
+{
+    //Fills the given tiled array by sampling the given generator, which must be able to sample ("CanSample").
+    //The tiles are split into "gen.NumbThreads" groups, which are generated in parallel.
+    //Gives the same values as "gen.Generate" would give for the whole array wherever the generator's
+    //    "Sample" matches its "Generate"; see the generator's "CanSample" description for where it doesn't
+    //    (e.x. Perlin noise near the far edges, and Worley noise within a cell of the edges).
+    void Generate(const Generator2D& gen, TiledArray2D<float>& outNoise);
+
+    //Runs the given filter's "FilterFunc" over each tile of "inNoise" and writes the results into "outNoise",
+    //    which must have the same size and tile size.
+    //Each tile is filtered along with a border of "haloSize" values from its neighbors,
+    //    so filters that look at nearby values (e.x. "Smooth") give the same result
+    //    as filtering the whole array if the halo is at least as big as the filter's reach
+    //    (except right along the edges of the whole array, where the halo just repeats the edge values).
+    //Filters that depend on the whole array at once (e.x. "Average") only see each tile and its halo,
+    //    and the filter's "FillRegion" is positioned relative to the tile's halo instead of the whole array,
+    //    so position-dependent regions should generally be a "MaxFilterRegion".
+    //The tiles are split into "filter.NumbThreads" groups, which are filtered in parallel.
+    void Filter(const NoiseFilterer2D& filter, const TiledArray2D<float>& inNoise,
+                TiledArray2D<float>& outNoise, unsigned int haloSize);
+}
+
+//Generating and filtering 3D noise that's too big to fit in memory,
+//    by streaming it through a "TiledArray3D" one tile at a time.
+namespace TiledNoise3D
+{
+    //Fills the given tiled array by sampling the given generator, which must be able to sample ("CanSample").
+    //The tiles are split into "gen.NumbThreads" groups, which are generated in parallel.
+    //Gives the same values as "gen.Generate" would give for the whole array wherever the generator's
+    //    "Sample" matches its "Generate"; see the generator's "CanSample" description for where it doesn't
+    //    (e.x. Perlin noise near the far edges, and Worley noise within a cell of the edges).
+    void Generate(const Generator3D& gen, TiledArray3D<float>& outNoise);
+
+    //Runs the given filter's "FilterFunc" over each tile of "inNoise" and writes the results into "outNoise",
+    //    which must have the same size and tile size.
+    //Each tile is filtered along with a border of "haloSize" values from its neighbors,
+    //    so filters that look at nearby values (e.x. "Smooth") give the same result
+    //    as filtering the whole array if the halo is at least as big as the filter's reach
+    //    (except right along the edges of the whole array, where the halo just repeats the edge values).
+    //Filters that depend on the whole array at once (e.x. "Average") only see each tile and its halo,
+    //    and the filter's "FillVolume" is positioned relative to the tile's halo instead of the whole array,
+    //    so position-dependent volumes should generally be a "MaxFilterVolume".
+    //The tiles are split into "filter.NumbThreads" groups, which are filtered in parallel.
+    void Filter(const NoiseFilterer3D& filter, const TiledArray3D<float>& inNoise,
+                TiledArray3D<float>& outNoise, unsigned int haloSize);
+}
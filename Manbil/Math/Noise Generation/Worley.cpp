@@ -1,5 +1,6 @@
 #include "Worley.h"
 
+#include <vector>
 #include "NoiseFilterer.h"
 
 
@@ -7,14 +8,15 @@
 Worley2D::Worley2D(DistanceCalculatorFunc distFunc, GetValueFunc noiseOutput,
                    unsigned int cellSize, Vector2f variability, int seed, Vector2i cellOffset)
     : DistFunc(distFunc), ValueGenerator(noiseOutput),
-      CellSize(cellSize), Variability(variability), Seed(seed), CellOffset(cellOffset)
+      CellSize(cellSize), Variability(variability), Seed(seed), CellOffset(cellOffset), RemapValues(true),
+      CenterSource(nullptr)
 {
 
 }
 Worley3D::Worley3D(DistanceCalculatorFunc distFunc, GetValueFunc noiseOutput,
                    unsigned int cellSize, Vector3f variability, int seed, Vector3i cellOffset)
     : DistFunc(distFunc), ValueGenerator(noiseOutput),
-      CellSize(cellSize), Variability(variability), Seed(seed), CellOffset(cellOffset)
+      CellSize(cellSize), Variability(variability), Seed(seed), CellOffset(cellOffset), RemapValues(true)
 {
 
 }
@@ -22,296 +24,210 @@ Worley3D::Worley3D(DistanceCalculatorFunc distFunc, GetValueFunc noiseOutput,
 
 #pragma warning(disable : 4018)
 
-namespace WORLEY_HELPERS
+Vector2f Worley2D::GetCellCenter(Vector2i cell, float cellSize) const
 {
-    //Given an array and its size, tries to insert the given element
-    //    while keeping the array sorted in ascending order.
-    void Insert(float toInsert, float* insertInto, unsigned int maxSize)
-    {
-	    unsigned int i;
-	    for (i = 0; i < maxSize; ++i)
-	    {
-		    //If this is the right spot to insert the data...
-		    if (toInsert < insertInto[i])
-		    {
-			    //Move all the other data up.
-			    for (unsigned int j = maxSize - 1; j > i; --j)
-			    {
-				    insertInto[j] = insertInto[j - 1];
-			    }
-			    //Insert the element.
-			    insertInto[i] = toInsert;
-			    break;
-		    }
-	    }
-    }
+    //Get the range of values available for the center of this cell.
+    float startX = (float)cell.x * cellSize,
+          startY = (float)cell.y * cellSize;
+    Interval xBreadth = Interval(startX, startX + cellSize, 0.001f, true, true).Inflate(Variability.x),
+             yBreadth = Interval(startY, startY + cellSize, 0.001f, true, true).Inflate(Variability.y);
+
+    //Generate the center position for this cell.
+    //Each axis gets its own random value by using the axis as the first coordinate of the hash.
+    Vector2i cellPos = cell + CellOffset;
+    return Vector2f(xBreadth.Lerp(HashRand::GetZeroToOne(Seed, 0, cellPos.x, cellPos.y)),
+                    yBreadth.Lerp(HashRand::GetZeroToOne(Seed, 1, cellPos.x, cellPos.y)));
+}
+Vector3f Worley3D::GetCellCenter(Vector3i cell, float cellSize) const
+{
+    //Get the range of values available for the center of this cell.
+    //"Variability" isn't used here; see its description in the header.
+    float startX = (float)cell.x * cellSize,
+          startY = (float)cell.y * cellSize,
+          startZ = (float)cell.z * cellSize;
+    Interval xBreadth = Interval(startX, startX + cellSize, 0.001f, true, true),
+             yBreadth = Interval(startY, startY + cellSize, 0.001f, true, true),
+             zBreadth = Interval(startZ, startZ + cellSize, 0.001f, true, true);
+
+    //Generate the center position for this cell.
+    //Each axis gets its own random value by using the axis as the first coordinate of the hash.
+    Vector3i cellPos = cell + CellOffset;
+    return Vector3f(xBreadth.Lerp(HashRand::GetZeroToOne(Seed, 0, cellPos.x, cellPos.y, cellPos.z)),
+                    yBreadth.Lerp(HashRand::GetZeroToOne(Seed, 1, cellPos.x, cellPos.y, cellPos.z)),
+                    zBreadth.Lerp(HashRand::GetZeroToOne(Seed, 2, cellPos.x, cellPos.y, cellPos.z)));
 }
-using namespace WORLEY_HELPERS;
 
-void Worley2D::Generate(Array2D<float>& noise) const
+
+void Worley2D::GetCellCenters(Vector2u noiseSize, unsigned int& outCellSize, Array2D<Vector2f>& outCenters) const
 {
 	//Get the size of a cell.
-    unsigned int cSize = Mathf::Min(CellSize, noise.GetWidth(), noise.GetHeight());
-    float cSizeF = (float)cSize;
+    outCellSize = Mathf::Min(CellSize, noiseSize.x, noiseSize.y);
+    float cSizeF = (float)outCellSize;
 
 	//Get the number of cells.
-	Vector2u cells = Vector2u((noise.GetWidth() / cSize),
-							  (noise.GetHeight() / cSize));
-
-	Array2D<Vector2f> cellCenters(cells.x, cells.y);
+    outCenters.Reset(noiseSize.x / outCellSize, noiseSize.y / outCellSize);
 
 	//Generate cell positions.
-	FastRand fr(Seed);
-    Vector2u loc;
-    for (loc.y = 0; loc.y < cells.y; ++loc.y)
+    outCenters.FillFunc([&](Vector2u loc, Vector2f* outCenter)
     {
-        //Get the range of Y values available for the center of this cell.
-        float startY = (float)loc.y * cSizeF;
-        Interval yBreadth = Interval(startY, startY + cSizeF, 0.001f, true, true);
-        yBreadth = yBreadth.Inflate(Variability.y);
-
-        for (loc.x = 0; loc.x < cells.x; ++loc.x)
-        {
-            //Get the range of X values available for the center of this cell.
-            float startX = loc.x * cSizeF;
-            Interval xBreadth = Interval(startX, startX + cSizeF, 0.001f, true, true);
-            xBreadth = xBreadth.Inflate(Variability.x);
-
-            //Generate the center position for this cell.
-            fr.Seed = Vector3i(Seed, (int)loc.x + CellOffset.x, (int)loc.y + CellOffset.y).GetHashCode();
-            fr.GetRandInt();
-            fr.GetRandInt();
-            cellCenters[loc] = Vector2f(xBreadth.RandomInsideRange(fr),
-                                        yBreadth.RandomInsideRange(fr));
-
-            Vector2f temp = cellCenters[loc];
-            temp.x = temp.x;
-        }
+        *outCenter = GetCellCenter(ToV2i(loc), cSizeF);
+    });
+}
+void Worley2D::GetSourceCenters(Vector2u noiseSize, unsigned int& outBucketSize, Vector2u& outNBuckets,
+                                std::vector<unsigned int>& outBucketStarts, std::vector<Vector2f>& outCenters) const
+{
+    //Scatter the centers so that they wrap around the noise, like the normal cell grid does.
+    PoissonDisk2D sampler = *CenterSource;
+    sampler.Wrap = true;
+    std::vector<Vector2f> points;
+    sampler.Generate(ToV2f(noiseSize), points);
+
+    //Usually no center is much farther than "MaxRadius" from the closest one, but there's no guarantee
+    //    (e.x. if the sampler gave up on a gap), so "GenerateSourceCells" widens its search when it has to.
+    //Buckets half that wide keep the search tight around each pixel.
+    outBucketSize = Mathf::Clamp((unsigned int)ceilf(CenterSource->MaxRadius * 0.5f), (unsigned int)1,
+                                 Mathf::Min(noiseSize.x, noiseSize.y));
+    outNBuckets = Vector2u(noiseSize.x / outBucketSize, noiseSize.y / outBucketSize);
+
+    //Sort the centers into their buckets by counting how many go in each one.
+    std::vector<unsigned int> pointBuckets(points.size());
+    outBucketStarts.clear();
+    outBucketStarts.resize((outNBuckets.x * outNBuckets.y) + 1, 0);
+    for (unsigned int i = 0; i < points.size(); ++i)
+    {
+        Vector2u bucket(Mathf::Min((unsigned int)points[i].x / outBucketSize, outNBuckets.x - 1),
+                        Mathf::Min((unsigned int)points[i].y / outBucketSize, outNBuckets.y - 1));
+        pointBuckets[i] = bucket.x + (bucket.y * outNBuckets.x);
+        outBucketStarts[pointBuckets[i] + 1] += 1;
     }
+    for (unsigned int i = 1; i < outBucketStarts.size(); ++i)
+        outBucketStarts[i] += outBucketStarts[i - 1];
 
+    std::vector<unsigned int> nextIndices(outBucketStarts.begin(), outBucketStarts.end() - 1);
+    outCenters.resize(points.size());
+    for (unsigned int i = 0; i < points.size(); ++i)
+        outCenters[nextIndices[pointBuckets[i]]++] = points[i];
+}
+Vector3u Worley3D::GetNumbCells(Vector3u noiseSize) const
+{
+    return Vector3u(Mathf::Max((unsigned int)1, noiseSize.x / CellSize),
+                    Mathf::Max((unsigned int)1, noiseSize.y / CellSize),
+                    Mathf::Max((unsigned int)1, noiseSize.z / CellSize));
+}
+void Worley3D::GetCellCenters(Vector3u noiseSize, int firstCellZ, int lastCellZ,
+                              unsigned int& outCellSize, Array3D<Vector3f>& outCenters) const
+{
+	//Get the size of a cell.
+    outCellSize = CellSize;//Mathf::Min(CellSize, noise.GetWidth(),
+                           //Mathf::Min(noise.GetHeight(), noise.GetDepth()));
+    float cSizeF = (float)outCellSize;
 
-	//Get n-th-closest point for every spot on the noise grid.
-
-    float min = std::numeric_limits<float>::max(),
-          max = -std::numeric_limits<float>::max();
-
-	DistanceValues vals;
-
-	Vector2f tempPos;
-    Vector2u tempCellLoc;
-    loc = Vector2u();
+	//Get the number of cells.
+    Vector3u cells = GetNumbCells(noiseSize);
+    outCenters.Reset(cells.x, cells.y, (unsigned int)(lastCellZ - firstCellZ + 1));
 
-    for (loc.y = 0; loc.y < noise.GetHeight(); ++loc.y)
+	//Generate cell positions, wrapping the layers around the cell grid.
+    outCenters.FillFunc([&](Vector3u loc, Vector3f* outCenter)
     {
-        tempPos.y = (float)loc.y;
-        tempCellLoc.y = loc.y / cSize;
-
-        for (loc.x = 0; loc.x < noise.GetWidth(); ++loc.x)
-        {
-            tempPos.x = (float)loc.x;
-            tempCellLoc.x = loc.x / cSize;
-
-            for (unsigned int i = 0; i < NUMB_DISTANCE_VALUES; ++i)
-                vals.Values[i] = std::numeric_limits<float>::max();
-
-            //Loop through every surrounding cell.
-            for (int y2 = -1; y2 <= 1; ++y2)
-            {
-                for (int x2 = -1; x2 <= 1; ++x2)
-                {
-                    //If this cell is out of the bounds of the cell grid, wrap around.
-                    Vector2i tempCell = ToV2i(tempCellLoc) + Vector2i(x2, y2),
-                             tempCellWrapped = tempCell;
-                    Vector2f posOffset;
-                    if (tempCell.x < 0)
-                    {
-                        tempCellWrapped.x += cells.x;
-                        posOffset.x = -(float)noise.GetWidth();
-                    }
-                    else if (tempCell.x >= cells.x)
-                    {
-                        tempCellWrapped.x -= cells.x;
-                        posOffset.x = (float)noise.GetWidth();
-                    }
-                    if (tempCell.y < 0)
-                    {
-                        tempCellWrapped.y += cells.y;
-                        posOffset.y = -(float)noise.GetHeight();
-                    }
-                    else if (tempCell.y >= cells.y)
-                    {
-                        tempCellWrapped.y -= cells.y;
-                        posOffset.y = (float)noise.GetHeight();
-                    }
-                    Vector2u tempCellWrappedU = ToV2u(tempCellWrapped);
-
-                    //Get the distance to the cell's center and insert that distance into the sorted array.
-                    float tempDist = DistFunc(tempPos, cellCenters[tempCellWrappedU] + posOffset);
-                    Insert(tempDist, vals.Values, NUMB_DISTANCE_VALUES);
-                }
-            }
-
-            float noiseVal = ValueGenerator(vals);
-            min = Mathf::Min(min, noiseVal);
-            max = Mathf::Max(max, noiseVal);
-            noise[loc] = noiseVal;
-        }
-    }
+        int cellZ = firstCellZ + (int)loc.z;
+        if (cellZ < 0)
+            cellZ += cells.z;
+        else if (cellZ >= (int)cells.z)
+            cellZ = (cellZ - (int)cells.z) % (int)cells.z;
+
+        *outCenter = GetCellCenter(Vector3i((int)loc.x, (int)loc.y, cellZ), cSizeF);
+    });
+}
 
+void Worley2D::FinishGenerating(Noise2D& noise, const std::vector<NoiseAnalysis2D::MinMax>& minMaxes) const
+{
 	//Remap values to 0-1.
-	NoiseFilterer2D nf;
-    MaxFilterRegion mfr;
-	nf.FillRegion = &mfr;
-	nf.RemapValues_OldVals = Interval(min, max, 0.000001f, true, true);
-    nf.RemapValues_NewVals = Interval(0.0f, 1.0f, 0.000001f, true, true);
-    nf.RemapValues(&noise);
+    if (RemapValues)
+    {
+        NoiseAnalysis2D::MinMax minMax = NoiseAnalysis2D::MinMax::Combine(minMaxes);
+
+	    NoiseFilterer2D nf;
+        MaxFilterRegion mfr;
+	    nf.FillRegion = &mfr;
+	    nf.RemapValues_OldVals = Interval(minMax.Min, minMax.Max, 0.000001f, true, true);
+        nf.RemapValues_NewVals = Interval(0.0f, 1.0f, 0.000001f, true, true);
+        nf.RemapValues(&noise);
+    }
 }
-void Worley3D::Generate(Array3D<float>& noise) const
+void Worley3D::FinishGenerating(Noise3D& noise, const std::vector<NoiseAnalysis3D::MinMax>& minMaxes) const
 {
-	//Get the size of a cell.
-    unsigned int cSize = CellSize;//Mathf::Min(CellSize, noise.GetWidth(),
-                                    //Mathf::Min(noise.GetHeight(), noise.GetDepth()));
-    float cSizeF = (float)cSize;
+	//Remap values to 0-1.
+    if (RemapValues)
+    {
+        NoiseAnalysis3D::MinMax minMax = NoiseAnalysis3D::MinMax::Combine(minMaxes);
 
-	//Get the number of cells.
-	Vector3u cells = Vector3u(Mathf::Max((unsigned int)1, noise.GetWidth() / cSize),
-							  Mathf::Max((unsigned int)1, noise.GetHeight() / cSize),
-                              Mathf::Max((unsigned int)1, noise.GetDepth() / cSize));
+	    NoiseFilterer3D nf;
+        MaxFilterVolume mfv;
+	    nf.FillVolume = &mfv;
+	    nf.RemapValues_OldVals = Interval(minMax.Min, minMax.Max, 0.000001f, true, true);
+        nf.RemapValues(&noise);
+    }
+}
 
-	Array3D<Vector3f> cellCenters(cells.x, cells.y, cells.z);
 
-	//Generate cell positions.
-	FastRand fr(Seed);
-    Vector3u loc;
-    for (loc.z = 0; loc.z < cells.z; ++loc.z)
+void Worley2D::Generate(Array2D<float>& noise) const
+{
+    GenerateWith(noise, DistFunc, ValueGenerator);
+}
+void Worley3D::Generate(Array3D<float>& noise) const
+{
+    GenerateWith(noise, DistFunc, ValueGenerator);
+}
+void Worley3D::GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const
+{
+    if (RemapValues)
     {
-        //Get the range of Z values available for the center of this cell.
-        float startZ = loc.z * cSizeF;
-        Interval zBreadth = Interval(startZ, startZ + cSizeF, 0.001f, true, true);
-        zBreadth.Inflate(Variability.z);
-
-        for (loc.y = 0; loc.y < cells.y; ++loc.y)
-        {
-            //Get the range of Y values available for the center of this cell.
-            float startY = loc.y * cSizeF;
-            Interval yBreadth = Interval(startY, startY + cSizeF, 0.001f, true, true);
-            yBreadth.Inflate(Variability.y);
-
-            for (loc.x = 0; loc.x < cells.x; ++loc.x)
-            {
-                //Get the range of X values available for the center of this cell.
-                float startX = loc.x * cSizeF;
-                Interval xBreadth = Interval(startX, startX + cSizeF, 0.001f, true, true);
-                xBreadth.Inflate(Variability.x);
-
-                //Generate the center position for this cell.
-                fr.Seed = Vector4i(Seed,
-                                   (int)loc.x + CellOffset.x,
-                                   (int)loc.y + CellOffset.y,
-                                   (int)loc.z + CellOffset.z).GetHashCode();
-                fr.GetRandInt();
-                fr.GetRandInt();
-                cellCenters[loc] = Vector3f(xBreadth.RandomInsideRange(fr),
-                                            yBreadth.RandomInsideRange(fr),
-                                            zBreadth.RandomInsideRange(fr));
-            }
-        }
+        Generator3D::GenerateSlab(volumeSize, startZ, endZ, outSlab);
+        return;
     }
 
+    assert(startZ < endZ && endZ <= volumeSize.z);
+    outSlab.Reset(volumeSize.x, volumeSize.y, endZ - startZ);
 
-	//Get n-th-closest point for every spot on the noise grid.
+    GetValueFunc valueGen = ValueGenerator;
+    std::vector<NoiseAnalysis3D::MinMax> minMaxes;
+    GenerateCellSlices<NearestCells>(volumeSize, startZ, endZ, outSlab, minMaxes, DistFunc,
+                                     [valueGen](const NearestCells& nearest) { return valueGen(nearest.Distances); });
+}
 
-    float min = std::numeric_limits<float>::max(),
-          max = -std::numeric_limits<float>::max();
 
-	DistanceValues vals;
-	Vector3f tempPos;
-    Vector3u tempCellLoc;
-    loc = Vector3u();
+float Worley2D::Sample(Vector2f pos) const
+{
+    float cSizeF = (float)CellSize;
+    Vector2i cellLoc((int)floorf(pos.x / cSizeF), (int)floorf(pos.y / cSizeF));
 
-    for (loc.z = 0; loc.z < noise.GetDepth(); ++loc.z)
-    {
-        tempPos.z = (float)loc.z;
-        tempCellLoc.z = loc.z / cSize;
-
-        for (loc.y = 0; loc.y < noise.GetHeight(); ++loc.y)
-        {
-            tempPos.y = (float)loc.y;
-            tempCellLoc.y = loc.y / cSize;
-
-            for (loc.x = 0; loc.x < noise.GetWidth(); ++loc.x)
-            {
-                tempPos.x = (float)loc.x;
-                tempCellLoc.x = loc.x / cSize;
-
-                for (unsigned int i = 0; i < NUMB_DISTANCE_VALUES; ++i)
-                    vals.Values[i] = std::numeric_limits<float>::max();
-
-                //Loop through every surrounding cell.
-                for (int z2 = -1; z2 <= 1; ++z2)
-                {
-                    for (int y2 = -1; y2 <= 1; ++y2)
-                    {
-                        for (int x2 = -1; x2 <= 1; ++x2)
-                        {
-                            //If this cell is out of the bounds of the cell grid, wrap around.
-                            Vector3i tempCell = ToV3i(tempCellLoc) + Vector3i(x2, y2, z2),
-                                     tempCellWrapped = tempCell;
-                            Vector3f posOffset;
-                            if (tempCell.x < 0)
-                            {
-                                tempCellWrapped.x += cells.x;
-                                posOffset.x = -(float)noise.GetWidth();
-                            }
-                            else if (tempCell.x >= cells.x)
-                            {
-                                tempCellWrapped.x -= cells.x;
-                                posOffset.x = (float)noise.GetWidth();
-                            }
-                            if (tempCell.y < 0)
-                            {
-                                tempCellWrapped.y += cells.y;
-                                posOffset.y = -(float)noise.GetHeight();
-                            }
-                            else if (tempCell.y >= cells.y)
-                            {
-                                tempCellWrapped.y -= cells.y;
-                                posOffset.y = (float)noise.GetHeight();
-                            }
-                            if (tempCell.z < 0)
-                            {
-                                tempCellWrapped.z += cells.z;
-                                posOffset.z = -(float)noise.GetDepth();
-                            }
-                            else if (tempCell.z >= cells.z)
-                            {
-                                tempCellWrapped.z -= cells.z;
-                                posOffset.z = (float)noise.GetDepth();
-                            }
-                            Vector3u tempCellWrappedU = ToV3u(tempCellWrapped);
-
-                            //Get the distance to the cell's center
-                            //    and insert that distance into the sorted array.
-                            float tempDist = DistFunc(tempPos, cellCenters[tempCellWrappedU] + posOffset);
-                            Insert(tempDist, vals.Values, NUMB_DISTANCE_VALUES);
-                        }
-                    }
-                }
-
-                float noiseVal = ValueGenerator(vals);
-                min = Mathf::Min(min, noiseVal);
-                max = Mathf::Max(max, noiseVal);
-                noise[loc] = noiseVal;
-            }
-        }
-    }
+    NearestCells nearest;
+    nearest.Reset();
 
-	//Remap values to 0-1.
-	NoiseFilterer3D nf;
-    MaxFilterVolume mfv;
-	nf.FillVolume = &mfv;
-	nf.RemapValues_OldVals = Interval(min, max, 0.000001f, true, true);
-    nf.RemapValues(&noise);
+    //Loop through every surrounding cell.
+    //Unlike "Generate", the cell grid is infinite, so there's no wrapping.
+    for (int y2 = -1; y2 <= 1; ++y2)
+        for (int x2 = -1; x2 <= 1; ++x2)
+            nearest.Add(DistFunc(pos, GetCellCenter(cellLoc + Vector2i(x2, y2), cSizeF)));
+
+    return ValueGenerator(nearest.Distances);
+}
+float Worley3D::Sample(Vector3f pos) const
+{
+    float cSizeF = (float)CellSize;
+    Vector3i cellLoc((int)floorf(pos.x / cSizeF), (int)floorf(pos.y / cSizeF), (int)floorf(pos.z / cSizeF));
+
+    NearestCells nearest;
+    nearest.Reset();
+
+    //Loop through every surrounding cell.
+    //Unlike "Generate", the cell grid is infinite, so there's no wrapping.
+    for (int z2 = -1; z2 <= 1; ++z2)
+        for (int y2 = -1; y2 <= 1; ++y2)
+            for (int x2 = -1; x2 <= 1; ++x2)
+                nearest.Add(DistFunc(pos, GetCellCenter(cellLoc + Vector3i(x2, y2, z2), cSizeF)));
+
+    return ValueGenerator(nearest.Distances);
 }
 
 
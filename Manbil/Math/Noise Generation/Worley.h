@@ -1,6 +1,8 @@
 #pragma once
 
+#include <vector>
 #include "BasicGenerators.h"
+#include "PoissonDisk.h"
 
 
 //TODO: Make wrapping optional. If not wrapping, just expand the cell grid by 2 and offset the cell position by -1.
@@ -46,6 +48,19 @@ public:
 
 	int Seed;
 
+    //If true, the generated noise is remapped to the range 0-1. Defaults to true.
+    bool RemapValues;
+
+    //If not null, the cell centers are scattered across the noise by this sampler (with wrapping turned on)
+    //    instead of being one randomly-moved point per grid cell, which gives much more even cells.
+    //A density map on the sampler gives smaller cells where the density is higher.
+    //The centers are sorted into square buckets half of "MaxRadius" wide, and each pixel only looks at
+    //    the centers in the ring of buckets around its own. The ring is widened for each bucket
+    //    until it's sure to hold the closest centers to every pixel in the bucket (no matter how sparse
+    //    the density map makes them), for any distance function except "SmallestManhattanDistance".
+    //"CellSize", "CellOffset", and "Variability" are ignored, and the noise can't be sampled.
+    const PoissonDisk2D* CenterSource;
+
 
     Worley2D(DistanceCalculatorFunc distFunc = &StraightLineDistance,
              GetValueFunc noiseOutput = [](DistanceValues distVals) { return distVals.Values[0]; },
@@ -56,6 +71,106 @@ public:
 
 
 	virtual void Generate(Noise2D& noise) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so it can only be sampled
+    //    if "RemapValues" is off. Samples give the same values as "Generate"
+    //    as long as the noise is at least "CellSize" along each axis and the position isn't within
+    //    a cell of the noise's edge (where "Generate" wraps the cells around).
+    //Cell centers from "CenterSource" depend on the size of the whole noise, so they can't be sampled either.
+    virtual bool CanSample(void) const override { return !RemapValues && CenterSource == nullptr; }
+    virtual float Sample(Vector2f pos) const override;
+
+    //A "CenterSource" with a density map can't be hashed, since the map could be changed at any time.
+    virtual bool CanHash(void) const override { return CenterSource == nullptr || CenterSource->Density == nullptr; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        GeneratorHasher hasher("Worley2D");
+        hasher.Add(DistFunc).Add(ValueGenerator).Add(CellSize).Add(CellOffset)
+              .Add(Variability).Add(Seed).Add(RemapValues);
+        if (CenterSource != nullptr)
+            hasher.Add(CenterSource->MinRadius).Add(CenterSource->MaxRadius).Add(CenterSource->NumbCandidates)
+                  .Add(CenterSource->Seed).Add(CenterSource->TileSize);
+        return hasher.Value;
+    }
+
+    //Gets the center of the given cell, given the size of each cell.
+    Vector2f GetCellCenter(Vector2i cell, float cellSize) const;
+
+
+    //Generates the same noise as "Generate", but with the distance and value calculations
+    //    passed in as functors (e.x. lambdas) so that they can be inlined into the inner loop.
+    //"DistFunc" and "ValueGenerator" are ignored.
+    //"DistanceCalc" has the signature "float GetDist(Vector2f pixel, Vector2f cellCenter)".
+    //"ValueCalc" has the signature "float GetValue(const DistanceValues& closestDistances)".
+    template<typename DistanceCalc, typename ValueCalc>
+    void GenerateWith(Noise2D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const
+    {
+        GenerateCells<NearestCells>(noise, distFunc,
+                                    [&valueFunc](const NearestCells& nearest) { return valueFunc(nearest.Distances); });
+    }
+    //A faster version of "GenerateWith" for noise that only depends on the distance to the closest cell.
+    //"ValueGenerator" is ignored, and "DistanceValues" are never computed.
+    //For straight-line distance, it's faster to use the squared distance and take the square root in "valueFunc".
+    //"DistanceCalc" has the signature "float GetDist(Vector2f pixel, Vector2f cellCenter)".
+    //"ValueCalc" has the signature "float GetValue(float closestDistance)".
+    template<typename DistanceCalc, typename ValueCalc>
+    void GenerateClosest(Noise2D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const
+    {
+        GenerateCells<NearestCell>(noise, distFunc,
+                                   [&valueFunc](const NearestCell& nearest) { return valueFunc(nearest.Distance); });
+    }
+
+
+private:
+
+    //Keeps track of the distances to the closest few cells.
+    struct NearestCells
+    {
+        DistanceValues Distances;
+        void Reset(void)
+        {
+            for (unsigned int i = 0; i < NUMB_DISTANCE_VALUES; ++i)
+                Distances.Values[i] = std::numeric_limits<float>::max();
+        }
+        void Add(float dist)
+        {
+            //Most cells aren't close enough to matter, so check that first.
+            if (dist < Distances.Values[NUMB_DISTANCE_VALUES - 1])
+            {
+                unsigned int i = NUMB_DISTANCE_VALUES - 1;
+                for (; i > 0 && dist < Distances.Values[i - 1]; --i)
+                    Distances.Values[i] = Distances.Values[i - 1];
+                Distances.Values[i] = dist;
+            }
+        }
+        float GetFarthest(void) const { return Distances.Values[NUMB_DISTANCE_VALUES - 1]; }
+    };
+    //Keeps track of the distance to the closest cell.
+    struct NearestCell
+    {
+        float Distance;
+        void Reset(void) { Distance = std::numeric_limits<float>::max(); }
+        void Add(float dist) { Distance = Mathf::Min(dist, Distance); }
+        float GetFarthest(void) const { return Distance; }
+    };
+
+    //Computes the center of every cell for noise of the given size.
+    void GetCellCenters(Vector2u noiseSize, unsigned int& outCellSize, Array2D<Vector2f>& outCenters) const;
+    //Scatters cell centers across noise of the given size using "CenterSource",
+    //    and sorts them into square buckets of pixels "outBucketSize" wide.
+    //The last bucket along each axis also gets any leftover pixels past the end of the other buckets.
+    //The centers in bucket "i" (counting along rows) are "outCenters[outBucketStarts[i]]"
+    //    through "outCenters[outBucketStarts[i + 1] - 1]".
+    void GetSourceCenters(Vector2u noiseSize, unsigned int& outBucketSize, Vector2u& outNBuckets,
+                          std::vector<unsigned int>& outBucketStarts, std::vector<Vector2f>& outCenters) const;
+    //Remaps the generated noise using the min/max of each band/slab of it, if "RemapValues" is true.
+    void FinishGenerating(Noise2D& noise, const std::vector<NoiseAnalysis2D::MinMax>& minMaxes) const;
+
+    template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+    void GenerateCells(Noise2D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const;
+    //Does the work of "GenerateCells" when the cell centers come from "CenterSource".
+    template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+    void GenerateSourceCells(Noise2D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const;
 };
 
 
@@ -96,10 +211,15 @@ public:
     Vector3i CellOffset;
     
     //The variability (between 0 and 1) of worley cells along each axis.
+    //Note that 3D cells currently ignore this: each center can be anywhere inside its cell.
+    //It's kept so that Worley3D has the same fields as Worley2D, and using it would change existing noise.
     Vector3f Variability;
 
 	int Seed;
 
+    //If true, the generated noise is remapped to the range 0-1. Defaults to true.
+    bool RemapValues;
+
 
     Worley3D(DistanceCalculatorFunc distFunc = &StraightLineDistance,
              GetValueFunc noiseOutput = [](DistanceValues distVals) { return distVals.Values[0]; },
@@ -109,4 +229,453 @@ public:
 
 
 	virtual void Generate(Noise3D& noise) const override;
-};
\ No newline at end of file
+
+    //Remapped noise depends on the min/max of the whole generated array, so it can only be sampled
+    //    if "RemapValues" is off. Samples give the same values as "Generate"
+    //    as long as the noise is at least "CellSize" along each axis and the position isn't within
+    //    a cell of the noise's edge (where "Generate" wraps the cells around).
+    virtual bool CanSample(void) const override { return !RemapValues; }
+    virtual float Sample(Vector3f pos) const override;
+
+    //Remapped noise depends on the min/max of the whole generated array, so slabs can only be generated
+    //    on their own if "RemapValues" is off. Each slab only computes the cells it needs.
+    virtual bool CanGenerateSlab(void) const override { return !RemapValues; }
+    virtual void GenerateSlab(Vector3u volumeSize, unsigned int startZ, unsigned int endZ, Noise3D& outSlab) const override;
+
+    virtual bool CanHash(void) const override { return true; }
+    virtual unsigned long long GetHash(void) const override
+    {
+        return GeneratorHasher("Worley3D").Add(DistFunc).Add(ValueGenerator).Add(CellSize).Add(CellOffset)
+                                          .Add(Variability).Add(Seed).Add(RemapValues).Value;
+    }
+
+    //Gets the center of the given cell, given the size of each cell.
+    Vector3f GetCellCenter(Vector3i cell, float cellSize) const;
+
+
+    //Generates the same noise as "Generate", but with the distance and value calculations
+    //    passed in as functors (e.x. lambdas) so that they can be inlined into the inner loop.
+    //"DistFunc" and "ValueGenerator" are ignored.
+    //"DistanceCalc" has the signature "float GetDist(Vector3f pixel, Vector3f cellCenter)".
+    //"ValueCalc" has the signature "float GetValue(const DistanceValues& closestDistances)".
+    template<typename DistanceCalc, typename ValueCalc>
+    void GenerateWith(Noise3D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const
+    {
+        GenerateCells<NearestCells>(noise, distFunc,
+                                    [&valueFunc](const NearestCells& nearest) { return valueFunc(nearest.Distances); });
+    }
+    //A faster version of "GenerateWith" for noise that only depends on the distance to the closest cell.
+    //"ValueGenerator" is ignored, and "DistanceValues" are never computed.
+    //For straight-line distance, it's faster to use the squared distance and take the square root in "valueFunc".
+    //"DistanceCalc" has the signature "float GetDist(Vector3f pixel, Vector3f cellCenter)".
+    //"ValueCalc" has the signature "float GetValue(float closestDistance)".
+    template<typename DistanceCalc, typename ValueCalc>
+    void GenerateClosest(Noise3D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const
+    {
+        GenerateCells<NearestCell>(noise, distFunc,
+                                   [&valueFunc](const NearestCell& nearest) { return valueFunc(nearest.Distance); });
+    }
+
+
+private:
+
+    //Keeps track of the distances to the closest few cells.
+    struct NearestCells
+    {
+        DistanceValues Distances;
+        void Reset(void)
+        {
+            for (unsigned int i = 0; i < NUMB_DISTANCE_VALUES; ++i)
+                Distances.Values[i] = std::numeric_limits<float>::max();
+        }
+        void Add(float dist)
+        {
+            //Most cells aren't close enough to matter, so check that first.
+            if (dist < Distances.Values[NUMB_DISTANCE_VALUES - 1])
+            {
+                unsigned int i = NUMB_DISTANCE_VALUES - 1;
+                for (; i > 0 && dist < Distances.Values[i - 1]; --i)
+                    Distances.Values[i] = Distances.Values[i - 1];
+                Distances.Values[i] = dist;
+            }
+        }
+    };
+    //Keeps track of the distance to the closest cell.
+    struct NearestCell
+    {
+        float Distance;
+        void Reset(void) { Distance = std::numeric_limits<float>::max(); }
+        void Add(float dist) { Distance = Mathf::Min(dist, Distance); }
+    };
+
+    //Gets the number of cells along each axis of the cell grid for noise of the given size.
+    Vector3u GetNumbCells(Vector3u noiseSize) const;
+    //Computes the center of every cell in the layers of cells from "firstCellZ" to "lastCellZ" (inclusive)
+    //    for noise of the given size. Layers past either end of the cell grid wrap around to the other end.
+    void GetCellCenters(Vector3u noiseSize, int firstCellZ, int lastCellZ,
+                        unsigned int& outCellSize, Array3D<Vector3f>& outCenters) const;
+    //Remaps the generated noise using the min/max of each band/slab of it, if "RemapValues" is true.
+    void FinishGenerating(Noise3D& noise, const std::vector<NoiseAnalysis3D::MinMax>& minMaxes) const;
+
+    template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+    void GenerateCells(Noise3D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const;
+    //Generates the Z slices "noiseStartZ" through "noiseEndZ - 1" of noise with the given size, without remapping.
+    //The first Z slice of "outNoise" is slice "noiseStartZ".
+    //Only computes the cells that those slices need. Outputs the min/max of each slab of slices.
+    template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+    void GenerateCellSlices(Vector3u noiseSize, unsigned int noiseStartZ, unsigned int noiseEndZ,
+                            Noise3D& outNoise, std::vector<NoiseAnalysis3D::MinMax>& outMinMaxes,
+                            DistanceCalc distFunc, ValueCalc valueFunc) const;
+};
+
+
+
+template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+void Worley2D::GenerateCells(Noise2D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const
+{
+    if (CenterSource != nullptr)
+    {
+        GenerateSourceCells<Tracker>(noise, distFunc, valueFunc);
+        return;
+    }
+
+    unsigned int cSize;
+    Array2D<Vector2f> cellCenters(1, 1);
+    GetCellCenters(noise.GetDimensions(), cSize, cellCenters);
+
+    Vector2u cells = cellCenters.GetDimensions(),
+             noiseSize = noise.GetDimensions();
+    Vector2f noiseSizeF = ToV2f(noiseSize);
+
+    //Each band of rows keeps track of its own min/max.
+    std::vector<NoiseAnalysis2D::MinMax> bandMinMaxes(GetNumbBands());
+
+    ForEachRowBand(noiseSize.y, [&](unsigned int band, unsigned int startY, unsigned int endY)
+    {
+        if (startY == endY)
+            return;
+
+        float min = bandMinMaxes[band].Min,
+              max = bandMinMaxes[band].Max;
+        Tracker nearest;
+
+        //Walk through the noise one cell at a time, so that each cell's neighbors
+        //    only have to be looked up once.
+        unsigned int nCellsX = (noiseSize.x + cSize - 1) / cSize;
+        for (unsigned int cellY = startY / cSize; cellY <= (endY - 1) / cSize; ++cellY)
+        {
+            for (unsigned int cellX = 0; cellX < nCellsX; ++cellX)
+            {
+                //Get the center of every surrounding cell.
+                //If a cell is out of the bounds of the cell grid, wrap around.
+                //The modulo is only needed when a partial cell at the far edge looks past a single full cell.
+                Vector2f neighbors[9];
+                unsigned int neighborI = 0;
+                for (int y2 = -1; y2 <= 1; ++y2)
+                {
+                    for (int x2 = -1; x2 <= 1; ++x2)
+                    {
+                        Vector2i tempCell((int)cellX + x2, (int)cellY + y2),
+                                 tempCellWrapped = tempCell;
+                        Vector2f posOffset;
+                        if (tempCell.x < 0)
+                        {
+                            tempCellWrapped.x += cells.x;
+                            posOffset.x = -noiseSizeF.x;
+                        }
+                        else if (tempCell.x >= (int)cells.x)
+                        {
+                            tempCellWrapped.x = (tempCell.x - (int)cells.x) % (int)cells.x;
+                            posOffset.x = noiseSizeF.x;
+                        }
+                        if (tempCell.y < 0)
+                        {
+                            tempCellWrapped.y += cells.y;
+                            posOffset.y = -noiseSizeF.y;
+                        }
+                        else if (tempCell.y >= (int)cells.y)
+                        {
+                            tempCellWrapped.y = (tempCell.y - (int)cells.y) % (int)cells.y;
+                            posOffset.y = noiseSizeF.y;
+                        }
+
+                        neighbors[neighborI++] = cellCenters[ToV2u(tempCellWrapped)] + posOffset;
+                    }
+                }
+
+                //Compute every pixel in this cell.
+                Vector2u cellStart(cellX * cSize, Mathf::Max(cellY * cSize, startY)),
+                         cellEnd(Mathf::Min((cellX + 1) * cSize, noiseSize.x),
+                                 Mathf::Min((cellY + 1) * cSize, endY));
+                for (Vector2u loc(cellStart.x, cellStart.y); loc.y < cellEnd.y; ++loc.y)
+                {
+                    for (loc.x = cellStart.x; loc.x < cellEnd.x; ++loc.x)
+                    {
+                        Vector2f pos = ToV2f(loc);
+
+                        nearest.Reset();
+                        for (unsigned int i = 0; i < 9; ++i)
+                            nearest.Add(distFunc(pos, neighbors[i]));
+
+                        float noiseVal = valueFunc(nearest);
+                        min = Mathf::Min(min, noiseVal);
+                        max = Mathf::Max(max, noiseVal);
+                        noise[loc] = noiseVal;
+                    }
+                }
+            }
+        }
+
+        bandMinMaxes[band] = NoiseAnalysis2D::MinMax(min, max);
+    });
+
+    FinishGenerating(noise, bandMinMaxes);
+}
+
+template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+void Worley2D::GenerateSourceCells(Noise2D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const
+{
+    unsigned int bSize;
+    Vector2u nBuckets,
+             noiseSize = noise.GetDimensions();
+    std::vector<unsigned int> bucketStarts;
+    std::vector<Vector2f> centers;
+    GetSourceCenters(noiseSize, bSize, nBuckets, bucketStarts, centers);
+
+    Vector2f noiseSizeF = ToV2f(noiseSize);
+    const float sqrt2 = sqrtf(2.0f);
+
+    //Once the ring of buckets is wider than the whole noise, it already holds the closest copy of every center.
+    int maxRing = (int)Mathf::Max(nBuckets.x, nBuckets.y) + 1;
+
+    //Each band of rows keeps track of its own min/max.
+    std::vector<NoiseAnalysis2D::MinMax> bandMinMaxes(GetNumbBands());
+
+    ForEachRowBand(noiseSize.y, [&](unsigned int band, unsigned int startY, unsigned int endY)
+    {
+        if (startY == endY)
+            return;
+
+        float min = bandMinMaxes[band].Min,
+              max = bandMinMaxes[band].Max;
+        Tracker nearest, coverage;
+        std::vector<Vector2f> neighbors;
+
+        //Walk through the noise one bucket at a time, so that each bucket's neighbors
+        //    only have to be looked up once.
+        unsigned int lastBucketY = Mathf::Min((endY - 1) / bSize, nBuckets.y - 1);
+        for (unsigned int bucketY = Mathf::Min(startY / bSize, nBuckets.y - 1); bucketY <= lastBucketY; ++bucketY)
+        {
+            for (unsigned int bucketX = 0; bucketX < nBuckets.x; ++bucketX)
+            {
+                //Compute the bounds of this bucket.
+                Vector2u bucketStart(bucketX * bSize, Mathf::Max(bucketY * bSize, startY)),
+                         bucketEnd((bucketX == nBuckets.x - 1) ? noiseSize.x : ((bucketX + 1) * bSize),
+                                   Mathf::Min((bucketY == nBuckets.y - 1) ? noiseSize.y : ((bucketY + 1) * bSize), endY));
+                Vector2f fullStart((float)(bucketX * bSize), (float)(bucketY * bSize)),
+                         fullEnd((bucketX == nBuckets.x - 1) ? noiseSizeF.x : (float)((bucketX + 1) * bSize),
+                                 (bucketY == nBuckets.y - 1) ? noiseSizeF.y : (float)((bucketY + 1) * bSize));
+                Vector2f bucketCenter = (fullStart + fullEnd) * 0.5f;
+                float bucketHalfDiagonal = (fullEnd - fullStart).Length() * 0.5f;
+
+                //Get the centers in the ring of buckets around this one, widening the ring until it holds
+                //    the closest centers to every pixel in this bucket.
+                //Every pixel in the bucket is at least "ring * bSize" away from anything outside the ring,
+                //    and the closest centers to the middle of the bucket are at most "bucketHalfDiagonal"
+                //    farther from any of its pixels. Manhattan distance can be up to sqrt(2) times
+                //    the straight-line distance, so leave room for that too.
+                //If a bucket is out of the bounds of the bucket grid, wrap around.
+                //If there are only a few buckets along an axis, the same bucket shows up more than once,
+                //    but each time with a different offset.
+                neighbors.clear();
+                coverage.Reset();
+                for (int ring = 0; ring <= maxRing; ++ring)
+                {
+                    for (int y2 = -ring; y2 <= ring; ++y2)
+                    {
+                        int tempY = (int)bucketY + y2,
+                            wrapsY = (tempY < 0) ? -((-tempY + (int)nBuckets.y - 1) / (int)nBuckets.y) :
+                                                   (tempY / (int)nBuckets.y);
+                        tempY -= wrapsY * (int)nBuckets.y;
+                        float offsetY = noiseSizeF.y * (float)wrapsY;
+
+                        //Only the edges of the ring are new.
+                        int stepX = (y2 == -ring || y2 == ring) ? 1 : Mathf::Max(1, 2 * ring);
+                        for (int x2 = -ring; x2 <= ring; x2 += stepX)
+                        {
+                            int tempX = (int)bucketX + x2,
+                                wrapsX = (tempX < 0) ? -((-tempX + (int)nBuckets.x - 1) / (int)nBuckets.x) :
+                                                       (tempX / (int)nBuckets.x);
+                            tempX -= wrapsX * (int)nBuckets.x;
+                            float offsetX = noiseSizeF.x * (float)wrapsX;
+
+                            unsigned int bucketI = (unsigned int)tempX + ((unsigned int)tempY * nBuckets.x);
+                            for (unsigned int i = bucketStarts[bucketI]; i < bucketStarts[bucketI + 1]; ++i)
+                            {
+                                Vector2f center = centers[i] + Vector2f(offsetX, offsetY);
+                                neighbors.push_back(center);
+                                coverage.Add(bucketCenter.Distance(center));
+                            }
+                        }
+                    }
+
+                    float reach = (float)(ring * bSize);
+                    if (ring > 0 && (coverage.GetFarthest() + bucketHalfDiagonal) * sqrt2 <= reach)
+                        break;
+                }
+
+                //Compute every pixel in this bucket.
+                for (Vector2u loc(bucketStart.x, bucketStart.y); loc.y < bucketEnd.y; ++loc.y)
+                {
+                    for (loc.x = bucketStart.x; loc.x < bucketEnd.x; ++loc.x)
+                    {
+                        Vector2f pos = ToV2f(loc);
+
+                        nearest.Reset();
+                        for (unsigned int i = 0; i < neighbors.size(); ++i)
+                            nearest.Add(distFunc(pos, neighbors[i]));
+
+                        float noiseVal = valueFunc(nearest);
+                        min = Mathf::Min(min, noiseVal);
+                        max = Mathf::Max(max, noiseVal);
+                        noise[loc] = noiseVal;
+                    }
+                }
+            }
+        }
+
+        bandMinMaxes[band] = NoiseAnalysis2D::MinMax(min, max);
+    });
+
+    FinishGenerating(noise, bandMinMaxes);
+}
+
+template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+void Worley3D::GenerateCells(Noise3D& noise, DistanceCalc distFunc, ValueCalc valueFunc) const
+{
+    std::vector<NoiseAnalysis3D::MinMax> slabMinMaxes;
+    GenerateCellSlices<Tracker>(noise.GetDimensions(), 0, noise.GetDepth(), noise, slabMinMaxes, distFunc, valueFunc);
+    FinishGenerating(noise, slabMinMaxes);
+}
+template<typename Tracker, typename DistanceCalc, typename ValueCalc>
+void Worley3D::GenerateCellSlices(Vector3u noiseSize, unsigned int noiseStartZ, unsigned int noiseEndZ,
+                                  Noise3D& outNoise, std::vector<NoiseAnalysis3D::MinMax>& outMinMaxes,
+                                  DistanceCalc distFunc, ValueCalc valueFunc) const
+{
+    Vector3f noiseSizeF = ToV3f(noiseSize);
+
+    //Each slab of Z slices keeps track of its own min/max.
+    outMinMaxes.clear();
+    outMinMaxes.resize(GetNumbSlabs());
+
+    ForEachZSlab(noiseEndZ - noiseStartZ, [&](unsigned int slab, unsigned int startZ, unsigned int endZ)
+    {
+        if (startZ == endZ)
+            return;
+        startZ += noiseStartZ;
+        endZ += noiseStartZ;
+
+        float min = outMinMaxes[slab].Min,
+              max = outMinMaxes[slab].Max;
+        Tracker nearest;
+
+        //Get the centers of the layers of cells this slab touches, plus the layer on either side of them.
+        unsigned int cSize;
+        int firstCellZ = (int)(startZ / CellSize) - 1;
+        Array3D<Vector3f> cellCenters(1, 1, 1);
+        GetCellCenters(noiseSize, firstCellZ, (int)((endZ - 1) / CellSize) + 1, cSize, cellCenters);
+        Vector3u cells = GetNumbCells(noiseSize);
+
+        //Walk through the noise one cell at a time, so that each cell's neighbors
+        //    only have to be looked up once.
+        Vector2u nCellsXY((noiseSize.x + cSize - 1) / cSize,
+                          (noiseSize.y + cSize - 1) / cSize);
+        for (unsigned int cellZ = startZ / cSize; cellZ <= (endZ - 1) / cSize; ++cellZ)
+        {
+            for (unsigned int cellY = 0; cellY < nCellsXY.y; ++cellY)
+            {
+                for (unsigned int cellX = 0; cellX < nCellsXY.x; ++cellX)
+                {
+                    //Get the center of every surrounding cell.
+                    //If a cell is out of the bounds of the cell grid, wrap around.
+                    //The modulo is only needed when a partial cell at the far edge looks past a single full cell.
+                    Vector3f neighbors[27];
+                    unsigned int neighborI = 0;
+                    for (int z2 = -1; z2 <= 1; ++z2)
+                    {
+                        for (int y2 = -1; y2 <= 1; ++y2)
+                        {
+                            for (int x2 = -1; x2 <= 1; ++x2)
+                            {
+                                Vector3i tempCell((int)cellX + x2, (int)cellY + y2, (int)cellZ + z2),
+                                         tempCellWrapped = tempCell;
+                                Vector3f posOffset;
+                                if (tempCell.x < 0)
+                                {
+                                    tempCellWrapped.x += cells.x;
+                                    posOffset.x = -noiseSizeF.x;
+                                }
+                                else if (tempCell.x >= (int)cells.x)
+                                {
+                                    tempCellWrapped.x = (tempCell.x - (int)cells.x) % (int)cells.x;
+                                    posOffset.x = noiseSizeF.x;
+                                }
+                                if (tempCell.y < 0)
+                                {
+                                    tempCellWrapped.y += cells.y;
+                                    posOffset.y = -noiseSizeF.y;
+                                }
+                                else if (tempCell.y >= (int)cells.y)
+                                {
+                                    tempCellWrapped.y = (tempCell.y - (int)cells.y) % (int)cells.y;
+                                    posOffset.y = noiseSizeF.y;
+                                }
+                                if (tempCell.z < 0)
+                                {
+                                    tempCellWrapped.z += cells.z;
+                                    posOffset.z = -noiseSizeF.z;
+                                }
+                                else if (tempCell.z >= (int)cells.z)
+                                {
+                                    tempCellWrapped.z = (tempCell.z - (int)cells.z) % (int)cells.z;
+                                    posOffset.z = noiseSizeF.z;
+                                }
+
+                                neighbors[neighborI++] = cellCenters[Vector3u(tempCellWrapped.x, tempCellWrapped.y,
+                                                                              tempCell.z - firstCellZ)] +
+                                                         posOffset;
+                            }
+                        }
+                    }
+
+                    //Compute every pixel in this cell.
+                    Vector3u cellStart(cellX * cSize, cellY * cSize, Mathf::Max(cellZ * cSize, startZ)),
+                             cellEnd(Mathf::Min((cellX + 1) * cSize, noiseSize.x),
+                                     Mathf::Min((cellY + 1) * cSize, noiseSize.y),
+                                     Mathf::Min((cellZ + 1) * cSize, endZ));
+                    for (Vector3u loc(cellStart.x, cellStart.y, cellStart.z); loc.z < cellEnd.z; ++loc.z)
+                    {
+                        for (loc.y = cellStart.y; loc.y < cellEnd.y; ++loc.y)
+                        {
+                            for (loc.x = cellStart.x; loc.x < cellEnd.x; ++loc.x)
+                            {
+                                Vector3f pos = ToV3f(loc);
+
+                                nearest.Reset();
+                                for (unsigned int i = 0; i < 27; ++i)
+                                    nearest.Add(distFunc(pos, neighbors[i]));
+
+                                float noiseVal = valueFunc(nearest);
+                                min = Mathf::Min(min, noiseVal);
+                                max = Mathf::Max(max, noiseVal);
+                                outNoise[loc - Vector3u(0, 0, noiseStartZ)] = noiseVal;
+                            }
+                        }
+                    }
+                }
+            }
+        }
+
+        outMinMaxes[slab] = NoiseAnalysis3D::MinMax(min, max);
+    });
+}
\ No newline at end of file
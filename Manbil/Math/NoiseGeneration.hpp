@@ -1,9 +1,16 @@
 #pragma once
 
 #include "Noise Generation/DiamondSquare.h"
+#include "Noise Generation/DomainWarp.h"
+#include "Noise Generation/FusedGenerator.h"
 #include "Noise Generation/Interpolator.h"
 #include "Noise Generation/LayeredOctave.h"
 #include "Noise Generation/NoiseCombinations.h"
 #include "Noise Generation/NoiseFilterer.h"
+#include "Noise Generation/NoiseTileCache.h"
 #include "Noise Generation/Perlin.h"
+#include "Noise Generation/PoissonDisk.h"
+#include "Noise Generation/QuantizedNoise.h"
+#include "Noise Generation/Simplex.h"
+#include "Noise Generation/TiledNoise.h"
 #include "Noise Generation/Worley.h"
\ No newline at end of file
@@ -436,9 +436,10 @@ void Material::Render(const Mesh& mesh, const Transform& transform,
 	attributes.EnableAttributes();
 	if (mesh.GetUsesIndices())
 	{
+		assert(!mesh.GetUses16BitIndices() || mesh.GetNVertices() <= 65536);
 		glDrawElements(PrimitiveTypeToGLEnum(mesh.PrimType),
-					   mesh.GetRangeSize(), GL_UNSIGNED_INT,
-					   (GLvoid*)mesh.GetRangeStart());
+					   mesh.GetRangeSize(), mesh.GetIndexGLType(),
+					   (GLvoid*)(mesh.GetRangeStart() * mesh.GetIndexSize()));
 	}
 	else
 	{
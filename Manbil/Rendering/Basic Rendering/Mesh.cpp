@@ -9,7 +9,7 @@ RenderObjHandle Mesh::currentVHandle = 0,
 Mesh::Mesh(bool shouldStoreData, PrimitiveTypes primType)
     : storesData(shouldStoreData), PrimType(primType),
       verticesHandle(0), nVertices(0), bytesPerVertex(0),
-      indicesHandle(0), nIndices(0)
+      indicesHandle(0), nIndices(0), uses16BitIndices(false)
 {
     glGenBuffers(1, &verticesHandle);
 }
@@ -36,6 +36,7 @@ Mesh& Mesh::operator=(Mesh&& other)
         indicesHandle = other.indicesHandle;
         nVertices = other.nVertices;
         nIndices = other.nIndices;
+        uses16BitIndices = other.uses16BitIndices;
         vertexAttributes = std::move(other.vertexAttributes);
         verticesData = std::move(other.verticesData);
         indicesData = std::move(other.indicesData);
@@ -47,6 +48,7 @@ Mesh& Mesh::operator=(Mesh&& other)
         other.indicesHandle = 0;
         other.nVertices = 0;
         other.nIndices = 0;
+        other.uses16BitIndices = false;
         other.start = 0;
         other.range = 0;
     }
@@ -60,6 +62,7 @@ Mesh Mesh::MakeCopy(void) const
 
 	m.nVertices = nVertices;
 	m.nIndices = nIndices;
+	m.uses16BitIndices = uses16BitIndices;
 	m.vertexAttributes = vertexAttributes;
 	m.start = start;
 	m.range = range;
@@ -87,7 +90,7 @@ Mesh Mesh::MakeCopy(void) const
 		glBindBuffer(GL_COPY_READ_BUFFER, indicesHandle);
 		glBindBuffer(GL_COPY_WRITE_BUFFER, m.indicesHandle);
 		glCopyBufferSubData(GL_COPY_READ_BUFFER, GL_COPY_WRITE_BUFFER,
-							0, 0, nIndices * sizeof(unsigned int));
+							0, 0, nIndices * GetIndexSize());
 	}
 
 	return m;
@@ -109,9 +112,7 @@ void Mesh::SetStoresData(bool newValue)
 
             if (GetUsesIndices())
             {
-                indicesData.resize(nIndices);
-                glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, nIndices * sizeof(unsigned int),
-                                   indicesData.data());
+                ReadIndexData(indicesData);
             }
         }
         else
@@ -124,12 +125,23 @@ void Mesh::SetStoresData(bool newValue)
 
 void Mesh::ReadIndexData(std::vector<unsigned int>& outIndexData)
 {
+    //Check for a local copy before resizing, in case the output is the local copy itself.
+    bool hasLocalCopy = (storesData && indicesData.size() == nIndices);
     outIndexData.resize(nIndices);
 
-    if (storesData)
+    if (hasLocalCopy)
     {
         memcpy(outIndexData.data(), indicesData.data(), indicesData.size() * sizeof(unsigned int));
     }
+    else if (uses16BitIndices)
+    {
+        std::vector<unsigned short> smallIndices(nIndices);
+        Bind();
+        glGetBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, nIndices * sizeof(unsigned short),
+                           smallIndices.data());
+        for (unsigned int i = 0; i < nIndices; ++i)
+            outIndexData[i] = smallIndices[i];
+    }
     else
     {
         Bind();
@@ -145,24 +157,48 @@ void Mesh::SetIndexData(const std::vector<unsigned int>& newIndices, BufferUsage
 void Mesh::SetIndexData(const unsigned int* newIndices, unsigned int _nIndices,
                         BufferUsageFrequency usage)
 {
-    if (indicesHandle == 0)
+    if (storesData)
     {
-        glGenBuffers(1, &indicesHandle);
+        indicesData.resize(_nIndices);
+        memcpy(indicesData.data(), newIndices, _nIndices * sizeof(unsigned int));
     }
 
-    nIndices = _nIndices;
+    UploadIndexData(newIndices, _nIndices, false, usage);
+}
+void Mesh::SetIndexData(const std::vector<unsigned short>& newIndices, BufferUsageFrequency usage)
+{
+    SetIndexData(newIndices.data(), newIndices.size(), usage);
+}
+void Mesh::SetIndexData(const unsigned short* newIndices, unsigned int _nIndices,
+                        BufferUsageFrequency usage)
+{
+    //The local copy always uses 32-bit indices.
     if (storesData)
     {
-        indicesData.resize(nIndices);
-        memcpy(indicesData.data(), newIndices, nIndices * sizeof(unsigned int));
+        indicesData.resize(_nIndices);
+        for (unsigned int i = 0; i < _nIndices; ++i)
+            indicesData[i] = newIndices[i];
     }
 
+    UploadIndexData(newIndices, _nIndices, true, usage);
+}
+void Mesh::UploadIndexData(const void* newIndices, unsigned int _nIndices, bool is16Bit,
+                           BufferUsageFrequency usage)
+{
+    if (indicesHandle == 0)
+    {
+        glGenBuffers(1, &indicesHandle);
+    }
+
+    nIndices = _nIndices;
+    uses16BitIndices = is16Bit;
+
     start = 0;
     range = nIndices;
 
     currentIHandle = indicesHandle;
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, indicesHandle);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, nIndices * sizeof(unsigned int),
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, nIndices * GetIndexSize(),
                  newIndices, ToGLEnum(usage));
 }
 
@@ -179,6 +215,7 @@ bool Mesh::RemoveIndexData(void)
 
         glDeleteBuffers(1, &indicesHandle);
         nIndices = 0;
+        uses16BitIndices = false;
         indicesHandle = 0;
         indicesData.clear();
 
@@ -60,6 +60,12 @@ public:
     bool GetStoresData(void) const { return storesData; }
 
     bool GetUsesIndices(void) const { return indicesHandle != 0; }
+    //Gets whether the indices are stored on the GPU as 16-bit values instead of 32-bit ones.
+    bool GetUses16BitIndices(void) const { return uses16BitIndices; }
+    //Gets the size in bytes of each index on the GPU.
+    unsigned int GetIndexSize(void) const { return (uses16BitIndices ? sizeof(unsigned short) : sizeof(unsigned int)); }
+    //Gets the OpenGL type of each index on the GPU.
+    GLenum GetIndexGLType(void) const { return (uses16BitIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT); }
     
     unsigned int GetNVertices(void) const { return nVertices; }
     unsigned int GetNIndices(void) const { return nIndices; }
@@ -87,6 +93,7 @@ public:
 	const VertexType* GetVertexData(void) const { assert(storesData); return (VertexType*)verticesData.data(); }
     //Returns a pointer to a copy of the index data.
     //Assumes that this instance's mesh data uses indices, and that this instance stores the mesh data.
+    //The copy always uses 32-bit indices, even if the GPU's copy uses 16-bit ones.
 	const unsigned int* GetIndexData(void) const { assert(storesData && GetUsesIndices()); return indicesData.data(); }
 
 
@@ -117,6 +124,7 @@ public:
     //Otherwise, it will be copied in from this instance's local copy of the data.
     //Assumes that this instance's mesh data uses indices.
     //Also assumes that the given std::vector is empty.
+    //The output always uses 32-bit indices, even if the GPU's copy uses 16-bit ones.
     void ReadIndexData(std::vector<unsigned int>& outIndexData);
 
 
@@ -150,8 +158,36 @@ public:
         glBufferData(GL_ARRAY_BUFFER, nVertices * bytesPerVertex, newVertices, ToGLEnum(usage));
     }
 
+    template<typename VertexType>
+    //Replaces the given range of vertices without re-allocating the whole vertex buffer,
+    //    which is much faster than "SetVertexData" when only a small part of a big mesh changed.
+    //Assumes the given vertex type matches the vertices given to the last call to "SetVertexData".
+    void SetVertexSubData(const VertexType* newVertices, unsigned int firstVertex, unsigned int nNewVertices)
+    {
+        assert(sizeof(VertexType) == bytesPerVertex);
+        assert(firstVertex + nNewVertices <= nVertices);
+
+        if (storesData)
+        {
+            memcpy(verticesData.data() + (firstVertex * bytesPerVertex), newVertices,
+                   nNewVertices * bytesPerVertex);
+        }
+
+        currentVHandle = verticesHandle;
+        glBindBuffer(GL_ARRAY_BUFFER, verticesHandle);
+        glBufferSubData(GL_ARRAY_BUFFER, firstVertex * bytesPerVertex, nNewVertices * bytesPerVertex, newVertices);
+    }
+
     void SetIndexData(const std::vector<unsigned int>& newIndices, BufferUsageFrequency usage);
     void SetIndexData(const unsigned int* newIndices, unsigned int _nIndices, BufferUsageFrequency usage);
+    //Sets 16-bit indices, which take half the memory and bandwidth of 32-bit ones.
+    //Only usable if the mesh has no more than 65536 vertices.
+    //That's checked when the mesh is drawn, so the vertices can be set before or after the indices.
+    void SetIndexData(const std::vector<unsigned short>& newIndices, BufferUsageFrequency usage);
+    //Sets 16-bit indices, which take half the memory and bandwidth of 32-bit ones.
+    //Only usable if the mesh has no more than 65536 vertices.
+    //That's checked when the mesh is drawn, so the vertices can be set before or after the indices.
+    void SetIndexData(const unsigned short* newIndices, unsigned int _nIndices, BufferUsageFrequency usage);
 
 
     //Removes this data's indices if they exist. Returns whether they existed.
@@ -168,6 +204,7 @@ private:
 
     RenderObjHandle indicesHandle;
     unsigned int nIndices;
+    bool uses16BitIndices;
 
     RenderIOAttributes vertexAttributes;
 
@@ -184,4 +221,7 @@ private:
 
     //Converts the given value to the corresponding GL enum value.
     static GLenum ToGLEnum(BufferUsageFrequency usage);
+
+    //Uploads the given index data, which has the given number of bytes per index.
+    void UploadIndexData(const void* newIndices, unsigned int _nIndices, bool is16Bit, BufferUsageFrequency usage);
 };
\ No newline at end of file
@@ -3,6 +3,7 @@
 #include "../Data Nodes/DataNodes.hpp"
 #include "../../DebugAssist.h"
 #include "../../Math/Lower Math/Array2D.h"
+#include "../../Math/Lower Math/HashRand.h"
 
 
 
@@ -300,14 +301,14 @@ void GPUPG::GenerateGPUPParticles(Mesh& outMesh, GPUPG::NumberOfParticles numb,
         {
             float xID = increment * loc.x;
 
-            FastRand fr(Vector3u(loc.x, loc.y, randSeed).GetHashCode());
-            fr.GetRandInt();
-            fr.GetRandInt();
+            //Each of the six random values uses its index as the first coordinate of the hash.
+            float rands[6];
+            for (int i = 0; i < 6; ++i)
+                rands[i] = HashRand::GetZeroToOne(randSeed, i, (int)loc.x, (int)loc.y);
 
             particles[loc] = ParticleVertex(Vector2f(xID, yID),
-                                            Vector4f(fr.GetZeroToOne(), fr.GetZeroToOne(),
-                                                     fr.GetZeroToOne(), fr.GetZeroToOne()),
-                                            Vector2f(fr.GetZeroToOne(), fr.GetZeroToOne()));
+                                            Vector4f(rands[0], rands[1], rands[2], rands[3]),
+                                            Vector2f(rands[4], rands[5]));
         }
     }
 
@@ -1,64 +1,42 @@
 #include "NoiseToTexture.h"
 
 
+template<typename Func>
+void NoiseToTexture::ForEachClampedRow(Func convertRow) const
+{
+    unsigned int width = NoiseToUse->GetWidth();
+    ThreadPool::GetGlobalPool().RunChunks(NoiseToUse->GetHeight(), Mathf::Max(NumbThreads, (unsigned int)1),
+                                          [&](unsigned int band, unsigned int startY, unsigned int endY)
+    {
+        std::vector<float> rowVals(width);
+        for (unsigned int y = startY; y < endY; ++y)
+        {
+            const float* noiseRow = &NoiseToUse->GetArray()[NoiseToUse->GetIndex(0, y)];
+            for (unsigned int x = 0; x < width; ++x)
+                rowVals[x] = Mathf::Clamp(noiseRow[x], 0.0f, 1.0f);
+
+            convertRow(rowVals.data(), y);
+        }
+    });
+}
+
 void NoiseToTexture::GetImage(Array2D<Vector4b>& outImage) const
 {
 	//The pixel array.
     outImage.Reset(NoiseToUse->GetWidth(), NoiseToUse->GetHeight());
-	
-	//Some temp variables.
-	unsigned int x, y, pixX, pixY;
-	Vector4f col;
-	Vector4b colB;
-	float tempF, readNoise;
-	
-	//Go through every pixel and set its value.
-	for (x = 0; x < NoiseToUse->GetWidth(); ++x)
-	{
-		for (y = 0; y < NoiseToUse->GetHeight(); ++y)
-		{
-			tempF = (*NoiseToUse)[Vector2u(x, y)];
-            readNoise = Mathf::Clamp(tempF, 0.0f, 1.0f);
-
-			//Get the coordinates of the pixel in the out array.
-			pixX = x * 4;
-			pixY = y;
 
-			//Set the pixel values.
-			col = GradientToUse->GetColor(readNoise) * 255.0f;
-			col = Vector4f(Mathf::Clamp(col.x, 0.0f, 255.0f), Mathf::Clamp(col.y, 0.0f, 255.0f),
-						   Mathf::Clamp(col.z, 0.0f, 255.0f), Mathf::Clamp(col.w, 0.0f, 255.0f));
-			colB = Vector4b((unsigned char)Mathf::RoundToInt(col.x),
-							(unsigned char)Mathf::RoundToInt(col.y),
-							(unsigned char)Mathf::RoundToInt(col.z),
-							(unsigned char)Mathf::RoundToInt(col.w));
-            outImage[Vector2u(pixX, pixY)] = colB;
-		}
-	}
+    ForEachClampedRow([this, &outImage](const float* noiseVals, unsigned int y)
+    {
+        GradientToUse->GetColors(&outImage[Vector2u(0, y)], noiseVals, outImage.GetWidth());
+    });
 }
 void NoiseToTexture::GetImage(Array2D<Vector4f>& outImage) const
 {
 	//The pixel array.
     outImage.Reset(NoiseToUse->GetWidth(), NoiseToUse->GetHeight());
-	
-	//Some temp variables.
-	unsigned int x, y, pixX, pixY;
-	float tempF, readNoise;
-	
-	//Go through every pixel and set its value.
-	for (x = 0; x < NoiseToUse->GetWidth(); ++x)
-	{
-		for (y = 0; y < NoiseToUse->GetHeight(); ++y)
-		{
-			tempF = (*NoiseToUse)[Vector2u(x, y)];
-            readNoise = Mathf::Clamp(tempF, 0.0f, 1.0f);
-
-			//Get the coordinates of the pixel in the out array.
-			pixX = x * 4;
-			pixY = y;
 
-			//Set the pixel values.
-            outImage[Vector2u(pixX, pixY)] = GradientToUse->GetColor(readNoise);
-		}
-	}
+    ForEachClampedRow([this, &outImage](const float* noiseVals, unsigned int y)
+    {
+        GradientToUse->GetColors(&outImage[Vector2u(0, y)], noiseVals, outImage.GetWidth());
+    });
 }
\ No newline at end of file
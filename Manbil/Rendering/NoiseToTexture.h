@@ -2,6 +2,7 @@
 
 #include "../Math/Noise Generation/ColorGradient.h"
 #include "../Math/Noise Generation/BasicGenerators.h"
+#include <vector>
 
 //Converts a 2D noise field to a texture.
 class NoiseToTexture
@@ -11,9 +12,24 @@ public:
 	const ColorGradient* GradientToUse;
 	const Noise2D* NoiseToUse;
 
+	//The number of bands of rows the image is split into. Each band is converted in parallel on the global ThreadPool.
+	unsigned int NumbThreads;
+
 	NoiseToTexture(ColorGradient* gradient = 0, Noise2D* noise = 0)
-        : GradientToUse(gradient), NoiseToUse(noise) { }
+        : GradientToUse(gradient), NoiseToUse(noise), NumbThreads(1) { }
 
+	//Converts the noise to colors. Noise values are clamped between 0 and 1 first.
+	//For large images, bake the gradient first (see "ColorGradient::Bake").
 	void GetImage(Array2D<Vector4b>& outImage) const;
+	//Converts the noise to colors. Noise values are clamped between 0 and 1 first.
+	//For large images, bake the gradient first (see "ColorGradient::Bake").
     void GetImage(Array2D<Vector4f>& outImage) const;
+
+
+private:
+
+    //A function with signature "void ConvertRow(const float* noiseVals, unsigned int y)".
+    template<typename Func>
+    //Clamps each row of noise into a buffer and passes it to the given function, in parallel.
+    void ForEachClampedRow(Func convertRow) const;
 };
\ No newline at end of file
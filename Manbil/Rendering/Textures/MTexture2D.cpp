@@ -215,8 +215,10 @@ bool MTexture2D::SetDataFromFile(std::string filePath, PixelSizes newSize, std::
     pixelSize = newSize;
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, outData.GetRowPitch());
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
                  GL_RGBA, GL_UNSIGNED_BYTE, outData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -253,8 +255,10 @@ bool MTexture2D::SetColorData(const Array2D<Vector4b>& pixelData, PixelSizes new
     height = pixelData.GetHeight();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
                  GL_RGBA, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -281,8 +285,10 @@ bool MTexture2D::SetColorData(const Array2D<Vector4f>& pixelData, PixelSizes new
     height = pixelData.GetHeight();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
                  GL_RGBA, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -300,8 +306,10 @@ bool MTexture2D::UpdateColorData(const Array2D<Vector4b>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
                     GL_RGBA, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -319,8 +327,10 @@ bool MTexture2D::UpdateColorData(const Array2D<Vector4f>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
                     GL_RGBA, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -348,8 +358,10 @@ bool MTexture2D::SetGreyscaleData(const Array2D<unsigned char>& greyscaleData, P
     height = greyscaleData.GetHeight();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
                  GL_RED, GL_UNSIGNED_BYTE, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -376,8 +388,76 @@ bool MTexture2D::SetGreyscaleData(const Array2D<float>& greyscaleData, PixelSize
     height = greyscaleData.GetHeight();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
                  GL_RED, GL_FLOAT, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    return true;
+}
+bool MTexture2D::SetGreyscaleData(const Array2D<unsigned short>& greyscaleData, PixelSizes newSize)
+{
+    if (!IsValidTexture())
+    {
+        return false;
+    }
+    if (IsPixelSizeGreyscale(newSize))
+    {
+        pixelSize = newSize;
+    }
+    if (!IsGreyscaleTexture())
+    {
+        return false;
+    }
+
+    width = greyscaleData.GetWidth();
+    height = greyscaleData.GetHeight();
+
+    Bind();
+    //Rows of 2-byte values aren't always a multiple of OpenGL's default 4-byte row alignment.
+    //The array's rows may also be padded, so OpenGL is told how far apart they really are.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
+    glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
+                 GL_RED, GL_UNSIGNED_SHORT, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    return true;
+}
+bool MTexture2D::SetGreyscaleData(const Array2D<HalfFloat>& greyscaleData, PixelSizes newSize)
+{
+    if (!IsValidTexture())
+    {
+        return false;
+    }
+    if (IsPixelSizeGreyscale(newSize))
+    {
+        pixelSize = newSize;
+    }
+    if (!IsGreyscaleTexture())
+    {
+        return false;
+    }
+
+    width = greyscaleData.GetWidth();
+    height = greyscaleData.GetHeight();
+
+    Bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
+    glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
+                 GL_RED, GL_HALF_FLOAT, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -395,8 +475,10 @@ bool MTexture2D::UpdateGreyscaleData(const Array2D<unsigned char>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
                     GL_RED, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -414,8 +496,56 @@ bool MTexture2D::UpdateGreyscaleData(const Array2D<float>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
                     GL_RED, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    return true;
+}
+bool MTexture2D::UpdateGreyscaleData(const Array2D<unsigned short>& pixelData,
+                                     unsigned int offX, unsigned int offY)
+{
+    if (offX + pixelData.GetWidth() > width ||
+        offY + pixelData.GetHeight() > height)
+    {
+        return false;
+    }
+
+    Bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
+                    GL_RED, GL_UNSIGNED_SHORT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_2D);
+    }
+
+    return true;
+}
+bool MTexture2D::UpdateGreyscaleData(const Array2D<HalfFloat>& pixelData,
+                                     unsigned int offX, unsigned int offY)
+{
+    if (offX + pixelData.GetWidth() > width ||
+        offY + pixelData.GetHeight() > height)
+    {
+        return false;
+    }
+
+    Bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
+    glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
+                    GL_RED, GL_HALF_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -442,8 +572,10 @@ bool MTexture2D::SetDepthData(const Array2D<unsigned char>& depthData, PixelSize
     Bind();
     width = depthData.GetWidth();
     height = depthData.GetHeight();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, depthData.GetRowPitch());
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
                  GL_UNSIGNED_BYTE, GL_DEPTH_COMPONENT, depthData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -469,8 +601,10 @@ bool MTexture2D::SetDepthData(const Array2D<float>& depthData, PixelSizes newSiz
     Bind();
     width = depthData.GetWidth();
     height = depthData.GetHeight();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, depthData.GetRowPitch());
     glTexImage2D(GL_TEXTURE_2D, 0, ToGLenum(pixelSize), width, height, 0,
                  GL_FLOAT, GL_DEPTH_COMPONENT, depthData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -488,8 +622,10 @@ bool MTexture2D::UpdateDepthData(const Array2D<unsigned char>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
                     GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -506,8 +642,10 @@ bool MTexture2D::UpdateDepthData(const Array2D<float>& pixelData, unsigned int o
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage2D(GL_TEXTURE_2D, 0, offX, offY, pixelData.GetWidth(), pixelData.GetHeight(),
                     GL_DEPTH_COMPONENT, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_2D);
@@ -526,7 +664,9 @@ bool MTexture2D::GetColorData(Array2D<Vector4b>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_UNSIGNED_BYTE, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -539,7 +679,9 @@ bool MTexture2D::GetColorData(Array2D<Vector4f>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_2D, 0, GL_RGBA, GL_FLOAT, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -553,7 +695,9 @@ bool MTexture2D::GetGreyscaleData(Array2D<unsigned char>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_UNSIGNED_BYTE, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -566,7 +710,9 @@ bool MTexture2D::GetGreyscaleData(Array2D<float>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_2D, 0, GL_RED, GL_FLOAT, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -580,7 +726,9 @@ bool MTexture2D::GetDepthData(Array2D<unsigned char>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -593,7 +741,9 @@ bool MTexture2D::GetDepthData(Array2D<float>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT, GL_FLOAT, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -609,6 +759,7 @@ GLenum MTexture2D::GetCPUFormat(void) const
             return GL_RGBA;
         case PS_8U_GREYSCALE:
         case PS_16U_GREYSCALE:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
             return GL_RED;
         case PS_16U_DEPTH:
@@ -635,6 +786,7 @@ GLenum MTexture2D::GetComponentType(void) const
 
         case PS_16F:
         case PS_32F:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
         case PS_32F_DEPTH:
             return GL_FLOAT;
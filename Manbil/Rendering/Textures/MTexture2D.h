@@ -2,6 +2,7 @@
 
 #include "TextureSettings.h"
 #include "../../Math/Lower Math/Array2D.h"
+#include "../../Math/Lower Math/HalfFloat.h"
 
 
 //Represents a 2D texture.
@@ -121,6 +122,20 @@ public:
     //Returns whether the operation succeeded.
     bool SetGreyscaleData(const Array2D<float>& greyscaleData,
                           PixelSizes newSize = PixelSizes::PS_16U_DEPTH);
+    //Uploads 16-bit unsigned int data (e.x. compact noise) directly, without converting it to floats first.
+    //This data matches the "PS_16U_GREYSCALE" pixel size, which is a good choice for "newSize".
+    //This operation only succeeds if this texture's pixel type is a greyscale type.
+    //If a non-greyscale pixel size is passed in, the current pixel size is not changed.
+    //Returns whether the operation succeeded.
+    bool SetGreyscaleData(const Array2D<unsigned short>& greyscaleData,
+                          PixelSizes newSize = PixelSizes::PS_16U_DEPTH);
+    //Uploads half-float data (e.x. compact noise) directly, without converting it to floats first.
+    //This data matches the "PS_16F_GREYSCALE" pixel size, which is a good choice for "newSize".
+    //This operation only succeeds if this texture's pixel type is a greyscale type.
+    //If a non-greyscale pixel size is passed in, the current pixel size is not changed.
+    //Returns whether the operation succeeded.
+    bool SetGreyscaleData(const Array2D<HalfFloat>& greyscaleData,
+                          PixelSizes newSize = PixelSizes::PS_16U_DEPTH);
     //Updates this texture's greyscale data without having to allocate new space.
     //This operation fails if any part of the pixel array is outside the texture bounds.
     //Returns whether the operation succeeded.
@@ -131,6 +146,16 @@ public:
     //Returns whether the operation succeeded.
     bool UpdateGreyscaleData(const Array2D<float>& pixelData,
                              unsigned int offsetX = 0, unsigned int offsetY = 0);
+    //Updates this texture's greyscale data without having to allocate new space.
+    //This operation fails if any part of the pixel array is outside the texture bounds.
+    //Returns whether the operation succeeded.
+    bool UpdateGreyscaleData(const Array2D<unsigned short>& pixelData,
+                             unsigned int offsetX = 0, unsigned int offsetY = 0);
+    //Updates this texture's greyscale data without having to allocate new space.
+    //This operation fails if any part of the pixel array is outside the texture bounds.
+    //Returns whether the operation succeeded.
+    bool UpdateGreyscaleData(const Array2D<HalfFloat>& pixelData,
+                             unsigned int offsetX = 0, unsigned int offsetY = 0);
 
 
     //This operation only succeeds if this texture's pixel type is a depth type.
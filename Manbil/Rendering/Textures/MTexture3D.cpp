@@ -167,8 +167,10 @@ bool MTexture3D::SetColorData(const Array3D<Vector4b>& pixelData, PixelSizes new
     depth = pixelData.GetDepth();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
                  GL_RGBA, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -196,8 +198,10 @@ bool MTexture3D::SetColorData(const Array3D<Vector4f>& pixelData, PixelSizes new
     depth = pixelData.GetDepth();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
                  GL_RGBA, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -216,9 +220,11 @@ bool MTexture3D::UpdateColorData(const Array3D<Vector4b>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
                     pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
                     GL_RGBA, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -237,9 +243,11 @@ bool MTexture3D::UpdateColorData(const Array3D<Vector4f>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
                     pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
                     GL_RGBA, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -268,8 +276,10 @@ bool MTexture3D::SetGreyscaleData(const Array3D<unsigned char>& greyscaleData, P
     depth = greyscaleData.GetDepth();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
     glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
                  GL_RED, GL_UNSIGNED_BYTE, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -297,8 +307,78 @@ bool MTexture3D::SetGreyscaleData(const Array3D<float>& greyscaleData, PixelSize
     depth = greyscaleData.GetDepth();
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
     glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
                  GL_RED, GL_FLOAT, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_3D);
+    }
+
+    return true;
+}
+bool MTexture3D::SetGreyscaleData(const Array3D<unsigned short>& greyscaleData, PixelSizes newSize)
+{
+    if (!IsValidTexture())
+    {
+        return false;
+    }
+    if (IsPixelSizeGreyscale(newSize))
+    {
+        pixelSize = newSize;
+    }
+    if (!IsGreyscaleTexture())
+    {
+        return false;
+    }
+
+    width = greyscaleData.GetWidth();
+    height = greyscaleData.GetHeight();
+    depth = greyscaleData.GetDepth();
+
+    Bind();
+    //Rows of 2-byte values aren't always a multiple of OpenGL's default 4-byte row alignment.
+    //The array's rows may also be padded, so OpenGL is told how far apart they really are.
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
+    glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
+                 GL_RED, GL_UNSIGNED_SHORT, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_3D);
+    }
+
+    return true;
+}
+bool MTexture3D::SetGreyscaleData(const Array3D<HalfFloat>& greyscaleData, PixelSizes newSize)
+{
+    if (!IsValidTexture())
+    {
+        return false;
+    }
+    if (IsPixelSizeGreyscale(newSize))
+    {
+        pixelSize = newSize;
+    }
+    if (!IsGreyscaleTexture())
+    {
+        return false;
+    }
+
+    width = greyscaleData.GetWidth();
+    height = greyscaleData.GetHeight();
+    depth = greyscaleData.GetDepth();
+
+    Bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, greyscaleData.GetRowPitch());
+    glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
+                 GL_RED, GL_HALF_FLOAT, greyscaleData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -317,9 +397,11 @@ bool MTexture3D::UpdateGreyscaleData(const Array3D<unsigned char>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
                     pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
                     GL_RED, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -338,9 +420,61 @@ bool MTexture3D::UpdateGreyscaleData(const Array3D<float>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
                     pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
                     GL_RED, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_3D);
+    }
+
+    return true;
+}
+bool MTexture3D::UpdateGreyscaleData(const Array3D<unsigned short>& pixelData,
+                                     unsigned int offX, unsigned int offY, unsigned int offZ)
+{
+    if (offX + pixelData.GetWidth() > width ||
+        offY + pixelData.GetHeight() > height ||
+        offZ + pixelData.GetDepth() > depth)
+    {
+        return false;
+    }
+
+    Bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
+    glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
+                    pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
+                    GL_RED, GL_UNSIGNED_SHORT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (usesMipmaps)
+    {
+        glGenerateMipmap(GL_TEXTURE_3D);
+    }
+
+    return true;
+}
+bool MTexture3D::UpdateGreyscaleData(const Array3D<HalfFloat>& pixelData,
+                                     unsigned int offX, unsigned int offY, unsigned int offZ)
+{
+    if (offX + pixelData.GetWidth() > width ||
+        offY + pixelData.GetHeight() > height ||
+        offZ + pixelData.GetDepth() > depth)
+    {
+        return false;
+    }
+
+    Bind();
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
+    glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
+                    pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
+                    GL_RED, GL_HALF_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -368,8 +502,10 @@ bool MTexture3D::SetDepthData(const Array3D<unsigned char>& depthData, PixelSize
     width = depthData.GetWidth();
     height = depthData.GetHeight();
     depth = depthData.GetDepth();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, depthData.GetRowPitch());
     glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
                  GL_UNSIGNED_BYTE, GL_DEPTH_COMPONENT, depthData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -396,8 +532,10 @@ bool MTexture3D::SetDepthData(const Array3D<float>& depthData, PixelSizes newSiz
     width = depthData.GetWidth();
     height = depthData.GetHeight();
     depth = depthData.GetDepth();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, depthData.GetRowPitch());
     glTexImage3D(GL_TEXTURE_3D, 0, ToGLenum(pixelSize), width, height, depth, 0,
                  GL_FLOAT, GL_DEPTH_COMPONENT, depthData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -416,9 +554,11 @@ bool MTexture3D::UpdateDepthData(const Array3D<unsigned char>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
                     pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
                     GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -437,9 +577,11 @@ bool MTexture3D::UpdateDepthData(const Array3D<float>& pixelData,
     }
 
     Bind();
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch());
     glTexSubImage3D(GL_TEXTURE_3D, 0, offX, offY, offZ,
                     pixelData.GetWidth(), pixelData.GetHeight(), pixelData.GetDepth(),
                     GL_DEPTH_COMPONENT, GL_FLOAT, pixelData.GetArray());
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
     if (usesMipmaps)
     {
         glGenerateMipmap(GL_TEXTURE_3D);
@@ -458,7 +600,9 @@ bool MTexture3D::GetColorData(Array3D<Vector4b>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_3D, 0, GL_RGBA, GL_UNSIGNED_BYTE, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -471,7 +615,9 @@ bool MTexture3D::GetColorData(Array3D<Vector4f>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_3D, 0, GL_RGBA, GL_FLOAT, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -485,7 +631,9 @@ bool MTexture3D::GetGreyscaleData(Array3D<unsigned char>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_3D, 0, GL_RED, GL_UNSIGNED_BYTE, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -498,7 +646,9 @@ bool MTexture3D::GetGreyscaleData(Array3D<float>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_3D, 0, GL_RED, GL_FLOAT, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -512,7 +662,9 @@ bool MTexture3D::GetDepthData(Array3D<unsigned char>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_3D, 0, GL_DEPTH_COMPONENT, GL_UNSIGNED_BYTE, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -525,7 +677,9 @@ bool MTexture3D::GetDepthData(Array3D<float>& outData) const
     }
 
     Bind();
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch());
     glGetTexImage(GL_TEXTURE_3D, 0, GL_DEPTH_COMPONENT, GL_FLOAT, outData.GetArray());
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0);
 
     return true;
 }
@@ -541,6 +695,7 @@ GLenum MTexture3D::GetCPUFormat(void) const
             return GL_RGBA;
         case PS_8U_GREYSCALE:
         case PS_16U_GREYSCALE:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
             return GL_RED;
         case PS_16U_DEPTH:
@@ -565,6 +720,7 @@ GLenum MTexture3D::GetComponentType(void) const
 
         case PS_16F:
         case PS_32F:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
         case PS_32F_DEPTH:
             return GL_FLOAT;
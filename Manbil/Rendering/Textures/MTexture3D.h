@@ -2,6 +2,7 @@
 
 #include "TextureSettings.h"
 #include "../../Math/Lower Math/Array3D.h"
+#include "../../Math/Lower Math/HalfFloat.h"
 
 
 //Represents a 3D texture.
@@ -108,6 +109,20 @@ public:
     //Returns whether the operation succeeded.
     bool SetGreyscaleData(const Array3D<float>& greyscaleData,
                           PixelSizes newSize = PixelSizes::PS_16U_DEPTH);
+    //Uploads 16-bit unsigned int data (e.x. compact noise) directly, without converting it to floats first.
+    //This data matches the "PS_16U_GREYSCALE" pixel size, which is a good choice for "newSize".
+    //This operation only succeeds if this texture's pixel type is a greyscale type.
+    //If a non-greyscale pixel size is passed in, the current pixel size is not changed.
+    //Returns whether the operation succeeded.
+    bool SetGreyscaleData(const Array3D<unsigned short>& greyscaleData,
+                          PixelSizes newSize = PixelSizes::PS_16U_DEPTH);
+    //Uploads half-float data (e.x. compact noise) directly, without converting it to floats first.
+    //This data matches the "PS_16F_GREYSCALE" pixel size, which is a good choice for "newSize".
+    //This operation only succeeds if this texture's pixel type is a greyscale type.
+    //If a non-greyscale pixel size is passed in, the current pixel size is not changed.
+    //Returns whether the operation succeeded.
+    bool SetGreyscaleData(const Array3D<HalfFloat>& greyscaleData,
+                          PixelSizes newSize = PixelSizes::PS_16U_DEPTH);
     //Updates this texture's greyscale data without having to allocate new space.
     //This operation fails if any part of the pixel array is outside the texture bounds.
     //Returns whether the operation succeeded.
@@ -118,6 +133,16 @@ public:
     //Returns whether the operation succeeded.
     bool UpdateGreyscaleData(const Array3D<float>& pixelData,
                              unsigned int offsetX = 0, unsigned int offsetY = 0, unsigned int offsetZ = 0);
+    //Updates this texture's greyscale data without having to allocate new space.
+    //This operation fails if any part of the pixel array is outside the texture bounds.
+    //Returns whether the operation succeeded.
+    bool UpdateGreyscaleData(const Array3D<unsigned short>& pixelData,
+                             unsigned int offsetX = 0, unsigned int offsetY = 0, unsigned int offsetZ = 0);
+    //Updates this texture's greyscale data without having to allocate new space.
+    //This operation fails if any part of the pixel array is outside the texture bounds.
+    //Returns whether the operation succeeded.
+    bool UpdateGreyscaleData(const Array3D<HalfFloat>& pixelData,
+                             unsigned int offsetX = 0, unsigned int offsetY = 0, unsigned int offsetZ = 0);
 
 
     //This operation only succeeds if this texture's pixel type is a depth type.
@@ -308,18 +308,25 @@ bool MTextureCubemap::SetData ## colorType(const Array2D<pixelType>& negX, \
     height = negX.GetHeight(); \
     \
     Bind(); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, negX.GetRowPitch()); \
     glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_X, 0, ToGLenum(pixelSize), width, height, \
                  0, glDataType, glPixelType, negX.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, negY.GetRowPitch()); \
     glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Y, 0, ToGLenum(pixelSize), width, height, \
                  0, glDataType, glPixelType, negY.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, negZ.GetRowPitch()); \
     glTexImage2D(GL_TEXTURE_CUBE_MAP_NEGATIVE_Z, 0, ToGLenum(pixelSize), width, height, \
                  0, glDataType, glPixelType, negZ.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, posX.GetRowPitch()); \
     glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X, 0, ToGLenum(pixelSize), width, height, \
                  0, glDataType, glPixelType, posX.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, posY.GetRowPitch()); \
     glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Y, 0, ToGLenum(pixelSize), width, height, \
                  0, glDataType, glPixelType, posY.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, posZ.GetRowPitch()); \
     glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_Z, 0, ToGLenum(pixelSize), width, height, \
                  0, glDataType, glPixelType, posZ.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); \
     if (usesMipmaps) \
     { \
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP); \
@@ -350,8 +357,10 @@ bool MTextureCubemap::SetFace ## colorType(CubeTextureTypes face, const Array2D<
     } \
     \
     Bind(); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, pixelData.GetRowPitch()); \
     glTexImage2D(TextureTypeToGLEnum(face), 0, ToGLenum(pixelSize), width, height, \
                  0, glDataType, glPixelType, pixelData.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); \
     if (shouldUpdateMips && usesMipmaps) \
     { \
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP); \
@@ -382,8 +391,10 @@ bool MTextureCubemap::UpdateFace ## colorType(CubeTextureTypes face, const Array
     } \
     \
     Bind(); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, newData.GetRowPitch()); \
     glTexSubImage2D(TextureTypeToGLEnum(face), 0, offX, offY, newData.GetWidth(), newData.GetHeight(), \
                     glDataType, glPixelType, newData.GetArray()); \
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0); \
     if (updateMips && usesMipmaps) \
     { \
         glGenerateMipmap(GL_TEXTURE_CUBE_MAP); \
@@ -413,7 +424,9 @@ bool MTextureCubemap::GetFace ## colorType(CubeTextureTypes face, Array2D<pixelT
     } \
     \
     Bind(); \
+    glPixelStorei(GL_PACK_ROW_LENGTH, outData.GetRowPitch()); \
     glGetTexImage(TextureTypeToGLEnum(face), 0, glDataType, glPixelType, outData.GetArray()); \
+    glPixelStorei(GL_PACK_ROW_LENGTH, 0); \
     \
     return true; \
 }
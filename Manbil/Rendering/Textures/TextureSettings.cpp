@@ -85,6 +85,7 @@ bool IsPixelSizeColor(PixelSizes pixelSize)
 
         case PS_8U_GREYSCALE:
         case PS_16U_GREYSCALE:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
         case PS_16U_DEPTH:
         case PS_24U_DEPTH:
@@ -100,6 +101,7 @@ bool IsPixelSizeGreyscale(PixelSizes pixelSize)
     {
         case PS_8U_GREYSCALE:
         case PS_16U_GREYSCALE:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
             return true;
 
@@ -130,6 +132,7 @@ bool IsPixelSizeDepth(PixelSizes pixelSize)
         case PS_32F:
         case PS_8U_GREYSCALE:
         case PS_16U_GREYSCALE:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
             return false;
 
@@ -142,6 +145,7 @@ bool IsPixelSizeFloat(PixelSizes size)
     {
         case PS_16F:
         case PS_32F:
+        case PS_16F_GREYSCALE:
         case PS_32F_GREYSCALE:
         case PS_32F_DEPTH:
             return true;
@@ -168,6 +172,7 @@ unsigned int GetComponentSize(PixelSizes size)
         case PS_16F:
         case PS_16U:
         case PS_16U_GREYSCALE:
+        case PS_16F_GREYSCALE:
         case PS_16U_DEPTH:
             return 16;
 
@@ -192,6 +197,7 @@ GLenum ToGLenum(PixelSizes pixelSize)
         case PS_32F: return GL_RGBA32F;
         case PS_8U_GREYSCALE: return GL_R8;
         case PS_16U_GREYSCALE: return GL_R16;
+        case PS_16F_GREYSCALE: return GL_R16F;
         case PS_32F_GREYSCALE: return GL_R32F;
         case PS_16U_DEPTH: return GL_DEPTH_COMPONENT16;
         case PS_24U_DEPTH: return GL_DEPTH_COMPONENT24;
@@ -210,6 +216,7 @@ std::string ToString(PixelSizes size)
         case PS_32F: return "RGBA Float 32";
         case PS_8U_GREYSCALE: return "Greyscale UInt 8";
         case PS_16U_GREYSCALE: return "Greyscale UInt 16";
+        case PS_16F_GREYSCALE: return "Greyscale Float 16";
         case PS_32F_GREYSCALE: return "Greyscale Float 32";
         case PS_16U_DEPTH: return "Depth UInt 16";
         case PS_24U_DEPTH: return "Depth UInt 24";
@@ -246,6 +253,10 @@ PixelSizes ToPixelSize(const std::string& sizeStr)
     {
         return PS_16U_GREYSCALE;
     }
+    else if (sizeStr == std::string("Greyscale Float 16"))
+    {
+        return PS_16F_GREYSCALE;
+    }
     else if (sizeStr == std::string("Greyscale Float 32"))
     {
         return PS_32F_GREYSCALE;
@@ -27,6 +27,8 @@ enum PixelSizes
     //Red only, uint, 2 bytes.
     PS_16U_GREYSCALE,
 
+    //Red only, float, 2 bytes.
+    PS_16F_GREYSCALE,
     //Red only, float, 4 bytes.
     PS_32F_GREYSCALE,
 
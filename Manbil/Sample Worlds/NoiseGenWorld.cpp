@@ -5,8 +5,10 @@
 
 #include "../Math/NoiseGeneration.hpp"
 #include "../Math/Higher Math/BumpmapToNormalmap.h"
+#include "../Rendering/NoiseToTexture.h"
 
 #include <iostream>
+#include <chrono>
 
 
 NoiseGenWorld::NoiseGenWorld(void)
@@ -177,6 +179,30 @@ void NoiseGenWorld::GenerateNoise(MTexture2D& tex)
         }
         break;
 
+        case 5:
+        {
+            //Use a 2D slice of several octaves of 3D Simplex noise.
+            //Simplex noise has the same settings as Perlin noise, so it can be layered the same way.
+            Simplex3D layers[] =
+            {
+                Simplex3D(128.0f, Vector3i(), rng.GetRandInt(), false),
+                Simplex3D(64.0f, Vector3i(), rng.GetRandInt(), false),
+                Simplex3D(32.0f, Vector3i(), rng.GetRandInt(), false),
+            };
+            const Generator3D* layerPointers[] = { &layers[0], &layers[1], &layers[2] };
+            float layerWeights[] = { 0.6f, 0.3f, 0.1f };
+            LayeredOctave3D octaves(3, layerWeights, layerPointers);
+
+            Noise3D noiseMap3(noiseMap.GetWidth(), noiseMap.GetHeight(), 1);
+            octaves.Generate(noiseMap3);
+
+            //Move the values from roughly [-1, 1] into [0, 1].
+            assert(noiseMap.GetNumbElements() == noiseMap3.GetNumbElements());
+            for (unsigned int i = 0; i < noiseMap.GetNumbElements(); ++i)
+                noiseMap.GetArray()[i] = 0.5f + (0.5f * noiseMap3.GetArray()[i]);
+        }
+        break;
+
         default:
             Assert(false, "Unknown generation method", std::to_string(method));
     }
@@ -184,6 +210,34 @@ void NoiseGenWorld::GenerateNoise(MTexture2D& tex)
     //Put the result into the texture.
     tex.SetGreyscaleData(noiseMap, PS_32F_GREYSCALE);
 }
+void NoiseGenWorld::RunBenchmark(void)
+{
+    //Compare the speed of 3D Perlin and Simplex noise at a few different sizes.
+    Perlin3D perlin(32.0f, Perlin3D::Quintic, Vector3i(), rng.GetRandInt());
+    Simplex3D simplex(32.0f, Vector3i(), rng.GetRandInt());
+    Simplex4D simplex4(Vector4f(32.0f, 32.0f, 32.0f, 32.0f), 0.0f, Vector3i(), rng.GetRandInt());
+
+    const Generator3D* generators[] = { &perlin, &simplex, &simplex4 };
+    const char* generatorNames[] = { "Perlin3D", "Simplex3D", "Simplex4D" };
+    const unsigned int sizes[] = { 64, 128, 256 };
+
+    for (unsigned int sizeI = 0; sizeI < 3; ++sizeI)
+    {
+        Noise3D noise(sizes[sizeI], sizes[sizeI], sizes[sizeI]);
+        std::cout << sizes[sizeI] << "^3:\n";
+
+        for (unsigned int genI = 0; genI < 3; ++genI)
+        {
+            auto startTime = std::chrono::high_resolution_clock::now();
+            generators[genI]->Generate(noise);
+            auto endTime = std::chrono::high_resolution_clock::now();
+
+            std::cout << "\t" << generatorNames[genI] << ": " <<
+                         std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() <<
+                         "ms\n";
+        }
+    }
+}
 void NoiseGenWorld::GenerateBumpMap(MTexture2D& outBumpTex)
 {
     //Get the noise.
@@ -203,6 +257,22 @@ void NoiseGenWorld::GenerateBumpMap(MTexture2D& outBumpTex)
     outBumpTex.SetColorData(texCols, PS_32F);
 }
 
+void NoiseGenWorld::ColorizeNoise(MTexture2D& tex)
+{
+    Noise2D noise(tex.GetWidth(), tex.GetHeight());
+    tex.GetGreyscaleData(noise);
+
+    //The gradient is baked, so this stays fast even for big textures.
+    auto startTime = std::chrono::high_resolution_clock::now();
+    Array2D<Vector4b> colors(noise.GetWidth(), noise.GetHeight());
+    NoiseToTexture(&noiseGradient, &noise).GetImage(colors);
+    auto endTime = std::chrono::high_resolution_clock::now();
+    std::cout << "Took " << std::chrono::duration_cast<std::chrono::milliseconds>(endTime - startTime).count() <<
+                 "ms to color " << noise.GetWidth() << "x" << noise.GetHeight() << " noise\n";
+
+    tex.SetColorData(colors, PS_8U);
+}
+
 void NoiseGenWorld::InitializeWorld(void)
 {
     SFMLOpenGLWorld::InitializeWorld();
@@ -243,6 +313,16 @@ void NoiseGenWorld::InitializeWorld(void)
     guiTexColor.Mat = tryMat.Mat;
 
 
+    //Set up the gradient for coloring the noise: deep water, shallow water, sand, grass, rock, and snow.
+    noiseGradient.OrderedNodes.push_back(ColorNode(0.0f, Vector4f(0.0f, 0.0f, 0.3f, 1.0f)));
+    noiseGradient.OrderedNodes.push_back(ColorNode(0.4f, Vector4f(0.1f, 0.3f, 0.8f, 1.0f)));
+    noiseGradient.OrderedNodes.push_back(ColorNode(0.45f, Vector4f(0.1f, 0.3f, 0.8f, 1.0f), Vector4f(0.9f, 0.85f, 0.5f, 1.0f)));
+    noiseGradient.OrderedNodes.push_back(ColorNode(0.5f, Vector4f(0.2f, 0.6f, 0.1f, 1.0f)));
+    noiseGradient.OrderedNodes.push_back(ColorNode(0.75f, Vector4f(0.4f, 0.35f, 0.3f, 1.0f)));
+    noiseGradient.OrderedNodes.push_back(ColorNode(0.9f, Vector4f(1.0f, 1.0f, 1.0f, 1.0f)));
+    noiseGradient.Bake();
+
+
     //Set up the rendering camera.
     cam = Camera(Vector3f(), Vector3f(0.0f, 0.0f, 1.0f), Vector3f(0.0f, 1.0f, 0.0f));
     cam.MinOrthoBounds = Vector3f(0.0f, 0.0f, -1.0f);
@@ -250,7 +330,7 @@ void NoiseGenWorld::InitializeWorld(void)
 
 
     std::cout << "Use left/right arrow keys to change bumpmap height, Space to re-generate, " <<
-                 "and Enter to convert to bumpmap.\n";
+                 "Enter to convert to bumpmap, C to color the noise, and B to benchmark 3D noise.\n";
 
     std::cout << "\nRegenerating...\n";
     noiseTex.Create();
@@ -296,6 +376,19 @@ void NoiseGenWorld::UpdateWorld(float elapsedSeconds)
         GenerateBumpMap(noiseTex);
         std::cout << "Converted!\n\n";
     }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::C) &&
+        IsPixelSizeGreyscale(noiseTex.GetPixelSize()))
+    {
+        std::cout << "\nColoring...\n";
+        ColorizeNoise(noiseTex);
+        std::cout << "Colored!\n\n";
+    }
+    if (sf::Keyboard::isKeyPressed(sf::Keyboard::B))
+    {
+        std::cout << "\nBenchmarking...\n";
+        RunBenchmark();
+        std::cout << "Done!\n\n";
+    }
     if (sf::Keyboard::isKeyPressed(sf::Keyboard::Left))
     {
         bumpmapHeight *= 0.95f;
@@ -2,11 +2,13 @@
 
 #include "../Game Loop/SFMLOpenGLWorld.h"
 #include "../Rendering/GUI/GUI Elements/GUITexture.h"
+#include "../Math/Noise Generation/ColorGradient.h"
 
 
 //Allows the user to generate random noise and create a normal map from it.
 //Use Space to re-generate the noise, Enter to convert it to a normalmap,
-//    and Left/Right Arrows to change the slope of the normalmap.
+//    C to color the noise with a gradient, Left/Right Arrows to change the slope of the normalmap,
+//    and B to print how long 3D Perlin and Simplex noise take to generate.
 class NoiseGenWorld : public SFMLOpenGLWorld
 {
 public:
@@ -35,6 +37,8 @@ private:
 
     void GenerateNoise(MTexture2D& outNoiseTex);
     void GenerateBumpMap(MTexture2D& outBumpTex);
+    void ColorizeNoise(MTexture2D& tex);
+    void RunBenchmark(void);
     void GenerateGUI();
 
     //If the given value is "false", prints the given error message and ends the world.
@@ -49,5 +53,6 @@ private:
 
     FastRand rng;
     MTexture2D noiseTex;
+    ColorGradient noiseGradient;
     float bumpmapHeight = 20.0f;
 };
\ No newline at end of file
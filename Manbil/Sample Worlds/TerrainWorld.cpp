@@ -39,13 +39,15 @@ sf::ContextSettings TerrainWorld::GenerateContext(void)
 
 void TW::GenerateTerrainLOD(const Terrain& terr, unsigned int lodLevel)
 {
-    std::vector<VertexPosUVNormal> verts;
-    std::vector<unsigned int> inds;
-    terr.GenerateTrianglesFull<VertexPosUVNormal>(verts, inds,
-                                                  [](VertexPosUVNormal& v) { return &v.Pos; },
-                                                  [](VertexPosUVNormal& v) { return &v.UV; },
-                                                  [](VertexPosUVNormal& v) { return &v.Normal; },
-                                                  100.0f, lodLevel);
+    Vector2u nVerts = Terrain::GetNVertices(Vector2u(terr.GetWidth(), terr.GetHeight()), lodLevel);
+    std::vector<VertexPosUVNormal> verts(nVerts.x * nVerts.y);
+    std::vector<unsigned int> inds(Terrain::GetNIndices(Vector2u(terr.GetWidth(), terr.GetHeight()), lodLevel));
+    terr.GenerateTrianglesFull(verts.data(), inds.data(),
+                               [](VertexPosUVNormal& v, Vector3f pos, Vector2f uv, Vector3f normal)
+                               {
+                                   v = VertexPosUVNormal(pos, uv, normal);
+                               },
+                               100.0f, lodLevel, ThreadPool::GetGlobalPool().GetNThreads());
     
     //Insert a mesh for the terrain with this level of detail.
 	Mesh mesh(false, PrimitiveTypes::PT_TRIANGLE_LIST);
@@ -0,0 +1,105 @@
+#include "ThreadPool.h"
+
+
+namespace
+{
+    //Whether the current thread is already running a chunk of some job.
+    //Jobs started from inside a chunk are run serially to avoid waiting on ourselves.
+    thread_local bool isInsideJob = false;
+}
+
+
+ThreadPool& ThreadPool::GetGlobalPool(void)
+{
+    static ThreadPool globalPool(std::thread::hardware_concurrency());
+    return globalPool;
+}
+
+
+ThreadPool::ThreadPool(unsigned int nThreads)
+    : currentJob(0), currentNChunks(0), nextChunk(0), nFinishedChunks(0), shouldStop(false)
+{
+    //The thread that starts a job does some of the work, so it doesn't need its own worker.
+    for (unsigned int i = 1; i < nThreads; ++i)
+        workers.push_back(std::thread(&ThreadPool::WorkerLoop, this));
+}
+ThreadPool::~ThreadPool(void)
+{
+    {
+        std::lock_guard<std::mutex> lock(stateLock);
+        shouldStop = true;
+    }
+    jobStarted.notify_all();
+
+    for (unsigned int i = 0; i < workers.size(); ++i)
+        workers[i].join();
+}
+
+void ThreadPool::RunJob(unsigned int nChunks, const std::function<void(unsigned int)>& job)
+{
+    //If there's no point in using other threads, just run the chunks in order.
+    if (isInsideJob || nChunks == 1 || workers.size() == 0)
+    {
+        for (unsigned int i = 0; i < nChunks; ++i)
+            job(i);
+        return;
+    }
+
+    std::lock_guard<std::mutex> singleJob(jobLock);
+
+    {
+        std::lock_guard<std::mutex> lock(stateLock);
+        currentJob = &job;
+        currentNChunks = nChunks;
+        nextChunk = 0;
+        nFinishedChunks = 0;
+    }
+    jobStarted.notify_all();
+
+    isInsideJob = true;
+    RunAvailableChunks();
+    isInsideJob = false;
+
+    //Wait for the workers to finish the chunks they took.
+    std::unique_lock<std::mutex> lock(stateLock);
+    jobFinished.wait(lock, [this]() { return nFinishedChunks == currentNChunks; });
+    currentJob = 0;
+}
+void ThreadPool::RunAvailableChunks(void)
+{
+    std::unique_lock<std::mutex> lock(stateLock);
+    while (currentJob != 0 && nextChunk < currentNChunks)
+    {
+        const std::function<void(unsigned int)>* job = currentJob;
+        unsigned int chunk = nextChunk;
+        nextChunk += 1;
+
+        lock.unlock();
+        (*job)(chunk);
+        lock.lock();
+
+        nFinishedChunks += 1;
+        if (nFinishedChunks == currentNChunks)
+            jobFinished.notify_all();
+    }
+}
+void ThreadPool::WorkerLoop(void)
+{
+    isInsideJob = true;
+
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock(stateLock);
+            jobStarted.wait(lock, [this]()
+            {
+                return shouldStop || (currentJob != 0 && nextChunk < currentNChunks);
+            });
+
+            if (shouldStop)
+                return;
+        }
+
+        RunAvailableChunks();
+    }
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <assert.h>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+
+//A set of worker threads that split a range of work into contiguous chunks and run them in parallel.
+//The thread that starts a job helps run its chunks, and doesn't return until the whole job is done.
+//Only one job runs at a time; other threads that try to start a job will wait their turn.
+class ThreadPool
+{
+public:
+
+    //Gets a pool shared by the whole program, with one thread for each hardware thread.
+    static ThreadPool& GetGlobalPool(void);
+
+    //Gets the first element of the given chunk when splitting "nElements" elements into "nChunks" chunks.
+    //The last chunk ends at "GetChunkStart(nElements, nChunks, nChunks)", which is "nElements".
+    static unsigned int GetChunkStart(unsigned int nElements, unsigned int nChunks, unsigned int chunk)
+    {
+        return (unsigned int)(((unsigned long long)nElements * chunk) / nChunks);
+    }
+
+
+    //Creates a pool that runs jobs on the given number of threads
+    //    (including the thread that starts the job).
+    ThreadPool(unsigned int nThreads);
+    ~ThreadPool(void);
+
+    ThreadPool(const ThreadPool& cpy) = delete;
+    ThreadPool& operator=(const ThreadPool& cpy) = delete;
+
+
+    //Gets the number of threads that work on jobs (including the thread that starts the job).
+    unsigned int GetNThreads(void) const { return workers.size() + 1; }
+
+
+    //A function with signature "void DoChunk(unsigned int chunkIndex, unsigned int start, unsigned int end)".
+    template<typename Func>
+    //Splits the range [0, nElements) into "nChunks" contiguous chunks and runs the given function on each one.
+    //The range is always split the same way for a given number of elements and chunks,
+    //    so the caller can store one result per chunk and combine them deterministically afterwards.
+    //Some chunks may be empty if there are fewer elements than chunks.
+    //If this is called from inside another job, all chunks run on the calling thread.
+    void RunChunks(unsigned int nElements, unsigned int nChunks, Func doChunk)
+    {
+        assert(nChunks > 0);
+
+        std::function<void(unsigned int)> job = [&doChunk, nElements, nChunks](unsigned int chunk)
+        {
+            doChunk(chunk,
+                    GetChunkStart(nElements, nChunks, chunk),
+                    GetChunkStart(nElements, nChunks, chunk + 1));
+        };
+        RunJob(nChunks, job);
+    }
+
+
+private:
+
+    std::vector<std::thread> workers;
+
+    //Only one job can be running at a time.
+    std::mutex jobLock;
+
+    //Guards all the data about the current job.
+    std::mutex stateLock;
+    std::condition_variable jobStarted, jobFinished;
+
+    const std::function<void(unsigned int)>* currentJob;
+    unsigned int currentNChunks, nextChunk, nFinishedChunks;
+    bool shouldStop;
+
+
+    void RunJob(unsigned int nChunks, const std::function<void(unsigned int)>& job);
+
+    //Runs chunks from the current job until there are none left to start.
+    void RunAvailableChunks(void);
+    void WorkerLoop(void);
+};